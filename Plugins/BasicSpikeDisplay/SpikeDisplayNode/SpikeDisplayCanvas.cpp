@@ -66,7 +66,6 @@ SpikeDisplayCanvas::SpikeDisplayCanvas(SpikeDisplayNode* n) :
 
 SpikeDisplayCanvas::~SpikeDisplayCanvas()
 {
-    processor->removeSpikePlots();
 }
 
 void SpikeDisplayCanvas::beginAnimation()
@@ -89,7 +88,6 @@ void SpikeDisplayCanvas::update()
     //std::cout << "Updating SpikeDisplayCanvas" << std::endl;
 
     int nPlots = processor->getNumElectrodes();
-    processor->removeSpikePlots();
 
     if (nPlots != spikeDisplay->getNumPlots())
     {
@@ -97,16 +95,8 @@ void SpikeDisplayCanvas::update()
 
         for (int i = 0; i < nPlots; i++)
         {
-            SpikePlot* sp = spikeDisplay->addSpikePlot(processor->getNumberOfChannelsForElectrode(i), i,
-                                                       processor->getNameForElectrode(i));
-            processor->addSpikePlotForElectrode(sp, i);
-        }
-    }
-    else
-    {
-        for (int i = 0; i < nPlots; i++)
-        {
-            processor->addSpikePlotForElectrode(spikeDisplay->getSpikePlot(i), i);
+            spikeDisplay->addSpikePlot(processor->getNumberOfChannelsForElectrode(i), i,
+                                       processor->getNameForElectrode(i));
         }
     }
 
@@ -152,9 +142,18 @@ void SpikeDisplayCanvas::refresh()
 
 void SpikeDisplayCanvas::processSpikeEvents()
 {
+    for (int i = 0; i < spikeDisplay->getNumPlots(); i++)
+    {
+        // hand the current display thresholds to the processor
+        for (int j = 0; j < spikeDisplay->getNumChannelsForPlot(i); j++)
+            processor->setDisplayThreshold(i, j, spikeDisplay->getThresholdForWaveAxis(i, j));
 
-    processor->setParameter(2, 0.0f); // request redraw
+        // and take whatever spikes it gathered since the last refresh
+        const SpikeDisplayNode::SpikeBatch* spikes = processor->getLatestSpikes(i);
 
+        if (spikes != nullptr)
+            spikeDisplay->plotSpikes(*spikes, i);
+    }
 }
 
 bool SpikeDisplayCanvas::keyPressed(const KeyPress& key)
@@ -451,9 +450,9 @@ void SpikeDisplay::invertSpikes(bool shouldInvert_)
     //std::cout << "Invert spikes? " << shouldInvert_ << std::endl;
 }
 
-void SpikeDisplay::plotSpike(const SpikeEvent* spike, int electrodeNum)
+void SpikeDisplay::plotSpikes(const SpikeDisplayNode::SpikeBatch& spikes, int electrodeNum)
 {
-    spikePlots[electrodeNum]->processSpikeObject(spike);
+    spikePlots[electrodeNum]->processSpikeBatch(spikes);
 }
 
 void SpikeDisplay::registerThresholdCoordinator(SpikeThresholdCoordinator* stc)
@@ -582,32 +581,19 @@ void SpikePlot::paint(Graphics& g)
 
 }
 
-void SpikePlot::processSpikeObject(const SpikeEvent* s)
+void SpikePlot::processSpikeBatch(const SpikeDisplayNode::SpikeBatch& spikes)
 {
-    // std::cout << "ElectrodePlot::processSpikeObject()" << std::endl;
-
-    // first, check if it's above threshold
-    // bool aboveThreshold = false;
-
-    // for (int i = 0; i < nWaveAx; i++)
-    // {
-    //     aboveThreshold = aboveThreshold | wAxes[i]->checkThreshold(s);
-    // }
+    if (spikes.getNumStored() == 0 || spikes.numChannels != nChannels)
+        return;
 
-    // if (aboveThreshold)
-    // {
     for (int i = 0; i < nWaveAx; i++)
-        wAxes[i]->updateSpikeData(s);
+    {
+        wAxes[i]->setDetectorThreshold(spikes.detectorThresholds[i]);
+        wAxes[i]->updateSpikeData(spikes);
+    }
 
     for (int i = 0; i < nProjAx; i++)
-        pAxes[i]->updateSpikeData(s);
-    // }
-
-    //     if (aboveThreshold && isRecording)
-    //     {
-    //         // write spike to disk
-    //       writeSpike(s);
-    //     }
+        pAxes[i]->updateSpikeData(spikes);
 
 }
 
@@ -867,8 +853,9 @@ WaveAxes::WaveAxes(int channel) : GenericAxes(channel),
     drawGrid(true),
     displayThresholdLevel(0.0f),
     detectorThresholdLevel(0.0f),
-    spikesReceivedSinceLastRedraw(0),
+    numSamples(0),
     spikeIndex(0),
+    numStored(0),
     bufferSize(5),
     range(250.0f),
     isOverThresholdSlider(false),
@@ -883,11 +870,6 @@ WaveAxes::WaveAxes(int channel) : GenericAxes(channel),
     thresholdColour = Colours::red;
 
     font = Font("Small Text",10,Font::plain);
-
-    for (int n = 0; n < bufferSize; n++)
-    {
-        spikeBuffer.add(nullptr);
-    }
 }
 
 void WaveAxes::setRange(float r)
@@ -922,80 +904,42 @@ void WaveAxes::paint(Graphics& g)
         return;
     }
 
+    // collect the waveforms into one path per colour so each takes a single stroke
+    Path olderSpikes, newestSpike;
 
-    for (int spikeNum = 0; spikeNum < bufferSize; spikeNum++)
+    for (int n = 0; n < numStored; n++)
     {
+        const int spikeNum = (spikeIndex + bufferSize - n) % bufferSize;
 
-        if (spikeNum != spikeIndex)
-        {
-            g.setColour(Colours::grey);
-            plotSpike(spikeBuffer[spikeNum], g);
-        }
-
+        addSpikeToPath(&spikeBuffer[spikeNum * numSamples], n == 0 ? newestSpike : olderSpikes);
     }
 
-    
-    plotSpike(spikeBuffer[spikeIndex], g);
-
+    g.setColour(Colours::grey);
+    g.strokePath(olderSpikes, PathStrokeType(1.0f));
 
-    spikesReceivedSinceLastRedraw = 0;
+    g.setColour(Colours::white);
+    g.strokePath(newestSpike, PathStrokeType(1.0f));
 
 }
 
-void WaveAxes::plotSpike(const SpikeEvent* s, Graphics& g)
+void WaveAxes::addSpikeToPath(const float* data, Path& path)
 {
-	if (!s) return;
-
     float h = getHeight();
 
     //compute the spatial width for each waveform sample
-	int nSamples = s->getChannelInfo()->getTotalSamples();
-	float dx = getWidth() / float(nSamples);
+	float dx = getWidth() / float(numSamples);
 
     //TODO: check for special metadata for this
 	//if (s.sortedId > 0)
     //   g.setColour(Colour(s.color[0],s.color[1],s.color[2]));
-    //else
-       g.setColour(Colours::white);
 
-    // type corresponds to channel so we need to calculate the starting
-    // sample based upon which channel is getting plotted
-    int sampIdx = nSamples*type; //spikeBuffer[0].nSamples * type; //
+    const float sign = spikesInverted ? 1.0f : -1.0f;
 
-    int dSamples = 1;
+    path.startNewSubPath(0.0f, h / 2 + sign * data[0] / range * h);
 
-    float x = 0.0f;
-	const float* data = s->getDataPointer();
-
-	for (int i = 0; i < nSamples - 1; i++)
+	for (int i = 1; i < numSamples; i++)
 	{
-		//std::cout << s.data[sampIdx] << std::endl;
-
-
-
-		float s1, s2;
-
-		if (spikesInverted)
-		{
-			s1 = h / 2 + data[sampIdx] / range * h;
-			s2 = h / 2 + data[sampIdx + 1] / range * h;
-		}
-		else
-		{
-			s1 = h / 2 - data[sampIdx] / range * h;
-			s2 = h / 2 - data[sampIdx + 1] / range * h;
-
-		}
-		g.drawLine(x,
-			s1,
-			x + dx,
-			s2);
-
-
-
-
-		sampIdx += dSamples;
-		x += dx;
+		path.lineTo(i * dx, h / 2 + sign * data[i] / range * h);
 	}
 
 }
@@ -1044,62 +988,46 @@ void WaveAxes::drawWaveformGrid(Graphics& g)
 
 }
 
-bool WaveAxes::updateSpikeData(const SpikeEvent* s)
+bool WaveAxes::updateSpikeData(const SpikeDisplayNode::SpikeBatch& spikes)
 {
     if (!gotFirstSpike)
     {
         gotFirstSpike = true;
     }
 
-    if (spikesReceivedSinceLastRedraw < bufferSize)
+    if (spikes.numSamples != numSamples)
     {
+        numSamples = spikes.numSamples;
+        spikeBuffer.assign(bufferSize * numSamples, 0.0f);
+        spikeIndex = 0;
+        numStored = 0;
+    }
 
-        SpikeEvent* newSpike = new SpikeEvent(*s);
+    // only the newest bufferSize spikes can ever be drawn
+    const int numSpikes = spikes.getNumStored();
+
+    for (int n = jmax(0, numSpikes - bufferSize); n < numSpikes; n++)
+    {
+        // type corresponds to channel, so only that part of the waveform is kept
+        const float* data = spikes.getWaveform(n) + numSamples * type;
 
         spikeIndex++;
         spikeIndex %= bufferSize;
 
-        spikeBuffer.set(spikeIndex, newSpike);
-
-        spikesReceivedSinceLastRedraw++;
+        std::copy(data, data + numSamples, spikeBuffer.begin() + spikeIndex * numSamples);
 
+        numStored = jmin(numStored + 1, bufferSize);
     }
 
     return true;
 
 }
 
-bool WaveAxes::checkThreshold(const SpikeEvent* s)
-{
-	int nSamples = s->getChannelInfo()->getTotalSamples();
-    int sampIdx = nSamples*type;
-	const float* data = s->getDataPointer();
-
-    for (int i = 0; i < nSamples-1; i++)
-    {
-
-        if (data[sampIdx] > displayThresholdLevel)
-        {
-            return true;
-        }
-
-        sampIdx++;
-    }
-
-    return false;
-
-}
-
 void WaveAxes::clear()
 {
 
-    spikeBuffer.clear();
     spikeIndex = 0;
-
-    for (int n = 0; n < bufferSize; n++)
-    {
-        spikeBuffer.add(nullptr);
-    }
+    numStored = 0;
 
     repaint();
 }
@@ -1269,35 +1197,40 @@ void ProjectionAxes::paint(Graphics& g)
                 0, imageDim-rangeY, rangeX, rangeY);
 }
 
-bool ProjectionAxes::updateSpikeData(const SpikeEvent* s)
+bool ProjectionAxes::updateSpikeData(const SpikeDisplayNode::SpikeBatch& spikes)
 {
     if (!gotFirstSpike)
     {
         gotFirstSpike = true;
     }
 
-    int idx1, idx2;
-    calcWaveformPeakIdx(s, ampDim1, ampDim2, &idx1, &idx2);
+    // one graphics context for the whole batch
+    Graphics g(projectionImage);
+
+    for (int n = 0; n < spikes.getNumStored(); n++)
+    {
+        const float* data = spikes.getWaveform(n);
+
+        int idx1, idx2;
+        calcWaveformPeakIdx(data, spikes.numSamples, ampDim1, ampDim2, &idx1, &idx2);
 
-    // add peaks to image
-    Colour col;
+        // add peaks to image
+        Colour col;
 
-	//Again, fix this adding proper metadata check
-    //if (s.sortedId > 0)
-    //    col = Colour(s.color[0], s.color[1], s.color[2]);
-    //else
-        col = Colours::white;
+	    //Again, fix this adding proper metadata check
+        //if (s.sortedId > 0)
+        //    col = Colour(s.color[0], s.color[1], s.color[2]);
+        //else
+            col = Colours::white;
 
-	const float* data = s->getDataPointer();
-    updateProjectionImage(data[idx1], data[idx2], 1, col);
+        updateProjectionImage(g, data[idx1], data[idx2], 1, col);
+    }
 
     return true;
 }
 
-void ProjectionAxes::updateProjectionImage(float x, float y, float gain, Colour col)
+void ProjectionAxes::updateProjectionImage(Graphics& g, float x, float y, float gain, Colour col)
 {
-    Graphics g(projectionImage);
-
     // h/2 + float(s.data[sampIdx]-32768)/float(*s.gain)*1000.0f / range * h;
 
     if (gain != 0)
@@ -1311,13 +1244,13 @@ void ProjectionAxes::updateProjectionImage(float x, float y, float gain, Colour
 
 }
 
-void ProjectionAxes::calcWaveformPeakIdx(const SpikeEvent* s, int d1, int d2, int* idx1, int* idx2)
+void ProjectionAxes::calcWaveformPeakIdx(const float* data, int nSamples, int d1, int d2, int* idx1, int* idx2)
 {
 
     float max1 = -1*pow(2.0,15);
     float max2 = max1;
-	int nSamples = s->getChannelInfo()->getTotalSamples();
-	const float* data = s->getDataPointer();
+    *idx1 = d1*nSamples;
+    *idx2 = d2*nSamples;
 
     for (int i = 0; i < nSamples; i++)
     {
@@ -1408,7 +1341,7 @@ GenericAxes::~GenericAxes()
 
 }
 
-bool GenericAxes::updateSpikeData(const SpikeEvent* newSpike)
+bool GenericAxes::updateSpikeData(const SpikeDisplayNode::SpikeBatch& spikes)
 {
     if (!gotFirstSpike)
     {
@@ -141,7 +141,7 @@ public:
 
     void mouseDown(const MouseEvent& event);
 
-    void plotSpike(const SpikeEvent* spike, int electrodeNum);
+    void plotSpikes(const SpikeDisplayNode::SpikeBatch& spikes, int electrodeNum);
 
     void invertSpikes(bool);
 
@@ -204,7 +204,7 @@ public:
     void select();
     void deselect();
 
-    void processSpikeObject(const SpikeEvent* s);
+    void processSpikeBatch(const SpikeDisplayNode::SpikeBatch& spikes);
 
     SpikeDisplayCanvas* canvas;
 
@@ -280,7 +280,7 @@ public:
 
     virtual ~GenericAxes();
 
-    virtual bool updateSpikeData(const SpikeEvent* s);
+    virtual bool updateSpikeData(const SpikeDisplayNode::SpikeBatch& spikes);
 
     void setXLims(double xmin, double xmax);
     void getXLims(double* xmin, double* xmax);
@@ -324,13 +324,10 @@ public:
     WaveAxes(int channel);
     ~WaveAxes() {}
 
-    bool updateSpikeData(const SpikeEvent* s);
-    bool checkThreshold(const SpikeEvent* spike);
+    bool updateSpikeData(const SpikeDisplayNode::SpikeBatch& spikes);
 
     void paint(Graphics& g);
 
-    void plotSpike(const SpikeEvent* s, Graphics& g);
-
     void clear();
 
     void mouseMove(const MouseEvent& event);
@@ -374,13 +371,15 @@ private:
 
     void drawThresholdSlider(Graphics& g);
 
-    int spikesReceivedSinceLastRedraw;
+    void addSpikeToPath(const float* data, Path& path);
 
     Font font;
 
-   OwnedArray<SpikeEvent> spikeBuffer;
+    std::vector<float> spikeBuffer; // bufferSize waveforms of this axis' channel
+    int numSamples;
 
-    int spikeIndex;
+    int spikeIndex; // slot of the newest waveform
+    int numStored;
     int bufferSize;
 
     float range;
@@ -411,7 +410,7 @@ public:
     ProjectionAxes(int projectionNum);
     ~ProjectionAxes() {}
 
-    bool updateSpikeData(const SpikeEvent* s);
+    bool updateSpikeData(const SpikeDisplayNode::SpikeBatch& spikes);
 
     void paint(Graphics& g);
 
@@ -423,9 +422,9 @@ public:
 
 private:
 
-    void updateProjectionImage(float, float, float, Colour);
+    void updateProjectionImage(Graphics&, float, float, float, Colour);
 
-    void calcWaveformPeakIdx(const SpikeEvent*, int, int, int*, int*);
+    void calcWaveformPeakIdx(const float*, int, int, int, int*, int*);
 
     int ampDim1, ampDim2;
 
@@ -22,6 +22,7 @@
 */
 
 #include "SpikeDisplayEditor.h"
+#include "SpikeDisplayCanvas.h"
 
 #include <string>
 
@@ -27,7 +27,6 @@
 #include <VisualizerEditorHeaders.h>
 #include <RecordingLib.h>
 #include "SpikeDisplayNode.h"
-#include "SpikeDisplayCanvas.h"
 
 
 #define MAX_N_SUB_CHAN 8
@@ -29,8 +29,7 @@
 
 SpikeDisplayNode::SpikeDisplayNode()
     : GenericProcessor  ("Spike Viewer")
-    , displayBufferSize (5)
-    ,  redrawRequested  (false)
+    , displayBufferSize (256)
     , isRecording       (false)
 {
     setProcessorType (PROCESSOR_TYPE_SINK);
@@ -59,17 +58,30 @@ void SpikeDisplayNode::updateSettings()
 
 		Electrode* elec = new Electrode();
 		elec->numChannels = spikeChannelArray[i]->getNumChannels();
+		elec->numSamples = spikeChannelArray[i]->getTotalSamples();
 		elec->bitVolts = spikeChannelArray[i]->getChannelBitVolts(0); //lets assume all channels have the same bitvolts
 		elec->name = spikeChannelArray[i]->getName();
-		elec->currentSpikeIndex = 0;
-		elec->mostRecentSpikes.ensureStorageAllocated(displayBufferSize);
 
+		elec->displayThresholds = std::vector<std::atomic<float>>(elec->numChannels);
 		for (int j = 0; j < elec->numChannels; ++j)
+			elec->displayThresholds[j] = 0;
+
+		// all waveform storage is allocated here, the audio thread only copies into it
+		for (int b = 0; b < 3; ++b)
 		{
-			elec->displayThresholds.add(0);
-			elec->detectorThresholds.add(0);
+			SpikeBatch& batch = elec->batches[b];
+			batch.capacity = displayBufferSize;
+			batch.numChannels = elec->numChannels;
+			batch.numSamples = elec->numSamples;
+			batch.numSpikes = 0;
+			batch.waveforms.assign(displayBufferSize * elec->numChannels * elec->numSamples, 0.0f);
+			batch.detectorThresholds.assign(elec->numChannels, 0.0f);
 		}
 
+		elec->backBatch = 0;
+		elec->frontBatch = 1;
+		elec->middleBatch = 2;
+
 		electrodes.add(elec);
 
 	}
@@ -130,20 +142,61 @@ String SpikeDisplayNode::getNameForElectrode (int i) const
 }
 
 
-void SpikeDisplayNode::addSpikePlotForElectrode (SpikePlot* sp, int i)
+int SpikeDisplayNode::SpikeBatch::getNumStored() const
 {
-    Electrode* e = electrodes[i];
-    e->spikePlot = sp;
+    return jmin (numSpikes, capacity);
 }
 
 
-void SpikeDisplayNode::removeSpikePlots()
+const float* SpikeDisplayNode::SpikeBatch::getWaveform (int i) const
 {
-    for (int i = 0; i < getNumElectrodes(); ++i)
-    {
-        Electrode* e = electrodes[i];
-        e->spikePlot = nullptr;
-    }
+    // once the batch has wrapped, the oldest waveform sits in the next slot to be written
+    const int first = numSpikes > capacity ? numSpikes % capacity : 0;
+
+    return waveforms.data() + ((first + i) % capacity) * numChannels * numSamples;
+}
+
+
+const SpikeDisplayNode::SpikeBatch* SpikeDisplayNode::getLatestSpikes (int electrode)
+{
+    if (electrode < 0 || electrode >= electrodes.size())
+        return nullptr;
+
+    Electrode* e = electrodes[electrode];
+
+    if (! (e->middleBatch.load (std::memory_order_acquire) & newBatchFlag))
+        return nullptr;
+
+    e->frontBatch = e->middleBatch.exchange (e->frontBatch, std::memory_order_acq_rel) & ~newBatchFlag;
+
+    return &e->batches[e->frontBatch];
+}
+
+
+void SpikeDisplayNode::setDisplayThreshold (int electrode, int channel, float threshold)
+{
+    if (electrode < 0 || electrode >= electrodes.size())
+        return;
+
+    Electrode* e = electrodes[electrode];
+
+    if (channel >= 0 && channel < e->numChannels)
+        e->displayThresholds[channel].store (threshold, std::memory_order_relaxed);
+}
+
+
+void SpikeDisplayNode::publishSpikes (Electrode* e)
+{
+    if (e->batches[e->backBatch].numSpikes == 0)
+        return;
+
+    // only the canvas clears the flag, so if it is set the previous batch is still
+    // waiting and we keep filling ours (overwriting the oldest spikes if need be)
+    if (e->middleBatch.load (std::memory_order_acquire) & newBatchFlag)
+        return;
+
+    e->backBatch = e->middleBatch.exchange (e->backBatch | newBatchFlag, std::memory_order_acq_rel) & ~newBatchFlag;
+    e->batches[e->backBatch].numSpikes = 0;
 }
 
 
@@ -177,10 +230,6 @@ void SpikeDisplayNode::setParameter (int param, float val)
     {
         isRecording = true;
     }
-    else if (param == 2)   // redraw
-    {
-        redrawRequested = true;
-    }
 }
 
 
@@ -188,33 +237,8 @@ void SpikeDisplayNode::process (AudioSampleBuffer& buffer)
 {
     checkForEvents (true); // automatically calls 'handleEvent
 
-    if (redrawRequested)
-    {
-        // update incoming thresholds
-        for (int i = 0; i < getNumElectrodes(); ++i)
-        {
-            Electrode* e = electrodes[i];
-
-            // update thresholds
-            for (int j = 0; j < e->numChannels; ++j)
-            {
-                e->displayThresholds.set (j,
-                                         e->spikePlot->getDisplayThresholdForChannel (j));
-
-                e->spikePlot->setDetectorThresholdForChannel (j, e->detectorThresholds[j]);
-            }
-
-            // transfer buffered spikes to spike plot
-            for (int j = 0; j < e->currentSpikeIndex; ++j)
-            {
-                //std::cout << "Transferring spikes." << std::endl;
-                e->spikePlot->processSpikeObject (e->mostRecentSpikes[j]);
-                e->currentSpikeIndex = 0;
-            }
-        }
-
-        redrawRequested = false;
-    }
+    for (int i = 0; i < getNumElectrodes(); ++i)
+        publishSpikes (electrodes[i]);
 }
 
 
@@ -230,12 +254,14 @@ void SpikeDisplayNode::handleSpike(const SpikeChannel* spikeInfo, const MidiMess
 
 	bool aboveThreshold = false;
 
+	SpikeBatch& batch = e->batches[e->backBatch];
+
 	// update threshold / check threshold
 	for (int i = 0; i < e->numChannels; ++i)
 	{
-		e->detectorThresholds.set(i, float(newSpike->getThreshold(i))); // / float(newSpike.gain[i]));
+		batch.detectorThresholds[i] = float(newSpike->getThreshold(i)); // / float(newSpike.gain[i]));
 
-		aboveThreshold = aboveThreshold | checkThreshold(i, e->displayThresholds[i], newSpike);
+		aboveThreshold = aboveThreshold | checkThreshold(i, e->displayThresholds[i].load(std::memory_order_relaxed), newSpike);
 	}
 
 	if (aboveThreshold)
@@ -245,13 +271,12 @@ void SpikeDisplayNode::handleSpike(const SpikeChannel* spikeInfo, const MidiMess
 		{
 			//CoreServices::RecordNode::writeSpike(newSpike, spikeInfo);
 		}
-		// add to buffer
-		if (e->currentSpikeIndex < displayBufferSize)
-		{
-			//This releases the spike from the smart pointer to avoid copies, so it's done latest.
-			e->mostRecentSpikes.set(e->currentSpikeIndex, newSpike.release());
-			e->currentSpikeIndex++;
-		}
+		// add to batch, overwriting the oldest waveform if the canvas has fallen behind
+		const int waveformSize = e->numChannels * e->numSamples;
+		float* dest = batch.waveforms.data() + (batch.numSpikes % batch.capacity) * waveformSize;
+
+		FloatVectorOperations::copy(dest, newSpike->getDataPointer(), waveformSize);
+		batch.numSpikes++;
 
 		
 	}
@@ -27,13 +27,21 @@
 #include <ProcessorHeaders.h>
 #include "SpikeDisplayEditor.h"
 
+#include <vector>
+#include <atomic>
+
 class DataViewport;
 class SpikePlot;
 
 
 /**
   Takes in MidiEvents and extracts SpikeObjects from the MidiEvent buffers.
-  Those Events are then held in a queue until they are pulled by the SpikeDisplayCanvas.
+
+  The waveforms of spikes above the display threshold are copied into a
+  preallocated batch for their electrode. Each electrode owns three batches
+  which are handed between the audio thread and the SpikeDisplayCanvas through
+  a lock-free triple buffer, so the audio thread never touches the plots and
+  the canvas pulls whole batches on the message thread.
 
   @see GenericProcessor, SpikeDisplayEditor, SpikeDisplayCanvas
 */
@@ -63,8 +71,33 @@ public:
     int getNumberOfChannelsForElectrode (int i) const;
     int getNumElectrodes() const;
 
-    void addSpikePlotForElectrode (SpikePlot* sp, int i);
-    void removeSpikePlots();
+    /** Fixed-capacity block of spike waveforms for one electrode. When more
+        spikes arrive than fit, the oldest ones are overwritten. */
+    struct SpikeBatch
+    {
+        int capacity;
+        int numChannels;
+        int numSamples;
+        int numSpikes; // spikes written since the batch was last handed over, may exceed capacity
+
+        std::vector<float> waveforms; // capacity spikes of numChannels x numSamples, channel-major
+        std::vector<float> detectorThresholds; // as seen with the newest spike
+
+        /** Number of waveforms held, at most capacity */
+        int getNumStored() const;
+
+        /** Waveform i of getNumStored(), oldest first */
+        const float* getWaveform (int i) const;
+    };
+
+    /** Returns the spikes gathered since the last call for an electrode, or
+        nullptr if there are none. Message thread only; the batch stays valid
+        until the next call for the same electrode. */
+    const SpikeBatch* getLatestSpikes (int electrode);
+
+    /** Sets the threshold a spike must cross on one of the electrode's channels
+        to be displayed. Safe to call while acquisition is running. */
+    void setDisplayThreshold (int electrode, int channel, float threshold);
 
     bool checkThreshold (int, float, SpikeEvent*);
 
@@ -75,23 +108,27 @@ private:
         String name;
 
         int numChannels;
+        int numSamples;
         int recordIndex;
-        int currentSpikeIndex;
 
-        Array<float> displayThresholds;
-        Array<float> detectorThresholds;
+        std::vector<std::atomic<float>> displayThresholds; // written by the canvas
 
-        OwnedArray<SpikeEvent> mostRecentSpikes;
+        SpikeBatch batches[3];
+        int backBatch;      // filled by the audio thread
+        int frontBatch;     // read by the message thread
+        std::atomic<int> middleBatch; // index of the batch in transit, plus newBatchFlag
 
 		float bitVolts;
-
-        SpikePlot* spikePlot;
     };
 
+    static const int newBatchFlag = 4;
+
+    /** Hands the audio thread's batch over if the canvas has taken the previous one */
+    void publishSpikes (Electrode* e);
+
     OwnedArray<Electrode> electrodes;
 
-    int displayBufferSize;
-    bool redrawRequested;
+    int displayBufferSize; // spikes per batch
 
     // members for recording
     bool isRecording;
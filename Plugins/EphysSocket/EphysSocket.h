@@ -5,19 +5,13 @@
 
 namespace EphysSocketNode
 {
-    class EphysSocket : public DataThread, public Timer
+    class EphysSocket : public NetworkDataThread
     {
 
     public:
         EphysSocket(SourceNode* sn);
         ~EphysSocket();
 
-        // Interface fulfillment
-        bool foundInputSource() override;
-        int getNumDataOutputs(DataChannel::DataChannelTypes type, int subProcessor) const override;
-        int getNumTTLOutputs(int subprocessor) const override;
-        float getSampleRate(int subprocessor) const override;
-        float getBitVolts(const DataChannel* chan) const override;
         int getNumChannels() const;
 
         // User defined
@@ -37,18 +31,6 @@ namespace EphysSocketNode
 
     private:
 
-        bool updateBuffer() override;
-        bool startAcquisition() override;
-        bool stopAcquisition()  override;
-        void timerCallback() override;
-
-        bool connected = false;
-
-       ScopedPointer<DatagramSocket> socket;
-
-        uint16_t *recvbuf;
-        float *convbuf;
-
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EphysSocket);
     };
 }
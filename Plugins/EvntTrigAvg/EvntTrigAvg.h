@@ -26,8 +26,10 @@
 
 #include <ProcessorHeaders.h>
 #include "EvntTrigAvgEditor.h"
+#include "PeriEventHistogram.h"
 #include <vector>
 #include <map>
+#include <atomic>
 
 class EvntTrigAvgEditor;
 
@@ -76,20 +78,10 @@ public:
     uint64 getWindowSize();
     uint64 getBinSize();
     std::vector<String> getElectrodeLabels();
-    CriticalSection* getMutex() { return &mut; }
-    //get pointers to shared data
-    Array<uint64 *> getHistoData();
-    Array<float *> getMinMaxMean();
-
-    //create histogram data
-    uint64* createHistogramData(std::vector<uint64> spikeData, std::vector<uint64> ttlData); // shared data
-    uint64 binDataPoint(uint64 startBin, uint64 endBin, uint64 binSize, uint64 dataPoint); // shared data
-    void processSpikeData(std::vector<std::vector<std::vector<uint64>>> spikeData,std::vector<uint64> ttlData);
-    uint64* binCount(std::vector<uint64> binData, uint64 numberOfBins); // shared data
-    bool shouldReadHistoData();
-    float findMin(uint64* data_);
-    float findMax(uint64* data_);
-    float findMean(uint64* data_); // TODO make running
+
+    /** Returns the latest histograms without locking (message thread only). The
+        snapshot stays valid until the next call. */
+    const PeriEventHistogram::Snapshot& getHistogramSnapshot();
     
     //TODO electrodeMap is not being used right now, fix it to actually work with SourceInfo instead of just indexes
     //std::map<SourceChannelInfo,int> createElectrodeMap();
@@ -98,33 +90,20 @@ public:
     void saveCustomParametersToXml (XmlElement* parentElement) override;
     void loadCustomParametersFromXml() override;
 private:
-    CriticalSection mut;
-    void initializeHistogramArray();
-    void initializeMinMaxMean();
-    void clearHistogramArray();
-    void clearMinMaxMean();
-    void addNewSortedIdHistoData(int electrode, int sortedId);
-    void addNewSortedIdMinMaxMean(int electrode,int sortedID);
+    /** Clears the histograms now if acquisition is stopped, otherwise at the start of the next block */
+    void requestReset();
+
     std::atomic<int> triggerEvent;
     std::atomic<int> triggerChannel;
-
-    uint64 bins[1000]; // workspace for bin counting
+    std::atomic<bool> resetRequested;
 
     int numChannels = 0;
-    bool recalc = false;
-    int lastTTLCalculated = 0;
     uint64 windowSize;
     uint64 binSize;
     
-    std::vector<uint64> ttlTimestampBuffer;
-    std::vector<std::vector<std::vector<uint64>>> spikeData;// channel.sortedID.spikeInstance.timestamp
-    void clearHistogramData(uint64 * const);
-    Array<uint64*> histogramData; // shared data
-    Array<float*> minMaxMean; // shared data
+    PeriEventHistogram histogram; // spike/trigger history and running counts, bounded in size
     //std::map<SourceChannelInfo,int> electrodeMap; // Used to identify what electrode a spike came from
     std::vector<String> electrodeLabels;
-    std::vector<int> idIndex; //sorted ID, electrode. used to match a sortedID with its electrode
-    std::vector<std::vector<int>> electrodeSortedId; 
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EvntTrigAvg);
 
@@ -150,8 +150,6 @@ bool EvntTrigAvgCanvas::keyPressed(const KeyPress& key)
 void EvntTrigAvgCanvas::buttonClicked(Button* button)
 {
     if (button == clearHisto){
-        histoData.clear();
-        minMaxMean.clear();
         processor->setParameter(4,0);
     }
      repaint();
@@ -218,11 +216,9 @@ void EvntTrigAvgDisplay::resized()
 
 void EvntTrigAvgDisplay::paint(Graphics &g)
 {
-
-    histoData.clear();
-    histoData = processor->getHistoData();
-    minMaxMean.clear();
-    minMaxMean = processor->getMinMaxMean();
+    // the snapshot stays untouched by the processor until the next call, so the
+    // graphs built below can keep pointing into it
+    const PeriEventHistogram::Snapshot& snapshot = processor->getHistogramSnapshot();
     int width=getWidth();
     g.setColour(Colours::snow);
     std::vector<String> labels = processor->getElectrodeLabels();
@@ -230,14 +226,15 @@ void EvntTrigAvgDisplay::paint(Graphics &g)
     graphs.clear();
     int graphCount = 0;
     
-    for (int i = 0 ; i < histoData.size() ; i++){
+    for (int i = 0 ; i < snapshot.getNumUnits() ; i++){
         GraphUnit* graph;
-        ScopedLock myScopedLock(*processor->getMutex());
-        if(histoData[i][1]==0){ // if sortedId == 0
-                graph = new GraphUnit(processor,canvas,channelColours[(histoData[i][0])%16],labels[histoData[i][0]],&minMaxMean[i][2],&histoData[i][2]); // pass &histoData[i][2] instead of 3 to pass on how many bins are used
+        const uint64* histoData = snapshot.getHistogram(i);
+        const float* minMaxMean = snapshot.getStats(i);
+        if(histoData[1]==0){ // if sortedId == 0
+                graph = new GraphUnit(processor,canvas,channelColours[(histoData[0])%16],labels[histoData[0]],&minMaxMean[2],&histoData[2]); // pass &histoData[2] instead of 3 to pass on how many bins are used
         }
             else{
-                graph = new GraphUnit(processor,canvas,channelColours[(histoData[i][0])%16],"ID "+String(histoData[i][1]),&minMaxMean[i][2],&histoData[i][2]);
+                graph = new GraphUnit(processor,canvas,channelColours[(histoData[0])%16],"ID "+String(histoData[1]),&minMaxMean[2],&histoData[2]);
             }
             graphs.push_back(graph);
             graph->setBounds(0, 40*(graphCount), width-20, 40);
@@ -327,8 +324,7 @@ void inline Timescale::setBinSize(int binSize_)
 //--------------------------------------------------------------------
 
 
-GraphUnit::GraphUnit(EvntTrigAvg* processor_, EvntTrigAvgCanvas* canvas_,juce::Colour color_, String name_, float  * stats_,uint64 * data_){
-    ScopedLock myScopedLock(*processor_->getMutex());
+GraphUnit::GraphUnit(EvntTrigAvg* processor_, EvntTrigAvgCanvas* canvas_,juce::Colour color_, String name_, const float* stats_, const uint64* data_){
     color = color_;
     LD = new LabelDisplay(color_,name_);
     LD->setBounds(0,0,30,40);
@@ -379,7 +375,7 @@ void LabelDisplay::resized()
 
 //----------------
 
-HistoGraph::HistoGraph(EvntTrigAvg* processor_,EvntTrigAvgCanvas* canvas_, juce::Colour color_, uint64 bins_, float max_, uint64 * histoData_)
+HistoGraph::HistoGraph(EvntTrigAvg* processor_,EvntTrigAvgCanvas* canvas_, juce::Colour color_, uint64 bins_, float max_, const uint64* histoData_)
 {
     color = color_;
     histoData = histoData_;
@@ -402,7 +398,6 @@ void HistoGraph::paint(Graphics& g)
     g.drawVerticalLine(getWidth()/2,5, getHeight());
     g.setColour(color);
     for (int i = 1 ; i < bins ; i++){
-        ScopedLock myScopedLock(*processor->getMutex());
         if(max!=0){
             g.drawLine(float(i-1)*float(getWidth())/float(bins),getHeight()-(histoData[i-1]*getHeight()/max),float(i)*float(getWidth())/float(bins),getHeight()-(histoData[i]*getHeight()/max));
         }
@@ -435,7 +430,6 @@ void HistoGraph::mouseMove(const MouseEvent &event)
 {
     if(bins>0){
         int posX = event.x;
-        ScopedLock myScopedLock(*processor->getMutex());
         int valueY = histoData[int(float(posX)/float(getWidth())*float(bins))];
         canvas->setData(valueY);
         canvas->setBin(int(float(posX)/float(getWidth())*float(bins))-(bins/2));
@@ -445,7 +439,7 @@ void HistoGraph::mouseMove(const MouseEvent &event)
 
 //----------------
 
-StatDisplay::StatDisplay(EvntTrigAvg* processor_, juce::Colour c, float * s)
+StatDisplay::StatDisplay(EvntTrigAvg* processor_, juce::Colour c, const float* s)
 {
     processor=processor_;
     color = c;
@@ -459,7 +453,6 @@ StatDisplay::~StatDisplay()
 
 void StatDisplay::paint(Graphics& g)
 {
-    ScopedLock myScopedLock(*processor->getMutex());
     g.setColour(color);
     g.drawText(String(stats[0]),0, 0, 60, 40, juce::Justification::right);
     g.drawText(String(stats[1]),60, 0, 60, 40, juce::Justification::right);
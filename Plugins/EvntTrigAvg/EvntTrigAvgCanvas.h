@@ -74,8 +74,6 @@ public:
 
 private:
 
-    Array<uint64*> histoData;
-    std::vector<std::vector<float>> minMaxMean;
     void removeUnitOrBox();
     ScopedPointer<Viewport> viewport;
     ScopedPointer<EvntTrigAvgDisplay> display;
@@ -117,8 +115,6 @@ private:
     Viewport* viewport;
     std::vector<GraphUnit*> graphs;
     juce::Colour channelColours[16];
-    Array<uint64 *> histoData;
-    Array<float *> minMaxMean;
     int border = 20;
 };
 
@@ -153,7 +149,7 @@ private:
 class GraphUnit : public Component
 {
 public:
-    GraphUnit(EvntTrigAvg* processor_,EvntTrigAvgCanvas* canvas_,juce::Colour color_, String name_, float * stats_, uint64 * data_);
+    GraphUnit(EvntTrigAvg* processor_,EvntTrigAvgCanvas* canvas_,juce::Colour color_, String name_, const float* stats_, const uint64* data_);
     ~GraphUnit();
     void paint(Graphics& g);
     void resized();
@@ -184,7 +180,7 @@ class HistoGraph : public Component
 {
     
 public:
-    HistoGraph(EvntTrigAvg* processor_,EvntTrigAvgCanvas* canvas_,juce::Colour color_, uint64 bins_, float max_, uint64 * histoData_);
+    HistoGraph(EvntTrigAvg* processor_,EvntTrigAvgCanvas* canvas_,juce::Colour color_, uint64 bins_, float max_, const uint64* histoData_);
     ~HistoGraph();
     
     void paint(Graphics& g);
@@ -212,7 +208,7 @@ private:
 class StatDisplay : public Component
 {
 public:
-    StatDisplay(EvntTrigAvg* display_, juce::Colour c, float * s);
+    StatDisplay(EvntTrigAvg* display_, juce::Colour c, const float* s);
     ~StatDisplay();
     void paint(Graphics& g);
     void resized();
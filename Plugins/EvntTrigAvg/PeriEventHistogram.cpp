@@ -0,0 +1,283 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "PeriEventHistogram.h"
+#include <algorithm>
+
+PeriEventHistogram::PeriEventHistogram()
+    : numElectrodes(0)
+    , numUnits(0)
+    , spikeCapacity(0)
+    , triggerCapacity(0)
+    , firstTrigger(0)
+    , numTriggers(0)
+    , windowSize(0)
+    , binSize(1)
+    , numBins(0)
+    , numTrials(0)
+    , backSnapshot(0)
+    , frontSnapshot(1)
+    , middleSnapshot(2)
+{
+}
+
+void PeriEventHistogram::prepare(int numElectrodes_, int maxSortedUnits, int spikeCapacity_, int triggerCapacity_)
+{
+    numElectrodes = numElectrodes_;
+    spikeCapacity = spikeCapacity_;
+    triggerCapacity = triggerCapacity_;
+
+    const int maxUnits = numElectrodes + maxSortedUnits;
+
+    units.resize(maxUnits);
+
+    for (auto& unit : units)
+    {
+        unit.spikes.assign(spikeCapacity, 0);
+        unit.counts.assign(maxBins, 0);
+    }
+
+    unitOrder.clear();
+    unitOrder.reserve(maxUnits);
+
+    triggers.assign(triggerCapacity, 0);
+
+    for (auto& snapshot : snapshots)
+    {
+        snapshot.histograms.assign(size_t(maxUnits) * (histogramHeaderSize + maxBins), 0);
+        snapshot.stats.assign(size_t(maxUnits) * statsSize, 0.0f);
+        snapshot.numUnits = 0;
+        snapshot.numTrials = 0;
+    }
+
+    backSnapshot = 0;
+    frontSnapshot = 1;
+    middleSnapshot = 2;
+
+    clear(windowSize, binSize);
+}
+
+void PeriEventHistogram::clear(int64 windowSize_, int64 binSize_)
+{
+    windowSize = windowSize_;
+    binSize = jmax(int64(1), binSize_);
+    numBins = int(jlimit(int64(0), int64(maxBins), windowSize / binSize));
+
+    firstTrigger = 0;
+    numTriggers = 0;
+    numTrials = 0;
+
+    // every electrode keeps its unsorted unit; sorted units are added again as they show up
+    numUnits = 0;
+    unitOrder.clear();
+
+    for (int electrode = 0; electrode < numElectrodes; electrode++)
+        getOrAddUnit(electrode, 0);
+
+    publish();
+}
+
+int PeriEventHistogram::getOrAddUnit(int electrode, int sortedId)
+{
+    for (int i = 0; i < numUnits; i++)
+    {
+        if (units[i].electrode == electrode && units[i].sortedId == sortedId)
+            return i;
+    }
+
+    if (numUnits >= (int) units.size())
+        return -1;
+
+    Unit& unit = units[numUnits];
+    unit.electrode = electrode;
+    unit.sortedId = sortedId;
+    unit.firstSpike = 0;
+    unit.numSpikes = 0;
+    std::fill(unit.counts.begin(), unit.counts.end(), 0);
+
+    // keep the display order grouped by electrode (capacity is reserved, so no allocation)
+    auto position = std::upper_bound(unitOrder.begin(), unitOrder.end(), numUnits,
+                                     [this] (int a, int b)
+                                     {
+                                         return units[a].electrode != units[b].electrode
+                                             ? units[a].electrode < units[b].electrode
+                                             : units[a].sortedId < units[b].sortedId;
+                                     });
+    unitOrder.insert(position, numUnits);
+
+    return numUnits++;
+}
+
+void PeriEventHistogram::addSpike(int unitIndex, int64 timestamp)
+{
+    if (unitIndex < 0 || unitIndex >= numUnits || spikeCapacity == 0)
+        return;
+
+    Unit& unit = units[unitIndex];
+
+    if (unit.numSpikes == spikeCapacity)
+    {
+        // ring is full: the oldest spike makes room
+        unit.firstSpike = (unit.firstSpike + 1) % spikeCapacity;
+        unit.numSpikes--;
+    }
+
+    unit.spikes[(unit.firstSpike + unit.numSpikes) % spikeCapacity] = timestamp;
+    unit.numSpikes++;
+}
+
+void PeriEventHistogram::addTrigger(int64 timestamp)
+{
+    if (triggerCapacity == 0)
+        return;
+
+    if (numTriggers == triggerCapacity)
+    {
+        // more triggers pending than we can hold: give up on the oldest one
+        firstTrigger = (firstTrigger + 1) % triggerCapacity;
+        numTriggers--;
+    }
+
+    triggers[(firstTrigger + numTriggers) % triggerCapacity] = timestamp;
+    numTriggers++;
+}
+
+void PeriEventHistogram::advance(int64 currentTimestamp)
+{
+    const int64 halfWindow = windowSize / 2;
+    bool changed = false;
+
+    while (numTriggers > 0 && currentTimestamp >= triggers[firstTrigger] + halfWindow)
+    {
+        closeTrigger(triggers[firstTrigger]);
+
+        firstTrigger = (firstTrigger + 1) % triggerCapacity;
+        numTriggers--;
+        changed = true;
+    }
+
+    // spikes older than the earliest window still to come are never needed again
+    int64 earliestNeeded = currentTimestamp - halfWindow;
+
+    if (numTriggers > 0)
+        earliestNeeded = jmin(earliestNeeded, triggers[firstTrigger] - halfWindow);
+
+    for (int i = 0; i < numUnits; i++)
+        discardSpikesBefore(units[i], earliestNeeded);
+
+    if (changed)
+        publish();
+}
+
+void PeriEventHistogram::closeTrigger(int64 triggerTime)
+{
+    const int64 halfWindow = windowSize / 2;
+    const int64 windowStart = triggerTime - halfWindow;
+    const int64 windowEnd = triggerTime + halfWindow;
+
+    if (numBins > 0)
+    {
+        for (int i = 0; i < numUnits; i++)
+        {
+            Unit& unit = units[i];
+
+            for (int s = 0; s < unit.numSpikes; s++)
+            {
+                const int64 t = unit.spikes[(unit.firstSpike + s) % spikeCapacity];
+
+                if (t < windowStart)
+                    continue;
+
+                if (t > windowEnd)
+                    break;
+
+                const int bin = int(jmin(int64(numBins - 1), (t - windowStart) / binSize));
+                unit.counts[bin]++;
+            }
+        }
+    }
+
+    numTrials++;
+}
+
+void PeriEventHistogram::discardSpikesBefore(Unit& unit, int64 timestamp)
+{
+    while (unit.numSpikes > 0 && unit.spikes[unit.firstSpike] < timestamp)
+    {
+        unit.firstSpike = (unit.firstSpike + 1) % spikeCapacity;
+        unit.numSpikes--;
+    }
+}
+
+void PeriEventHistogram::publish()
+{
+    if (units.empty())
+        return;
+
+    Snapshot& snapshot = snapshots[backSnapshot];
+
+    snapshot.numUnits = numUnits;
+    snapshot.numTrials = numTrials;
+
+    for (int i = 0; i < numUnits; i++)
+    {
+        const Unit& unit = units[unitOrder[i]];
+
+        uint64* histogram = snapshot.histograms.data() + i * (histogramHeaderSize + maxBins);
+        histogram[0] = uint64(unit.electrode);
+        histogram[1] = uint64(unit.sortedId);
+        histogram[2] = uint64(numBins);
+        std::copy(unit.counts.begin(), unit.counts.begin() + numBins, histogram + histogramHeaderSize);
+
+        float* stats = snapshot.stats.data() + i * statsSize;
+        stats[0] = float(unit.electrode);
+        stats[1] = float(unit.sortedId);
+
+        if (numBins > 0)
+        {
+            const auto minMax = std::minmax_element(unit.counts.begin(), unit.counts.begin() + numBins);
+
+            uint64 sum = 0;
+            for (int bin = 0; bin < numBins; bin++)
+                sum += unit.counts[bin];
+
+            stats[2] = float(*minMax.first);
+            stats[3] = float(*minMax.second);
+            stats[4] = float(sum) / float(numBins);
+        }
+        else
+        {
+            stats[2] = stats[3] = stats[4] = 0.0f;
+        }
+    }
+
+    backSnapshot = middleSnapshot.exchange(backSnapshot | newSnapshotFlag, std::memory_order_acq_rel) & ~newSnapshotFlag;
+}
+
+const PeriEventHistogram::Snapshot& PeriEventHistogram::acquireSnapshot()
+{
+    if (middleSnapshot.load(std::memory_order_relaxed) & newSnapshotFlag)
+        frontSnapshot = middleSnapshot.exchange(frontSnapshot, std::memory_order_acq_rel) & ~newSnapshotFlag;
+
+    return snapshots[frontSnapshot];
+}
@@ -0,0 +1,152 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __PERIEVENTHISTOGRAM_H__
+#define __PERIEVENTHISTOGRAM_H__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+#include <vector>
+#include <atomic>
+
+/**
+ Streaming peri-stimulus time histogram engine used by EvntTrigAvg.
+
+ Every unit keeps a fixed-size ring of its recent spike times, and pending
+ triggers are held in a fixed-size ring as well. When the window of a trigger
+ closes, the spikes inside it are binned once and added to the running counts,
+ after which the trigger is dropped. Memory and per-block cost therefore stay
+ constant however long the session runs.
+
+ All storage is allocated by prepare() on the message thread; the audio-thread
+ methods (clear, getOrAddUnit, addSpike, addTrigger, advance) never allocate.
+ Results are published to the canvas through a lock-free triple buffer.
+
+ @see EvntTrigAvg, EvntTrigAvgCanvas
+ */
+class PeriEventHistogram
+{
+public:
+    /** Maximum number of bins per histogram, matching the canvas layout */
+    static const int maxBins = 1000;
+
+    /** Per-unit header entries preceding the bin counts in a snapshot histogram:
+        electrode, sorted ID, number of bins used */
+    static const int histogramHeaderSize = 3;
+
+    /** Per-unit stat entries in a snapshot: electrode, sorted ID, min, max, mean */
+    static const int statsSize = 5;
+
+    /** A consistent copy of all histograms, owned by the reader until its next acquire */
+    class Snapshot
+    {
+    public:
+        int getNumUnits() const { return numUnits; }
+        int getNumTrials() const { return numTrials; }
+
+        /** Returns [electrode, sortedId, numBins, bin counts...] for one unit */
+        const uint64* getHistogram(int unit) const { return histograms.data() + unit * (histogramHeaderSize + maxBins); }
+
+        /** Returns [electrode, sortedId, min, max, mean] for one unit */
+        const float* getStats(int unit) const { return stats.data() + unit * statsSize; }
+
+    private:
+        friend class PeriEventHistogram;
+
+        int numUnits = 0;
+        int numTrials = 0;
+        std::vector<uint64> histograms;
+        std::vector<float> stats;
+    };
+
+    PeriEventHistogram();
+
+    /** Allocates storage for the given number of electrodes, each of which gets
+        an unsorted unit (sorted ID 0), plus room for extra sorted units.
+        Must not be called while acquisition is running. */
+    void prepare(int numElectrodes, int maxSortedUnits = 128,
+                 int spikeCapacity = 4096, int triggerCapacity = 1024);
+
+    /** Sets the window and bin sizes (in samples) and discards all counts,
+        pending triggers and sorted units. Does not allocate. */
+    void clear(int64 windowSize, int64 binSize);
+
+    /** Returns the unit index for an electrode/sorted ID pair, creating it if
+        needed. Returns -1 if the unit pool is exhausted. */
+    int getOrAddUnit(int electrode, int sortedId);
+
+    void addSpike(int unit, int64 timestamp);
+
+    void addTrigger(int64 timestamp);
+
+    /** Closes every pending trigger whose window ends before currentTimestamp,
+        bins its spikes and publishes a new snapshot if anything changed. */
+    void advance(int64 currentTimestamp);
+
+    /** Number of triggers whose window has been binned since the last clear */
+    int getNumTrials() const { return numTrials.load(std::memory_order_relaxed); }
+
+    /** Returns the most recent published snapshot (message thread only). The
+        reference stays valid until the next call. */
+    const Snapshot& acquireSnapshot();
+
+private:
+    struct Unit
+    {
+        int electrode;
+        int sortedId;
+        std::vector<int64> spikes;  // ring of recent spike timestamps, in arrival order
+        int firstSpike;
+        int numSpikes;
+        std::vector<uint64> counts;
+    };
+
+    void closeTrigger(int64 triggerTime);
+    void discardSpikesBefore(Unit& unit, int64 timestamp);
+    void publish();
+
+    std::vector<Unit> units;
+    std::vector<int> unitOrder;     // unit indices sorted by electrode, then sorted ID
+    int numElectrodes;
+    int numUnits;
+    int spikeCapacity;
+
+    std::vector<int64> triggers;    // ring of pending trigger timestamps
+    int triggerCapacity;
+    int firstTrigger;
+    int numTriggers;
+
+    int64 windowSize;
+    int64 binSize;
+    int numBins;
+    std::atomic<int> numTrials;
+
+    Snapshot snapshots[3];
+    int backSnapshot;
+    int frontSnapshot;
+    std::atomic<int> middleSnapshot; // index of the middle buffer, plus newSnapshotFlag
+    static const int newSnapshotFlag = 4;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PeriEventHistogram);
+};
+
+#endif  // __PERIEVENTHISTOGRAM_H__
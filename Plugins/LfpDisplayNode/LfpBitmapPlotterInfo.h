@@ -47,7 +47,7 @@ struct LfpBitmapPlotterInfo
     int height;
     int width;
     float channelHeightFloat;
-    std::array<float, MAX_N_SAMP_PER_PIXEL> samplesPerPixel;
+    std::array<float, MAX_N_SAMP_PER_PIXEL> samplesPerPixel; // raw samples, or the pyramid's min/max envelope for long timebases
     int sampleCountPerPixel;
     float range;
     int samplerange;
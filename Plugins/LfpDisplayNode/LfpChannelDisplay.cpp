@@ -117,6 +117,13 @@ void LfpChannelDisplay::pxPaint()
     
     Image::BitmapData bdLfpChannelBitmap(display->lfpChannelBitmap, 0,0, display->lfpChannelBitmap.getWidth(), display->lfpChannelBitmap.getHeight());
     
+    pxPaint(bdLfpChannelBitmap);
+}
+
+void LfpChannelDisplay::pxPaint(Image::BitmapData& bdLfpChannelBitmap)
+{
+    if (!isEnabled) return; // return early if THIS display is not enabled
+    
     int center = getHeight()/2;
     
     // max and min of channel in absolute px coords for event displays etc - actual data might be drawn outside of this range
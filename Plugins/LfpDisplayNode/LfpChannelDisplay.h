@@ -49,6 +49,10 @@ public:
     void pxPaint(); // like paint, but just populate lfpChannelBitmap
                     // needs to avoid a paint(Graphics& g) mechanism here becauswe we need to clear the screen in the lfpDisplay repaint(),
                     // because otherwise we cant deal with the channel overlap (need to clear a vertical section first, _then_ all channels are dawn, so cant do it per channel)
+
+    /** Same as pxPaint(), but draws into bitmap data that was already opened on lfpChannelBitmap.
+        Only touches pixels, so it may be called from a render thread. */
+    void pxPaint(Image::BitmapData& bdLfpChannelBitmap);
                 
     void select();
     void deselect();
@@ -0,0 +1,190 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2013 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "LfpDecimationPyramid.h"
+
+#include <limits>
+
+using namespace LfpViewer;
+
+#pragma  mark - LfpDecimationPyramid -
+
+LfpDecimationPyramid::LfpDecimationPyramid()
+    : numSamples(0)
+{ }
+
+void LfpDecimationPyramid::reset(std::shared_ptr<AudioSampleBuffer> displayBuffer)
+{
+    buffer = displayBuffer;
+    numSamples = buffer != nullptr ? buffer->getNumSamples() : 0;
+
+    const int numChannels = buffer != nullptr ? buffer->getNumChannels() : 0;
+
+    numBins.clear();
+    levels.clear();
+    updatedTo.assign(numChannels, 0);
+
+    if (numSamples == 0 || numChannels == 0)
+        return;
+
+    int n = (numSamples + baseBinSize - 1) / baseBinSize;
+
+    while (true)
+    {
+        numBins.push_back(n);
+        levels.push_back(std::vector<Bin>(size_t(n) * numChannels, Bin { 0.0f, 0.0f, 0.0f }));
+
+        if (n == 1)
+            break;
+
+        n = (n + 1) / 2;
+    }
+}
+
+void LfpDecimationPyramid::update(int channel, int writeIndex)
+{
+    if (channel < 0 || channel >= (int) updatedTo.size())
+        return;
+
+    const int from = updatedTo[channel];
+
+    if (writeIndex == from)
+        return;
+
+    if (writeIndex > from)
+    {
+        updateRange(channel, from, writeIndex);
+    }
+    else // wrapped around the end of the ring
+    {
+        updateRange(channel, from, numSamples);
+
+        if (writeIndex > 0)
+            updateRange(channel, 0, writeIndex);
+    }
+
+    updatedTo[channel] = writeIndex;
+}
+
+void LfpDecimationPyramid::rebuild(int channel, int writeIndex)
+{
+    if (channel < 0 || channel >= (int) updatedTo.size())
+        return;
+
+    updateRange(channel, 0, numSamples);
+    updatedTo[channel] = writeIndex;
+}
+
+void LfpDecimationPyramid::updateRange(int channel, int start, int end)
+{
+    if (start >= end || numBins.empty())
+        return;
+
+    int lo = start / baseBinSize;
+    int hi = (end - 1) / baseBinSize;
+
+    Bin* base = levels[0].data() + size_t(channel) * numBins[0];
+
+    for (int b = lo; b <= hi; b++)
+        base[b] = computeRaw(channel, b * baseBinSize, jmin((b + 1) * baseBinSize, numSamples));
+
+    for (int level = 1; level < (int) numBins.size(); level++)
+    {
+        lo /= 2;
+        hi /= 2;
+
+        const int nChildren = numBins[level - 1];
+        const Bin* children = levels[level - 1].data() + size_t(channel) * nChildren;
+        Bin* parents = levels[level].data() + size_t(channel) * numBins[level];
+
+        for (int b = lo; b <= hi; b++)
+        {
+            parents[b] = children[2 * b];
+
+            if (2 * b + 1 < nChildren)
+                combine(parents[b], children[2 * b + 1]);
+        }
+    }
+}
+
+LfpDecimationPyramid::Bin LfpDecimationPyramid::query(int channel, int start, int end) const
+{
+    if (numBins.empty() || start >= end)
+        return Bin { 0.0f, 0.0f, 0.0f };
+
+    const int firstFull = (start + baseBinSize - 1) / baseBinSize;
+    const int lastFull = end == numSamples ? numBins[0] : end / baseBinSize; // exclusive
+
+    if (firstFull >= lastFull)
+        return computeRaw(channel, start, end);
+
+    Bin result { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), 0.0f };
+
+    // partial base bins at either edge come straight from the ring
+    if (start < firstFull * baseBinSize)
+        combine(result, computeRaw(channel, start, firstFull * baseBinSize));
+
+    if (lastFull < numBins[0] && lastFull * baseBinSize < end)
+        combine(result, computeRaw(channel, lastFull * baseBinSize, end));
+
+    // whole bins are covered bottom-up by the coarsest levels that fit
+    int lo = firstFull;
+    int hi = lastFull;
+
+    for (int level = 0; lo < hi; level++)
+    {
+        const Bin* bins = levels[level].data() + size_t(channel) * numBins[level];
+
+        if (lo & 1)
+            combine(result, bins[lo++]);
+
+        if (hi & 1)
+            combine(result, bins[--hi]);
+
+        lo /= 2;
+        hi /= 2;
+    }
+
+    return result;
+}
+
+LfpDecimationPyramid::Bin LfpDecimationPyramid::computeRaw(int channel, int start, int end) const
+{
+    const float* samples = buffer->getReadPointer(channel, start);
+    const int n = end - start;
+
+    const Range<float> minMax = FloatVectorOperations::findMinAndMax(samples, n);
+
+    float sum = 0;
+    for (int i = 0; i < n; i++)
+        sum += samples[i];
+
+    return Bin { minMax.getStart(), minMax.getEnd(), sum };
+}
+
+void LfpDecimationPyramid::combine(Bin& dest, const Bin& src)
+{
+    dest.min = jmin(dest.min, src.min);
+    dest.max = jmax(dest.max, src.max);
+    dest.sum += src.sum;
+}
@@ -0,0 +1,95 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef __LFPDECIMATIONPYRAMID_H__
+#define __LFPDECIMATIONPYRAMID_H__
+
+#include <VisualizerWindowHeaders.h>
+
+#include <vector>
+#include <memory>
+
+#include "LfpDisplayClasses.h"
+namespace LfpViewer {
+#pragma  mark - LfpDecimationPyramid -
+//==============================================================================
+/**
+    Multi-resolution min/max/mean summary of the LfpDisplayNode display buffer.
+
+    Level 0 holds one bin per baseBinSize samples of the ring; every level above
+    halves the number of bins. Bins are kept up to date incrementally as the
+    canvas observes new write indices, so only new samples are ever re-read.
+
+    A query over any sample range combines O(log n) bins plus at most two
+    partial base bins of raw samples, which makes building a screen buffer cost
+    O(pixels) regardless of the timebase.
+
+    @see LfpDisplayCanvas
+*/
+class LfpDecimationPyramid
+{
+public:
+    struct Bin
+    {
+        float min;
+        float max;
+        float sum;
+    };
+
+    LfpDecimationPyramid();
+
+    /** Resizes the pyramid to match the given display buffer and clears all bins */
+    void reset(std::shared_ptr<AudioSampleBuffer> displayBuffer);
+
+    /** Folds the samples written since the last call (up to writeIndex) into the pyramid */
+    void update(int channel, int writeIndex);
+
+    /** Recomputes every bin of a channel, e.g. after the canvas has been hidden */
+    void rebuild(int channel, int writeIndex);
+
+    /** Returns min, max and sum over the samples [start, end) of one channel. The
+        range must not wrap around the end of the ring. */
+    Bin query(int channel, int start, int end) const;
+
+    int getNumLevels() const { return (int) numBins.size(); }
+
+    static const int baseBinSize = 16;
+
+private:
+    void updateRange(int channel, int start, int end);
+
+    Bin computeRaw(int channel, int start, int end) const;
+
+    static void combine(Bin& dest, const Bin& src);
+
+    std::shared_ptr<AudioSampleBuffer> buffer;
+    int numSamples;
+
+    std::vector<int> numBins;                   // bins per channel at each level
+    std::vector<std::vector<Bin>> levels;       // [level][channel * numBins[level] + bin]
+    std::vector<int> updatedTo;                 // ring position folded in so far, per channel
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LfpDecimationPyramid);
+};
+
+}; // namespace
+#endif
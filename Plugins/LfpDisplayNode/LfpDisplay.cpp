@@ -41,9 +41,41 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "LfpGradientColourScheme.h"
 
 #include <math.h>
+#include <algorithm>
 
 using namespace LfpViewer;
 
+namespace
+{
+    /** Draws a contiguous band of channels into the shared bitmap */
+    class LfpChannelRenderJob : public ThreadPoolJob
+    {
+    public:
+        LfpChannelRenderJob(Image::BitmapData& bitmapData_, LfpChannelDisplay* const* first_, int numChannels_)
+            : ThreadPoolJob("LFP channel band")
+            , bitmapData(bitmapData_)
+            , first(first_)
+            , numChannels(numChannels_)
+        { }
+
+        JobStatus runJob() override
+        {
+            for (int i = 0; i < numChannels; i++)
+                first[i]->pxPaint(bitmapData);
+
+            return jobHasFinished;
+        }
+
+    private:
+        Image::BitmapData& bitmapData;
+        LfpChannelDisplay* const* first;
+        int numChannels;
+    };
+
+    // bands thinner than this are not worth a job of their own
+    const int minUsefulChannelsPerBand = 4;
+}
+
 #pragma  mark - LfpDisplay -
 // ---------------------------------------------------------------
 
@@ -54,6 +86,7 @@ LfpDisplay::LfpDisplay(LfpDisplayCanvas* c, Viewport* v)
     , channelsReversed(false)
     , displaySkipAmt(0)
     , m_SpikeRasterPlottingFlag(false)
+    , numRenderThreads(0)
 {
     perPixelPlotter = new PerPixelBitmapPlotter(this);
     supersampledPlotter = new SupersampledBitmapPlotter(this);
@@ -107,6 +140,8 @@ LfpDisplay::LfpDisplay(LfpDisplayCanvas* c, Viewport* v)
 
     isPaused=false;
 
+    setNumRenderThreads(jlimit(0, 8, SystemStats::getNumCpus() - 1));
+
 }
 
 LfpDisplay::~LfpDisplay()
@@ -325,6 +360,8 @@ void LfpDisplay::refresh()
         gLfpChannelBitmap.fillRect(fillfrom,0, (fillto-fillfrom)+1, getHeight());
     };
     
+    Array<LfpChannelDisplay*> channelsToDraw;
+
     for (int i = 0; i < numChans; i++)
 //    for (int i = 0; i < drawableChannels.size(); ++i)
     {
@@ -335,28 +372,35 @@ void LfpDisplay::refresh()
         if ((topBorder <= componentBottom && bottomBorder >= componentTop)) // only draw things that are visible
         {
             if (canvas->fullredraw)
-            {
                 channels[i]->fullredraw = true;
-                
-                channels[i]->pxPaint();
-                channelInfo[i]->repaint();
-                
-            }
-            else
-            {
-                 channels[i]->pxPaint(); // draws to lfpChannelBitmap
-                
-                 // it's not clear why, but apparently because the pxPaint() in a child component of LfpDisplay, we also need to issue repaint() calls for each channel, even though there's nothin to repaint there. Otherwise, the repaint call in LfpDisplay::refresh(), a few lines down, lags behind the update line by ~60 px. This could ahev something to do with teh reopaint message passing in juce. In any case, this seemingly redundant repaint here seems to fix the issue.
-                
-                 // we redraw from 0 to +2 (px) relative to the real redraw window, the +1 draws the vertical update line
-                 channels[i]->repaint(fillfrom, 0, (fillto-fillfrom)+2, channels[i]->getHeight());
-                
-            }
-            //std::cout << i << std::endl;
+
+            channelsToDraw.add(channels[i]);
         }
 
     }
 
+    if (channelsToDraw.size() > 0)
+    {
+        Image::BitmapData bdLfpChannelBitmap(lfpChannelBitmap, 0,0, lfpChannelBitmap.getWidth(), lfpChannelBitmap.getHeight());
+
+        renderChannels(bdLfpChannelBitmap, channelsToDraw); // draws to lfpChannelBitmap
+    }
+
+    for (auto* channel : channelsToDraw)
+    {
+        if (canvas->fullredraw)
+        {
+            channelInfo[channel->getChannelNumber()]->repaint();
+        }
+        else
+        {
+            // it's not clear why, but apparently because the pxPaint() in a child component of LfpDisplay, we also need to issue repaint() calls for each channel, even though there's nothin to repaint there. Otherwise, the repaint call in LfpDisplay::refresh(), a few lines down, lags behind the update line by ~60 px. This could ahev something to do with teh reopaint message passing in juce. In any case, this seemingly redundant repaint here seems to fix the issue.
+
+            // we redraw from 0 to +2 (px) relative to the real redraw window, the +1 draws the vertical update line
+            channel->repaint(fillfrom, 0, (fillto-fillfrom)+2, channel->getHeight());
+        }
+    }
+
     if (fillfrom == 0 && singleChan != -1)
     {
         channelInfo[singleChan]->repaint();
@@ -372,6 +416,67 @@ void LfpDisplay::refresh()
     canvas->fullredraw = false;
 }
 
+void LfpDisplay::renderChannels(Image::BitmapData& bitmapData, Array<LfpChannelDisplay*>& channelsToDraw)
+{
+    // A channel draws up to channelOverlapFactor channel heights either side of its centre, and
+    // event markers span its whole slot. Two bands drawn at the same time are kept apart by one
+    // band of the other phase, which must then be tall enough that their rows never meet.
+    const int channelHeight = jmax(1, channelsToDraw.size() > 0 ? channelsToDraw[0]->getChannelHeight() : 1);
+    const float reach = jmax(0.5f, canvas->channelOverlapFactor) * channelHeight + 2.0f;
+    const int minChannelsPerBand = jmax(minUsefulChannelsPerBand, (int) std::ceil(2.0f * reach / channelHeight));
+
+    const int numBands = jmin(2 * numRenderThreads, channelsToDraw.size() / minChannelsPerBand);
+
+    if (renderPool == nullptr || numBands < 2)
+    {
+        for (auto* channel : channelsToDraw)
+            channel->pxPaint(bitmapData);
+
+        return;
+    }
+
+    // bands must be contiguous on screen, whatever the channel ordering
+    std::sort(channelsToDraw.begin(), channelsToDraw.end(),
+              [] (const LfpChannelDisplay* a, const LfpChannelDisplay* b) { return a->getY() < b->getY(); });
+
+    // a channel may draw past its own band (overlap, event markers), so neighbouring
+    // bands are never drawn at the same time: even bands first, then odd ones. Every band
+    // holds at least minChannelsPerBand channels, so same-phase bands stay out of reach
+    for (int phase = 0; phase < 2; phase++)
+    {
+        OwnedArray<LfpChannelRenderJob> jobs;
+
+        for (int band = phase; band < numBands; band += 2)
+        {
+            const int first = band * channelsToDraw.size() / numBands;
+            const int last = (band + 1) * channelsToDraw.size() / numBands;
+
+            auto* job = new LfpChannelRenderJob(bitmapData, channelsToDraw.getRawDataPointer() + first, last - first);
+            jobs.add(job);
+            renderPool->addJob(job, false);
+        }
+
+        for (auto* job : jobs)
+            renderPool->waitForJobToFinish(job, -1);
+    }
+}
+
+void LfpDisplay::setNumRenderThreads(int numThreads)
+{
+    numThreads = jmax(0, numThreads);
+
+    if (numThreads == numRenderThreads && (renderPool != nullptr) == (numThreads > 0))
+        return;
+
+    numRenderThreads = numThreads;
+    renderPool = numThreads > 0 ? new ThreadPool(numThreads) : nullptr;
+}
+
+int LfpDisplay::getNumRenderThreads() const
+{
+    return numRenderThreads;
+}
+
 void LfpDisplay::setRange(float r, DataChannel::DataChannelTypes type)
 {
     range[type] = r;
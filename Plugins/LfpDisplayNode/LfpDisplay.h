@@ -155,6 +155,13 @@ public:
     /** Returns a const pointer to the internally managed plotter method class */
     LfpBitmapPlotter * const getPlotterPtr() const;
 
+    /** Sets the number of worker threads used to rasterize channel bands. With 0,
+        all channels are drawn on the message thread. */
+    void setNumRenderThreads(int numThreads);
+
+    /** Returns the number of worker threads used to rasterize channel bands */
+    int getNumRenderThreads() const;
+
     Colour backgroundColour;
     
     Array<Colour> channelColours;
@@ -197,6 +204,10 @@ public:
     TrackZoomInfo_Struct trackZoomInfo; // and create an instance here
 
 private:
+
+    /** Rasterizes the given channels into lfpChannelBitmap, splitting them into
+        vertical bands that are drawn in parallel on the render pool */
+    void renderChannels(Image::BitmapData& bitmapData, Array<LfpChannelDisplay*>& channelsToDraw);
     
     int singleChan;
 	Array<bool> savedChannelState;
@@ -226,6 +237,9 @@ private:
     ScopedPointer<PerPixelBitmapPlotter> perPixelPlotter;
     ScopedPointer<SupersampledBitmapPlotter> supersampledPlotter;
 
+    ScopedPointer<ThreadPool> renderPool;
+    int numRenderThreads;
+
     // TODO: (kelly) add reference to a color scheme
 //    LfpChannelColourScheme * colourScheme;
     uint8 activeColourScheme;
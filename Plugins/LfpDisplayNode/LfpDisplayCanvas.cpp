@@ -35,6 +35,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "PerPixelBitmapPlotter.h"
 #include "SupersampledBitmapPlotter.h"
 #include "LfpChannelColourScheme.h"
+#include "LfpDecimationPyramid.h"
 
 #include <math.h>
 
@@ -198,6 +199,7 @@ void LfpDisplayCanvas::beginAnimation()
     {
 
         displayBufferSize = displayBuffer->getNumSamples();
+        pyramid.reset(displayBuffer);
 
         for (int i = 0; i < screenBufferIndex.size(); i++)
         {
@@ -221,6 +223,7 @@ void LfpDisplayCanvas::update()
 {
 
     displayBufferSize = displayBuffer->getNumSamples();
+    pyramid.reset(displayBuffer);
 
     nChans = jmax(processor->getNumSubprocessorChannels(), 0);
 
@@ -315,6 +318,9 @@ void LfpDisplayCanvas::refreshState()
 
             displayBufferIndex.set(i, processor->getDisplayBufferIndex(i));
             screenBufferIndex.set(i, 0);
+
+            // the ring may have been overwritten while we were hidden
+            pyramid.rebuild(i, processor->getDisplayBufferIndex(i));
         }
     }
 
@@ -342,12 +348,15 @@ void LfpDisplayCanvas::updateScreenBuffer()
         // copy new samples from the displayBuffer into the screenBuffer
         int maxSamples = lfpDisplay->getWidth() - leftmargin;
 
-        ScopedLock displayLock(*processor->getMutex());
+        // no lock needed: the node publishes each channel's write index only after
+        // the samples before it have been written, so we never read a partial block
 
         int triggerTime = processor->getTriggerSource()>=0 
                           ? processor->getLatestTriggerTime() 
                           : -1;
         processor->acknowledgeTrigger();
+
+        const bool supersampled = getDrawMethodState();
                 
         for (int channel = 0; channel <= nChans; channel++) // pull one extra channel for event display
         {
@@ -389,6 +398,9 @@ void LfpDisplayCanvas::updateScreenBuffer()
 
             int index = processor->getDisplayBufferIndex(channel);
 
+            // fold the newly published samples into the decimation pyramid
+            pyramid.update(channel, index);
+
             int nSamples = index - dbi; // N new samples (not pixels) to be added to displayBufferIndex
 
             if (nSamples < 0)
@@ -425,27 +437,29 @@ void LfpDisplayCanvas::updateScreenBuffer()
                     //If paused don't update screen buffers, but update all indexes as needed
                     if (!lfpDisplay->isPaused)
                     {
-                        float gain = 1.0;
-
-                        screenBuffer->clear(channel, sbi, 1);
-                        screenBufferMean->clear(channel, sbi, 1);
-                        screenBufferMin->clear(channel, sbi, 1);
-                        screenBufferMax->clear(channel, sbi, 1);
-
                         // update continuous data channels
                         int nextpix = dbi + int(ceil(ratio));
                         if (nextpix > displayBufferSize)
                             nextpix = displayBufferSize;
 
-                        if (nextpix - dbi > 1) 
-                        {
-                            // multiple samples, calculate average
-                            float sum = 0;
-                            for (int j = dbi; j < nextpix; j++)
-                                sum += displayBuffer->getSample(channel, j);
+                        const float* pixelSamples = displayBuffer->getReadPointer(channel, dbi);
+                        const int nPixelSamples = nextpix - dbi;
 
-                            screenBuffer->addSample(channel, sbi, sum*gain / (nextpix - dbi));
-                        } 
+                        float sample_min;
+                        float sample_max;
+                        float sample_mean;
+
+                        if (nPixelSamples > 1)
+                        {
+                            // multiple samples, take min, max and average from the pyramid
+                            // so that the cost per pixel does not grow with the timebase
+                            const LfpDecimationPyramid::Bin bin = pyramid.query(channel, dbi, nextpix);
+                            sample_min = bin.min;
+                            sample_max = bin.max;
+                            sample_mean = bin.sum / nPixelSamples;
+
+                            screenBuffer->setSample(channel, sbi, sample_mean);
+                        }
                         else
                         {
                             // interpolate between two samples with invAlpha and alpha
@@ -454,42 +468,17 @@ void LfpDisplayCanvas::updateScreenBuffer()
                             float alpha = (float) subSampleOffset;
                             float invAlpha = 1.0f - alpha;
 
-                            float val0 = displayBuffer->getSample(channel, dbi);
+                            float val0 = pixelSamples[0];
                             float val1 = displayBuffer->getSample(channel, (dbi+1)%displayBufferSize);
 
-                            float val = invAlpha * val0  + alpha * val1;
-
-                            screenBuffer->addSample(channel, sbi, val*gain);
-                        }
-                        
-
-                        // same thing again, but this time add the min,mean, and max of all samples in current pixel
-                        float sample_min = 10000000;
-                        float sample_max = -10000000;
-                        float sample_mean = 0;
-
-                        for (int j = dbi; j < nextpix; j++)
-                        {
-
-                            float sample_current = displayBuffer->getSample(channel, j);
-                            sample_mean = sample_mean + sample_current;
-
-                            if (sample_min > sample_current)
-                            {
-                                sample_min = sample_current;
-                            }
-
-                            if (sample_max < sample_current)
-                            {
-                                sample_max = sample_current;
-                            }
+                            screenBuffer->setSample(channel, sbi, invAlpha * val0  + alpha * val1);
 
+                            sample_min = sample_max = sample_mean = val0;
                         }
 
                         // update event channel
                         if (channel == nChans)
                         {
-                            //std::cout << sample_max << std::endl;
                             screenBuffer->setSample(channel, sbi, sample_max);
                         }
 
@@ -498,24 +487,31 @@ void LfpDisplayCanvas::updateScreenBuffer()
                         // with an additional array sampleCountPerPixel[px] that holds the N samples per pixel
                         if (channel < nChans) // we're looping over one 'extra' channel for events above, so make sure not to loop over that one here
                         {
-                            int c = 0;
-                            for (int j = dbi; j < nextpix && c < MAX_N_SAMP_PER_PIXEL; j++)
+                            if (nPixelSamples <= MAX_N_SAMP_PER_PIXEL)
                             {
-                                float sample_current = displayBuffer->getSample(channel, j);
-                                samplesPerPixel[channel][sbi][c] = sample_current;
-                                c++;
+                                FloatVectorOperations::copy(samplesPerPixel[channel][sbi].data(), pixelSamples, nPixelSamples);
+                                sampleCountPerPixel[sbi] = nPixelSamples - 1; // save count of samples for this pixel
                             }
-                            if (c > 0){
-                                sampleCountPerPixel[sbi] = c - 1; // save count of samples for this pixel
-                            }
-                            else{
-                                sampleCountPerPixel[sbi] = 0;
+                            else if (supersampled)
+                            {
+                                // too many samples to keep: hand the histogram the min/max envelope of
+                                // evenly spaced sub-ranges instead, so it still covers the whole pixel
+                                const int nRanges = MAX_N_SAMP_PER_PIXEL / 2;
+
+                                for (int r = 0; r < nRanges; r++)
+                                {
+                                    const LfpDecimationPyramid::Bin bin = pyramid.query(channel,
+                                                                                        dbi + nPixelSamples * r / nRanges,
+                                                                                        dbi + nPixelSamples * (r + 1) / nRanges);
+                                    samplesPerPixel[channel][sbi][2 * r] = bin.min;
+                                    samplesPerPixel[channel][sbi][2 * r + 1] = bin.max;
+                                }
+                                sampleCountPerPixel[sbi] = 2 * nRanges - 1;
                             }
-                            sample_mean = sample_mean / c;
-                            screenBufferMean->addSample(channel, sbi, sample_mean*gain);
 
-                            screenBufferMin->addSample(channel, sbi, sample_min*gain);
-                            screenBufferMax->addSample(channel, sbi, sample_max*gain);
+                            screenBufferMean->setSample(channel, sbi, sample_mean);
+                            screenBufferMin->setSample(channel, sbi, sample_min);
+                            screenBufferMax->setSample(channel, sbi, sample_max);
                         }
                         sbi++;
                     }
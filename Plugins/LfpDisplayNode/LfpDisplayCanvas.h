@@ -30,6 +30,7 @@
 
 #include "LfpDisplayClasses.h"
 #include "LfpDisplayNode.h"
+#include "LfpDecimationPyramid.h"
 namespace LfpViewer {
 #pragma  mark - LfpDisplayCanvas -
 //==============================================================================
@@ -170,6 +171,8 @@ private:
     ScopedPointer<AudioSampleBuffer> screenBufferMean; // like screenBuffer but holds min/mean/max values per pixel
     ScopedPointer<AudioSampleBuffer> screenBufferMax; // like screenBuffer but holds min/mean/max values per pixel
 
+    LfpDecimationPyramid pyramid; // multi-resolution min/max/mean summary of displayBuffer
+
     MidiBuffer* eventBuffer;
 
     ScopedPointer<LfpTimescale> timescale;
@@ -16,6 +16,7 @@ namespace LfpViewer {
     class LfpDisplay;
     class LfpChannelDisplay;
     class LfpChannelDisplayInfo;
+    class LfpDecimationPyramid;
     class EventDisplayInterface;
     class LfpViewport;
     class LfpBitmapPlotterInfo;
@@ -200,30 +200,28 @@ bool LfpDisplayNode::resizeBuffer()
     
     int totalResized = 0;
 
-    if (true)
+    // only called while acquisition is stopped, so process() is not writing
+    for (int currSubproc = 0; currSubproc < numSubprocessors ; currSubproc++)
     {
-        ScopedLock displayLock(displayMutex);
+        int nSamples = (int)getSubprocessorSampleRate(allSubprocessors[currSubproc]) * bufferLength;
+        int nInputs = numChannelsInSubprocessor[allSubprocessors[currSubproc]];
 
-        for (int currSubproc = 0; currSubproc < numSubprocessors ; currSubproc++)
-        {
-            int nSamples = (int)getSubprocessorSampleRate(allSubprocessors[currSubproc]) * bufferLength;
-            int nInputs = numChannelsInSubprocessor[allSubprocessors[currSubproc]];
+        std::cout << "Resizing buffer for Subprocessor " << allSubprocessors[currSubproc] << ". Samples: " << nSamples << ", Inputs: " << nInputs << std::endl;
 
-            std::cout << "Resizing buffer for Subprocessor " << allSubprocessors[currSubproc] << ". Samples: " << nSamples << ", Inputs: " << nInputs << std::endl;
+        if (nSamples > 0 && nInputs > 0)
+        {
+            abstractFifo.setTotalSize(nSamples);
+            displayBuffers[currSubproc]->setSize(nInputs + 1, nSamples); // add extra channel for TTLs
+            displayBuffers[currSubproc]->clear();
 
-            if (nSamples > 0 && nInputs > 0)
-            {
-                abstractFifo.setTotalSize(nSamples);
-                displayBuffers[currSubproc]->setSize(nInputs + 1, nSamples); // add extra channel for TTLs
-                displayBuffers[currSubproc]->clear();
+            displayBufferIndices[currSubproc] = std::vector<std::atomic<int>>(nInputs + 1);
 
-                displayBufferIndices[currSubproc].clear();
-                displayBufferIndices[currSubproc].insert(displayBufferIndices[currSubproc].end(), nInputs + 1, 0);
+            for (auto& index : displayBufferIndices[currSubproc])
+                index.store(0, std::memory_order_relaxed);
 
-                channelIndices.clear();
+            channelIndices.clear();
 
-                totalResized++;
-            }
+            totalResized++;
         }
     }
     
@@ -317,7 +315,8 @@ void LfpDisplayNode::handleEvent(const EventChannel* eventInfo, const MidiMessag
         int subProcIndex = allSubprocessors.indexOf(eventSourceNodeId);
 
         const int chan          = numChannelsInSubprocessor[eventSourceNodeId];
-        const int index         = (displayBufferIndices[subProcIndex][chan] + eventTime) % displayBuffers[subProcIndex]->getNumSamples();
+        const int writeIndex    = displayBufferIndices[subProcIndex][chan].load(std::memory_order_relaxed);
+        const int index         = (writeIndex + eventTime) % displayBuffers[subProcIndex]->getNumSamples();
         const int samplesLeft   = displayBuffers[subProcIndex]->getNumSamples() - index;
         const int nSamples      = getNumSourceSamples(eventSourceNodeId) - eventTime;
 
@@ -363,13 +362,14 @@ void LfpDisplayNode::initializeEventChannels()
     {
         const int chan = numChannelsInSubprocessor[allSubprocessors[i]];
         const int nSamples = getNumSourceSamples(allSubprocessors[i]);
-        const int samplesLeft   = displayBuffers[i]->getNumSamples() - displayBufferIndices[i][chan];
+        const int writeIndex = displayBufferIndices[i][chan].load(std::memory_order_relaxed);
+        const int samplesLeft   = displayBuffers[i]->getNumSamples() - writeIndex;
         
         if (nSamples < samplesLeft)
         {
 
             displayBuffers[i]->copyFrom (chan,                                      // destChannel
-                                     displayBufferIndices[i][chan],             // destStartSample
+                                     writeIndex,                                // destStartSample
                                      arrayOfOnes,                               // source
                                      nSamples,                                  // numSamples
                                      float (ttlState[subprocessorToDraw]));     // gain
@@ -379,7 +379,7 @@ void LfpDisplayNode::initializeEventChannels()
             int extraSamples = nSamples - samplesLeft;
 
             displayBuffers[i]->copyFrom (chan,                                      // destChannel
-                                     displayBufferIndices[i][chan],             // destStartSample
+                                     writeIndex,                                // destStartSample
                                      arrayOfOnes,                               // source
                                      samplesLeft,                               // numSamples
                                      float (ttlState[subprocessorToDraw]));     // gain
@@ -397,7 +397,7 @@ void LfpDisplayNode::finalizeEventChannels()
 {
     for (int i = 0 ; i < numSubprocessors ; i++){    
         const int chan          = numChannelsInSubprocessor[allSubprocessors[i]];
-        const int index = displayBufferIndices[i][chan];
+        const int index = displayBufferIndices[i][chan].load(std::memory_order_relaxed);
         const int samplesLeft   = displayBuffers[i]->getNumSamples() - index;
         const int nSamples      = getNumSourceSamples(allSubprocessors[i]);
         
@@ -405,21 +405,22 @@ void LfpDisplayNode::finalizeEventChannels()
         
         if (nSamples < samplesLeft)
         {
-            newIdx = displayBufferIndices[i][chan] + nSamples;
+            newIdx = index + nSamples;
         }
         else
         {
             newIdx = nSamples - samplesLeft;
         }
         
-        displayBufferIndices[i][chan] = newIdx;
+        // publish the event samples written for this block
+        displayBufferIndices[i][chan].store(newIdx, std::memory_order_release);
     }
     
     if (latestCurrentTrigger >= 0)
     {
         int chan = numChannelsInSubprocessor[subprocessorToDraw];
         int subProcIndex = allSubprocessors.indexOf(subprocessorToDraw);
-        latestTrigger = latestCurrentTrigger + displayBufferIndices[subProcIndex][chan];
+        latestTrigger = latestCurrentTrigger + displayBufferIndices[subProcIndex][chan].load(std::memory_order_relaxed);
     }
         
 }
@@ -430,67 +431,62 @@ void LfpDisplayNode::process (AudioSampleBuffer& buffer)
     // 1. place any new samples into the displayBuffer
     //std::cout << "Display node sample count: " << nSamples << std::endl; ///buffer.getNumSamples() << std::endl;
 
-    if (true)
+    // No lock is taken here: this is the only writer of the display buffers, and
+    // each write index is published with release semantics once its samples are in
+    // place, so the canvas can read everything before the index it observes.
+
+    initializeEventChannels();
+    checkForEvents(); // see if we got any TTL events
+    finalizeEventChannels();
+
+    channelIndices.clearQuick();
+    channelIndices.insertMultiple(0, -1, numSubprocessors);
+    uint32 subProcId = 0;
+    int currSubproc = -1;
+
+    for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
     {
-        ScopedLock displayLock(displayMutex);
+        subProcId =  getDataSubprocId(chan);
+        currSubproc = allSubprocessors.indexOf(subProcId);
 
-        if (true)
-        {
-            initializeEventChannels();
-            checkForEvents(); // see if we got any TTL events
-            finalizeEventChannels();
-        }
+        channelIndices.set(currSubproc, channelIndices[currSubproc] + 1);
 
-        if (true)
-        {
-            int channelIndex = -1;
-            channelIndices.insertMultiple(0, -1, numSubprocessors);
-            uint32 subProcId = 0;
-            int currSubproc = -1;
+        std::atomic<int>& writeIndex = displayBufferIndices[currSubproc][channelIndices[currSubproc]];
+        const int index = writeIndex.load(std::memory_order_relaxed);
 
-            for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
-            {
-                subProcId =  getDataSubprocId(chan);
-                currSubproc = allSubprocessors.indexOf(subProcId);
-
-                channelIndices.set(currSubproc, channelIndices[currSubproc] + 1);
-
-                const int samplesLeft = displayBuffers[currSubproc]->getNumSamples() - displayBufferIndices[currSubproc][channelIndices[currSubproc]];
-                const int nSamples = getNumSamples(chan);
-
-                if (nSamples < samplesLeft)
-                {
-                    displayBuffers[currSubproc]->copyFrom(channelIndices[currSubproc],                      // destChannel
-                        displayBufferIndices[currSubproc][channelIndices[currSubproc]],  // destStartSample
-                        buffer,                    // source
-                        chan,                      // source channel
-                        0,                         // source start sample
-                        nSamples);                 // numSamples
-
-                    displayBufferIndices[currSubproc][channelIndices[currSubproc]] = displayBufferIndices[currSubproc][channelIndices[currSubproc]] + nSamples;
-                }
-                else
-                {
-                    const int extraSamples = nSamples - samplesLeft;
-
-                    displayBuffers[currSubproc]->copyFrom(channelIndices[currSubproc],                      // destChannel
-                        displayBufferIndices[currSubproc][channelIndices[currSubproc]],  // destStartSample
-                        buffer,                    // source
-                        chan,                      // source channel
-                        0,                         // source start sample
-                        samplesLeft);              // numSamples
-
-                    displayBuffers[currSubproc]->copyFrom(channelIndices[currSubproc],                      // destChannel
-                        0,                         // destStartSample
-                        buffer,                    // source
-                        chan,                      // source channel
-                        samplesLeft,               // source start sample
-                        extraSamples);             // numSamples
-
-                    displayBufferIndices[currSubproc][channelIndices[currSubproc]] = extraSamples;
-                }
+        const int samplesLeft = displayBuffers[currSubproc]->getNumSamples() - index;
+        const int nSamples = getNumSamples(chan);
 
-            }
+        if (nSamples < samplesLeft)
+        {
+            displayBuffers[currSubproc]->copyFrom(channelIndices[currSubproc],                      // destChannel
+                index,                     // destStartSample
+                buffer,                    // source
+                chan,                      // source channel
+                0,                         // source start sample
+                nSamples);                 // numSamples
+
+            writeIndex.store(index + nSamples, std::memory_order_release);
+        }
+        else
+        {
+            const int extraSamples = nSamples - samplesLeft;
+
+            displayBuffers[currSubproc]->copyFrom(channelIndices[currSubproc],                      // destChannel
+                index,                     // destStartSample
+                buffer,                    // source
+                chan,                      // source channel
+                0,                         // source start sample
+                samplesLeft);              // numSamples
+
+            displayBuffers[currSubproc]->copyFrom(channelIndices[currSubproc],                      // destChannel
+                0,                         // destStartSample
+                buffer,                    // source
+                chan,                      // source channel
+                samplesLeft,               // source start sample
+                extraSamples);             // numSamples
+
+            writeIndex.store(extraSamples, std::memory_order_release);
         }
     }
 }
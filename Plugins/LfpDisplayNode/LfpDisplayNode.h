@@ -28,6 +28,7 @@
 #include "LfpDisplayEditor.h"
 
 #include <map>
+#include <atomic>
 
 class DataViewport;
 
@@ -39,6 +40,12 @@ namespace LfpViewer
   Holds data in a displayBuffer to be used by the LfpDisplayCanvas
   for rendering continuous data streams.
 
+  The display buffers are single-writer rings: only process() writes
+  samples, and each channel's write index is published atomically after
+  its samples have been copied. The canvas reads up to the published
+  index without taking any lock, so a slow repaint never blocks the
+  audio thread.
+
   @see GenericProcessor, LfpDisplayEditor, LfpDisplayCanvas
 
 */
@@ -64,9 +71,9 @@ public:
 
     std::shared_ptr<AudioSampleBuffer> getDisplayBufferAddress() const { return displayBuffers[allSubprocessors.indexOf(subprocessorToDraw)]; }
 
-    int getDisplayBufferIndex (int chan) const { return displayBufferIndices[allSubprocessors.indexOf(subprocessorToDraw)][chan]; }
-
-    CriticalSection* getMutex() { return &displayMutex; }
+    /** Returns the published write index of a channel in the drawn subprocessor's
+        display buffer. Samples before this index are safe to read without locking. */
+    int getDisplayBufferIndex (int chan) const { return displayBufferIndices[allSubprocessors.indexOf(subprocessorToDraw)][chan].load (std::memory_order_acquire); }
 
     void setSubprocessor(uint32 sp);
     uint32 getSubprocessor() const;
@@ -87,7 +94,7 @@ private:
 
     std::vector<std::shared_ptr<AudioSampleBuffer>> displayBuffers;
 
-    std::vector<std::vector<int>> displayBufferIndices;
+    std::vector<std::vector<std::atomic<int>>> displayBufferIndices;
     Array<int> channelIndices;
 
     Array<uint32> eventSourceNodes;
@@ -102,7 +109,7 @@ private:
     float* arrayOfOnes;
     int totalSamples;
     int triggerSource;
-    int64 latestTrigger; // overall timestamp
+    std::atomic<int64> latestTrigger; // overall timestamp
     int latestCurrentTrigger; // within current input buffer
  
 
@@ -114,8 +121,6 @@ private:
     std::map<uint32, int> numChannelsInSubprocessor;
     std::map<uint32, float> subprocessorSampleRate;
 
-    CriticalSection displayMutex;
-
     static uint32 getEventSourceId(const EventChannel* event);
     static uint32 getChannelSourceId(const InfoObjectCommon* chan);
 
@@ -1163,6 +1163,7 @@ void LfpDisplayOptions::saveParameters(XmlElement* xml)
     xmlNode->setAttribute("triggerSource", triggerSourceSelection->getSelectedId());
     xmlNode->setAttribute("isInverted",invertInputButton->getToggleState());
     xmlNode->setAttribute("drawMethod",drawMethodButton->getToggleState());
+    xmlNode->setAttribute("renderThreads",lfpDisplay->getNumRenderThreads());
 
     int eventButtonState = 0;
 
@@ -1244,6 +1245,11 @@ void LfpDisplayOptions::loadParameters(XmlElement* xml)
 
             drawMethodButton->setToggleState(xmlNode->getBoolAttribute("drawMethod", true), sendNotification);
 
+            if (xmlNode->hasAttribute("renderThreads"))
+            {
+                lfpDisplay->setNumRenderThreads(xmlNode->getIntAttribute("renderThreads"));
+            }
+
             canvas->viewport->setViewPosition(xmlNode->getIntAttribute("ScrollX"),
                                       xmlNode->getIntAttribute("ScrollY"));
 
@@ -0,0 +1,186 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2018 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "RHD2000BlockDecoder.h"
+#include "rhythm-api/rhd2000datablock.h"
+
+using namespace RhythmNode;
+
+// byte offsets within each sample of a USB block, for numStreams data streams
+#define USB_TIMESTAMP_OFFSET 8
+#define USB_AUX_OFFSET 12
+#define USB_AMPLIFIER_OFFSET(numStreams) (12 + 6 * (numStreams))
+#define USB_ADC_OFFSET(numStreams) (12 + 72 * (numStreams))
+#define USB_TTL_OFFSET(numStreams) (28 + 72 * (numStreams))
+
+namespace
+{
+    inline uint16 readUsbWord(const unsigned char* usbBuffer)
+    {
+        return *reinterpret_cast<const uint16*>(usbBuffer);
+    }
+
+    /** Converts the word at the same place in numSamples consecutive samples,
+        as (word - zero) * scale + offset */
+    void convertUsbWords(const unsigned char* firstWord, int sampleSize, int numSamples,
+                         int zero, float scale, float offset, float* dest)
+    {
+        for (int samp = 0; samp < numSamples; samp++)
+            dest[samp] = float(int(readUsbWord(firstWord + samp * sampleSize)) - zero) * scale + offset;
+    }
+}
+
+RHD2000BlockDecoder::RHD2000BlockDecoder()
+    : acquireAuxChannels(false), acquireAdcChannels(false), numChannels(0)
+{
+    for (int i = 0; i < 8; i++)
+        adcRanges[i] = 0;
+}
+
+void RHD2000BlockDecoder::setLayout(const Array<StreamLayout>& newStreams, bool acquireAux, bool acquireAdc)
+{
+    streams = newStreams;
+    acquireAuxChannels = acquireAux;
+    acquireAdcChannels = acquireAdc;
+
+    numChannels = 0;
+
+    for (int stream = 0; stream < streams.size(); stream++)
+    {
+        numChannels += streams[stream].numChannels;
+
+        if (acquireAuxChannels && streams[stream].hasAuxChannels)
+            numChannels += 3;
+    }
+
+    if (acquireAdcChannels)
+        numChannels += 8;
+
+    const std::array<float, 3> zeros = { { 0.0f, 0.0f, 0.0f } };
+    auxSamples.clearQuick();
+    auxSamples.insertMultiple(0, zeros, streams.size());
+    auxHeldSamples.clearQuick();
+    auxHeldSamples.insertMultiple(0, zeros, streams.size());
+}
+
+void RHD2000BlockDecoder::setAdcRange(int adcChannel, short range)
+{
+    adcRanges[adcChannel] = range;
+}
+
+short RHD2000BlockDecoder::getAdcRange(int adcChannel) const
+{
+    return adcRanges[adcChannel];
+}
+
+int RHD2000BlockDecoder::getNumChannels() const
+{
+    return numChannels;
+}
+
+int RHD2000BlockDecoder::getSampleSize() const
+{
+    // 8 = magic number; 4 = timestamp; 72 per stream = 3 aux + 32 amplifier + 1 filler word; 16 = ADCs; 4 = TTL in/out
+    return 32 + 72 * streams.size();
+}
+
+int RHD2000BlockDecoder::decode(const unsigned char* usbBuffer, int numSamples, float* channelData, int64* timestamps, uint64* ttlWords)
+{
+    unsigned char* buffer = const_cast<unsigned char*>(usbBuffer);
+    const int numStreams = streams.size();
+    const int sampleSize = getSampleSize();
+
+    // check every header first, so the number of samples to decode is known before writing any
+    int numValid = 0;
+
+    while (numValid < numSamples && Rhd2000DataBlock::checkUsbHeader(buffer, numValid * sampleSize))
+        numValid++;
+
+    for (int samp = 0; samp < numValid; samp++)
+    {
+        timestamps[samp] = Rhd2000DataBlock::convertUsbTimeStamp(buffer, samp * sampleSize + USB_TIMESTAMP_OFFSET);
+        ttlWords[samp] = readUsbWord(usbBuffer + samp * sampleSize + USB_TTL_OFFSET(numStreams));
+    }
+
+    float* dest = channelData;
+
+    // amplifier channels: word c of stream s is at (c * numStreams + s)
+    for (int stream = 0; stream < numStreams; stream++)
+    {
+        const StreamLayout& layout = streams.getReference(stream);
+        const unsigned char* firstWord = usbBuffer + USB_AMPLIFIER_OFFSET(numStreams)
+                                         + 2 * (layout.firstChannel * numStreams + stream);
+
+        for (int chan = 0; chan < layout.numChannels; chan++)
+        {
+            convertUsbWords(firstWord + 2 * chan * numStreams, sampleSize, numValid, 32768, 0.195f, 0.0f, dest);
+            dest += numValid;
+        }
+    }
+
+    if (acquireAuxChannels)
+    {
+        for (int stream = 0; stream < numStreams; stream++)
+        {
+            if (! streams[stream].hasAuxChannels)
+                continue;
+
+            // results of the second aux command slot, which cycles through the 3 aux inputs
+            const unsigned char* auxWord = usbBuffer + USB_AUX_OFFSET + 2 * (numStreams + stream);
+            std::array<float, 3>& samples = auxSamples.getReference(stream);
+            std::array<float, 3>& held = auxHeldSamples.getReference(stream);
+
+            for (int samp = 0; samp < numValid; samp++)
+            {
+                const int auxNum = (samp + 3) % 4;
+
+                if (auxNum < 3)
+                    samples[auxNum] = float(int(readUsbWord(auxWord + samp * sampleSize)) - 32768) * 0.0000374f;
+                else
+                    held = samples;
+
+                for (int chan = 0; chan < 3; chan++)
+                    dest[chan * numValid + samp] = held[chan];
+            }
+
+            dest += 3 * numValid;
+        }
+    }
+
+    if (acquireAdcChannels)
+    {
+        for (int adcChan = 0; adcChan < 8; adcChan++)
+        {
+            const unsigned char* firstWord = usbBuffer + USB_ADC_OFFSET(numStreams) + 2 * adcChan;
+
+            // ADC waveform units = volts
+            if (adcRanges[adcChan] == 0)
+                convertUsbWords(firstWord, sampleSize, numValid, 0, 0.00015258789f, -5.0f - 0.4096f, dest); // account for +/-5V input range and DC offset
+            else
+                convertUsbWords(firstWord, sampleSize, numValid, 0, 0.00030517578f, 0.0f, dest);
+
+            dest += numValid;
+        }
+    }
+
+    return numValid;
+}
@@ -0,0 +1,94 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2018 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __RHD2000BLOCKDECODER_H__
+#define __RHD2000BLOCKDECODER_H__
+
+#include <DataThreadHeaders.h>
+
+#include <array>
+#include <atomic>
+
+namespace RhythmNode
+{
+
+	/**
+		Decodes the raw USB blocks read from the RHD2000 Evaluation Board, a whole
+		block at a time, into samples stored one channel after another.
+
+		Only the block layout is needed, not the board, so blocks captured from
+		Rhd2000EvalBoard::readRawDataBlock() can be decoded offline.
+
+		@see RHD2000Thread, Rhd2000DataBlock
+	*/
+	class RHD2000BlockDecoder
+	{
+	public:
+		RHD2000BlockDecoder();
+
+		/** One enabled data stream, in the order the board sends them */
+		struct StreamLayout
+		{
+			int numChannels;		// amplifier channels decoded
+			int firstChannel;		// of the 32 sent, e.g. 8 for 16-channel RHD2132 headstages
+			bool hasAuxChannels;	// false for the second stream of an RHD2164
+		};
+
+		/** Sets the streams and optional channels of each block, and clears the aux channels */
+		void setLayout(const Array<StreamLayout>& streams, bool acquireAux, bool acquireAdc);
+
+		void setAdcRange(int adcChannel, short range);
+		short getAdcRange(int adcChannel) const;
+
+		/** Returns the number of channels decode() writes */
+		int getNumChannels() const;
+
+		/** Returns the number of bytes each sample takes in a USB block */
+		int getSampleSize() const;
+
+		/** Decodes numSamples samples from a raw USB block. Every header is checked first,
+			and decoding stops before the first bad one.
+
+			@param channelData receives getNumChannels() channels of the returned number of
+			samples each, one channel after another: amplifier channels, aux, then ADC
+			@return the number of samples decoded
+		*/
+		int decode(const unsigned char* usbBuffer, int numSamples, float* channelData, int64* timestamps, uint64* ttlWords);
+
+	private:
+		Array<StreamLayout> streams;
+		bool acquireAuxChannels;
+		bool acquireAdcChannels;
+		int numChannels;
+
+		// aux inputs are only sampled every 4th sample, so their values are held until the next update
+		Array<std::array<float, 3>> auxSamples;
+		Array<std::array<float, 3>> auxHeldSamples;
+
+		std::array<std::atomic_short, 8> adcRanges;
+
+		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RHD2000BlockDecoder);
+	};
+
+}
+#endif  // __RHD2000BLOCKDECODER_H__
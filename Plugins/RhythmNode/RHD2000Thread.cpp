@@ -95,12 +95,6 @@ RHD2000Thread::RHD2000Thread(SourceNode* sn) : DataThread(sn),
     newScan(true), ledsEnabled(true)
 {
     impedanceThread = new RHDImpedanceMeasure(this);
-    memset(auxBuffer, 0, sizeof(auxBuffer));
-    memset(auxSamples, 0, sizeof(auxSamples));
-
-    for (int i = 0; i < 8; i++)
-        adcRangeSettings[i] = 0;
-
     for (int i=0; i < MAX_NUM_HEADSTAGES; i++)
         headstagesArray.add(new RHDHeadstage(static_cast<Rhd2000EvalBoard::BoardDataSource>(i)));
 
@@ -1454,6 +1448,25 @@ bool RHD2000Thread::startAcquisition()
 
     blockSize = dataBlock->calculateDataBlockSizeInWords(evalBoard->getNumEnabledDataStreams(), evalBoard->isUSB3());
     std::cout << "Expecting blocksize of " << blockSize << " for " << evalBoard->getNumEnabledDataStreams() << " streams" << std::endl;
+
+    Array<RHD2000BlockDecoder::StreamLayout> streamLayouts;
+
+    for (int i = 0; i < enabledStreams.size(); i++)
+    {
+        RHD2000BlockDecoder::StreamLayout layout;
+        layout.numChannels = numChannelsPerDataStream[i];
+        layout.firstChannel = (chipId[i] == CHIP_ID_RHD2132 && numChannelsPerDataStream[i] == 16) ? RHD2132_16CH_OFFSET : 0; //RHD2132 16ch. headstage
+        layout.hasAuxChannels = chipId[i] != CHIP_ID_RHD2164_B;
+        streamLayouts.add(layout);
+    }
+
+    blockDecoder.setLayout(streamLayouts, acquireAuxChannels, acquireAdcChannels);
+
+    const int samplesPerBlock = Rhd2000DataBlock::getSamplesPerDataBlock(evalBoard->isUSB3());
+    blockData.malloc(blockDecoder.getNumChannels() * samplesPerBlock);
+    blockTimestamps.malloc(samplesPerBlock);
+    blockTtlWords.malloc(samplesPerBlock);
+
     //evalBoard->printFIFOmetrics();
     startThread();
 
@@ -1529,96 +1542,15 @@ bool RHD2000Thread::updateBuffer()
         return_code = evalBoard->readRawDataBlock(&bufferPtr);
         // see Rhd2000DataBlock::fillFromUsbBuffer() for an idea of data order in bufferPtr
 
-        int index = 0;
-        int auxIndex, chanIndex;
-        int numStreams = enabledStreams.size();
         int nSamps = Rhd2000DataBlock::getSamplesPerDataBlock(evalBoard->isUSB3());
 
-        //evalBoard->printFIFOmetrics();
-        for (int samp = 0; samp < nSamps; samp++)
-        {
-            int channel = -1;
-
-            if (!Rhd2000DataBlock::checkUsbHeader(bufferPtr, index))
-            {
-                cerr << "Error in Rhd2000EvalBoard::readDataBlock: Incorrect header." << endl;
-                break;
-            }
-
-            index += 8; // magic number header width (bytes)
-            timestamps.set(0, Rhd2000DataBlock::convertUsbTimeStamp(bufferPtr, index));
-            index += 4; // timestamp width
-            auxIndex = index; // aux chans start at this offset
-            // skip aux channels for now
-            index += 6 * numStreams; // width of the 3 aux chans
-            // copy 64 neural data channels
-            for (int dataStream = 0; dataStream < numStreams; dataStream++)
-            {
-                int nChans = numChannelsPerDataStream[dataStream];
-                chanIndex = index + 2*dataStream;
-                if ((chipId[dataStream] == CHIP_ID_RHD2132) && (nChans == 16)) //RHD2132 16ch. headstage
-                {
-                    chanIndex += 2 * RHD2132_16CH_OFFSET*numStreams;
-                }
-                for (int chan = 0; chan < nChans; chan++)
-                {
-                    channel++;
-                    thisSample[channel] = float(*(uint16*)(bufferPtr + chanIndex) - 32768)*0.195f;
-                    chanIndex += 2*numStreams; // single chan width (2 bytes)
-                }
-            }
-            index += 64 * numStreams; // neural data width
-            auxIndex += 2 * numStreams; // skip AuxCmd1 slots (see updateRegisters())
-            // copy the 3 aux channels
-            if (acquireAuxChannels)
-            {
-                for (int dataStream = 0; dataStream < numStreams; dataStream++)
-                {
-                    if (chipId[dataStream] != CHIP_ID_RHD2164_B)
-                    {
-                        int auxNum = (samp+3) % 4;
-                        if (auxNum < 3)
-                        {
-                            auxSamples[dataStream][auxNum] = float(*(uint16*)(bufferPtr + auxIndex) - 32768)*0.0000374;
-                        }
-                        for (int chan = 0; chan < 3; chan++)
-                        {
-                            channel++;
-                            if (auxNum == 3)
-                            {
-                                auxBuffer[channel] = auxSamples[dataStream][chan];
-                            }
-                            thisSample[channel] = auxBuffer[channel];
-                        }
-                    }
-                    auxIndex += 2; // single chan width (2 bytes)
-                }
-            }
-            index += 2 * numStreams; // skip over filler word at the end of each data stream
-            // copy the 8 ADC channels
-            if (acquireAdcChannels)
-            {
-                for (int adcChan = 0; adcChan < 8; ++adcChan)
-                {
+        // decode the whole block at once, one channel after another
+        int numDecoded = blockDecoder.decode(bufferPtr, nSamps, blockData, blockTimestamps, blockTtlWords);
 
-                    channel++;
-                    // ADC waveform units = volts
-                    thisSample[channel] = adcRangeSettings[adcChan] == 0 ?
-                        //0.000050354 * float(dataBlock->boardAdcData[adcChan][samp]);
-                        0.00015258789 * float(*(uint16*)(bufferPtr + index)) - 5 - 0.4096 : // account for +/-5V input range and DC offset
-                        0.00030517578 * float(*(uint16*)(bufferPtr + index));
-                    index += 2; // single chan width (2 bytes)
-                }
-            }
-            else
-            {
-                index += 16; // skip ADC chans (8 * 2 bytes)
-            }
-            ttlEventWords.set(0, *(uint16*)(bufferPtr + index));
-            index += 4;
-            sourceBuffers[0]->addToBuffer(thisSample, &timestamps.getReference(0), &ttlEventWords.getReference(0), 1);
-        }
+        if (numDecoded < nSamps)
+            cerr << "Error in Rhd2000EvalBoard::readDataBlock: Incorrect header." << endl;
 
+        sourceBuffers[0]->addChannelBlocksToBuffer(blockData, blockTimestamps, blockTtlWords, numDecoded);
     }
 
 
@@ -1792,12 +1724,12 @@ int RHD2000Thread::setClockDivider(int divide_ratio)
 
 void RHD2000Thread::setAdcRange(int channel, short range)
 {
-    adcRangeSettings[channel] = range;
+    blockDecoder.setAdcRange(channel, range);
 }
 
 short RHD2000Thread::getAdcRange(int channel) const
 {
-    return adcRangeSettings[channel];
+    return blockDecoder.getAdcRange(channel);
 }
 
 void RHD2000Thread::runImpedanceTest(ImpedanceData* data)
@@ -36,6 +36,8 @@
 #include "rhythm-api/rhd2000datablock.h"
 #include "rhythm-api/okFrontPanelDLL.h"
 
+#include "RHD2000BlockDecoder.h"
+
 #define MAX_NUM_DATA_STREAMS_USB2 8
 #define MAX_NUM_DATA_STREAMS_USB3 16
 #define MAX_NUM_HEADSTAGES 8
@@ -171,10 +173,10 @@ namespace RhythmNode
 		int numChannels;
 		bool deviceFound;
 
-		float thisSample[MAX_NUM_CHANNELS];
-		// aux inputs are only sampled every 4th sample, so use this to buffer the samples so they can be handles just like the regular neural channels later
-		float auxBuffer[MAX_NUM_CHANNELS];
-		float auxSamples[MAX_NUM_DATA_STREAMS_USB3][3];
+		RHD2000BlockDecoder blockDecoder;
+		HeapBlock<float> blockData;
+		HeapBlock<int64> blockTimestamps;
+		HeapBlock<uint64> blockTtlWords;
 
 		unsigned int blockSize;
 
@@ -230,9 +232,6 @@ namespace RhythmNode
 		// Sync ouput divide factor
 		uint16 clockDivideFactor;
 
-		//ADC ranges
-		std::array<atomic_short, 8> adcRangeSettings;
-
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RHD2000Thread);
 	};
 
@@ -0,0 +1,103 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __STREAMFORMAT_H__
+#define __STREAMFORMAT_H__
+
+#include <DataThreadHeaders.h>
+
+/** First four bytes of a stream, "OESF" */
+#define STREAM_FORMAT_MAGIC 0x46534f45
+
+/** First four bytes of every block, "OESB" */
+#define STREAM_BLOCK_MAGIC 0x42534f45
+
+/** First four bytes of a shared-memory ring, "OESR" */
+#define STREAM_RING_MAGIC 0x52534f45
+
+/** Bytes before the data area of a shared-memory ring */
+#define STREAM_RING_HEADER_SIZE 256
+
+/** Most samples a block may hold */
+#define STREAM_MAX_BLOCK_SIZE 16384
+
+/*
+    A stream is a StreamFormat followed by any number of blocks. Each block is a
+    StreamBlockHeader, then its samples, then one TTL word per sample if the
+    format has TTL lines. All values are little endian.
+
+    Over TCP the producer listens, and sends the stream to each connection.
+
+    In shared memory the stream goes through a ring buffer created with
+    shm_open(): a StreamRingHeader, then `capacity` bytes of data starting at
+    STREAM_RING_HEADER_SIZE. Byte n of the stream is at data offset
+    n % capacity. The producer writes its bytes, then advances writePosition;
+    the reader copies them out, then advances readPosition. Nothing is lost:
+    the producer waits while writePosition - readPosition == capacity.
+*/
+
+namespace StreamSourceNode
+{
+    struct StreamFormat
+    {
+        enum SampleType
+        {
+            INT16 = 0,      // converted to floats with bitVolts
+            FLOAT32 = 1     // stored as they are
+        };
+
+        enum Layout
+        {
+            INTERLEAVED = 0,    // all channels of the first sample, then of the second...
+            PLANAR = 1          // all samples of the first channel, then of the second...
+        };
+
+        uint32 magic;           // STREAM_FORMAT_MAGIC
+        uint16 headerSize;      // bytes in this header, so fields can be appended later
+        uint16 numChannels;
+        uint8 sampleType;       // a SampleType
+        uint8 layout;           // a Layout
+        uint16 numTTLLines;     // 0 if blocks carry no TTL words
+        float sampleRate;
+        float bitVolts;
+        uint32 reserved[3];
+    };
+
+    struct StreamBlockHeader
+    {
+        uint32 magic;           // STREAM_BLOCK_MAGIC
+        uint32 numSamples;      // at most STREAM_MAX_BLOCK_SIZE
+        int64 firstTimestamp;   // of the block's first sample; the others follow one by one
+    };
+
+    struct StreamRingHeader
+    {
+        uint32 magic;                   // STREAM_RING_MAGIC, set once the rest is ready
+        uint32 reserved;
+        uint64 capacity;                // bytes in the data area
+        Atomic<int64> writePosition;    // stream bytes written so far
+        Atomic<int64> readPosition;     // stream bytes read so far
+    };
+}
+
+#endif
@@ -0,0 +1,471 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "StreamSource.h"
+#include "StreamSourceEditor.h"
+
+#if ! JUCE_WINDOWS
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+#endif
+
+/** How long a block may take to arrive once it has started, in milliseconds */
+#define STREAM_STALL_TIMEOUT_MS 1000
+
+using namespace StreamSourceNode;
+
+static_assert (sizeof (StreamFormat) == 32, "StreamFormat must match the wire format");
+static_assert (sizeof (StreamBlockHeader) == 16, "StreamBlockHeader must match the wire format");
+static_assert (sizeof (StreamRingHeader) == 32, "StreamRingHeader must match the shared-memory layout");
+
+namespace StreamSourceNode
+{
+    /** Where a StreamSource reads its bytes from */
+    class StreamReader
+    {
+    public:
+        virtual ~StreamReader() {}
+
+        /** Reads up to numBytes, waiting at most timeoutMs for the first ones. Returns
+            the number of bytes read, 0 if none arrived in time, or -1 if the stream ended. */
+        virtual int read (void* dest, int numBytes, int timeoutMs) = 0;
+    };
+}
+
+namespace
+{
+    class SocketStreamReader : public StreamReader
+    {
+    public:
+        bool connect (const String& host, int port)
+        {
+            return socket.connect (host, port, 1000);
+        }
+
+        int read (void* dest, int numBytes, int timeoutMs) override
+        {
+            const int ready = socket.waitUntilReady (true, timeoutMs);
+
+            if (ready <= 0)
+                return ready;
+
+            // readable but empty means the producer closed the connection
+            const int numRead = socket.read (dest, numBytes, false);
+            return numRead > 0 ? numRead : -1;
+        }
+
+    private:
+        StreamingSocket socket;
+    };
+
+#if ! JUCE_WINDOWS
+    class SharedMemoryStreamReader : public StreamReader
+    {
+    public:
+        SharedMemoryStreamReader() : ring (nullptr), data (nullptr), mappedSize (0) {}
+
+        ~SharedMemoryStreamReader()
+        {
+            if (ring != nullptr)
+                munmap (ring, mappedSize);
+        }
+
+        bool open (const String& name)
+        {
+            const int fd = shm_open (("/" + name).toRawUTF8(), O_RDWR, 0);
+
+            if (fd < 0)
+                return false;
+
+            struct stat info;
+            void* address = MAP_FAILED;
+
+            if (fstat (fd, &info) == 0 && info.st_size > STREAM_RING_HEADER_SIZE)
+            {
+                mappedSize = (size_t) info.st_size;
+                address = mmap (nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+
+            close (fd);
+
+            if (address == MAP_FAILED)
+                return false;
+
+            ring = static_cast<StreamRingHeader*> (address);
+            data = static_cast<uint8*> (address) + STREAM_RING_HEADER_SIZE;
+
+            return ring->magic == STREAM_RING_MAGIC
+                && ring->capacity > 0
+                && ring->capacity <= mappedSize - STREAM_RING_HEADER_SIZE;
+        }
+
+        int read (void* dest, int numBytes, int timeoutMs) override
+        {
+            const int64 capacity = (int64) ring->capacity;
+            const int64 readPosition = ring->readPosition.get();
+            const uint32 startTime = Time::getMillisecondCounter();
+            int64 available;
+
+            while ((available = ring->writePosition.get() - readPosition) == 0)
+            {
+                if (Time::getMillisecondCounter() - startTime >= (uint32) timeoutMs)
+                    return 0;
+
+                Thread::sleep (1);
+            }
+
+            if (available < 0 || available > capacity)
+                return -1;
+
+            const int numRead = (int) jmin ((int64) numBytes, available);
+            const int64 offset = readPosition % capacity;
+            const int firstPart = (int) jmin ((int64) numRead, capacity - offset);
+
+            memcpy (dest, data + offset, (size_t) firstPart);
+            memcpy (static_cast<uint8*> (dest) + firstPart, data, (size_t) (numRead - firstPart));
+
+            ring->readPosition = readPosition + numRead;
+            return numRead;
+        }
+
+    private:
+        StreamRingHeader* ring;
+        uint8* data;
+        size_t mappedSize;
+    };
+#endif
+
+    /** Converts a block's samples to floats, written channel after channel */
+    template <typename SampleType>
+    void convertToChannelBlocks (const uint8* source, int numChannels, int numSamples, bool interleaved,
+                                 float scale, float* dest)
+    {
+        const SampleType* samples = reinterpret_cast<const SampleType*> (source);
+
+        if (! interleaved)
+        {
+            const int numValues = numChannels * numSamples;
+
+            for (int i = 0; i < numValues; ++i)
+                dest[i] = (float) samples[i] * scale;
+        }
+        else
+        {
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                const SampleType* in = samples + chan;
+                float* out = dest + chan * numSamples;
+
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] = (float) in[i * numChannels] * scale;
+            }
+        }
+    }
+}
+
+
+DataThread* StreamSource::createDataThread (SourceNode* sn)
+{
+    return new StreamSource (sn);
+}
+
+
+StreamSource::StreamSource (SourceNode* sn)
+    : DataThread    (sn)
+    , connected     (false)
+{
+    zerostruct (format);
+    format.sampleRate = 30000.0f;
+    format.bitVolts = 1.0f;
+
+    sourceBuffers.add (new DataBuffer (1, 10000));
+}
+
+
+StreamSource::~StreamSource()
+{
+}
+
+
+GenericEditor* StreamSource::createEditor (SourceNode* sn)
+{
+    return new StreamSourceEditor (sn, this);
+}
+
+
+bool StreamSource::connectToSocket (const String& host, int port)
+{
+    disconnect();
+
+    ScopedPointer<SocketStreamReader> socketReader = new SocketStreamReader();
+
+    if (! socketReader->connect (host, port))
+    {
+        std::cout << "Stream source: could not connect to " << host << ":" << port << std::endl;
+        return false;
+    }
+
+    return connectTo (socketReader.release());
+}
+
+
+bool StreamSource::connectToSharedMemory (const String& name)
+{
+    disconnect();
+
+#if JUCE_WINDOWS
+    std::cout << "Stream source: shared memory is not supported on this platform" << std::endl;
+    return false;
+#else
+    ScopedPointer<SharedMemoryStreamReader> sharedMemoryReader = new SharedMemoryStreamReader();
+
+    if (! sharedMemoryReader->open (name))
+    {
+        std::cout << "Stream source: could not open shared memory " << name << std::endl;
+        return false;
+    }
+
+    return connectTo (sharedMemoryReader.release());
+#endif
+}
+
+
+void StreamSource::disconnect()
+{
+    reader = nullptr;
+    connected = false;
+}
+
+
+bool StreamSource::connectTo (StreamReader* newReader)
+{
+    reader = newReader;
+
+    // read the fields this version knows, then skip any appended by newer producers
+    StreamFormat newFormat;
+    const int knownSize = (int) sizeof (StreamFormat);
+
+    if (readFully (&newFormat, knownSize, false) < 0
+        || newFormat.magic != STREAM_FORMAT_MAGIC
+        || newFormat.headerSize < knownSize)
+    {
+        std::cout << "Stream source: no stream format received" << std::endl;
+        disconnect();
+        return false;
+    }
+
+    HeapBlock<uint8> extraFields (jmax (1, newFormat.headerSize - knownSize));
+
+    if (readFully (extraFields, newFormat.headerSize - knownSize, false) < 0
+        || newFormat.numChannels == 0
+        || newFormat.sampleType > StreamFormat::FLOAT32
+        || newFormat.layout > StreamFormat::PLANAR
+        || newFormat.numTTLLines > 64
+        || newFormat.sampleRate <= 0.0f
+        || newFormat.bitVolts <= 0.0f)
+    {
+        std::cout << "Stream source: invalid stream format" << std::endl;
+        disconnect();
+        return false;
+    }
+
+    format = newFormat;
+    connected = true;
+
+    const int maxValues = format.numChannels * STREAM_MAX_BLOCK_SIZE;
+
+    blockData.malloc (maxValues * sizeof (float));
+    channelData.malloc (maxValues);
+    sampleTimestamps.malloc (STREAM_MAX_BLOCK_SIZE);
+    ttlWords.calloc (STREAM_MAX_BLOCK_SIZE);
+
+    sourceBuffers[0]->resize (format.numChannels, jmax (4 * STREAM_MAX_BLOCK_SIZE, roundToInt (2 * format.sampleRate)));
+
+    std::cout << "Stream source: connected, " << getFormatDescription() << std::endl;
+    return true;
+}
+
+
+String StreamSource::getFormatDescription() const
+{
+    if (! connected)
+        return "not connected";
+
+    String description;
+    description << (int) format.numChannels << " ch, " << String (format.sampleRate, 0) << " Hz, "
+                << (format.sampleType == StreamFormat::FLOAT32 ? "float32" : "int16");
+
+    if (format.numTTLLines > 0)
+        description << ", " << (int) format.numTTLLines << " TTL";
+
+    return description;
+}
+
+
+int StreamSource::readFully (void* dest, int numBytes, bool canStop)
+{
+    uint8* const bytes = static_cast<uint8*> (dest);
+    int numRead = 0;
+    uint32 lastProgress = Time::getMillisecondCounter();
+
+    while (numRead < numBytes)
+    {
+        // short waits, so the thread notices quickly when it is asked to stop
+        const int result = reader->read (bytes + numRead, numBytes - numRead, 100);
+
+        if (result < 0)
+            return -1;
+
+        if (result > 0)
+        {
+            numRead += result;
+            lastProgress = Time::getMillisecondCounter();
+        }
+        else if (canStop && numRead == 0)
+        {
+            if (threadShouldExit())
+                return 0;
+        }
+        else if (Time::getMillisecondCounter() - lastProgress > STREAM_STALL_TIMEOUT_MS)
+        {
+            return -1;
+        }
+    }
+
+    return 1;
+}
+
+
+bool StreamSource::foundInputSource()
+{
+    return connected;
+}
+
+
+bool StreamSource::startAcquisition()
+{
+    sourceBuffers[0]->clear();
+
+    startThread();
+    return true;
+}
+
+
+bool StreamSource::stopAcquisition()
+{
+    if (isThreadRunning())
+    {
+        signalThreadShouldExit();
+    }
+
+    waitForThreadToExit (STREAM_STALL_TIMEOUT_MS + 500);
+
+    sourceBuffers[0]->clear();
+    return true;
+}
+
+
+int StreamSource::getNumDataOutputs (DataChannel::DataChannelTypes type, int subProcessorIdx) const
+{
+    if (type == DataChannel::HEADSTAGE_CHANNEL)
+        return format.numChannels;
+    else
+        return 0;
+}
+
+
+int StreamSource::getNumTTLOutputs (int subProcessorIdx) const
+{
+    return format.numTTLLines;
+}
+
+
+float StreamSource::getSampleRate (int subProcessorIdx) const
+{
+    return format.sampleRate;
+}
+
+
+float StreamSource::getBitVolts (const DataChannel* chan) const
+{
+    return format.bitVolts;
+}
+
+
+bool StreamSource::updateBuffer()
+{
+    if (reader == nullptr)
+        return false;
+
+    StreamBlockHeader header;
+    const int result = readFully (&header, sizeof (header), true);
+
+    if (result == 0)
+        return true;
+
+    const int numSamples = (int) header.numSamples;
+    const int numValues = numSamples * format.numChannels;
+    const bool isFloat = format.sampleType == StreamFormat::FLOAT32;
+    const bool interleaved = format.layout == StreamFormat::INTERLEAVED;
+
+    if (result < 0
+        || header.magic != STREAM_BLOCK_MAGIC
+        || numSamples <= 0
+        || numSamples > STREAM_MAX_BLOCK_SIZE
+        || readFully (blockData, numValues * (isFloat ? sizeof (float) : sizeof (int16)), false) < 0
+        || (format.numTTLLines > 0 && readFully (ttlWords, numSamples * sizeof (uint64), false) < 0))
+    {
+        std::cout << "Stream source: lost the stream" << std::endl;
+        disconnect();
+        return false;
+    }
+
+    const float* samples = channelData;
+
+    if (isFloat && ! interleaved)
+        samples = reinterpret_cast<const float*> (blockData.getData());
+    else if (isFloat)
+        convertToChannelBlocks<float> (blockData, format.numChannels, numSamples, true, 1.0f, channelData);
+    else
+        convertToChannelBlocks<int16> (blockData, format.numChannels, numSamples, interleaved, format.bitVolts, channelData);
+
+    for (int i = 0; i < numSamples; ++i)
+        sampleTimestamps[i] = header.firstTimestamp + i;
+
+    // wait for room rather than drop samples; the producer is held back meanwhile
+    DataBuffer* buffer = sourceBuffers[0];
+
+    while (buffer->getFreeSpace() < numSamples)
+    {
+        if (threadShouldExit())
+            return true;
+
+        wait (1);
+    }
+
+    buffer->addChannelBlocksToBuffer (samples, sampleTimestamps, ttlWords, numSamples);
+
+    return true;
+}
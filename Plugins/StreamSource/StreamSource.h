@@ -0,0 +1,99 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __STREAMSOURCE_H__
+#define __STREAMSOURCE_H__
+
+#include <DataThreadHeaders.h>
+#include "StreamFormat.h"
+
+namespace StreamSourceNode
+{
+    class StreamReader;
+
+    /**
+        Reads continuous data written by a local producer process, either over a
+        TCP connection or through a shared-memory ring buffer.
+
+        The stream describes itself (see StreamFormat.h): its format is read when
+        connecting, and sets the channels this source creates. During acquisition
+        each block is read in one go and copied to the DataBuffer a channel at a
+        time. When the DataBuffer is full the thread waits instead of dropping
+        samples, so a slow GUI slows the producer down rather than losing data.
+
+        @see StreamFormat, DataThread
+    */
+    class StreamSource : public DataThread
+    {
+    public:
+        StreamSource (SourceNode* sn);
+        ~StreamSource();
+
+        /** Connects to a producer listening on a TCP port, and reads its format */
+        bool connectToSocket (const String& host, int port);
+
+        /** Opens the named shared-memory ring, and reads its format */
+        bool connectToSharedMemory (const String& name);
+
+        void disconnect();
+
+        /** Returns a short description of the stream, e.g. "64 ch, 30000 Hz, int16" */
+        String getFormatDescription() const;
+
+        bool foundInputSource() override;
+        bool startAcquisition() override;
+        bool stopAcquisition() override;
+
+        int getNumDataOutputs (DataChannel::DataChannelTypes type, int subProcessorIdx) const override;
+        int getNumTTLOutputs (int subProcessorIdx) const override;
+        float getSampleRate (int subProcessorIdx) const override;
+        float getBitVolts (const DataChannel* chan) const override;
+
+        GenericEditor* createEditor (SourceNode* sn) override;
+        static DataThread* createDataThread (SourceNode* sn);
+
+    private:
+        bool updateBuffer() override;
+
+        /** Takes ownership of newReader, and reads the stream format from it */
+        bool connectTo (StreamReader* newReader);
+
+        /** Reads exactly numBytes. Returns 1 once done, 0 if the thread was asked
+            to stop before anything arrived (only when canStop is true), or -1 if
+            the producer went away or stalled mid-block. */
+        int readFully (void* dest, int numBytes, bool canStop);
+
+        ScopedPointer<StreamReader> reader;
+        StreamFormat format;
+        bool connected;
+
+        HeapBlock<uint8> blockData;
+        HeapBlock<float> channelData;       // channel after channel, as many samples each as the block holds
+        HeapBlock<int64> sampleTimestamps;
+        HeapBlock<uint64> ttlWords;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StreamSource);
+    };
+}
+
+#endif
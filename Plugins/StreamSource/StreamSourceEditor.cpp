@@ -0,0 +1,190 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "StreamSourceEditor.h"
+#include "StreamSource.h"
+
+using namespace StreamSourceNode;
+
+StreamSourceEditor::StreamSourceEditor (GenericProcessor* parentNode, StreamSource* source_)
+    : GenericEditor     (parentNode, false)
+    , host              ("127.0.0.1")
+    , sharedMemoryName  ("open-ephys-stream")
+    , source            (source_)
+{
+    desiredWidth = 180;
+
+    transportSelector = new ComboBox ("Transport");
+    transportSelector->addItem ("TCP", 1);
+    transportSelector->addItem ("Shared memory", 2);
+    transportSelector->setSelectedId (1, dontSendNotification);
+    transportSelector->setBounds (10, 30, 160, 20);
+    transportSelector->addListener (this);
+    addAndMakeVisible (transportSelector);
+
+    addressLabel = new Label ("Address", "Host");
+    addressLabel->setFont (Font ("Small Text", 10, Font::plain));
+    addressLabel->setBounds (10, 55, 100, 10);
+    addressLabel->setColour (Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible (addressLabel);
+
+    addressText = new TextEditor ("Address");
+    addressText->setFont (Font ("Small Text", 10, Font::plain));
+    addressText->setText (host);
+    addressText->setBounds (10, 67, 105, 18);
+    addAndMakeVisible (addressText);
+
+    portLabel = new Label ("Port", "Port");
+    portLabel->setFont (Font ("Small Text", 10, Font::plain));
+    portLabel->setBounds (120, 55, 50, 10);
+    portLabel->setColour (Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible (portLabel);
+
+    portText = new TextEditor ("Port");
+    portText->setFont (Font ("Small Text", 10, Font::plain));
+    portText->setText ("5001");
+    portText->setBounds (120, 67, 50, 18);
+    addAndMakeVisible (portText);
+
+    connectButton = new UtilityButton ("CONNECT", Font ("Small Text", 13, Font::bold));
+    connectButton->setRadius (3.0f);
+    connectButton->setBounds (10, 92, 70, 20);
+    connectButton->addListener (this);
+    addAndMakeVisible (connectButton);
+
+    statusLabel = new Label ("Status", source->getFormatDescription());
+    statusLabel->setFont (Font ("Small Text", 10, Font::plain));
+    statusLabel->setBounds (5, 115, 170, 15);
+    statusLabel->setColour (Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible (statusLabel);
+}
+
+
+void StreamSourceEditor::buttonEvent (Button* button)
+{
+    if (button == connectButton)
+    {
+        connect();
+    }
+}
+
+
+void StreamSourceEditor::comboBoxChanged (ComboBox* comboBox)
+{
+    if (comboBox == transportSelector)
+    {
+        // keep what was typed for the transport that was selected before
+        if (transportSelector->getSelectedId() == 1)
+            sharedMemoryName = addressText->getText();
+        else
+            host = addressText->getText();
+
+        updateAddressFields();
+    }
+}
+
+
+void StreamSourceEditor::updateAddressFields()
+{
+    const bool useSocket = transportSelector->getSelectedId() == 1;
+
+    addressLabel->setText (useSocket ? "Host" : "Name", dontSendNotification);
+    addressText->setText (useSocket ? host : sharedMemoryName);
+    portText->setEnabled (useSocket);
+}
+
+
+void StreamSourceEditor::connect()
+{
+    if (transportSelector->getSelectedId() == 1)
+    {
+        host = addressText->getText();
+        source->connectToSocket (host, portText->getText().getIntValue());
+    }
+    else
+    {
+        sharedMemoryName = addressText->getText();
+        source->connectToSharedMemory (sharedMemoryName);
+    }
+
+    statusLabel->setText (source->getFormatDescription(), dontSendNotification);
+
+    CoreServices::updateSignalChain (this);
+}
+
+
+void StreamSourceEditor::startAcquisition()
+{
+    transportSelector->setEnabled (false);
+    addressText->setEnabled (false);
+    portText->setEnabled (false);
+    connectButton->setEnabled (false);
+}
+
+
+void StreamSourceEditor::stopAcquisition()
+{
+    transportSelector->setEnabled (true);
+    addressText->setEnabled (true);
+    portText->setEnabled (transportSelector->getSelectedId() == 1);
+    connectButton->setEnabled (true);
+
+    // the producer may have gone away during acquisition
+    statusLabel->setText (source->getFormatDescription(), dontSendNotification);
+}
+
+
+void StreamSourceEditor::saveCustomParameters (XmlElement* xml)
+{
+    XmlElement* parameters = xml->createNewChildElement ("PARAMETERS");
+
+    if (transportSelector->getSelectedId() == 1)
+        host = addressText->getText();
+    else
+        sharedMemoryName = addressText->getText();
+
+    parameters->setAttribute ("transport", transportSelector->getSelectedId());
+    parameters->setAttribute ("host", host);
+    parameters->setAttribute ("port", portText->getText());
+    parameters->setAttribute ("name", sharedMemoryName);
+}
+
+
+void StreamSourceEditor::loadCustomParameters (XmlElement* xml)
+{
+    forEachXmlChildElement (*xml, xmlNode)
+    {
+        if (xmlNode->hasTagName ("PARAMETERS"))
+        {
+            host = xmlNode->getStringAttribute ("host", host);
+            sharedMemoryName = xmlNode->getStringAttribute ("name", sharedMemoryName);
+            portText->setText (xmlNode->getStringAttribute ("port", portText->getText()));
+            transportSelector->setSelectedId (xmlNode->getIntAttribute ("transport", 1), dontSendNotification);
+
+            updateAddressFields();
+
+            // the channels depend on the stream format, so try to reconnect straight away
+            connect();
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __STREAMSOURCEEDITOR_H__
+#define __STREAMSOURCEEDITOR_H__
+
+#include <EditorHeaders.h>
+
+namespace StreamSourceNode
+{
+    class StreamSource;
+
+    /**
+        Chooses where a StreamSource reads from, and shows the format of the
+        stream it is connected to.
+
+        @see StreamSource
+    */
+    class StreamSourceEditor : public GenericEditor,
+                               public ComboBox::Listener
+    {
+    public:
+        StreamSourceEditor (GenericProcessor* parentNode, StreamSource* source);
+
+        /** Connects to the selected producer, and updates the signal chain to its channels */
+        void buttonEvent (Button* button) override;
+
+        void comboBoxChanged (ComboBox* comboBox) override;
+
+        void startAcquisition() override;
+        void stopAcquisition() override;
+
+        void saveCustomParameters (XmlElement* xml) override;
+        void loadCustomParameters (XmlElement* xml) override;
+
+    private:
+        void connect();
+        void updateAddressFields();
+
+        ScopedPointer<ComboBox> transportSelector;
+
+        ScopedPointer<Label> addressLabel;
+        ScopedPointer<TextEditor> addressText;
+
+        ScopedPointer<Label> portLabel;
+        ScopedPointer<TextEditor> portText;
+
+        ScopedPointer<UtilityButton> connectButton;
+        ScopedPointer<Label> statusLabel;
+
+        String host;
+        String sharedMemoryName;
+
+        StreamSource* source;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StreamSourceEditor);
+    };
+}
+
+#endif
@@ -0,0 +1,132 @@
+"""
+    Sends a synthetic continuous stream to a NetworkDataThread (e.g. the
+    EphysSocket plugin) over UDP, to try it out or to measure its throughput.
+
+    Each packet starts with a NetworkPacketHeader unless --no-header is given,
+    in which case the legacy EphysSocket layout is sent: unsigned samples, all
+    samples of one channel after another.
+"""
+
+from __future__ import print_function
+
+import argparse
+import array
+import math
+import random
+import socket
+import struct
+import sys
+import time
+
+PACKET_MAGIC = 0x504e454f
+HEADER_FORMAT = '<IIQHHHH'
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+
+CHANNEL_MAJOR = 1
+UNSIGNED_SAMPLES = 2
+
+
+def make_period(num_channels, period):
+    """One period of a sine per channel, channel after channel, as unsigned samples"""
+    samples = array.array('H')
+    for chan in range(num_channels):
+        amplitude = 1000 + 100 * chan
+        for i in range(period):
+            samples.append(32768 + int(amplitude * math.sin(2 * math.pi * i / period)))
+    return samples
+
+
+def make_packets(args):
+    """Returns the payload of every packet in one period, as bytes"""
+    period = args.samples * max(1, int(args.rate / args.samples / 10))  # ~10 Hz
+    data = make_period(args.channels, period)
+    payloads = []
+    for start in range(0, period, args.samples):
+        packet = array.array('H')
+        for chan in range(args.channels):
+            offset = chan * period + start
+            packet.extend(data[offset:offset + args.samples])
+        if sys.byteorder != 'little':
+            packet.byteswap()
+        payloads.append(packet.tostring() if sys.version_info[0] < 3 else packet.tobytes())
+    return payloads
+
+
+def run(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    address = (args.host, args.port)
+
+    payloads = make_packets(args)
+    flags = CHANNEL_MAJOR | UNSIGNED_SAMPLES
+    packet_interval = float(args.samples) / args.rate
+
+    sequence = 0
+    sent = dropped = reordered = 0
+    held = None
+    start = time.time()
+    next_time = start
+
+    while args.packets <= 0 or sequence < args.packets:
+        payload = payloads[sequence % len(payloads)]
+        if args.no_header:
+            packet = payload
+        else:
+            header = struct.pack(HEADER_FORMAT, PACKET_MAGIC, sequence & 0xffffffff,
+                                 sequence * args.samples, args.channels, args.samples,
+                                 flags, HEADER_SIZE)
+            packet = header + payload
+        sequence += 1
+
+        if random.random() < args.drop:
+            dropped += 1
+        elif held is None and random.random() < args.reorder:
+            held = packet
+            reordered += 1
+        else:
+            sock.sendto(packet, address)
+            sent += 1
+            if held is not None:
+                sock.sendto(held, address)
+                sent += 1
+                held = None
+
+        if not args.benchmark:
+            next_time += packet_interval
+            delay = next_time - time.time()
+            if delay > 0:
+                time.sleep(delay)
+
+    elapsed = time.time() - start
+    samples = sequence * args.samples
+    print('%d packets sent, %d dropped, %d reordered in %.2f s' % (sent, dropped, reordered, elapsed))
+    print('%.0f samples/s (%.1f x real time), %.1f MB/s' % (
+        samples / elapsed, samples / elapsed / args.rate,
+        samples * args.channels * 2 / elapsed / 1e6))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--host', default='127.0.0.1')
+    parser.add_argument('--port', type=int, default=5000)
+    parser.add_argument('--channels', type=int, default=64)
+    parser.add_argument('--samples', type=int, default=250, help='samples per packet')
+    parser.add_argument('--rate', type=float, default=30000., help='sample rate in Hz')
+    parser.add_argument('--packets', type=int, default=0, help='packets to send, 0 to run until interrupted')
+    parser.add_argument('--drop', type=float, default=0., help='fraction of packets not sent')
+    parser.add_argument('--reorder', type=float, default=0., help='fraction of packets sent after their successor')
+    parser.add_argument('--no-header', action='store_true', help='send the legacy headerless layout')
+    parser.add_argument('--benchmark', action='store_true', help='send as fast as possible')
+    args = parser.parse_args()
+
+    if args.channels * args.samples * 2 + HEADER_SIZE > 65507:
+        parser.error('packets must fit in a UDP datagram')
+
+    try:
+        run(args)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,162 @@
+"""
+    Streams synthetic data to the Stream Source plugin, over TCP or through a
+    POSIX shared-memory ring (Python 3.8 or later), to show the wire format
+    described in Plugins/StreamSource/StreamFormat.h.
+
+    TCP:            python stream_source_producer.py tcp --port 5001
+    Shared memory:  python stream_source_producer.py shm --name open-ephys-stream
+"""
+
+import argparse
+import array
+import math
+import socket
+import struct
+import sys
+import time
+
+FORMAT_MAGIC = 0x46534f45
+BLOCK_MAGIC = 0x42534f45
+RING_MAGIC = 0x52534f45
+RING_HEADER_SIZE = 256
+
+INT16, FLOAT32 = 0, 1
+INTERLEAVED, PLANAR = 0, 1
+
+FORMAT_STRUCT = struct.Struct('<IHHBBHff12x')
+BLOCK_STRUCT = struct.Struct('<IIq')
+
+
+def stream_format(args):
+    sample_type = FLOAT32 if args.float32 else INT16
+    layout = PLANAR if args.planar else INTERLEAVED
+    return FORMAT_STRUCT.pack(FORMAT_MAGIC, FORMAT_STRUCT.size, args.channels,
+                              sample_type, layout, args.ttl_lines,
+                              args.rate, args.bit_volts)
+
+
+def block_payloads(args):
+    """Samples and TTL words of every block in one 10 Hz period, as bytes"""
+    period = args.samples * max(1, int(round(args.rate / args.samples / 10)))
+    typecode = 'f' if args.float32 else 'h'
+    scale = 1.0 if args.float32 else 1.0 / args.bit_volts
+    payloads = []
+    for start in range(0, period, args.samples):
+        values = array.array(typecode)
+        for index in range(args.channels * args.samples):
+            if args.planar:
+                chan, sample = divmod(index, args.samples)
+            else:
+                sample, chan = divmod(index, args.channels)
+            value = (100 + 10 * chan) * math.sin(2 * math.pi * (start + sample) / period) * scale
+            values.append(value if args.float32 else int(value))
+        ttl = array.array('Q')
+        if args.ttl_lines > 0:
+            ttl.extend(1 if start + sample < period // 2 else 0 for sample in range(args.samples))
+        if sys.byteorder != 'little':
+            values.byteswap()
+            ttl.byteswap()
+        payloads.append(values.tobytes() + ttl.tobytes())
+    return payloads
+
+
+def blocks(args):
+    """Yields (timestamp, block bytes) forever"""
+    payloads = block_payloads(args)
+    timestamp = 0
+    while True:
+        payload = payloads[(timestamp // args.samples) % len(payloads)]
+        yield timestamp, BLOCK_STRUCT.pack(BLOCK_MAGIC, args.samples, timestamp) + payload
+        timestamp += args.samples
+
+
+def paced(args):
+    start = time.time()
+    for timestamp, data in blocks(args):
+        delay = start + timestamp / args.rate - time.time()
+        if delay > 0:
+            time.sleep(delay)
+        yield data
+
+
+def run_tcp(args):
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(('127.0.0.1', args.port))
+    server.listen(1)
+    print('Waiting for the GUI on port %d' % args.port)
+    while True:
+        connection, address = server.accept()
+        print('Streaming to', address)
+        try:
+            connection.sendall(stream_format(args))
+            for data in paced(args):
+                connection.sendall(data)
+        except (socket.error, IOError):
+            print('Connection closed')
+        connection.close()
+
+
+def run_shm(args):
+    from multiprocessing import shared_memory
+
+    memory = shared_memory.SharedMemory(name=args.name, create=True, size=RING_HEADER_SIZE + args.capacity)
+    ring = memory.buf
+    struct.pack_into('<IIQqq', ring, 0, 0, 0, args.capacity, 0, 0)
+    struct.pack_into('<I', ring, 0, RING_MAGIC)
+    data_area = ring[RING_HEADER_SIZE:]
+
+    def write(data):
+        written = 0
+        while written < len(data):
+            write_position, read_position = struct.unpack_from('<qq', ring, 16)
+            free = args.capacity - (write_position - read_position)
+            if free == 0:
+                time.sleep(0.001)  # never overwrite what the GUI has not read
+                continue
+            offset = write_position % args.capacity
+            count = min(len(data) - written, free, args.capacity - offset)
+            data_area[offset:offset + count] = data[written:written + count]
+            struct.pack_into('<q', ring, 16, write_position + count)
+            written += count
+
+    print('Streaming to shared memory "%s"' % args.name)
+    try:
+        write(stream_format(args))
+        for data in paced(args):
+            write(data)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        del data_area, ring
+        memory.close()
+        memory.unlink()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('transport', choices=['tcp', 'shm'])
+    parser.add_argument('--port', type=int, default=5001)
+    parser.add_argument('--name', default='open-ephys-stream', help='shared memory name')
+    parser.add_argument('--capacity', type=int, default=16 * 1024 * 1024, help='shared memory ring size in bytes')
+    parser.add_argument('--channels', type=int, default=64)
+    parser.add_argument('--samples', type=int, default=300, help='samples per block')
+    parser.add_argument('--rate', type=float, default=30000.)
+    parser.add_argument('--bit-volts', type=float, default=0.195)
+    parser.add_argument('--ttl-lines', type=int, default=1)
+    parser.add_argument('--float32', action='store_true', help='send float32 samples instead of int16')
+    parser.add_argument('--planar', action='store_true', help='send one channel after another')
+    args = parser.parse_args()
+
+    try:
+        if args.transport == 'tcp':
+            run_tcp(args)
+        else:
+            run_shm(args)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
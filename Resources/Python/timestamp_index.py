@@ -0,0 +1,199 @@
+"""
+    Reads the compact timestamp index of a continuous stream recorded in the
+    Binary format with compact timestamps, checks it and expands it.
+
+    timestamps_index.npy holds runs (sample_number, timestamp, length) of
+    samples whose timestamps advance by one. synchronized_timestamps_index.npy
+    holds linear segments (sample_number, length, start_time, sample_period).
+    Given the stream folder, this prints a summary of both files, checks that
+    the runs and segments cover every sample once, and with --expand writes the
+    per-sample timestamps.npy and synchronized_timestamps.npy they stand for.
+    With --compare, the expanded timestamps are checked against per-sample
+    files recorded without the compact option.
+
+    Only the Python standard library is needed.
+"""
+
+from __future__ import print_function
+
+import argparse
+import array
+import ast
+import os
+import struct
+import sys
+
+NPY_MAGIC = b'\x93NUMPY'
+NPY_TYPES = {'<i8': ('q', 8), '<f8': ('d', 8)}
+
+RUN_FILE = 'timestamps_index.npy'
+SEGMENT_FILE = 'synchronized_timestamps_index.npy'
+TIMESTAMP_FILE = 'timestamps.npy'
+SYNC_TIMESTAMP_FILE = 'synchronized_timestamps.npy'
+
+
+def read_npy(path):
+    """Returns the records of a little-endian .npy file as a list of dicts, or of
+    plain values for a file without fields"""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if data[:6] != NPY_MAGIC:
+        raise ValueError('%s is not a .npy file' % path)
+
+    if bytearray(data[6:7])[0] == 1:
+        header_len = struct.unpack('<H', data[8:10])[0]
+        offset = 10
+    else:
+        header_len = struct.unpack('<I', data[8:12])[0]
+        offset = 12
+    header = ast.literal_eval(data[offset:offset + header_len].decode('latin1'))
+    offset += header_len
+
+    descr = header['descr']
+    if isinstance(descr, str):
+        fields = None
+        fmt, size = NPY_TYPES[descr]
+    else:
+        fields = []
+        fmt = '<'
+        size = 0
+        for field in descr:
+            count = field[2][0] if len(field) > 2 else 1
+            code, item_size = NPY_TYPES[field[1]]
+            fields.append((field[0], count))
+            fmt += code * count
+            size += item_size * count
+    if not fmt.startswith('<'):
+        fmt = '<' + fmt
+
+    num_records = header['shape'][0]
+    if offset + num_records * size > len(data):
+        raise ValueError('%s is shorter than its header says' % path)
+
+    records = []
+    for n in range(num_records):
+        values = struct.unpack_from(fmt, data, offset + n * size)
+        if fields is None:
+            records.append(values[0])
+            continue
+        record = {}
+        i = 0
+        for name, count in fields:
+            record[name] = values[i] if count == 1 else values[i:i + count]
+            i += count
+        records.append(record)
+    return records
+
+
+def write_npy(path, typecode, values):
+    """Writes a one-dimensional little-endian .npy file"""
+    descr = '<i8' if typecode == 'q' else '<f8'
+    header = "{'descr': '%s', 'fortran_order': False, 'shape': (%d,), }" % (descr, len(values))
+    padding = 64 - (10 + len(header) + 1) % 64
+    header += ' ' * padding + '\n'
+
+    data = array.array(typecode, values)
+    if sys.byteorder != 'little':
+        data.byteswap()
+
+    with open(path, 'wb') as f:
+        f.write(NPY_MAGIC + b'\x01\x00' + struct.pack('<H', len(header)) + header.encode('latin1'))
+        f.write(data.tobytes())
+
+
+def check_cover(records, name):
+    """Checks that the records cover consecutive samples from 0, and returns the sample count"""
+    errors = 0
+    next_sample = 0
+    for i, r in enumerate(records):
+        if r['length'] <= 0:
+            print('%s: record %d has length %d' % (name, i, r['length']))
+            errors += 1
+        if r['sample_number'] != next_sample:
+            print('%s: record %d starts at sample %d, expected %d' % (name, i, r['sample_number'], next_sample))
+            errors += 1
+        next_sample = r['sample_number'] + r['length']
+    return next_sample, errors
+
+
+def expand_runs(runs):
+    timestamps = []
+    for r in runs:
+        timestamps.extend(range(r['timestamp'], r['timestamp'] + r['length']))
+    return timestamps
+
+
+def expand_segments(segments):
+    times = []
+    for s in segments:
+        times.extend(s['start_time'] + k * s['sample_period'] for k in range(s['length']))
+    return times
+
+
+def run(args):
+    folder = args.folder
+    errors = 0
+
+    runs = read_npy(os.path.join(folder, RUN_FILE))
+    num_samples, run_errors = check_cover(runs, RUN_FILE)
+    errors += run_errors
+    gaps = sum(1 for a, b in zip(runs, runs[1:]) if b['timestamp'] != a['timestamp'] + a['length'])
+    print('%s: %d runs, %d samples, %d timestamp gaps' % (RUN_FILE, len(runs), num_samples, gaps))
+
+    segments = None
+    segment_path = os.path.join(folder, SEGMENT_FILE)
+    if os.path.exists(segment_path):
+        segments = read_npy(segment_path)
+        num_synced, segment_errors = check_cover(segments, SEGMENT_FILE)
+        errors += segment_errors
+        print('%s: %d segments, %d samples' % (SEGMENT_FILE, len(segments), num_synced))
+        if num_synced != num_samples:
+            print('the two index files cover %d and %d samples' % (num_samples, num_synced))
+            errors += 1
+
+    timestamps = expand_runs(runs)
+    times = expand_segments(segments) if segments is not None else None
+
+    if args.compare:
+        recorded = read_npy(os.path.join(args.compare, TIMESTAMP_FILE))
+        mismatches = sum(1 for a, b in zip(timestamps, recorded) if a != b) + abs(len(timestamps) - len(recorded))
+        print('%s: %d samples differ from %s' % (TIMESTAMP_FILE, mismatches, args.compare))
+        errors += mismatches != 0
+
+        sync_path = os.path.join(args.compare, SYNC_TIMESTAMP_FILE)
+        if times is not None and os.path.exists(sync_path):
+            recorded = read_npy(sync_path)
+            worst = max([abs(a - b) for a, b in zip(times, recorded)] or [0.])
+            print('%s: largest difference %g s' % (SYNC_TIMESTAMP_FILE, worst))
+
+    if args.expand:
+        if not os.path.isdir(args.expand):
+            os.makedirs(args.expand)
+        write_npy(os.path.join(args.expand, TIMESTAMP_FILE), 'q', timestamps)
+        if times is not None:
+            write_npy(os.path.join(args.expand, SYNC_TIMESTAMP_FILE), 'd', times)
+        print('per-sample timestamps written to %s' % args.expand)
+
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('folder', help='continuous stream folder holding ' + RUN_FILE)
+    parser.add_argument('--expand', metavar='DIR', help='write the per-sample timestamp files to DIR')
+    parser.add_argument('--compare', metavar='DIR', help='folder with per-sample timestamp files to compare with')
+    args = parser.parse_args()
+
+    try:
+        errors = run(args)
+    except (IOError, OSError, ValueError, KeyError) as e:
+        print(e)
+        sys.exit(2)
+
+    sys.exit(1 if errors else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -27,8 +27,8 @@
 AudioResamplingNode::AudioResamplingNode()
     : GenericProcessor("Resampling Node"),
       sourceBufferSampleRate(40000.0), destBufferSampleRate(44100.0),
-      ratio(1.0), lastRatio(1.0), destBuffer(0), tempBuffer(0),
-      destBufferIsTempBuffer(true), isTransmitting(false), destBufferPos(0)
+      ratio(1.0), lastRatio(1.0), maxBlockSize(4096), destBuffer(0), tempBuffer(0),
+      destBufferIsTempBuffer(true), isTransmitting(false), destBufferPos(0), tempBufferPos(0)
 {
 
     settings.numInputs = 2;
@@ -39,9 +39,6 @@ AudioResamplingNode::AudioResamplingNode()
                          44100.0, // sampleRate
                          128);    // blockSize
 
-    filter = new Dsp::SmoothedFilterDesign
-    <Dsp::RBJ::Design::LowPass, 1> (1024);
-
     if (destBufferIsTempBuffer)
         destBufferWidth = 1024;
     else
@@ -61,7 +58,6 @@ AudioResamplingNode::~AudioResamplingNode()
     delete[] continuousDataBuffer;
     deleteAndZero(tempBuffer);
     deleteAndZero(destBuffer);
-    delete filter;
 }
 
 
@@ -96,7 +92,6 @@ void AudioResamplingNode::prepareToPlay(double sampleRate_, int estimatedSamples
     if (destBufferIsTempBuffer)
     {
         destBufferSampleRate = sampleRate_;
-        tempBuffer->setSize(getNumInputs(), 4096);
     }
     else
     {
@@ -104,154 +99,107 @@ void AudioResamplingNode::prepareToPlay(double sampleRate_, int estimatedSamples
         destBuffer->setSize(getNumInputs(), destBufferWidth);
     }
 
+    if (const DataChannel* chan = getDataChannel(0))
+        sourceBufferSampleRate = chan->getSampleRate();
+
+    maxBlockSize = jmax(4096, estimatedSamplesPerBlock);
+
     destBuffer->clear();
-    tempBuffer->clear();
 
     destBufferPos = 0;
 
-    // std::cout << "Temp buffer size: " << tempBuffer->getNumChannels() << " x "
-    //           << tempBuffer->getNumSamples() << std::endl;
+    ratio = sourceBufferSampleRate / destBufferSampleRate;
+    lastRatio = ratio;
 
-    updateFilter();
+    updateResampler();
 
 }
 
-void AudioResamplingNode::updateFilter()
+void AudioResamplingNode::updateResampler()
 {
 
-    double cutoffFreq = (ratio > 1.0) ? 2 * destBufferSampleRate  // downsample
-                        : destBufferSampleRate / 2; // upsample
-
-    double sampleFreq = (ratio > 1.0) ? sourceBufferSampleRate // downsample
-                        : destBufferSampleRate;  // upsample
-
-    Dsp::Params params;
-    params[0] = sampleFreq; // sample rate
-    params[1] = cutoffFreq; // cutoff frequency
-    params[2] = 1.25; //Q //
+    // the filter has its stopband at the lower of the two Nyquist frequencies,
+    // so the same design serves for upsampling and downsampling
+    resampler.setup(jmax(1, getNumInputs()), sourceBufferSampleRate, destBufferSampleRate, maxBlockSize);
 
-    filter->setParams(params);
-
-}
+    // room for the output of a full block on top of samples carried over from the last one
+    tempBuffer->setSize(resampler.getNumChannels(), resampler.getMaxOutputSamples(maxBlockSize) + maxBlockSize);
+    tempBuffer->clear();
+    tempBufferPos = 0;
 
-void AudioResamplingNode::releaseResources()
-{
+    inputPointers.malloc(resampler.getNumChannels());
+    outputPointers.malloc(resampler.getNumChannels());
 
 }
 
-void AudioResamplingNode::process(AudioSampleBuffer& buffer,
-                                  MidiBuffer& midiMessages)
+void AudioResamplingNode::discardTempSamples(int numSamples)
 {
 
-    int nSamps = buffer.getNumSamples(); // WRONG!!!!
-    int valuesNeeded;
+    const int remaining = tempBufferPos - numSamples;
 
-    if (destBufferIsTempBuffer)
+    for (int channel = 0; channel < tempBuffer->getNumChannels() && remaining > 0; channel++)
     {
-        ratio = float(nSamps) / float(buffer.getNumSamples());
-        valuesNeeded = buffer.getNumSamples();
-    }
-    else
-    {
-        ratio = sourceBufferSampleRate / destBufferSampleRate;
-        valuesNeeded = (int) buffer.getNumSamples() / ratio;
-        //std::cout << std::endl;
-        //std::cout << "Ratio: " << ratio << std::endl;
-        //std::cout << "Values needed: " << valuesNeeded << std::endl;
+        float* data = tempBuffer->getWritePointer(channel);
+        memmove(data, data + numSamples, remaining * sizeof(float));
     }
 
+    tempBufferPos = jmax(0, remaining);
 
+}
 
-    if (lastRatio != ratio)
-    {
-        updateFilter();
-        lastRatio = ratio;
-    }
-
+void AudioResamplingNode::releaseResources()
+{
 
-    if (ratio > 1.0001)
-    {
-        // pre-apply filter before downsampling
-        filter->process(nSamps, buffer.getArrayOfWritePointers());
-    }
+}
 
+void AudioResamplingNode::process(AudioSampleBuffer& buffer)
+{
 
-    // initialize variables
-    tempBuffer->clear();
-    int sourceBufferPos = 0;
-    int sourceBufferSize = buffer.getNumSamples();
-    float subSampleOffset = 0.0;
-    int nextPos = (sourceBufferPos + 1) % sourceBufferSize;
+    const int numChannels = jmin(buffer.getNumChannels(), resampler.getNumChannels());
 
-    int tempBufferPos;
-    //int totalSamples = 0;
+    if (getNumInputs() <= 0 || numChannels <= 0)
+        return;
 
-    // code modified from "juce_ResamplingAudioSource.cpp":
+    // only the samples delivered this block hold data, the rest of the buffer is stale
+    int nSamps = jmin((int) getNumSamples(0), buffer.getNumSamples());
 
-    for (tempBufferPos = 0; tempBufferPos < valuesNeeded; tempBufferPos++)
+    // the rates only change in prepareToPlay, which sizes the buffers; larger blocks
+    // are resampled in pieces so nothing is allocated here
+    for (int done = 0; done < nSamps;)
     {
-        float gain = 1.0;
-        float alpha = (float) subSampleOffset;
-        float invAlpha = 1.0f - alpha;
+        const int n = jmin(maxBlockSize, nSamps - done);
+        const int valuesNeeded = resampler.getMaxOutputSamples(n);
 
-        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        if (tempBufferPos + valuesNeeded > tempBuffer->getNumSamples())
         {
-
-            tempBuffer->addFrom(channel, 		// destChannel
-                                tempBufferPos,  // destSampleOffset
-                                buffer,			// source
-                                channel,		// sourceChannel
-                                sourceBufferPos,// sourceSampleOffset
-                                1,				// number of samples
-                                invAlpha*gain);      // gain to apply to source
-
-            tempBuffer->addFrom(channel, 		// destChannel
-                                tempBufferPos,   // destSampleOffset
-                                buffer,			// source
-                                channel,			// sourceChannel
-                                nextPos,		 	// sourceSampleOffset
-                                1,				// number of samples
-                                alpha*gain);     	 // gain to apply to source
-
+            // the output has fallen a whole block behind, which the rates rule out
+            jassertfalse;
+            discardTempSamples(tempBufferPos + valuesNeeded - tempBuffer->getNumSamples());
         }
 
-        subSampleOffset += ratio;
-
-
-
-        while (subSampleOffset >= 1.0)
+        for (int channel = 0; channel < resampler.getNumChannels(); channel++)
         {
-            if (++sourceBufferPos >= sourceBufferSize)
-                sourceBufferPos = 0;
-
-            nextPos = (sourceBufferPos + 1) % sourceBufferSize;
-            subSampleOffset -= 1.0;
+            inputPointers[channel] = buffer.getReadPointer(jmin(channel, numChannels - 1), done);
+            outputPointers[channel] = tempBuffer->getWritePointer(channel, tempBufferPos);
         }
-    }
-
-    // std::cout << sourceBufferPos << " " << tempBufferPos << std::endl;
-
-
-    if (ratio < 0.9999)
-    {
-
-        filter->process(tempBufferPos, tempBuffer->getArrayOfWritePointers());
-        // apply the filter after upsampling
-        ///////filter->process (totalSamples, buffer.getArrayOfChannels());
-    }
-    else if (ratio <= 1.0001)
-    {
-
-        // no resampling is being applied, no need to filter, BUT...
-        // keep the filter stoked with samples to avoid discontinuities
 
+        tempBufferPos += resampler.process(inputPointers, n, outputPointers);
+        done += n;
     }
 
     if (destBufferIsTempBuffer)
     {
 
-        // copy the temp buffer into the original buffer
-        buffer = AudioSampleBuffer(tempBuffer->getArrayOfWritePointers(), 2, tempBufferPos);//buffer.getNumSamples());
+        // hand on what fits in this block; the rest waits in the temp buffer for the next one
+        const int numOut = jmin(tempBufferPos, buffer.getNumSamples());
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            buffer.copyFrom(channel, 0, *tempBuffer, channel, 0, numOut);
+            buffer.clear(channel, numOut, buffer.getNumSamples() - numOut);
+        }
+
+        discardTempSamples(numOut);
 
     }
     else
@@ -261,16 +209,13 @@ void AudioResamplingNode::process(AudioSampleBuffer& buffer,
 
         // copy the temp buffer into the destination buffer
 
-        int pos = 0;
-
-        while (*tempBuffer->getWritePointer(0,pos) != 0)
-            pos++;
+        int pos = jmin(tempBufferPos, destBufferWidth);
 
         int spaceAvailable = destBufferWidth - destBufferPos;
         int blockSize1 = (spaceAvailable > pos) ? pos : spaceAvailable;
         int blockSize2 = (spaceAvailable > pos) ? 0 : (pos - spaceAvailable);
 
-        for (int channel = 0; channel < destBuffer->getNumChannels(); channel++)
+        for (int channel = 0; channel < jmin(numChannels, destBuffer->getNumChannels()); channel++)
         {
 
             // copy first block
@@ -293,13 +238,10 @@ void AudioResamplingNode::process(AudioSampleBuffer& buffer,
 
         }
 
-        //destBufferPos = (spaceAvailable > tempBufferPos) ? destBufferPos
-
         destBufferPos += pos;
         destBufferPos %= destBufferWidth;
 
-        //std::cout << "Temp buffer position: " << tempBufferPos << std::endl;
-        //std::cout << "Resampling node value:" << *destBuffer->getReadPointer(0,0) << std::endl;
+        tempBufferPos = 0;
 
     }
 
@@ -25,21 +25,19 @@
 #define __AUDIORESAMPLINGNODE_H_CFAB182E__
 
 #include "../../../JuceLibraryCode/JuceHeader.h"
-#include "../Dsp/Dsp.h"
 #include "../GenericProcessor/GenericProcessor.h"
+#include "PolyphaseResampler.h"
 
 /**
 
   Changes the sample rate of continuous data, specialized for increasing
   the sample rate to 44.1 kHz for audio output.
 
-  Code is based on Juce's ResamplingAudioSource class.
+  Resampling is done by a PolyphaseResampler that keeps its state across
+  blocks, and only the samples actually delivered for the block are read, so
+  blocks of varying length come out continuous and at the right pitch.
 
-  This processor could be vastly improved by implementing a scheme to handle
-  inputs that do not provide the same amount of samples in each buffer. At the
-  moment, the resampling process shifts the pitch of the incoming signal.
-
-  @see GenericProcessor
+  @see GenericProcessor, PolyphaseResampler
 
 */
 
@@ -55,12 +53,13 @@ public:
     {
         return destBuffer;
     }
-    void updateFilter();
+    /** Redesigns the resampler for the current source and destination rates */
+    void updateResampler();
 
-    void prepareToPlay(double sampleRate, int estimatedSamplesPerBlock);
-    void releaseResources();
-    void process(AudioSampleBuffer& buffer, MidiBuffer& midiMessages);
-    void setParameter(int parameterIndex, float newValue);
+    void prepareToPlay(double sampleRate, int estimatedSamplesPerBlock) override;
+    void releaseResources() override;
+    void process(AudioSampleBuffer& buffer) override;
+    void setParameter(int parameterIndex, float newValue) override;
 
     AudioSampleBuffer* getContinuousBuffer()
     {
@@ -75,9 +74,10 @@ private:
     double ratio, lastRatio;
     double destBufferTimebaseSecs;
     int destBufferWidth;
+    int maxBlockSize;
 
     // major objects:
-    Dsp::Filter* filter;
+    PolyphaseResampler resampler;
     AudioSampleBuffer* destBuffer;
     AudioSampleBuffer* tempBuffer;
 
@@ -87,6 +87,14 @@ private:
 
     // indexing objects that persist between rounds:
     int destBufferPos;
+    int tempBufferPos;  // resampled samples in tempBuffer not yet handed on
+
+    // channel pointers into the current piece of input and into tempBuffer
+    HeapBlock<const float*> inputPointers;
+    HeapBlock<float*> outputPointers;
+
+    /** Drops the oldest numSamples resampled samples from tempBuffer */
+    void discardTempSamples(int numSamples);
 
     // for testing purposes only:
     void writeContinuousBuffer(float*, int, int);
@@ -0,0 +1,243 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "PolyphaseResampler.h"
+
+#include <cmath>
+
+namespace
+{
+    // stopband attenuation of the prototype low-pass, in dB
+    const double stopbandAttenuation = 80.0;
+}
+
+PolyphaseResampler::PolyphaseResampler()
+    : numChannels(0), upFactor(1), downFactor(1), tapsPerPhase(1), maxBlockSize(0),
+      phase(0), inputPos(0)
+{
+}
+
+void PolyphaseResampler::setup(int numChannels_, double inputRate, double outputRate,
+                               int maxBlockSize_, int filterLength, int maxFactor)
+{
+    numChannels = jmax(1, numChannels_);
+    maxBlockSize = jmax(1, maxBlockSize_);
+
+    // rates are usually whole numbers, which reduce exactly
+    if (inputRate == std::floor(inputRate) && outputRate == std::floor(outputRate))
+    {
+        int64 a = (int64) outputRate, b = (int64) inputRate;
+        while (b != 0) { int64 t = a % b; a = b; b = t; }
+
+        upFactor = int(int64(outputRate) / a);
+        downFactor = int(int64(inputRate) / a);
+
+        if (upFactor > maxFactor || downFactor > maxFactor)
+            reduceRatio(outputRate / inputRate, maxFactor, upFactor, downFactor);
+    }
+    else
+    {
+        reduceRatio(outputRate / inputRate, maxFactor, upFactor, downFactor);
+    }
+
+    designFilter(jmax(4, filterLength));
+
+    history.malloc((tapsPerPhase - 1 + maxBlockSize) * numChannels);
+    frame.malloc(numChannels);
+
+    reset();
+}
+
+void PolyphaseResampler::reset()
+{
+    history.clear((tapsPerPhase - 1 + maxBlockSize) * numChannels);
+    phase = 0;
+    inputPos = 0;
+}
+
+int PolyphaseResampler::getNumChannels() const { return numChannels; }
+int PolyphaseResampler::getUpFactor() const { return upFactor; }
+int PolyphaseResampler::getDownFactor() const { return downFactor; }
+int PolyphaseResampler::getNumTapsPerPhase() const { return tapsPerPhase; }
+
+double PolyphaseResampler::getRatio() const
+{
+    return double(upFactor) / double(downFactor);
+}
+
+double PolyphaseResampler::getDelay() const
+{
+    return double(upFactor * tapsPerPhase - 1) / (2.0 * upFactor);
+}
+
+int PolyphaseResampler::getMaxOutputSamples(int numInputSamples) const
+{
+    return int((int64(numInputSamples) * upFactor) / downFactor) + 2;
+}
+
+int PolyphaseResampler::process(const float* const* input, int numInputSamples, float* const* output)
+{
+    int written = 0;
+
+    for (int offset = 0; offset < numInputSamples; offset += maxBlockSize)
+    {
+        const int n = jmin(maxBlockSize, numInputSamples - offset);
+        written += processChunk(input, offset, n, output, written);
+    }
+
+    return written;
+}
+
+int PolyphaseResampler::processChunk(const float* const* input, int inputOffset, int numInputSamples,
+                                     float* const* output, int outputOffset)
+{
+    const int keep = tapsPerPhase - 1;
+
+    // append the block, interleaved, after the samples kept from the last one
+    float* newest = history + keep * numChannels;
+
+    for (int c = 0; c < numChannels; c++)
+    {
+        const float* src = input[c] + inputOffset;
+
+        for (int i = 0; i < numInputSamples; i++)
+            newest[i * numChannels + c] = src[i];
+    }
+
+    int written = 0;
+
+    // output n sits at n * downFactor on the upsampled time axis; its phase picks the
+    // taps that meet input samples, the rest would multiply inserted zeros
+    while (inputPos < numInputSamples)
+    {
+        const float* taps = phaseTables + phase * tapsPerPhase;
+        const float* x = history + inputPos * numChannels;
+
+        FloatVectorOperations::clear(frame, numChannels);
+
+        for (int m = 0; m < tapsPerPhase; m++)
+            FloatVectorOperations::addWithMultiply(frame, x + m * numChannels, taps[m], numChannels);
+
+        for (int c = 0; c < numChannels; c++)
+            output[c][outputOffset + written] = frame[c];
+
+        written++;
+
+        phase += downFactor;
+        inputPos += phase / upFactor;
+        phase %= upFactor;
+    }
+
+    inputPos -= numInputSamples;
+
+    memmove(history, history + numInputSamples * numChannels, sizeof(float) * keep * numChannels);
+
+    return written;
+}
+
+void PolyphaseResampler::designFilter(int filterLength)
+{
+    const int factor = jmax(upFactor, downFactor);
+
+    // long enough to span filterLength samples of the lower rate
+    tapsPerPhase = (filterLength * factor + upFactor - 1) / upFactor;
+    const int numTaps = tapsPerPhase * upFactor;
+
+    // Kaiser's estimates for the window shape and the transition width it gives
+    const double beta = 0.1102 * (stopbandAttenuation - 8.7);
+    const double transition = (stopbandAttenuation - 7.95) / (14.36 * numTaps);
+
+    // end the transition band at the lower Nyquist frequency, so nothing aliases back
+    const double cutoff = jmax(0.25 / factor, 0.5 / factor - transition / 2.0);
+
+    const double centre = (numTaps - 1) / 2.0;
+    const double norm = besselI0(beta);
+
+    HeapBlock<double> prototype(numTaps);
+
+    for (int n = 0; n < numTaps; n++)
+    {
+        const double t = n - centre;
+        const double x = 2.0 * cutoff * t;
+        const double sinc = (t == 0.0) ? 1.0 : std::sin(double_Pi * x) / (double_Pi * x);
+
+        const double r = 2.0 * n / (numTaps - 1) - 1.0;
+        const double window = besselI0(beta * std::sqrt(jmax(0.0, 1.0 - r * r))) / norm;
+
+        // upFactor makes up for the zeros inserted between input samples
+        prototype[n] = upFactor * 2.0 * cutoff * sinc * window;
+    }
+
+    // tap m of a phase meets the input m samples after the oldest one it uses
+    phaseTables.malloc(numTaps);
+
+    for (int p = 0; p < upFactor; p++)
+        for (int m = 0; m < tapsPerPhase; m++)
+            phaseTables[p * tapsPerPhase + m] = float(prototype[p + (tapsPerPhase - 1 - m) * upFactor]);
+}
+
+void PolyphaseResampler::reduceRatio(double ratio, int maxFactor, int& up, int& down)
+{
+    // walk the continued fraction convergents of the ratio while they fit
+    int64 h0 = 0, h1 = 1, k0 = 1, k1 = 0;
+    double x = ratio;
+
+    for (int i = 0; i < 64; i++)
+    {
+        const double a = std::floor(x);
+        const int64 h2 = int64(a) * h1 + h0;
+        const int64 k2 = int64(a) * k1 + k0;
+
+        if (h2 > maxFactor || k2 > maxFactor)
+            break;
+
+        h0 = h1; h1 = h2;
+        k0 = k1; k1 = k2;
+
+        if (x - a < 1e-9)
+            break;
+
+        x = 1.0 / (x - a);
+    }
+
+    up = int(jmax(int64(1), h1));
+    down = int(jmax(int64(1), k1));
+}
+
+double PolyphaseResampler::besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    const double halfX = x / 2.0;
+
+    for (int k = 1; k < 50; k++)
+    {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+
+        if (term < sum * 1e-12)
+            break;
+    }
+
+    return sum;
+}
@@ -0,0 +1,118 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2013 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __POLYPHASERESAMPLER_H_3F1A9C2E__
+#define __POLYPHASERESAMPLER_H_3F1A9C2E__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+
+/**
+
+  Converts multichannel data between two sample rates with a polyphase FIR filter.
+
+  The rate ratio is reduced to upFactor / downFactor (approximated by the closest
+  fraction with both terms at most maxFactor, if needed). A single Kaiser-windowed
+  sinc low-pass, with its stopband starting at the lower of the two Nyquist
+  frequencies, is designed for the upsampled rate and split into upFactor phase
+  tables. Only the taps that meet non-zero input are ever evaluated, and input is
+  kept interleaved, so every tap is applied to all channels in one vector
+  operation.
+
+  The last input samples are kept between calls, so a stream can be fed block by
+  block without discontinuities. Output is delayed by getDelay() input samples.
+
+  @see AudioResamplingNode
+
+*/
+
+class PolyphaseResampler
+{
+public:
+    PolyphaseResampler();
+
+    /** Designs the filter and clears the history.
+
+        @param numChannels      channels processed together
+        @param inputRate        sample rate of the data passed to process()
+        @param outputRate       sample rate of the data it returns
+        @param maxBlockSize     largest block passed to process() in one go; larger
+                                blocks are split internally
+        @param filterLength     filter length in samples of the lower of the two
+                                rates; the transition band is about 5 / filterLength
+                                of that rate wide
+        @param maxFactor        upper bound on the reduced ratio's terms
+    */
+    void setup(int numChannels, double inputRate, double outputRate,
+               int maxBlockSize, int filterLength = 64, int maxFactor = 512);
+
+    /** Forgets previous input, as if the stream started again */
+    void reset();
+
+    int getNumChannels() const;
+    int getUpFactor() const;
+    int getDownFactor() const;
+    int getNumTapsPerPhase() const;
+
+    /** Ratio of output to input samples actually applied */
+    double getRatio() const;
+
+    /** Group delay of the filter, in input samples */
+    double getDelay() const;
+
+    /** Largest number of samples process() can return for numInputSamples */
+    int getMaxOutputSamples(int numInputSamples) const;
+
+    /** Resamples numInputSamples of each input channel and writes the result to the
+        output channels, which must hold getMaxOutputSamples(numInputSamples).
+        Returns the number of samples written to each channel. */
+    int process(const float* const* input, int numInputSamples, float* const* output);
+
+private:
+    int processChunk(const float* const* input, int inputOffset, int numInputSamples,
+                     float* const* output, int outputOffset);
+
+    void designFilter(int filterLength);
+
+    /** Closest fraction up / down to ratio with both terms at most maxFactor */
+    static void reduceRatio(double ratio, int maxFactor, int& up, int& down);
+
+    static double besselI0(double x);
+
+    int numChannels;
+    int upFactor;
+    int downFactor;
+    int tapsPerPhase;
+    int maxBlockSize;
+
+    HeapBlock<float> phaseTables;   // upFactor x tapsPerPhase, taps in input order
+    HeapBlock<float> history;       // (tapsPerPhase - 1 + maxBlockSize) x numChannels, interleaved
+    HeapBlock<float> frame;         // one output sample of every channel
+
+    int phase;          // phase of the next output sample, in [0, upFactor)
+    int inputPos;       // input sample, relative to the next block, where the next output starts
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolyphaseResampler);
+};
+
+
+#endif  // __POLYPHASERESAMPLER_H_3F1A9C2E__
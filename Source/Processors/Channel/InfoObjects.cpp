@@ -63,15 +63,24 @@ HistoryObject::~HistoryObject()
 
 String HistoryObject::getHistoricString() const
 {
-	return m_historicString;
+	Array<const HistoryEntry*> entries;
+	for (const HistoryEntry* e = m_history; e != nullptr; e = e->previous)
+		entries.add(e);
+
+	String historicString;
+	for (int i = entries.size() - 1; i >= 0; i--)
+	{
+		if (historicString.isEmpty())
+			historicString = entries[i]->entry;
+		else
+			historicString += (" -> " + entries[i]->entry);
+	}
+	return historicString;
 }
 
 void HistoryObject::addToHistoricString(String entry)
 {
-	if (m_historicString.isEmpty())
-		m_historicString = entry;
-	else
-		m_historicString += (" -> " + entry);
+	m_history = new HistoryEntry(entry, m_history);
 }
 
 //SourceProcessorInfo
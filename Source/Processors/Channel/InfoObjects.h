@@ -80,7 +80,15 @@ public:
 	void addToHistoricString(String entry);
 
 private:
-	String m_historicString;
+	/** Entries are shared between all the copies of a channel down the chain, each
+	processor only adds its own entry on top of the one it copied */
+	struct HistoryEntry : public ReferenceCountedObject
+	{
+		HistoryEntry(const String& e, HistoryEntry* p) : entry(e), previous(p) {}
+		const String entry;
+		const ReferenceCountedObjectPtr<HistoryEntry> previous;
+	};
+	ReferenceCountedObjectPtr<HistoryEntry> m_history;
 };
 
 class PLUGIN_API SourceProcessorInfo
@@ -176,6 +176,22 @@ typedef ReferenceCountedArray<MetaDataValue,CriticalSection> MetaDataValueArray;
 typedef ReferenceCountedObjectPtr<MetaDataDescriptor> MetaDataDescriptorPtr;
 typedef ReferenceCountedObjectPtr<MetaDataValue> MetaDataValuePtr;
 
+/** Metadata list shared by all the copies of an info object down the signal chain.
+Copying an info object only takes a new reference to it; a processor adding
+metadata to its copy clones the list first, so the other copies never see the change.*/
+class PLUGIN_API MetaDataSet : public ReferenceCountedObject
+{
+public:
+	MetaDataDescriptorArray descriptors;
+	MetaDataValueArray values;
+	size_t totalSize{ 0 };
+	size_t maxSize{ 0 };
+
+	typedef ReferenceCountedObjectPtr<MetaDataSet> Ptr;
+	/** Returns a set that can be modified without affecting other owners of set, creating or cloning it if needed */
+	static MetaDataSet* getWritable(Ptr& set);
+};
+
 //Inherited for all info objects that have metadata
 class PLUGIN_API MetaDataInfoObject
 {
@@ -192,8 +208,7 @@ public:
 	bool hasSameMetadata(const MetaDataInfoObject& other) const;
 	bool hasSimilarMetadata(const MetaDataInfoObject& other) const;
 protected:
-	MetaDataDescriptorArray m_metaDataDescriptorArray;
-	MetaDataValueArray m_metaDataValueArray;
+	MetaDataSet::Ptr m_metaData;
 private:
 	bool checkMetaDataCoincidence(const MetaDataInfoObject& other, bool similar) const;
 };
@@ -227,10 +242,8 @@ public:
 	bool hasSameEventMetadata(const MetaDataEventObject& other) const;
 	bool hasSimilarEventMetadata(const MetaDataEventObject& other) const;
 protected:
-	MetaDataDescriptorArray m_eventMetaDataDescriptorArray;
+	MetaDataSet::Ptr m_eventMetaData;
 	MetaDataEventObject();
-	size_t m_totalSize{ 0 };
-	size_t m_maxSize{ 0 };
 private:
 	bool checkMetaDataCoincidence(const MetaDataEventObject& other, bool similar) const;
 };
@@ -48,6 +48,7 @@ void DataBuffer::clear()
 
 void DataBuffer::resize (int chans, int size)
 {
+    abstractFifo.setTotalSize (size);
     buffer.setSize (chans, size);
 
     timestampBuffer.malloc (size);
@@ -106,9 +107,48 @@ int DataBuffer::addToBuffer (float* data, int64* timestamps, uint64* eventCodes,
 }
 
 
+int DataBuffer::addChannelBlocksToBuffer (const float* data, const int64* timestamps, const uint64* eventCodes, int numItems)
+{
+    int startIndex1, blockSize1, startIndex2, blockSize2;
+
+    abstractFifo.prepareToWrite (numItems, startIndex1, blockSize1, startIndex2, blockSize2);
+
+    const int numWritten = blockSize1 + blockSize2;
+
+    if (numWritten > 0)
+        lastTimestamp = timestamps[numWritten - 1];
+
+    for (int chan = 0; chan < numChans; ++chan)
+    {
+        const float* channelData = data + chan * numItems;
+
+        buffer.copyFrom (chan, startIndex1, channelData, blockSize1);
+
+        if (blockSize2 > 0)
+            buffer.copyFrom (chan, startIndex2, channelData + blockSize1, blockSize2);
+    }
+
+    memcpy (timestampBuffer + startIndex1, timestamps, blockSize1 * sizeof (int64));
+    memcpy (eventCodeBuffer + startIndex1, eventCodes, blockSize1 * sizeof (uint64));
+
+    if (blockSize2 > 0)
+    {
+        memcpy (timestampBuffer + startIndex2, timestamps + blockSize1, blockSize2 * sizeof (int64));
+        memcpy (eventCodeBuffer + startIndex2, eventCodes + blockSize1, blockSize2 * sizeof (uint64));
+    }
+
+    abstractFifo.finishedWrite (numWritten);
+
+    return numWritten;
+}
+
+
 int DataBuffer::getNumSamples() const { return abstractFifo.getNumReady(); }
 
 
+int DataBuffer::getFreeSpace() const { return abstractFifo.getFreeSpace(); }
+
+
 int DataBuffer::readAllFromBuffer (AudioSampleBuffer& data, uint64* timestamp, uint64* eventCodes, int maxSize, int dstStartChannel, int numChannels)
 {
     // check to see if the maximum size is smaller than the total number of available ints
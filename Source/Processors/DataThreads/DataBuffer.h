@@ -55,9 +55,21 @@ public:
     */
     int addToBuffer (float* data, int64* timestamps, uint64* eventCodes, int numItems, int chunkSize=1);
 
+    /** Add samples stored one channel after another: numItems samples of the first
+        channel, then numItems of the second, and so on. Every channel is copied in
+        one go, so this is much faster than addToBuffer for blocks of many samples.
+
+        @return The number of items actually written. May be less than numItems if
+        the buffer doesn't have space.
+    */
+    int addChannelBlocksToBuffer (const float* data, const int64* timestamps, const uint64* eventCodes, int numItems);
+
     /** Returns the number of samples currently available in the buffer.*/
     int getNumSamples() const;
 
+    /** Returns the number of samples that can be added before the buffer is full.*/
+    int getFreeSpace() const;
+
     /** Copies as many samples as possible from the DataBuffer to an AudioSampleBuffer.*/
     int readAllFromBuffer (AudioSampleBuffer& data, uint64* ts, uint64* eventCodes, int maxSize, int dstStartChannel = 0, int numChannels = -1);
 
@@ -0,0 +1,406 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "NetworkDataThread.h"
+
+#if JUCE_WINDOWS
+ #include <winsock2.h>
+#else
+ #include <sys/socket.h>
+ #include <errno.h>
+#endif
+
+/** Longest gap, in seconds, filled in with the last samples received. A packet
+    further ahead or behind starts the stream over at its own sample index. */
+#define NETWORK_MAX_GAP_SECONDS 1
+
+/** Receive buffer asked of the network stack, so bursts are not dropped while a batch is converted */
+#define NETWORK_RECEIVE_BUFFER_SIZE (8 * 1024 * 1024)
+
+static_assert (sizeof (NetworkPacketHeader) == 24, "NetworkPacketHeader must match the wire format");
+
+namespace
+{
+    /** Converts 16-bit samples to floats, written channel after channel */
+    template <typename SampleType>
+    void convertSamples (const uint8* source, int numChannels, int numSamples, bool channelMajor,
+                         float offset, float scale, float* dest)
+    {
+        const SampleType* samples = reinterpret_cast<const SampleType*> (source);
+
+        if (channelMajor)
+        {
+            const int numValues = numChannels * numSamples;
+
+            for (int i = 0; i < numValues; ++i)
+                dest[i] = ((float) samples[i] - offset) * scale;
+        }
+        else
+        {
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                const SampleType* in = samples + chan;
+                float* out = dest + chan * numSamples;
+
+                for (int i = 0; i < numSamples; ++i)
+                    out[i] = ((float) in[i * numChannels] - offset) * scale;
+            }
+        }
+    }
+}
+
+
+NetworkDataThread::NetworkDataThread (SourceNode* sn)
+    : DataThread            (sn)
+    , connected             (false)
+    , numChannels           (0)
+    , samplesPerPacket      (0)
+    , sampleRate            (30000.0f)
+    , bitVolts              (1.0f)
+    , sampleOffset          (0)
+    , channelMajor          (false)
+    , maxSamplesPerPacket   (0)
+    , streamStarted         (false)
+    , nextSequence          (0)
+    , nextSample            (0)
+{
+    packetData.malloc (NETWORK_PACKET_BATCH_SIZE * NETWORK_MAX_PACKET_SIZE);
+    sourceBuffers.add (new DataBuffer (1, 10000));
+}
+
+
+NetworkDataThread::~NetworkDataThread()
+{
+}
+
+
+void NetworkDataThread::setStreamFormat (int numChannels_, int samplesPerPacket_, float sampleRate_, float bitVolts_,
+                                         int sampleOffset_, bool channelMajor_)
+{
+    numChannels         = jmax (1, numChannels_);
+    samplesPerPacket    = jmax (1, samplesPerPacket_);
+    sampleRate          = sampleRate_;
+    bitVolts            = bitVolts_;
+    sampleOffset        = sampleOffset_;
+    channelMajor        = channelMajor_;
+
+    maxSamplesPerPacket = NETWORK_MAX_PACKET_SIZE / (numChannels * (int) sizeof (int16));
+
+    convertedData.malloc (numChannels * maxSamplesPerPacket);
+    sampleTimestamps.malloc (maxSamplesPerPacket);
+    sampleEventCodes.calloc (maxSamplesPerPacket);
+    lastSamples.calloc (numChannels);
+
+    sourceBuffers[0]->resize (numChannels, jmax (10000, roundToInt (sampleRate), samplesPerPacket * NETWORK_PACKET_BATCH_SIZE * 2));
+}
+
+
+bool NetworkDataThread::bindToPort (int port)
+{
+    socket = new DatagramSocket();
+    connected = false;
+
+    if (socket->bindToPort (port))
+    {
+        const int receiveBufferSize = NETWORK_RECEIVE_BUFFER_SIZE;
+        setsockopt (socket->getRawSocketHandle(), SOL_SOCKET, SO_RCVBUF,
+                    reinterpret_cast<const char*> (&receiveBufferSize), sizeof (receiveBufferSize));
+
+        connected = (socket->waitUntilReady (true, 1000) == 1);
+    }
+
+    return connected;
+}
+
+
+NetworkDataThread::Statistics NetworkDataThread::getStatistics() const
+{
+    Statistics stats;
+    stats.packetsReceived   = packetsReceived.get();
+    stats.packetsLost       = packetsLost.get();
+    stats.packetsLate       = packetsLate.get();
+    stats.packetsInvalid    = packetsInvalid.get();
+    stats.samplesFilled     = samplesFilled.get();
+    return stats;
+}
+
+
+bool NetworkDataThread::foundInputSource()
+{
+    return connected;
+}
+
+
+bool NetworkDataThread::startAcquisition()
+{
+    streamStarted = false;
+    nextSequence = 0;
+    nextSample = 0;
+
+    packetsReceived = 0;
+    packetsLost = 0;
+    packetsLate = 0;
+    packetsInvalid = 0;
+    samplesFilled = 0;
+
+    sourceBuffers[0]->clear();
+
+    startThread();
+    return true;
+}
+
+
+bool NetworkDataThread::stopAcquisition()
+{
+    if (isThreadRunning())
+    {
+        signalThreadShouldExit();
+    }
+
+    waitForThreadToExit (500);
+
+    std::cout << "Network stream: " << packetsReceived.get() << " packets received, "
+              << packetsLost.get() << " lost, " << packetsLate.get() << " late, "
+              << packetsInvalid.get() << " invalid, " << samplesFilled.get() << " samples filled in." << std::endl;
+
+    sourceBuffers[0]->clear();
+    return true;
+}
+
+
+int NetworkDataThread::getNumDataOutputs (DataChannel::DataChannelTypes type, int subProcessorIdx) const
+{
+    if (type == DataChannel::HEADSTAGE_CHANNEL)
+        return numChannels;
+    else
+        return 0;
+}
+
+
+int NetworkDataThread::getNumTTLOutputs (int subProcessorIdx) const
+{
+    return 0;
+}
+
+
+float NetworkDataThread::getSampleRate (int subProcessorIdx) const
+{
+    return sampleRate;
+}
+
+
+float NetworkDataThread::getBitVolts (const DataChannel* chan) const
+{
+    return bitVolts;
+}
+
+
+bool NetworkDataThread::updateBuffer()
+{
+    // a short wait, so the thread notices quickly when it is asked to stop
+    const int numPackets = receivePackets (100);
+
+    if (numPackets < 0)
+        return false;
+
+    for (int i = 0; i < numPackets; ++i)
+        processPacket (packetData + i * NETWORK_MAX_PACKET_SIZE, packetSizes[i]);
+
+    return true;
+}
+
+
+int NetworkDataThread::receivePackets (int timeoutMs)
+{
+    if (socket == nullptr)
+        return -1;
+
+    const int ready = socket->waitUntilReady (true, timeoutMs);
+
+    if (ready <= 0)
+        return ready;
+
+    const int handle = socket->getRawSocketHandle();
+
+   #if JUCE_LINUX
+    struct mmsghdr messages[NETWORK_PACKET_BATCH_SIZE];
+    struct iovec buffers[NETWORK_PACKET_BATCH_SIZE];
+
+    zeromem (messages, sizeof (messages));
+
+    for (int i = 0; i < NETWORK_PACKET_BATCH_SIZE; ++i)
+    {
+        buffers[i].iov_base = packetData + i * NETWORK_MAX_PACKET_SIZE;
+        buffers[i].iov_len = NETWORK_MAX_PACKET_SIZE;
+        messages[i].msg_hdr.msg_iov = &buffers[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    const int numPackets = recvmmsg (handle, messages, NETWORK_PACKET_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+
+    if (numPackets < 0)
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+
+    for (int i = 0; i < numPackets; ++i)
+        packetSizes[i] = (int) messages[i].msg_len;
+
+    return numPackets;
+   #else
+    int numPackets = 0;
+
+    do
+    {
+        const int size = (int) recv (handle, reinterpret_cast<char*> (packetData + numPackets * NETWORK_MAX_PACKET_SIZE),
+                                     NETWORK_MAX_PACKET_SIZE, 0);
+
+        if (size < 0)
+            return numPackets > 0 ? numPackets : -1;
+
+        packetSizes[numPackets++] = size;
+    }
+    while (numPackets < NETWORK_PACKET_BATCH_SIZE && socket->waitUntilReady (true, 0) == 1);
+
+    return numPackets;
+   #endif
+}
+
+
+void NetworkDataThread::processPacket (const uint8* packet, int size)
+{
+    ++packetsReceived;
+
+    if (size >= (int) sizeof (NetworkPacketHeader) && readUnaligned<uint32> (packet) == NETWORK_PACKET_MAGIC)
+    {
+        NetworkPacketHeader header;
+        memcpy (&header, packet, sizeof (header));
+
+        const int dataSize = header.numChannels * header.numSamples * (int) sizeof (int16);
+
+        if (header.numChannels != numChannels
+            || header.numSamples == 0
+            || header.numSamples > maxSamplesPerPacket
+            || header.headerSize < sizeof (NetworkPacketHeader)
+            || (header.headerSize & 1) != 0
+            || header.headerSize + dataSize > size)
+        {
+            ++packetsInvalid;
+            return;
+        }
+
+        if (streamStarted)
+        {
+            const int32 sequenceDelta = (int32) (header.sequence - nextSequence);
+            const int64 sampleDelta = (int64) header.firstSample - nextSample;
+            const int64 maxGap = (int64) (sampleRate * NETWORK_MAX_GAP_SECONDS);
+
+            if (sampleDelta < -maxGap || sampleDelta > maxGap)
+            {
+                // the sender restarted, or was silent for too long to fill in
+                if (sequenceDelta > 0)
+                    packetsLost += sequenceDelta;
+
+                streamStarted = false;
+            }
+            else if (sequenceDelta < 0 || sampleDelta < 0)
+            {
+                // repeated, or overtaken by a later packet whose gap was already filled
+                ++packetsLate;
+                return;
+            }
+            else
+            {
+                packetsLost += sequenceDelta;
+
+                if (sampleDelta > 0)
+                    fillGap (sampleDelta);
+            }
+        }
+
+        if (! streamStarted)
+        {
+            nextSample = (int64) header.firstSample;
+            streamStarted = true;
+        }
+
+        nextSequence = header.sequence + 1;
+
+        const uint8* samples = packet + header.headerSize;
+        const bool isChannelMajor = (header.flags & NetworkPacketHeader::CHANNEL_MAJOR) != 0;
+
+        if ((header.flags & NetworkPacketHeader::UNSIGNED_SAMPLES) != 0)
+            convertSamples<uint16> (samples, numChannels, header.numSamples, isChannelMajor, 32768.0f, bitVolts, convertedData);
+        else
+            convertSamples<int16> (samples, numChannels, header.numSamples, isChannelMajor, 0.0f, bitVolts, convertedData);
+
+        addConvertedSamples (header.numSamples);
+    }
+    else
+    {
+        const int frameSize = numChannels * (int) sizeof (int16);
+
+        if (size == 0 || size % frameSize != 0)
+        {
+            ++packetsInvalid;
+            return;
+        }
+
+        const int numSamples = size / frameSize;
+
+        streamStarted = true;
+
+        convertSamples<uint16> (packet, numChannels, numSamples, channelMajor, (float) sampleOffset, bitVolts, convertedData);
+
+        addConvertedSamples (numSamples);
+    }
+}
+
+
+void NetworkDataThread::addConvertedSamples (int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+        sampleTimestamps[i] = nextSample + i;
+
+    sourceBuffers[0]->addChannelBlocksToBuffer (convertedData, sampleTimestamps, sampleEventCodes, numSamples);
+
+    for (int chan = 0; chan < numChannels; ++chan)
+        lastSamples[chan] = convertedData[chan * numSamples + numSamples - 1];
+
+    nextSample += numSamples;
+}
+
+
+void NetworkDataThread::fillGap (int64 numSamples)
+{
+    samplesFilled += numSamples;
+
+    while (numSamples > 0)
+    {
+        const int blockSize = (int) jmin ((int64) maxSamplesPerPacket, numSamples);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+            FloatVectorOperations::fill (convertedData + chan * blockSize, lastSamples[chan], blockSize);
+
+        addConvertedSamples (blockSize);
+        numSamples -= blockSize;
+    }
+}
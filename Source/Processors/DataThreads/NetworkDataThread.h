@@ -0,0 +1,164 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __NETWORKDATATHREAD_H_7E2C19B4__
+#define __NETWORKDATATHREAD_H_7E2C19B4__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "DataThread.h"
+
+/** First four bytes of every NetworkPacketHeader, "OENP" */
+#define NETWORK_PACKET_MAGIC 0x504e454f
+
+/** Largest UDP packet a NetworkDataThread can receive */
+#define NETWORK_MAX_PACKET_SIZE 65536
+
+/** Most packets read with a single call to the network stack */
+#define NETWORK_PACKET_BATCH_SIZE 16
+
+/**
+    Header that can start each packet of a network stream. The samples follow it,
+    as 16-bit integers. All fields are little endian.
+
+    @see NetworkDataThread
+*/
+struct PLUGIN_API NetworkPacketHeader
+{
+    enum Flags
+    {
+        /** All samples of the first channel, then all of the second... Otherwise every sample holds all channels. */
+        CHANNEL_MAJOR = 1,
+        /** Samples are unsigned, with zero at 32768. Otherwise they are signed. */
+        UNSIGNED_SAMPLES = 2
+    };
+
+    uint32 magic;           // NETWORK_PACKET_MAGIC
+    uint32 sequence;        // one more than the previous packet's
+    uint64 firstSample;     // index of the packet's first sample since the stream started
+    uint16 numChannels;
+    uint16 numSamples;
+    uint16 flags;           // a combination of Flags
+    uint16 headerSize;      // bytes before the first sample, so fields can be appended later
+};
+
+/**
+    Base class for DataThreads that receive continuous data as UDP packets.
+
+    Waiting packets are read in batches, with recvmmsg() where it is available,
+    and their 16-bit samples are converted and written to the DataBuffer one
+    channel at a time.
+
+    Packets either start with a NetworkPacketHeader, or carry nothing but the
+    samples, laid out as set with setStreamFormat(). The sample indices in the
+    headers become the timestamps: missing packets are counted as lost and their
+    samples filled in by repeating the last ones received, while repeated or
+    overtaken packets are dropped. Headerless packets are timestamped by counting
+    the samples received, so losses go unnoticed.
+
+    @see DataThread, NetworkPacketHeader
+*/
+class PLUGIN_API NetworkDataThread : public DataThread
+{
+public:
+    NetworkDataThread (SourceNode* sn);
+    ~NetworkDataThread();
+
+    /** Packet and sample counters since acquisition started */
+    struct Statistics
+    {
+        int64 packetsReceived;
+        int64 packetsLost;
+        int64 packetsLate;
+        int64 packetsInvalid;
+        int64 samplesFilled;
+    };
+
+    /** Sets the stream layout; samplesPerPacket, sampleOffset and channelMajor only
+        apply to headerless packets. Must not be called during acquisition. */
+    void setStreamFormat (int numChannels, int samplesPerPacket, float sampleRate, float bitVolts,
+                          int sampleOffset, bool channelMajor);
+
+    /** Opens a new socket on port. Returns true if data arrives on it within a second. */
+    bool bindToPort (int port);
+
+    Statistics getStatistics() const;
+
+    bool foundInputSource() override;
+    bool startAcquisition() override;
+    bool stopAcquisition() override;
+
+    int getNumDataOutputs (DataChannel::DataChannelTypes type, int subProcessorIdx) const override;
+    int getNumTTLOutputs (int subProcessorIdx) const override;
+    float getSampleRate (int subProcessorIdx) const override;
+    float getBitVolts (const DataChannel* chan) const override;
+
+protected:
+    bool updateBuffer() override;
+
+private:
+    /** Reads up to NETWORK_PACKET_BATCH_SIZE packets, waiting up to timeoutMs for
+        the first one. Returns the number read, or -1 if the socket failed. */
+    int receivePackets (int timeoutMs);
+
+    void processPacket (const uint8* packet, int size);
+
+    /** Writes the numSamples converted samples to the DataBuffer */
+    void addConvertedSamples (int numSamples);
+
+    /** Writes numSamples copies of the last samples received to the DataBuffer */
+    void fillGap (int64 numSamples);
+
+    ScopedPointer<DatagramSocket> socket;
+    bool connected;
+
+    int numChannels;
+    int samplesPerPacket;
+    float sampleRate;
+    float bitVolts;
+    int sampleOffset;
+    bool channelMajor;
+
+    HeapBlock<uint8> packetData;
+    int packetSizes[NETWORK_PACKET_BATCH_SIZE];
+
+    HeapBlock<float> convertedData;   // channel after channel, as many samples each as the block holds
+    HeapBlock<int64> sampleTimestamps;
+    HeapBlock<uint64> sampleEventCodes;
+    HeapBlock<float> lastSamples;
+    int maxSamplesPerPacket;
+
+    bool streamStarted;
+    uint32 nextSequence;
+    int64 nextSample;
+
+    Atomic<int64> packetsReceived;
+    Atomic<int64> packetsLost;
+    Atomic<int64> packetsLate;
+    Atomic<int64> packetsInvalid;
+    Atomic<int64> samplesFilled;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NetworkDataThread);
+};
+
+
+#endif  // __NETWORKDATATHREAD_H_7E2C19B4__
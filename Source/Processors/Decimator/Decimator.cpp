@@ -0,0 +1,203 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Decimator.h"
+#include "DecimatorEditor.h"
+
+/** Anti-aliasing filter length, in decimated samples. The passband reaches about a
+    third of the decimated sample rate. */
+#define DECIMATOR_FILTER_LENGTH 32
+
+/** Largest number of input samples the resamplers take in one go */
+#define DECIMATOR_MAX_CHUNK_SIZE 1024
+
+Decimator::Decimator()
+    : GenericProcessor("Decimator"),
+      decimationFactor(12)
+{
+    setProcessorType(PROCESSOR_TYPE_FILTER);
+}
+
+Decimator::~Decimator()
+{
+
+}
+
+AudioProcessorEditor* Decimator::createEditor()
+{
+    editor = new DecimatorEditor(this, true);
+
+    return editor;
+}
+
+int Decimator::getDecimationFactor() const
+{
+    return decimationFactor;
+}
+
+int Decimator::getNumSubProcessors() const
+{
+    return jmax(1, streams.size());
+}
+
+float Decimator::getSampleRate(int subProcessorIdx) const
+{
+    if (subProcessorIdx < streams.size())
+        return streams[subProcessorIdx]->sourceSampleRate / decimationFactor;
+
+    return GenericProcessor::getSampleRate(subProcessorIdx);
+}
+
+void Decimator::setParameter(int parameterIndex, float newValue)
+{
+    if (parameterIndex == 0)
+        decimationFactor = jmax(1, roundToInt(newValue));
+}
+
+void Decimator::updateSettings()
+{
+    // the channels copied from the source node are swapped for new ones, owned by
+    // this processor, grouped into one subprocessor per incoming stream
+    OwnedArray<DataChannel> inputChannels;
+    inputChannels.swapWith(dataChannelArray);
+
+    streams.clear();
+    Array<int> channelStream;
+
+    for (int i = 0; i < inputChannels.size(); i++)
+    {
+        const DataChannel* input = inputChannels[i];
+        int sub = 0;
+
+        while (sub < streams.size()
+               && (streams[sub]->sourceNodeId != input->getSourceNodeID()
+                   || streams[sub]->sourceSubProcessorIdx != input->getSubProcessorIdx()))
+            sub++;
+
+        if (sub == streams.size())
+        {
+            Stream* stream = new Stream();
+            stream->sourceNodeId = input->getSourceNodeID();
+            stream->sourceSubProcessorIdx = input->getSubProcessorIdx();
+            stream->sourceSampleRate = input->getSampleRate();
+            stream->nextTimestamp = 0;
+            stream->hasTimestamp = false;
+            streams.add(stream);
+        }
+
+        streams[sub]->channels.add(i);
+        channelStream.add(sub);
+    }
+
+    // created only once every stream is known, so each channel gets the final subprocessor count
+    for (int i = 0; i < inputChannels.size(); i++)
+    {
+        const DataChannel* input = inputChannels[i];
+        const int sub = channelStream[i];
+
+        DataChannel* chan = new DataChannel(input->getChannelType(), getSampleRate(sub), this, sub);
+        chan->setName(input->getName());
+        chan->setBitVolts(input->getBitVolts());
+        chan->setDataUnits(input->getDataUnits());
+        chan->setRecordState(input->getRecordState());
+        chan->setMonitored(input->isMonitored());
+        chan->addToHistoricString(input->getHistoricString());
+        dataChannelArray.add(chan);
+    }
+
+    for (int sub = 0; sub < streams.size(); sub++)
+    {
+        const int numChannels = streams[sub]->channels.size();
+        streams[sub]->inputs.insertMultiple(0, nullptr, numChannels);
+        streams[sub]->outputs.insertMultiple(0, nullptr, numChannels);
+    }
+}
+
+bool Decimator::enable()
+{
+    for (int sub = 0; sub < streams.size(); sub++)
+    {
+        Stream* stream = streams[sub];
+        stream->resampler.setup(stream->channels.size(),
+                                stream->sourceSampleRate,
+                                stream->sourceSampleRate / decimationFactor,
+                                DECIMATOR_MAX_CHUNK_SIZE,
+                                DECIMATOR_FILTER_LENGTH);
+        stream->hasTimestamp = false;
+    }
+
+    return true;
+}
+
+void Decimator::process(AudioSampleBuffer& buffer)
+{
+    for (int sub = 0; sub < streams.size(); sub++)
+    {
+        Stream* stream = streams[sub];
+        const int numInputSamples = getNumSourceSamples(stream->sourceNodeId, stream->sourceSubProcessorIdx);
+        int numOutputSamples = 0;
+
+        if (numInputSamples > 0)
+        {
+            if (!stream->hasTimestamp)
+            {
+                stream->nextTimestamp = getSourceTimestamp(stream->sourceNodeId, stream->sourceSubProcessorIdx)
+                                        / decimationFactor;
+                stream->hasTimestamp = true;
+            }
+
+            // decimating in place is safe: the resampler copies each chunk of input
+            // before writing the (fewer) output samples that precede it
+            for (int i = 0; i < stream->channels.size(); i++)
+            {
+                stream->inputs.set(i, buffer.getReadPointer(stream->channels[i]));
+                stream->outputs.set(i, buffer.getWritePointer(stream->channels[i]));
+            }
+
+            numOutputSamples = stream->resampler.process(stream->inputs.getRawDataPointer(),
+                                                         numInputSamples,
+                                                         stream->outputs.getRawDataPointer());
+        }
+
+        setTimestampAndSamples(stream->nextTimestamp, numOutputSamples, sub);
+        stream->nextTimestamp += numOutputSamples;
+    }
+}
+
+void Decimator::saveCustomParametersToXml(XmlElement* parentElement)
+{
+    XmlElement* mainNode = parentElement->createNewChildElement("DECIMATOR");
+    mainNode->setAttribute("Factor", decimationFactor);
+}
+
+void Decimator::loadCustomParametersFromXml()
+{
+    if (parametersAsXml != nullptr)
+    {
+        forEachXmlChildElement(*parametersAsXml, mainNode)
+        {
+            if (mainNode->hasTagName("DECIMATOR"))
+                setParameter(0, mainNode->getIntAttribute("Factor", decimationFactor));
+        }
+    }
+}
@@ -0,0 +1,99 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __DECIMATOR_H_6B0E3F2A__
+#define __DECIMATOR_H_6B0E3F2A__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "../GenericProcessor/GenericProcessor.h"
+#include "../AudioResamplingNode/PolyphaseResampler.h"
+
+/**
+
+  Reduces the sample rate of every continuous channel by an integer factor.
+
+  Each incoming stream (a source processor and subprocessor pair) becomes one
+  subprocessor of the Decimator, at the source rate divided by the factor. Its
+  channels are replaced by new ones owned by the Decimator, so processors
+  further down the chain read the reduced sample count and timestamps the
+  Decimator publishes for that subprocessor, instead of those of the original
+  source. Samples are written in place to the start of each channel.
+
+  The anti-aliasing filter is linear phase, so decimated data lags the input by
+  half its length. Event and spike channels pass through untouched and keep the
+  timestamps of the processors that created them.
+
+  @see GenericProcessor, PolyphaseResampler
+
+*/
+
+class Decimator : public GenericProcessor
+{
+public:
+
+    Decimator();
+    ~Decimator();
+
+    AudioProcessorEditor* createEditor() override;
+
+    void process(AudioSampleBuffer& buffer) override;
+    void setParameter(int parameterIndex, float newValue) override;
+
+    bool isGeneratesTimestamps() const override { return true; }
+
+    int getNumSubProcessors() const override;
+    float getSampleRate(int subProcessorIdx = 0) const override;
+
+    void updateSettings() override;
+    bool enable() override;
+
+    void saveCustomParametersToXml(XmlElement* parentElement) override;
+    void loadCustomParametersFromXml() override;
+
+    int getDecimationFactor() const;
+
+private:
+
+    /** One stream of incoming data and the subprocessor it is turned into */
+    struct Stream
+    {
+        uint16 sourceNodeId;
+        uint16 sourceSubProcessorIdx;
+        float sourceSampleRate;
+        Array<int> channels;
+        Array<const float*> inputs;
+        Array<float*> outputs;
+        PolyphaseResampler resampler;
+        juce::uint64 nextTimestamp;
+        bool hasTimestamp;
+    };
+
+    OwnedArray<Stream> streams;
+    int decimationFactor;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Decimator);
+
+};
+
+
+#endif  // __DECIMATOR_H_6B0E3F2A__
@@ -0,0 +1,92 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "DecimatorEditor.h"
+#include "Decimator.h"
+
+static const int decimationFactors[] = { 2, 3, 4, 5, 6, 8, 10, 12, 15, 16, 20, 24, 30, 32 };
+
+DecimatorEditor::DecimatorEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors=true)
+    : GenericEditor(parentNode, useDefaultParameterEditors),
+      decimator(static_cast<Decimator*>(parentNode))
+{
+    desiredWidth = 150;
+
+    factorLabel = new Label("Factor Text", "Factor:");
+    factorLabel->setEditable(false);
+    factorLabel->setJustificationType(Justification::centredLeft);
+    factorLabel->setBounds(15, 35, 60, 20);
+    addAndMakeVisible(factorLabel);
+
+    factorSelector = new ComboBox("Factor");
+    factorSelector->setEditableText(false);
+    factorSelector->setJustificationType(Justification::centredLeft);
+    factorSelector->setBounds(75, 35, 55, 20);
+
+    for (int i = 0; i < numElementsInArray(decimationFactors); i++)
+        factorSelector->addItem(String(decimationFactors[i]), decimationFactors[i]);
+
+    factorSelector->setSelectedId(decimator->getDecimationFactor(), dontSendNotification);
+    factorSelector->addListener(this);
+    addAndMakeVisible(factorSelector);
+
+    rateLabel = new Label("Rate Text", String::empty);
+    rateLabel->setEditable(false);
+    rateLabel->setJustificationType(Justification::centredLeft);
+    rateLabel->setBounds(15, 70, 120, 20);
+    addAndMakeVisible(rateLabel);
+}
+
+DecimatorEditor::~DecimatorEditor()
+{
+
+}
+
+void DecimatorEditor::comboBoxChanged(ComboBox* comboBox)
+{
+    if (comboBox == factorSelector)
+    {
+        decimator->setParameter(0, comboBox->getSelectedId());
+        CoreServices::updateSignalChain(this);
+    }
+}
+
+void DecimatorEditor::updateSettings()
+{
+    factorSelector->setSelectedId(decimator->getDecimationFactor(), dontSendNotification);
+
+    if (decimator->getTotalDataChannels() > 0)
+        rateLabel->setText(String(decimator->getSampleRate(0), 1) + " Hz", dontSendNotification);
+    else
+        rateLabel->setText(String::empty, dontSendNotification);
+}
+
+void DecimatorEditor::startAcquisition()
+{
+    factorSelector->setEnabled(false);
+}
+
+void DecimatorEditor::stopAcquisition()
+{
+    factorSelector->setEnabled(true);
+}
@@ -0,0 +1,64 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __DECIMATOREDITOR_H_4D21A7C9__
+#define __DECIMATOREDITOR_H_4D21A7C9__
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "../Editors/GenericEditor.h"
+
+class Decimator;
+
+/**
+
+  User interface for the Decimator.
+
+  @see Decimator
+
+*/
+
+class DecimatorEditor : public GenericEditor,
+    public ComboBox::Listener
+{
+public:
+    DecimatorEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors);
+    ~DecimatorEditor();
+
+    void comboBoxChanged(ComboBox* comboBox) override;
+    void updateSettings() override;
+
+    void startAcquisition() override;
+    void stopAcquisition() override;
+
+private:
+    Decimator* decimator;
+
+    ScopedPointer<ComboBox> factorSelector;
+    ScopedPointer<Label> factorLabel, rateLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecimatorEditor);
+
+};
+
+
+#endif  // __DECIMATOREDITOR_H_4D21A7C9__
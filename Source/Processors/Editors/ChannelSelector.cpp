@@ -42,10 +42,13 @@ static const int DURATION_ANIMATION_COLLAPSE_MS = 200;
 
 ChannelSelector::ChannelSelector(bool createButtons, Font& titleFont_) :
     eventsOnly(false)
+    , parameterChannelGrid           (PARAMETER, titleFont_)
     , parameterSlicerChannelSelector (Channels::PARAM_CHANNELS,  "Parameter slicer channel selector component")
+    , audioChannelGrid               (AUDIO, titleFont_)
     , audioSlicerChannelSelector     (Channels::AUDIO_CHANNELS,  "Audio slicer channel selector component")
+    , recordChannelGrid              (RECORD, titleFont_)
     , recordSlicerChannelSelector    (Channels::RECORD_CHANNELS, "Record slicer channel selector component")
-    , paramsToggled(true), paramsActive(true), recActive(true), radioStatus(false), isNotSink(createButtons)
+    , paramsToggled(true), paramsActive(true), recActive(true), radioStatus(false), isNotSink(createButtons), isChangingManyChannels(false)
     , moveRight(false), moveLeft(false), offsetLR(0), offsetUD(0), desiredOffset(0), titleFont(titleFont_), acquisitionIsActive(false)
 {
     audioButton = new EditorButton("AUDIO", titleFont);
@@ -81,29 +84,15 @@ ChannelSelector::ChannelSelector(bool createButtons, Font& titleFont_) :
     noneButton->addListener(this);
     addAndMakeVisible(noneButton);
 
-    // Buttons managers
+    // Channel grids
     // ====================================================================
-    addAndMakeVisible (audioButtonsManager);
-    //addAndMakeVisible (recordButtonsManager);
-    addAndMakeVisible (parameterButtonsManager);
-
-    // Enable fast mode selection for buttons
-    audioButtonsManager.setFastSelectionModeEnabled     (true);
-    recordButtonsManager.setFastSelectionModeEnabled    (true);
-    parameterButtonsManager.setFastSelectionModeEnabled (true);
-
-    audioButtonsManager.setMinPaddingBetweenButtons     (0);
-    recordButtonsManager.setMinPaddingBetweenButtons    (0);
-    parameterButtonsManager.setMinPaddingBetweenButtons (0);
-
-    audioButtonsManager.setColour       (ButtonGroupManager::outlineColourId, Colour (0x0));
-    recordButtonsManager.setColour      (ButtonGroupManager::outlineColourId, Colour (0x0));
-    parameterButtonsManager.setColour   (ButtonGroupManager::outlineColourId, Colour (0x0));
-
-    // Register listeners for buttons
-    audioButtonsManager.setButtonListener      (this);
-    recordButtonsManager.setButtonListener     (this);
-    parameterButtonsManager.setButtonListener  (this);
+    addAndMakeVisible (audioChannelGrid);
+    //addAndMakeVisible (recordChannelGrid);
+    addAndMakeVisible (parameterChannelGrid);
+
+    audioChannelGrid.setListener      (this);
+    recordChannelGrid.setListener     (this);
+    parameterChannelGrid.setListener  (this);
     // ====================================================================
 
     // Slicer channels selectors
@@ -138,9 +127,9 @@ ChannelSelector::~ChannelSelector()
     // We will remove it after getting rid of the ugly calling of deleteAllChildren() method.
     // We should really use some RAII technuiqes to avoid calling this method.
     // TODO: refactor the code to follow RAII best principles and to avoid using raw pointers after merge with priyanjitdey94
-    removeChildComponent (&audioButtonsManager);
-    removeChildComponent (&recordButtonsManager);
-    removeChildComponent (&parameterButtonsManager);
+    removeChildComponent (&audioChannelGrid);
+    removeChildComponent (&recordChannelGrid);
+    removeChildComponent (&parameterChannelGrid);
 
     removeChildComponent (&audioSlicerChannelSelector);
     removeChildComponent (&recordSlicerChannelSelector);
@@ -173,36 +162,24 @@ void ChannelSelector::paint(Graphics& g)
 
 void ChannelSelector::setNumChannels(int numChans)
 {
-    int difference = numChans - parameterButtonsManager.getNumButtons();
-
-    // std::cout << difference << " buttons needed." << std::endl;
+    parameterChannelGrid.setNumChannels (numChans, paramsToggled);
 
-    if (difference > 0)
-    {
-        for (int n = 0; n < difference; n++)
-        {
-            addButton();
-        }
-    }
-    else if (difference < 0)
+    if (isNotSink)
     {
-        for (int n = 0; n < -difference; n++)
-        {
-            removeButton();
-        }
+        recordChannelGrid.setNumChannels (numChans, false);
+        audioChannelGrid.setNumChannels  (numChans, false);
     }
 
-    const int numButtons = parameterButtonsManager.getNumButtons();
     //Reassign numbers according to the actual channels (useful for channel mapper)
-    for (int n = 0; n < numButtons; ++n)
+    for (int n = 0; n < numChans; ++n)
     {
         int num = ( (GenericEditor*)getParentComponent())->getChannelDisplayNumber (n);
-        static_cast<ChannelSelectorButton*> (parameterButtonsManager.getButtonAt  (n))->setChannel (n + 1, num + 1);
+        parameterChannelGrid.setDisplayNumber (n, num + 1);
 
         if (isNotSink)
         {
-            static_cast<ChannelSelectorButton*> (recordButtonsManager.getButtonAt (n))->setChannel (n + 1, num + 1);
-            static_cast<ChannelSelectorButton*> (audioButtonsManager.getButtonAt  (n))->setChannel (n + 1, num + 1);
+            recordChannelGrid.setDisplayNumber (n, num + 1);
+            audioChannelGrid.setDisplayNumber  (n, num + 1);
         }
     }
 
@@ -211,12 +188,12 @@ void ChannelSelector::setNumChannels(int numChans)
 
 int ChannelSelector::getNumChannels()
 {
-    return parameterButtonsManager.getNumButtons();
+    return parameterChannelGrid.getNumChannels();
 }
 
 void ChannelSelector::shiftChannelsVertical(float amount)
 {
-    if (parameterButtonsManager.getNumButtons() > 16)
+    if (parameterChannelGrid.getNumChannels() > 16)
     {
         offsetUD -= amount * 10;
         offsetUD = jmin(offsetUD, 0.0f);
@@ -233,9 +210,9 @@ void ChannelSelector::refreshButtonBoundaries()
     const int columnWidth   = getDesiredWidth() / (numColumnsGreaterThan100 + 1) + 1;
     const int rowHeight     = 14;
 
-    audioButtonsManager.setButtonSize      (columnWidth, rowHeight);
-    recordButtonsManager.setButtonSize     (columnWidth, rowHeight);
-    parameterButtonsManager.setButtonSize  (columnWidth, rowHeight);
+    audioChannelGrid.setCellSize      (columnWidth, rowHeight);
+    recordChannelGrid.setCellSize     (columnWidth, rowHeight);
+    parameterChannelGrid.setCellSize  (columnWidth, rowHeight);
 
     const int xLoc = offsetLR + 3;
 
@@ -252,30 +229,30 @@ void ChannelSelector::refreshButtonBoundaries()
                                           .withY (audioSlicerChannelSelector.getY())
                                           .withHeight (audioSlicerChannelSelector.getHeight()));
 
-    // Set bounds for buttons managers
+    // Set bounds for channel grids
     // ===================================================================================================
     const int headerHeight              = 25;
     const int tabButtonHeight           = 15;
-    const int buttonsManagerWidth       = getDesiredWidth() - 6;
-    const int defaultButtonsManagerY    = headerHeight;
+    const int channelGridWidth          = getDesiredWidth() - 6;
+    const int defaultChannelGridY       = headerHeight;
 
     // We will use just some hacks to set initial y and height if height is zero,
-    // otherwise we will use the same bounds for buttons maangers
-    int buttonsManagerX = xLoc;
-    parameterButtonsManager.setBounds   (buttonsManagerX,
-                                         parameterButtonsManager.getHeight() == 0 ? defaultButtonsManagerY : parameterButtonsManager.getY(),
-                                         buttonsManagerWidth,
-                                         getHeight() - parameterButtonsManager.getY() - tabButtonHeight);
-    buttonsManagerX -= getDesiredWidth();
-    recordButtonsManager.setBounds      (buttonsManagerX,
-                                         recordButtonsManager.getHeight() == 0 ? defaultButtonsManagerY : recordButtonsManager.getY(),
-                                         buttonsManagerWidth,
-                                         getHeight() - recordButtonsManager.getY() - tabButtonHeight);
-    buttonsManagerX -= getDesiredWidth();
-    audioButtonsManager.setBounds       (buttonsManagerX,
-                                         audioButtonsManager.getHeight() == 0 ? defaultButtonsManagerY : audioButtonsManager.getY(),
-                                         buttonsManagerWidth,
-                                         getHeight() - audioButtonsManager.getY() - tabButtonHeight);
+    // otherwise we will use the same bounds for channel grids
+    int channelGridX = xLoc;
+    parameterChannelGrid.setBounds   (channelGridX,
+                                      parameterChannelGrid.getHeight() == 0 ? defaultChannelGridY : parameterChannelGrid.getY(),
+                                      channelGridWidth,
+                                      getHeight() - parameterChannelGrid.getY() - tabButtonHeight);
+    channelGridX -= getDesiredWidth();
+    recordChannelGrid.setBounds      (channelGridX,
+                                      recordChannelGrid.getHeight() == 0 ? defaultChannelGridY : recordChannelGrid.getY(),
+                                      channelGridWidth,
+                                      getHeight() - recordChannelGrid.getY() - tabButtonHeight);
+    channelGridX -= getDesiredWidth();
+    audioChannelGrid.setBounds       (channelGridX,
+                                      audioChannelGrid.getHeight() == 0 ? defaultChannelGridY : audioChannelGrid.getY(),
+                                      channelGridWidth,
+                                      getHeight() - audioChannelGrid.getY() - tabButtonHeight);
     // ===================================================================================================
 
     /*
@@ -325,56 +302,13 @@ void ChannelSelector::timerCallback()
     refreshButtonBoundaries();
 }
 
-void ChannelSelector::addButton()
-{
-    const int size = parameterButtonsManager.getNumButtons();
-
-    ChannelSelectorButton* b = new ChannelSelectorButton (size + 1, PARAMETER, titleFont);
-    parameterButtonsManager.addButton (b);
-
-    if (paramsToggled)
-        b->setToggleState(true, dontSendNotification);
-    else
-        b->setToggleState(false, dontSendNotification);
-
-    if (!paramsActive)
-        b->setActive(false);
-
-    if (isNotSink)
-    {
-        ChannelSelectorButton* br = new ChannelSelectorButton(size + 1, RECORD, titleFont);
-        recordButtonsManager.addButton (br);
-
-        ChannelSelectorButton* ba = new ChannelSelectorButton(size + 1, AUDIO, titleFont);
-        audioButtonsManager.addButton (ba);
-    }
-}
-
-void ChannelSelector::removeButton()
-{
-    int size = parameterButtonsManager.getNumButtons();
-
-    parameterButtonsManager.removeButton (size - 1);
-
-    if (isNotSink)
-    {
-        recordButtonsManager.removeButton (size - 1);
-        audioButtonsManager.removeButton  (size - 1);
-    }
-}
-
 Array<int> ChannelSelector::getActiveChannels()
 {
     Array<int> a;
 
     if (! eventsOnly)
     {
-        const int numButtons = parameterButtonsManager.getNumButtons();
-        for (int i = 0; i < numButtons; ++i)
-        {
-            if (parameterButtonsManager.getButtonAt (i)->getToggleState())
-                a.add (i);
-        }
+        a = parameterChannelGrid.getSelectedChannels();
     }
     else
     {
@@ -388,71 +322,36 @@ void ChannelSelector::setActiveChannels(Array<int> a)
 {
     //std::cout << "Setting active channels!" << std::endl;
 
-    const int numButtons = parameterButtonsManager.getNumButtons();
-    for (int i = 0; i < numButtons; ++i)
-    {
-        parameterButtonsManager.getButtonAt (i)->setToggleState (false, dontSendNotification);
-    }
+    parameterChannelGrid.setAllStates (false, dontSendNotification);
 
     for (int i = 0; i < a.size(); i++)
     {
-        if (a[i] < numButtons)
-        {
-            parameterButtonsManager.getButtonAt (a[i])->setToggleState (true, dontSendNotification);
-        }
+        parameterChannelGrid.setState (a[i], true, dontSendNotification);
     }
 }
 
 void ChannelSelector::inactivateButtons()
 {
     paramsActive = false;
-
-    const int numButtons = parameterButtonsManager.getNumButtons();
-    for (int i = 0; i < numButtons; ++i)
-    {
-        const auto& button = static_cast<ChannelSelectorButton*> (parameterButtonsManager.getButtonAt (i));
-        button->setActive (false);
-        button->repaint();
-    }
+    parameterChannelGrid.setActive (false);
 }
 
 void ChannelSelector::activateButtons()
 {
     paramsActive = true;
-
-    const int numButtons = parameterButtonsManager.getNumButtons();
-    for (int i = 0; i < numButtons; ++i)
-    {
-        const auto& button = static_cast<ChannelSelectorButton*> (parameterButtonsManager.getButtonAt (i));
-        button->setActive (true);
-        button->repaint();
-    }
+    parameterChannelGrid.setActive (true);
 }
 
 void ChannelSelector::inactivateRecButtons()
 {
     recActive = false;
-
-    const int numButtons = recordButtonsManager.getNumButtons();
-    for (int i = 0; i < numButtons; ++i)
-    {
-        const auto& button = static_cast<ChannelSelectorButton*> (recordButtonsManager.getButtonAt (i));
-        button->setActive (false);
-        button->repaint();
-    }
+    recordChannelGrid.setActive (false);
 }
 
 void ChannelSelector::activateRecButtons()
 {
     recActive = true;
-
-    const int numButtons = recordButtonsManager.getNumButtons();
-    for (int i = 0; i < numButtons; ++i)
-    {
-        const auto& button = static_cast<ChannelSelectorButton*> (recordButtonsManager.getButtonAt (i));
-        button->setActive (true);
-        button->repaint();
-    }
+    recordChannelGrid.setActive (true);
 }
 
 void ChannelSelector::refreshParameterColors()
@@ -482,63 +381,44 @@ void ChannelSelector::setRadioStatus(bool radioOn)
     {
         radioStatus = radioOn;
 
-        const int numButtons = parameterButtonsManager.getNumButtons();
-        for (int i = 0; i < numButtons; ++i)
-        {
-            parameterButtonsManager.getButtonAt (i)->setToggleState (false, dontSendNotification);
-        }
-
-        parameterButtonsManager.setRadioButtonMode (radioStatus);
+        parameterChannelGrid.setAllStates (false, dontSendNotification);
+        parameterChannelGrid.setRadioMode (radioStatus);
     }
 }
 
 bool ChannelSelector::getParamStatus(int chan)
 {
-    if (chan >= 0 && chan < parameterButtonsManager.getNumButtons())
-        return parameterButtonsManager.getButtonAt (chan)->getToggleState();
-    else
-        return false;
+    return parameterChannelGrid.getState (chan);
 }
 
 bool ChannelSelector::getRecordStatus(int chan)
 {
-    if (chan >= 0 && chan < recordButtonsManager.getNumButtons())
-        return recordButtonsManager.getButtonAt (chan)->getToggleState();
-    else
-        return false;
+    return recordChannelGrid.getState (chan);
 }
 
 bool ChannelSelector::getAudioStatus(int chan)
 {
-    if (chan >= 0 && chan < audioButtonsManager.getNumButtons())
-        return audioButtonsManager.getButtonAt (chan)->getToggleState();
-    else
-        return false;
+    return audioChannelGrid.getState (chan);
 }
 
 void ChannelSelector::setParamStatus(int chan, bool b)
 {
-    if (chan >= 0 && chan < parameterButtonsManager.getNumButtons())
-        parameterButtonsManager.getButtonAt (chan)->setToggleState(b, sendNotification);
+    parameterChannelGrid.setState (chan, b, sendNotification);
 }
 
 void ChannelSelector::setRecordStatus(int chan, bool b)
 {
-    if (chan >= 0 && chan < recordButtonsManager.getNumButtons())
-        recordButtonsManager.getButtonAt (chan)->setToggleState(b, sendNotification);
+    recordChannelGrid.setState (chan, b, sendNotification);
 }
 
 void ChannelSelector::setAudioStatus(int chan, bool b)
 {
-    if (chan >= 0 && chan < audioButtonsManager.getNumButtons())
-        audioButtonsManager.getButtonAt (chan)->setToggleState (b, sendNotification);
+    audioChannelGrid.setState (chan, b, sendNotification);
 }
 
 void ChannelSelector::clearAudio()
 {
-    const int numButtons = audioButtonsManager.getNumButtons();
-    for (int chan = 0; chan < numButtons; ++chan)
-        audioButtonsManager.getButtonAt (chan)->setToggleState (false, sendNotification);
+    audioChannelGrid.setAllStates (false, sendNotification);
 }
 
 int ChannelSelector::getDesiredWidth()
@@ -592,20 +472,15 @@ void ChannelSelector::buttonClicked(Button* button)
     else if (button == allButton)
     {
         // select all active buttons
+        ScopedValueSetter<bool> manyChannels (isChangingManyChannels, true);
+
         if (offsetLR == recordOffset)
         {
-            for (int i = 0; i < recordButtonsManager.getNumButtons(); ++i)
-            {
-                recordButtonsManager.getButtonAt (i)->setToggleState (true, sendNotification);
-            }
-
+            recordChannelGrid.setAllStates (true, sendNotification);
         }
         else if (offsetLR == parameterOffset)
         {
-            for (int i = 0; i < parameterButtonsManager.getNumButtons(); ++i)
-            {
-                parameterButtonsManager.getButtonAt (i)->setToggleState (true, sendNotification);
-            }
+            parameterChannelGrid.setAllStates (true, sendNotification);
         }
         else if (offsetLR == audioOffset)
         {
@@ -615,26 +490,19 @@ void ChannelSelector::buttonClicked(Button* button)
     else if (button == noneButton)
     {
         // deselect all active buttons
+        ScopedValueSetter<bool> manyChannels (isChangingManyChannels, true);
+
         if (offsetLR == recordOffset)
         {
-            for (int i = 0; i < recordButtonsManager.getNumButtons(); ++i)
-            {
-                recordButtonsManager.getButtonAt (i)->setToggleState (false, sendNotification);
-            }
+            recordChannelGrid.setAllStates (false, sendNotification);
         }
         else if (offsetLR == parameterOffset)
         {
-            for (int i = 0; i < parameterButtonsManager.getNumButtons(); ++i)
-            {
-                parameterButtonsManager.getButtonAt (i)->setToggleState (false, sendNotification);
-            }
+            parameterChannelGrid.setAllStates (false, sendNotification);
         }
         else if (offsetLR == audioOffset)
         {
-            for (int i = 0; i < audioButtonsManager.getNumButtons(); ++i)
-            {
-                audioButtonsManager.getButtonAt (i)->setToggleState (false, sendNotification);
-            }
+            audioChannelGrid.setAllStates (false, sendNotification);
         }
 
         if (radioStatus) // if radio buttons are active
@@ -644,130 +512,124 @@ void ChannelSelector::buttonClicked(Button* button)
             editor->channelChanged (-1, false);
         }
     }
-    else
-    {
-        ChannelSelectorButton* b = (ChannelSelectorButton*)button;
+    refreshParameterColors();
+}
 
-        if (b->getType() == AUDIO)
-        {
-            // get audio node, and inform it of the change
-            GenericEditor* editor = (GenericEditor*)getParentComponent();
-
-            const DataChannel* ch = editor->getChannel(b->getChannel() - 1);
-            //int channelNum = editor->getStartChannel() + b->getChannel() - 1;
-            bool status = b->getToggleState();
-
-         //   std::cout << "Requesting audio monitor for channel " << ch->nodeIndex + 1 << std::endl;
-            
-            // change parameter directly on editor
-            //     This is another of those ugly things that will go away once the
-            //     probe audio system is implemented, but is needed to maintain compatibility
-            //     between the older recording system and the newer channel objects.
-            const_cast<DataChannel*>(ch)->setMonitored(status);
-
-            
-            if (acquisitionIsActive) // use setParameter to change audio node's copy of parameter safely, if running
-            {
-                AccessClass::getProcessorGraph()->
-                getAudioNode()->setChannelStatus(ch, status);
-            }
-        }
-        else if (b->getType() == RECORD)
-        {
-			
-            // get record node, and inform it of the change
-            GenericEditor* editor = (GenericEditor*)getParentComponent();
 
-            const DataChannel* ch = editor->getChannel(b->getChannel() - 1);
-            //int channelNum = editor->getStartChannel() + b->getChannel() - 1;
-            bool status = b->getToggleState();
+void ChannelSelector::channelStateChanged (ChannelSelectorGrid* grid, int channel, bool status)
+{
+    GenericEditor* editor = (GenericEditor*) getParentComponent();
 
-            if (acquisitionIsActive) // use setParameter to change parameter safely
-            {
-                               
-                // disable toggling when acquisition is active
-                b->setToggleState(const_cast<DataChannel*>(ch)->getRecordState(), dontSendNotification);
-            }
-            else     // change parameter directly
-            {
-                //std::cout << "Setting record status for channel " << b->getChannel() << std::endl;
+    if (grid->getType() == AUDIO)
+    {
+        // get audio node, and inform it of the change
+        const DataChannel* ch = editor->getChannel (channel);
 
-				//This is another of those ugly things that will go away once the
-				//probe recording system is implemented, but is needed to maintain compatibility
-				//between the older recording system and the newer channel objects.
-                const_cast<DataChannel*>(ch)->setRecordState(status);
-            }
+     //   std::cout << "Requesting audio monitor for channel " << ch->nodeIndex + 1 << std::endl;
 
-            AccessClass::getGraphViewer()->repaint();
+        // change parameter directly on editor
+        //     This is another of those ugly things that will go away once the
+        //     probe audio system is implemented, but is needed to maintain compatibility
+        //     between the older recording system and the newer channel objects.
+        const_cast<DataChannel*>(ch)->setMonitored(status);
+
+
+        if (acquisitionIsActive) // use setParameter to change audio node's copy of parameter safely, if running
+        {
+            AccessClass::getProcessorGraph()->
+            getAudioNode()->setChannelStatus(ch, status);
+        }
+    }
+    else if (grid->getType() == RECORD)
+    {
+        // get record node, and inform it of the change
+        const DataChannel* ch = editor->getChannel (channel);
 
+        if (acquisitionIsActive) // use setParameter to change parameter safely
+        {
+            // disable toggling when acquisition is active
+            grid->setState (channel, const_cast<DataChannel*>(ch)->getRecordState(), dontSendNotification);
         }
-        else // parameter type
+        else     // change parameter directly
         {
-            GenericEditor* editor = (GenericEditor*) getParentComponent();
-            editor->channelChanged (b->getChannel() - 1, b->getToggleState());
+            //std::cout << "Setting record status for channel " << channel + 1 << std::endl;
 
-            // do nothing
-            if (radioStatus) // if radio buttons are active
-            {
-                // send a message to parent
-                GenericEditor* editor = (GenericEditor*) getParentComponent();
-                editor->channelChanged (b->getChannel(), b->getToggleState());
-            }
+			//This is another of those ugly things that will go away once the
+			//probe recording system is implemented, but is needed to maintain compatibility
+			//between the older recording system and the newer channel objects.
+            const_cast<DataChannel*>(ch)->setRecordState(status);
         }
 
+        AccessClass::getGraphViewer()->repaint();
+
     }
-    refreshParameterColors();
+    else // parameter type
+    {
+        editor->channelChanged (channel, status);
+
+        if (radioStatus) // if radio buttons are active
+        {
+            // send a message to parent
+            editor->channelChanged (channel + 1, status);
+        }
+    }
+
+    if (! isChangingManyChannels)
+        refreshParameterColors();
 }
 
 
-void ChannelSelector::changeChannelsSelectionButtonClicked (SlicerChannelSelectorComponent* sender,
-                                                            Button* buttonThatWasClicked,
-                                                            bool isSelect)
+ChannelSelectorGrid* ChannelSelector::getGridForChannelsType (Channels::ChannelsType channelsType)
 {
-    const Channels::ChannelsType channelsType = sender->getChannelsType();
-
-    TiledButtonGroupManager* buttonsManager = nullptr;
     if (channelsType == Channels::AUDIO_CHANNELS)
-        buttonsManager = &audioButtonsManager;
+        return &audioChannelGrid;
     else if (channelsType == Channels::RECORD_CHANNELS)
-        buttonsManager = &recordButtonsManager;
+        return &recordChannelGrid;
     else if (channelsType == Channels::PARAM_CHANNELS)
-        buttonsManager = &parameterButtonsManager;
+        return &parameterChannelGrid;
+
+    return nullptr;
+}
 
-    jassert (buttonsManager != nullptr);
 
-    Array<int> getBoxList = ListSliceParser::parseStringIntoRange (sender->getText(), audioButtonsManager.getNumButtons());
+void ChannelSelector::changeChannelsSelectionButtonClicked (SlicerChannelSelectorComponent* sender,
+                                                            Button* buttonThatWasClicked,
+                                                            bool isSelect)
+{
+    ChannelSelectorGrid* channelGrid = getGridForChannelsType (sender->getChannelsType());
+
+    jassert (channelGrid != nullptr);
+
+    Array<int> getBoxList = ListSliceParser::parseStringIntoRange (sender->getText(), channelGrid->getNumChannels());
     if (getBoxList.size() < 3)
         return;
 
-    int i = 0;
-    while (i <= getBoxList.size() - 3)
     {
-        const int lim = getBoxList[i + 1];
-        const int comd = getBoxList[i + 2];
-        for (int fa = getBoxList[i]; fa <= lim; fa += comd)
+        ScopedValueSetter<bool> manyChannels (isChangingManyChannels, true);
+
+        int i = 0;
+        while (i <= getBoxList.size() - 3)
         {
-            buttonsManager->getButtonAt (fa)->setToggleState (isSelect, sendNotification);
+            const int lim = getBoxList[i + 1];
+            const int comd = getBoxList[i + 2];
+            for (int fa = getBoxList[i]; fa <= lim; fa += comd)
+            {
+                channelGrid->setState (fa, isSelect, sendNotification);
+            }
+            i += 3;
         }
-        i += 3;
     }
+
+    refreshParameterColors();
 }
 
 
 void ChannelSelector::channelSelectorCollapsedStateChanged (SlicerChannelSelectorComponent* sender,
                                                             bool isCollapsed)
 {
-    const Channels::ChannelsType channelsType = sender->getChannelsType();
-
-    TiledButtonGroupManager* buttonsManager = nullptr;
-    if (channelsType == Channels::AUDIO_CHANNELS)
-        buttonsManager = &audioButtonsManager;
-    else if (channelsType == Channels::RECORD_CHANNELS)
-        buttonsManager = &recordButtonsManager;
-    else if (channelsType == Channels::PARAM_CHANNELS)
-        buttonsManager = &parameterButtonsManager;
+    ChannelSelectorGrid* channelGrid = getGridForChannelsType (sender->getChannelsType());
 
-    jassert (buttonsManager != nullptr);
+    jassert (channelGrid != nullptr);
 
     const int headerHeight      = 25;
     const int tabButtonHeight   = 15;
@@ -777,10 +639,10 @@ void ChannelSelector::channelSelectorCollapsedStateChanged (SlicerChannelSelecto
         yPos += SlicerChannelSelectorComponent::MAX_HEIGHT - 20;
 
     const int height = getHeight() - yPos - tabButtonHeight;
-    const juce::Rectangle<int> finalBounds (buttonsManager->getX(), yPos, buttonsManager->getWidth(), height);
+    const juce::Rectangle<int> finalBounds (channelGrid->getX(), yPos, channelGrid->getWidth(), height);
 
     auto& componentAnimator = Desktop::getInstance().getAnimator();
-    componentAnimator.animateComponent (buttonsManager, finalBounds, 1.f, DURATION_ANIMATION_COLLAPSE_MS, false, 1.0, 1.0);
+    componentAnimator.animateComponent (channelGrid, finalBounds, 1.f, DURATION_ANIMATION_COLLAPSE_MS, false, 1.0, 1.0);
 }
 
 ///////////// BUTTONS //////////////////////
@@ -982,75 +844,357 @@ void EditorButton::paintButton(Graphics& g, bool isMouseOver, bool isButtonDown)
 }
 
 
-ChannelSelectorButton::ChannelSelectorButton(int num_, int type_, Font& f) : Button("name")
+ChannelSelectorGrid::ChannelSelectorGrid (int type, const Font& font)
+    : m_type                (type)
+    , m_font                (font)
+    , m_numChannels         (0)
+    , m_cellWidth           (10)
+    , m_cellHeight          (10)
+    , m_numColumns          (1)
+    , m_padding             (0)
+    , m_scrollOffset        (0)
+    , m_hoveredChannel      (-1)
+    , m_firstDraggedChannel (-1)
+    , m_lastDraggedChannel  (-1)
+    , m_isDragging          (false)
+    , m_isActive            (true)
+    , m_isRadioMode         (false)
+    , m_listener            (nullptr)
 {
-    isActive = true;
-    num = num_;
-    displayNum = num_;
-    type = type_;
+    m_font.setHeight (11);
+}
 
-    setClickingTogglesState(true);
 
-    buttonFont = f;
-    buttonFont.setHeight (11);
+void ChannelSelectorGrid::paint (Graphics& g)
+{
+    if (m_numChannels == 0)
+        return;
+
+    g.setFont (m_font);
+
+    // Only the rows intersecting the clip region are drawn
+    const juce::Rectangle<int> clip = g.getClipBounds();
+    const int rowPitch  = m_cellHeight + m_padding;
+    const int firstRow  = jmax (0, (clip.getY() + m_scrollOffset) / rowPitch);
+    const int lastRow   = (clip.getBottom() + m_scrollOffset) / rowPitch;
+
+    const int firstChannel = firstRow * m_numColumns;
+    const int lastChannel  = jmin (m_numChannels, (lastRow + 1) * m_numColumns);
+
+    for (int channel = firstChannel; channel < lastChannel; ++channel)
+    {
+        const bool state = m_states[channel];
+
+        if (m_isActive)
+        {
+            if (channel == m_hoveredChannel)
+                g.setColour (Colours::white);
+            else
+                g.setColour (state ? Colours::orange : Colours::darkgrey);
+        }
+        else
+        {
+            g.setColour (state ? Colours::yellow : Colours::lightgrey);
+        }
+
+        g.drawText (String (m_displayNumbers[channel]), getCellBounds (channel), Justification::centred, true);
+    }
 }
 
-ChannelSelectorButton::~ChannelSelectorButton() {}
 
-int ChannelSelectorButton::getType()
+void ChannelSelectorGrid::resized()
 {
-    return type;
+    const int width = getWidth();
+
+    m_numColumns = jmax (1, width / m_cellWidth);
+    m_padding    = jmax (0, (width - m_numColumns * m_cellWidth) / jmax (m_numColumns - 1, 1));
+
+    setScrollOffset (m_scrollOffset);
+    repaint();
 }
 
-int ChannelSelectorButton::getChannel()
+
+void ChannelSelectorGrid::mouseDown (const MouseEvent& e)
 {
-    return num;
+    m_firstDraggedChannel = m_isActive ? getChannelAtPosition (e.getPosition()) : -1;
+    m_lastDraggedChannel  = m_firstDraggedChannel;
+    m_isDragging = false;
 }
 
-void ChannelSelectorButton::setChannel(int n)
+
+void ChannelSelectorGrid::mouseDrag (const MouseEvent& e)
 {
-    num = n;
-    displayNum = n;
+    if (m_firstDraggedChannel < 0 || m_isRadioMode)
+        return;
+
+    const int channel = getChannelAtPosition (e.getPosition());
+
+    if (channel < 0 || (channel == m_lastDraggedChannel && m_isDragging))
+        return;
+
+    m_isDragging = true;
+    m_lastDraggedChannel = channel;
+
+    // Dragging selects the range between the first and the current channel; shift + drag deselects it
+    const bool state = ! e.mods.isShiftDown();
+    const int fromChannel = jmin (m_firstDraggedChannel, m_lastDraggedChannel);
+    const int toChannel   = jmax (m_firstDraggedChannel, m_lastDraggedChannel);
+
+    for (int i = fromChannel; i <= toChannel; ++i)
+        setState (i, state, sendNotification);
 }
-void ChannelSelectorButton::setChannel(int n, int d)
+
+
+void ChannelSelectorGrid::mouseUp (const MouseEvent& e)
 {
-    num = n;
-    displayNum = d;
+    if (! m_isDragging
+        && m_firstDraggedChannel >= 0
+        && getChannelAtPosition (e.getPosition()) == m_firstDraggedChannel)
+    {
+        // Clicking a channel in radio mode always turns it on
+        setState (m_firstDraggedChannel, m_isRadioMode || ! getState (m_firstDraggedChannel), sendNotification);
+    }
+
+    m_firstDraggedChannel = -1;
+    m_lastDraggedChannel  = -1;
+    m_isDragging = false;
 }
 
-void ChannelSelectorButton::paintButton(Graphics& g, bool isMouseOver, bool isButtonDown)
+
+void ChannelSelectorGrid::mouseMove (const MouseEvent& e)
 {
-    if (isActive)
+    const int channel = getChannelAtPosition (e.getPosition());
+
+    if (channel != m_hoveredChannel)
     {
-        if (getToggleState() == true)
-            g.setColour(Colours::orange);
-        else
-            g.setColour(Colours::darkgrey);
+        const int previousChannel = m_hoveredChannel;
+        m_hoveredChannel = channel;
+
+        repaintChannel (previousChannel);
+        repaintChannel (m_hoveredChannel);
+    }
+}
+
+
+void ChannelSelectorGrid::mouseExit (const MouseEvent& e)
+{
+    const int previousChannel = m_hoveredChannel;
+    m_hoveredChannel = -1;
+
+    repaintChannel (previousChannel);
+}
+
+
+void ChannelSelectorGrid::mouseWheelMove (const MouseEvent& e, const MouseWheelDetails& wheel)
+{
+    const int maxOffset = jmax (0, getContentHeight() - getHeight());
 
-        if (isMouseOver)
-            g.setColour(Colours::white);
+    // Let the editor viewport scroll if there is nothing to scroll here
+    if (maxOffset == 0)
+    {
+        Component::mouseWheelMove (e, wheel);
+        return;
+    }
+
+    setScrollOffset (m_scrollOffset - roundToInt (wheel.deltaY * 10.0f * (m_cellHeight + m_padding)));
+    mouseMove (e);
+}
+
+
+int ChannelSelectorGrid::getType() const
+{
+    return m_type;
+}
+
+
+void ChannelSelectorGrid::setNumChannels (int numChannels, bool initialState)
+{
+    numChannels = jmax (0, numChannels);
+
+    if (numChannels > m_numChannels)
+    {
+        m_states.setRange (m_numChannels, numChannels - m_numChannels, initialState);
+
+        for (int i = m_numChannels; i < numChannels; ++i)
+            m_displayNumbers.add (i + 1);
     }
     else
     {
-        if (getToggleState() == true)
-            g.setColour(Colours::yellow);
-        else
-            g.setColour(Colours::lightgrey);
+        m_states.setRange (numChannels, m_numChannels - numChannels, false);
+        m_displayNumbers.removeRange (numChannels, m_numChannels - numChannels);
     }
 
-    // g.fillRect(0,0,getWidth(),getHeight());
+    m_numChannels = numChannels;
 
-    g.setFont(buttonFont);
+    if (m_hoveredChannel >= m_numChannels)
+        m_hoveredChannel = -1;
+
+    setScrollOffset (m_scrollOffset);
+    repaint();
+}
+
+
+int ChannelSelectorGrid::getNumChannels() const
+{
+    return m_numChannels;
+}
+
+
+void ChannelSelectorGrid::setDisplayNumber (int channel, int displayNumber)
+{
+    if (channel >= 0 && channel < m_numChannels && m_displayNumbers[channel] != displayNumber)
+    {
+        m_displayNumbers.set (channel, displayNumber);
+        repaintChannel (channel);
+    }
+}
+
+
+bool ChannelSelectorGrid::getState (int channel) const
+{
+    return channel >= 0 && channel < m_numChannels && m_states[channel];
+}
 
-    // g.drawRect(0,0,getWidth(),getHeight(),1.0);
 
-    g.drawText(String(displayNum), 0, 0, getWidth(), getHeight(), Justification::centred, true);
+void ChannelSelectorGrid::setState (int channel, bool state, NotificationType notification)
+{
+    if (channel < 0 || channel >= m_numChannels || m_states[channel] == state)
+        return;
+
+    if (m_isRadioMode && state)
+    {
+        for (int i = m_states.findNextSetBit (0); i >= 0; i = m_states.findNextSetBit (i + 1))
+            setState (i, false, notification);
+    }
+
+    m_states.setBit (channel, state);
+    repaintChannel (channel);
+
+    if (notification != dontSendNotification && m_listener != nullptr)
+        m_listener->channelStateChanged (this, channel, state);
+}
+
+
+void ChannelSelectorGrid::setAllStates (bool state, NotificationType notification)
+{
+    if (notification == dontSendNotification || m_listener == nullptr)
+    {
+        if (m_isRadioMode && state)
+            return;
+
+        m_states.setRange (0, m_numChannels, state);
+        repaint();
+        return;
+    }
+
+    for (int i = 0; i < m_numChannels; ++i)
+        setState (i, state, notification);
+}
+
+
+Array<int> ChannelSelectorGrid::getSelectedChannels() const
+{
+    Array<int> channels;
+
+    for (int i = m_states.findNextSetBit (0); i >= 0 && i < m_numChannels; i = m_states.findNextSetBit (i + 1))
+        channels.add (i);
+
+    return channels;
+}
+
+
+void ChannelSelectorGrid::setActive (bool isActive)
+{
+    if (m_isActive != isActive)
+    {
+        m_isActive = isActive;
+        repaint();
+    }
+}
+
+
+void ChannelSelectorGrid::setRadioMode (bool isRadioMode)
+{
+    m_isRadioMode = isRadioMode;
+}
+
+
+void ChannelSelectorGrid::setCellSize (int cellWidth, int cellHeight)
+{
+    m_cellWidth  = jmax (1, cellWidth);
+    m_cellHeight = jmax (1, cellHeight);
+
+    resized();
+}
+
+
+void ChannelSelectorGrid::setListener (Listener* listener)
+{
+    m_listener = listener;
+}
+
+
+int ChannelSelectorGrid::getChannelAtPosition (juce::Point<int> position) const
+{
+    const int columnPitch = m_cellWidth + m_padding;
+    const int rowPitch    = m_cellHeight + m_padding;
+    const int x = position.getX();
+    const int y = position.getY() + m_scrollOffset;
+
+    if (x < 0 || y < 0)
+        return -1;
+
+    const int column = x / columnPitch;
+    const int row    = y / rowPitch;
+
+    // Positions in the padding between cells belong to no channel
+    if (column >= m_numColumns
+        || x - column * columnPitch >= m_cellWidth
+        || y - row * rowPitch >= m_cellHeight)
+        return -1;
+
+    const int channel = row * m_numColumns + column;
+
+    return channel < m_numChannels ? channel : -1;
+}
+
+
+juce::Rectangle<int> ChannelSelectorGrid::getCellBounds (int channel) const
+{
+    const int column = channel % m_numColumns;
+    const int row    = channel / m_numColumns;
+
+    return juce::Rectangle<int> (column * (m_cellWidth + m_padding),
+                                 row * (m_cellHeight + m_padding) - m_scrollOffset,
+                                 m_cellWidth,
+                                 m_cellHeight);
 }
 
-void ChannelSelectorButton::setActive(bool t)
+
+void ChannelSelectorGrid::repaintChannel (int channel)
+{
+    if (channel >= 0 && channel < m_numChannels)
+        repaint (getCellBounds (channel));
+}
+
+
+int ChannelSelectorGrid::getContentHeight() const
 {
-    isActive = t;
-    setClickingTogglesState(t);
+    const int numRows = (m_numChannels + m_numColumns - 1) / m_numColumns;
+
+    return jmax (0, numRows * (m_cellHeight + m_padding) - m_padding);
+}
+
+
+void ChannelSelectorGrid::setScrollOffset (int newOffset)
+{
+    newOffset = jlimit (0, jmax (0, getContentHeight() - getHeight()), newOffset);
+
+    if (newOffset != m_scrollOffset)
+    {
+        m_scrollOffset = newOffset;
+        repaint();
+    }
 }
 
 
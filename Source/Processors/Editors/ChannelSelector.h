@@ -26,13 +26,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "../../../JuceLibraryCode/JuceHeader.h"
 #include "../Editors/GenericEditor.h"
-#include "../../UI/Utils/TiledButtonGroupManager.h"
 #include "../Channel/InfoObjects.h"
 
 #include <stdio.h>
 
 class ChannelSelectorRegion;
-class ChannelSelectorButton;
 class EditorButton;
 class ChannelSelectorBox;
 class ShowAlertMessage;
@@ -115,6 +113,111 @@ private:
 };
 
 
+/**
+    A grid of channel numbers used by the ChannelSelector, one cell per channel.
+
+    The selection state of the channels is kept in a bitset instead of a button per
+    channel, so painting, hit-testing and hovering only touch the cells in view.
+    Dragging the mouse across cells selects every channel between the first and the
+    current one; dragging with shift held deselects them.
+
+    @see ChannelSelector
+*/
+class ChannelSelectorGrid : public Component
+{
+public:
+    ChannelSelectorGrid (int type, const Font& font);
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() {}
+        /** Called whenever the state of a channel changes, unless it was set without notification */
+        virtual void channelStateChanged (ChannelSelectorGrid* grid, int channel, bool state) = 0;
+    };
+
+    void paint (Graphics& g) override;
+    void resized() override;
+
+    void mouseDown       (const MouseEvent& e) override;
+    void mouseDrag       (const MouseEvent& e) override;
+    void mouseUp         (const MouseEvent& e) override;
+    void mouseMove       (const MouseEvent& e) override;
+    void mouseExit       (const MouseEvent& e) override;
+    void mouseWheelMove  (const MouseEvent& e, const MouseWheelDetails& wheel) override;
+
+    /** Returns the tab (AUDIO, RECORD or PARAMETER) the grid belongs to */
+    int getType() const;
+
+    /** Adds or removes channels at the end. Added channels start with the given state. */
+    void setNumChannels (int numChannels, bool initialState);
+
+    int getNumChannels() const;
+
+    /** Sets the number shown for a channel, which can differ from its index (e.g. after a channel mapper) */
+    void setDisplayNumber (int channel, int displayNumber);
+
+    bool getState (int channel) const;
+
+    /** Sets the state of a channel. In radio mode, turning a channel on turns the others off. */
+    void setState (int channel, bool state, NotificationType notification);
+
+    /** Sets the state of every channel */
+    void setAllStates (bool state, NotificationType notification);
+
+    /** Returns the indices of the channels that are on */
+    Array<int> getSelectedChannels() const;
+
+    /** Inactive grids are drawn greyed out and ignore the mouse */
+    void setActive (bool isActive);
+
+    /** In radio mode at most one channel is on at a time */
+    void setRadioMode (bool isRadioMode);
+
+    void setCellSize (int cellWidth, int cellHeight);
+
+    void setListener (Listener* listener);
+
+private:
+    /** Returns the channel whose cell contains position, or -1 */
+    int getChannelAtPosition (juce::Point<int> position) const;
+
+    juce::Rectangle<int> getCellBounds (int channel) const;
+
+    void repaintChannel (int channel);
+
+    int getContentHeight() const;
+
+    void setScrollOffset (int newOffset);
+
+    int m_type;
+    Font m_font;
+
+    BigInteger m_states;
+    Array<int> m_displayNumbers;
+    int m_numChannels;
+
+    int m_cellWidth;
+    int m_cellHeight;
+    int m_numColumns;
+    int m_padding;
+    int m_scrollOffset;
+
+    int m_hoveredChannel;
+    int m_firstDraggedChannel;
+    int m_lastDraggedChannel;
+    bool m_isDragging;
+
+    bool m_isActive;
+    bool m_isRadioMode;
+
+    Listener* m_listener;
+
+    // ====================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelSelectorGrid)
+};
+
+
 /**
 Automatically creates an interactive editor for selecting channels.
 
@@ -127,6 +230,7 @@ channels to be selected for different purposes.
 class PLUGIN_API ChannelSelector : public Component
                                  , public Button::Listener
                                  , private SlicerChannelSelectorComponent::Listener
+                                 , private ChannelSelectorGrid::Listener
                                  , public Timer
 {
 public:
@@ -181,22 +285,22 @@ public:
     /** Called immediately after data acquisition ends.*/
     void stopAcquisition();
 
-    /** Inactivates all the ChannelSelectorButtons under the "param" tab.*/
+    /** Inactivates all the channels under the "param" tab.*/
     void inactivateButtons();
 
-    /** Activates all the ChannelSelectorButtons under the "param" tab.*/
+    /** Activates all the channels under the "param" tab.*/
     void activateButtons();
 
-    /** Inactivates all the ChannelSelectorButtons under the "rec" tab.*/
+    /** Inactivates all the channels under the "rec" tab.*/
     void inactivateRecButtons();
 
-    /** Activates all the ChannelSelectorButtons under the "rec" tab.*/
+    /** Activates all the channels under the "rec" tab.*/
     void activateRecButtons();
 
     /** Refreshes Parameter Colors on change*/
     void refreshParameterColors();
 
-    /** Controls the behavior of ChannelSelectorButtons; they can either behave
+    /** Controls the behavior of the "param" channels; they can either behave
     like radio buttons (only one selected at a time) or like toggle buttons (an
     arbitrary number can be selected at once).*/
     void setRadioStatus(bool);
@@ -216,25 +320,22 @@ private:
     EditorButton* allButton;
     EditorButton* noneButton;
 
-    /** An array of ChannelSelectorButtons used to select the channels that
-    will be updated when a parameter is changed.
+    /** The channels that will be updated when a parameter is changed.
     paramBox: TextBox where user input is taken for param tab.
     */
-    TiledButtonGroupManager parameterButtonsManager;
+    ChannelSelectorGrid parameterChannelGrid;
     SlicerChannelSelectorComponent parameterSlicerChannelSelector;
 
-    /** An array of ChannelSelectorButtons used to select the channels that
-    are sent to the audio monitor.
+    /** The channels that are sent to the audio monitor.
     audioBox: TextBox where user input is taken for audio tab
     */
-    TiledButtonGroupManager audioButtonsManager;
+    ChannelSelectorGrid audioChannelGrid;
     SlicerChannelSelectorComponent audioSlicerChannelSelector;
 
-    /** An array of ChannelSelectorButtons used to select the channels that
-    will be written to disk when the record button is pressed.
+    /** The channels that will be written to disk when the record button is pressed.
     recordBox: TextBox where user input is taken for record tab
     */
-    TiledButtonGroupManager recordButtonsManager;
+    ChannelSelectorGrid recordChannelGrid;
     SlicerChannelSelectorComponent recordSlicerChannelSelector;
 
     bool paramsToggled;
@@ -243,6 +344,8 @@ private:
     bool radioStatus;
 
     bool isNotSink;
+    /** Set while many channels change at once, so parameter colours are refreshed only at the end */
+    bool isChangingManyChannels;
     bool moveRight;
     bool moveLeft;
 
@@ -261,10 +364,10 @@ private:
 
     void resized();
 
-    void addButton();
-    void removeButton();
     void refreshButtonBoundaries();
 
+    ChannelSelectorGrid* getGridForChannelsType (Channels::ChannelsType channelsType);
+
     /** Controls the speed of animations. */
     void timerCallback();
 
@@ -283,6 +386,9 @@ private:
                                                bool isCollapsed)    override;
     // =================================================================================================
 
+    /** Applies a channel's new audio, record or parameter state to the editor */
+    void channelStateChanged (ChannelSelectorGrid* grid, int channel, bool state) override;
+
     Font& titleFont;
 
     enum { AUDIO, RECORD, PARAMETER };
@@ -328,39 +434,4 @@ private:
 };
 
 
-/**
-
-A button within the ChannelSelector representing an individual channel.
-
-@see ChannelSelector
-
-*/
-
-class ChannelSelectorButton : public Button
-{
-public:
-    ChannelSelectorButton(int num, int type, Font& f);
-    ~ChannelSelectorButton();
-
-    int getType();
-    int getChannel();
-    //Channel* getChannel() {return ch;}
-    void setActive(bool t);
-    void setChannel(int n);
-    void setChannel(int n, int d);
-
-private:
-    void paintButton(Graphics& g, bool isMouseOver, bool isButtonDown);
-
-    //Channel* ch;
-
-    int type;
-    int num;
-    int displayNum;
-    Font buttonFont;
-    bool isActive;
-};
-
-
-
 #endif  // __CHANNELSELECTOR_H_68124E35__
@@ -466,6 +466,46 @@ TTLEventPtr TTLEvent::deserializeFromMessage(const MidiMessage& msg, const Event
 	}
 }
 
+//TTLEventWriter
+
+TTLEventWriter::TTLEventWriter(const EventChannel* channelInfo)
+	: m_channelInfo(channelInfo),
+	m_eventSize(EVENT_BASE_SIZE + channelInfo->getDataSize() + channelInfo->getTotalEventMetaDataSize()),
+	m_dataSize(channelInfo->getDataSize())
+{
+	jassert(channelInfo->getChannelType() == EventChannel::TTL && channelInfo->getEventMetaDataCount() == 0);
+
+	m_event.calloc(m_eventSize);
+	uint64 word = 0;
+	TTLEventPtr event = TTLEvent::createTTLEvent(channelInfo, 0, &word, sizeof(word), 0);
+	if (event)
+		event->serialize(m_event, m_eventSize);
+}
+
+TTLEventWriter::~TTLEventWriter() {}
+
+const EventChannel* TTLEventWriter::getChannelInfo() const
+{
+	return m_channelInfo;
+}
+
+void TTLEventWriter::writeEvent(MidiBuffer& buffer, int sampleNum, juce::int64 timestamp, uint16 channel, const void* ttlWord) const
+{
+	//Same layout MidiBuffer::addEvent writes: sample position, event size and the event itself
+	const int offset = buffer.data.size();
+	buffer.data.resize(offset + sizeof(int32) + sizeof(uint16) + m_eventSize);
+
+	uint8* d = buffer.data.begin() + offset;
+	writeUnaligned<int32>(d, sampleNum);
+	writeUnaligned<uint16>(d + 4, static_cast<uint16>(m_eventSize));
+
+	char* event = reinterpret_cast<char*>(d + 6);
+	memcpy(event, m_event.getData(), m_eventSize);
+	writeUnaligned<juce::int64>(event + 8, timestamp);
+	writeUnaligned<uint16>(event + 16, channel);
+	memcpy(event + EVENT_BASE_SIZE, ttlWord, m_dataSize);
+}
+
 //TextEvent
 TextEvent::TextEvent(const EventChannel* channelInfo, juce::int64 timestamp, uint16 channel, const String& text)
 	: Event(channelInfo, timestamp, channel)
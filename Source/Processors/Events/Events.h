@@ -190,6 +190,33 @@ private:
 	JUCE_LEAK_DETECTOR(TTLEvent);
 };
 
+/**
+Writes serialized TTL events of one channel straight into a MidiBuffer, without creating an event object
+for each of them. The event is serialized once, when the writer is created, and only its timestamp, channel
+and TTL word are changed for every new one. Events are appended, so they must be written in increasing
+sample order, to a buffer holding only events at or before the first sample written.
+Channels with metadata are not supported.
+*/
+class PLUGIN_API TTLEventWriter
+{
+public:
+	TTLEventWriter(const EventChannel* channelInfo);
+	~TTLEventWriter();
+
+	/** Appends a TTL event at sampleNum. ttlWord must hold the channel's data size bytes */
+	void writeEvent(MidiBuffer& buffer, int sampleNum, juce::int64 timestamp, uint16 channel, const void* ttlWord) const;
+
+	const EventChannel* getChannelInfo() const;
+private:
+	TTLEventWriter() = delete;
+	const EventChannel* m_channelInfo;
+	HeapBlock<char> m_event;
+	size_t m_eventSize;
+	size_t m_dataSize;
+
+	JUCE_LEAK_DETECTOR(TTLEventWriter);
+};
+
 typedef ScopedPointer<TextEvent> TextEventPtr;
 class PLUGIN_API TextEvent
 	: public Event
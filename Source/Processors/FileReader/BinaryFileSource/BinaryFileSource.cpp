@@ -23,6 +23,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "BinaryFileSource.h"
 
+#if JUCE_INTEL
+#include <emmintrin.h>
+#endif
+
+#if JUCE_LINUX || JUCE_MAC
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 using namespace BinarySource;
 
 BinaryFileSource::BinaryFileSource() : m_samplePos(0)
@@ -46,6 +55,21 @@ bool BinaryFileSource::Open(File file)
 
 	m_rootPath = file.getParentDirectory();
 
+	// a split recording lists its segment folders, which are read back to back
+	m_segmentFolders.clear();
+	String segmentIndex = m_jsonData["segment_index"];
+	if (segmentIndex.isNotEmpty())
+	{
+		var segments = JSON::parse(m_rootPath.getChildFile(segmentIndex))["segments"];
+		for (int i = 0; i < segments.size(); i++)
+		{
+			String folderName = segments[i]["folder_name"];
+			m_segmentFolders.add(m_rootPath.getChildFile(folderName.trimCharactersAtEnd("/")));
+		}
+	}
+	if (m_segmentFolders.size() == 0)
+		m_segmentFolders.add(m_rootPath);
+
 	return true;
 }
 
@@ -60,6 +84,9 @@ void BinaryFileSource::fillRecordInfo()
 	Identifier idChannels("channels");
 	Identifier idChannelName("channel_name");
 	Identifier idBitVolts("bit_volts");
+	Identifier idSourceId("source_processor_id");
+	Identifier idSourceSubIdx("source_processor_sub_idx");
+	Identifier idSourceIndex("source_processor_index");
 
 	int numProcessors = continuousData.size();
 
@@ -76,16 +103,38 @@ void BinaryFileSource::fillRecordInfo()
 		String folderName = record[idFolder];
 		folderName = folderName.trimCharactersAtEnd("/");
 
-		File dataFile = m_rootPath.getChildFile("continuous").getChildFile(folderName).getChildFile("continuous.dat");
-		if (!dataFile.existsAsFile()) continue;
-
 		int numChannels = record[idNumChannels];
-		int64 numSamples = (dataFile.getSize() / numChannels) / sizeof(int16);
+		ScopedPointer<OwnedArray<RecordSegment>> segments = new OwnedArray<RecordSegment>();
+		int64 numSamples = 0;
+
+		for (int s = 0; s < m_segmentFolders.size(); s++)
+		{
+			File dataFile = m_segmentFolders[s].getChildFile("continuous").getChildFile(folderName).getChildFile("continuous.dat");
+			if (!dataFile.existsAsFile()) continue;
+
+			RecordSegment* segment = new RecordSegment();
+			segment->dataFile = dataFile;
+			segment->firstSample = numSamples;
+			segment->numSamples = (dataFile.getSize() / numChannels) / sizeof(int16);
+			numSamples += segment->numSamples;
+
+			// full per-sample arrays or the compact index, whichever was recorded
+			segment->timestamps = new TimestampReader();
+			if (!segment->timestamps->open(dataFile.getParentDirectory()))
+				std::cout << "No timestamps found for " << folderName << ", assuming contiguous samples" << std::endl;
+
+			segments->add(segment);
+		}
+		if (segments->size() == 0) continue;
 
 		info.name = folderName;
 		info.sampleRate = record[idSampleRate];
 		info.numSamples = numSamples;
 
+		RecordSource source;
+		source.processorId = record.getProperty(idSourceId, -1);
+		source.subProcessorIdx = record.getProperty(idSourceSubIdx, -1);
+
 		for (int c = 0; c < numChannels; c++)
 		{
 			var chan = channels[c];
@@ -95,21 +144,158 @@ void BinaryFileSource::fillRecordInfo()
 			cInfo.bitVolts = chan[idBitVolts];
 			
 			info.channels.add(cInfo);
+			source.channels.add(chan.getProperty(idSourceIndex, c));
 		}
+		m_recordSources.add(source);
 		
 		infoArray.add(info);
 		numRecords++;	
 
-		m_dataFileArray.add(dataFile);
-		
+		m_recordSegments.add(segments.release());
+	}
+
+	fillEventInfo();
+	fillSpikeInfo();
+}
+
+void BinaryFileSource::fillEventInfo()
+{
+	var eventData = m_jsonData["events"];
+
+	Identifier idFolder("folder_name");
+	Identifier idChannelName("channel_name");
+	Identifier idDescription("description");
+	Identifier idNumChannels("num_channels");
+
+	for (int i = 0; i < eventData.size(); i++)
+	{
+		var record = eventData[i];
+		String folderName = record[idFolder];
+		folderName = folderName.trimCharactersAtEnd("/");
+
+		// text and binary events are not replayed
+		if (!folderName.fromLastOccurrenceOf("/", false, false).startsWith("TTL"))
+			continue;
+
+		int channel = m_eventChannels.size();
+		for (int s = 0; s < m_segmentFolders.size(); s++)
+		{
+			ScopedPointer<EventReader> reader = new EventReader();
+			if (!reader->open(m_segmentFolders[s].getChildFile("events").getChildFile(folderName)))
+				continue;
+
+			m_eventReaders.add(reader.release());
+			m_eventReaderChannels.add(channel);
+		}
+
+		if (m_eventReaderChannels.getLast() != channel || m_eventReaders.size() == 0)
+		{
+			std::cout << "Could not open TTL events in " << folderName << std::endl;
+			continue;
+		}
+
+		RecordedEventChannelInfo info;
+		info.name = record[idChannelName];
+		info.description = record[idDescription];
+		info.numChannels = record[idNumChannels];
+
+		m_eventChannels.add(info);
 	}
+}
+
+void BinaryFileSource::fillSpikeInfo()
+{
+	var spikeData = m_jsonData["spikes"];
+
+	Identifier idFolder("folder_name");
+	Identifier idChannels("channels");
+	Identifier idChannelName("channel_name");
+	Identifier idPrePeak("pre_peak_samples");
+	Identifier idPostPeak("post_peak_samples");
+	Identifier idSourceInfo("source_channel_info");
+	Identifier idSourceId("source_processor_id");
+	Identifier idSourceSubIdx("source_processor_sub_idx");
+	Identifier idSourceChannel("source_processor_channel");
+
+	for (int i = 0; i < spikeData.size(); i++)
+	{
+		var record = spikeData[i];
+		String folderName = record[idFolder];
+		folderName = folderName.trimCharactersAtEnd("/");
+
+		int prePeak = record[idPrePeak];
+		int postPeak = record[idPostPeak];
+
+		// every electrode of a group shares one set of files
+		var electrodes = record[idChannels];
+		if (electrodes.size() <= 0) continue;
+
+		int firstChannel = m_spikeElectrodes.size();
+		int numReaders = m_spikeReaders.size();
+		for (int s = 0; s < m_segmentFolders.size(); s++)
+		{
+			ScopedPointer<SpikeReader> reader = new SpikeReader();
+			if (!reader->open(m_segmentFolders[s].getChildFile("spikes").getChildFile(folderName), prePeak + postPeak))
+				continue;
+
+			m_spikeReaders.add(reader.release());
+			m_firstSpikeChannels.add(firstChannel);
+		}
+
+		if (m_spikeReaders.size() == numReaders)
+		{
+			std::cout << "Could not open spikes in " << folderName << std::endl;
+			continue;
+		}
+
+		const SpikeReader* reader = m_spikeReaders.getLast();
 
+		for (int e = 0; e < electrodes.size(); e++)
+		{
+			var electrode = electrodes[e];
+			SpikeElectrode elec;
+
+			elec.info.name = electrode[idChannelName];
+			elec.info.numChannels = reader->getNumChannels();
+			elec.info.prePeakSamples = prePeak;
+			elec.info.postPeakSamples = postPeak;
+
+			var sources = electrode[idSourceInfo];
+			for (int c = 0; c < reader->getNumChannels(); c++)
+			{
+				var source = sources[c];
+				elec.sourceProcessorIds.add(source.getProperty(idSourceId, -1));
+				elec.sourceSubProcessors.add(source.getProperty(idSourceSubIdx, -1));
+				elec.sourceChannels.add(source.getProperty(idSourceChannel, -1));
+			}
+
+			m_spikeElectrodes.add(elec);
+		}
+	}
 }
 
 void BinaryFileSource::updateActiveRecord()
 {
-	m_dataFile = new MemoryMappedFile(m_dataFileArray[activeRecord.get()], MemoryMappedFile::readOnly);
+	const OwnedArray<RecordSegment>& segments = *m_recordSegments[activeRecord.get()];
+
+	m_dataFiles.clear();
+	for (int s = 0; s < segments.size(); s++)
+	{
+		MemoryMappedFile* dataFile = new MemoryMappedFile(segments[s]->dataFile, MemoryMappedFile::readOnly);
+		m_dataFiles.add(dataFile);
+
+#if JUCE_LINUX || JUCE_MAC
+		// playback walks the file front to back, so let the kernel read ahead aggressively
+		if (dataFile->getData() != nullptr)
+			madvise(dataFile->getData(), dataFile->getSize(), MADV_SEQUENTIAL);
+#endif
+	}
 	m_samplePos = 0;
+
+	int numChannels = getActiveNumChannels();
+	m_bitVolts.malloc(numChannels);
+	for (int i = 0; i < numChannels; i++)
+		m_bitVolts[i] = getChannelInfo(i).bitVolts;
 }
 
 void BinaryFileSource::seekTo(int64 sample)
@@ -131,11 +317,35 @@ int BinaryFileSource::readData(int16* buffer, int nSamples)
 		samplesToRead = nSamples;
 	}
 
-	int16* data = static_cast<int16*>(m_dataFile->getData()) + (m_samplePos * nChans);
+	const OwnedArray<RecordSegment>& segments = *m_recordSegments[activeRecord.get()];
+	int64 samplesRead = 0;
+
+	while (samplesRead < samplesToRead)
+	{
+		int s = findSegment(m_samplePos);
+		const int16* data = static_cast<const int16*>(m_dataFiles[s]->getData());
+		if (data == nullptr)
+			break;
 
-	memcpy(buffer, data, samplesToRead*nChans*sizeof(int16));
-    m_samplePos += samplesToRead;
-	return samplesToRead;
+		int64 offset = m_samplePos - segments[s]->firstSample;
+		int64 n = jmin(samplesToRead - samplesRead, segments[s]->numSamples - offset);
+
+		memcpy(buffer + samplesRead*nChans, data + offset*nChans, n*nChans*sizeof(int16));
+		samplesRead += n;
+		m_samplePos += n;
+	}
+	return samplesRead;
+}
+
+int BinaryFileSource::findSegment(int64 sample) const
+{
+	const OwnedArray<RecordSegment>& segments = *m_recordSegments[activeRecord.get()];
+
+	// empty segments share their first sample with the next one, which wins
+	int s = segments.size() - 1;
+	while (s > 0 && segments[s]->firstSample > sample)
+		s--;
+	return s;
 }
 
 void BinaryFileSource::processChannelData(int16* inBuffer, float* outBuffer, int channel, int64 numSamples)
@@ -149,6 +359,206 @@ void BinaryFileSource::processChannelData(int16* inBuffer, float* outBuffer, int
 	}
 }
 
+#if JUCE_INTEL
+namespace
+{
+	/** Transposes eight interleaved samples of eight channels into eight runs of eight
+	samples, one per channel, converting them to float and scaling by each channel's bitVolts */
+	inline void convertBlock8x8(const int16* in, int stride, float* const* out, int64 offset, const float* bitVolts)
+	{
+		__m128i r[8];
+		for (int i = 0; i < 8; i++)
+			r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * stride));
+
+		const __m128i t0 = _mm_unpacklo_epi16(r[0], r[1]);
+		const __m128i t1 = _mm_unpackhi_epi16(r[0], r[1]);
+		const __m128i t2 = _mm_unpacklo_epi16(r[2], r[3]);
+		const __m128i t3 = _mm_unpackhi_epi16(r[2], r[3]);
+		const __m128i t4 = _mm_unpacklo_epi16(r[4], r[5]);
+		const __m128i t5 = _mm_unpackhi_epi16(r[4], r[5]);
+		const __m128i t6 = _mm_unpacklo_epi16(r[6], r[7]);
+		const __m128i t7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+		const __m128i u0 = _mm_unpacklo_epi32(t0, t2); // channels 0 and 1 of samples 0-3
+		const __m128i u1 = _mm_unpackhi_epi32(t0, t2); // channels 2 and 3
+		const __m128i u2 = _mm_unpacklo_epi32(t1, t3); // channels 4 and 5
+		const __m128i u3 = _mm_unpackhi_epi32(t1, t3); // channels 6 and 7
+		const __m128i u4 = _mm_unpacklo_epi32(t4, t6); // the same for samples 4-7
+		const __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+		const __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+		const __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+		__m128i col[8];
+		col[0] = _mm_unpacklo_epi64(u0, u4);
+		col[1] = _mm_unpackhi_epi64(u0, u4);
+		col[2] = _mm_unpacklo_epi64(u1, u5);
+		col[3] = _mm_unpackhi_epi64(u1, u5);
+		col[4] = _mm_unpacklo_epi64(u2, u6);
+		col[5] = _mm_unpackhi_epi64(u2, u6);
+		col[6] = _mm_unpacklo_epi64(u3, u7);
+		col[7] = _mm_unpackhi_epi64(u3, u7);
+
+		for (int c = 0; c < 8; c++)
+		{
+			// duplicating each lane and shifting back sign-extends the samples to 32 bits
+			const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(col[c], col[c]), 16);
+			const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(col[c], col[c]), 16);
+			const __m128 scale = _mm_set1_ps(bitVolts[c]);
+
+			_mm_storeu_ps(out[c] + offset, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+			_mm_storeu_ps(out[c] + offset + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+		}
+	}
+}
+#endif
+
+void BinaryFileSource::processData(const int16* inBuffer, float* const* outBuffers, int64 numSamples)
+{
+	// The block is walked in strips of a few samples, so the interleaved data is read
+	// once for all channels instead of once per channel
+	const int stripSamples = 8;
+	const int n = getActiveNumChannels();
+
+	for (int64 s0 = 0; s0 < numSamples; s0 += stripSamples)
+	{
+		const int ns = int(jmin(int64(stripSamples), numSamples - s0));
+		const int16* in = inBuffer + s0 * n;
+		int c0 = 0;
+
+#if JUCE_INTEL
+		if (ns == stripSamples)
+		{
+			for (; c0 + 8 <= n; c0 += 8)
+				convertBlock8x8(in + c0, n, outBuffers + c0, s0, m_bitVolts + c0);
+		}
+#endif
+
+		// channels left over from the 8x8 blocks, and the last partial strip
+		for (int s = 0; s < ns; s++)
+		{
+			for (int c = c0; c < n; c++)
+				outBuffers[c][s0 + s] = in[s * n + c] * m_bitVolts[c];
+		}
+	}
+}
+
+const int16* BinaryFileSource::getDirectReadPointer(int64 sample) const
+{
+	// a block can straddle two segments, so split records are always copied by readData
+	if (m_dataFiles.size() != 1 || m_dataFiles[0]->getData() == nullptr)
+		return nullptr;
+
+	return static_cast<const int16*>(m_dataFiles[0]->getData()) + (sample * getActiveNumChannels());
+}
+
+void BinaryFileSource::prefetch(int64 sample, int64 numSamples)
+{
+	if (m_dataFiles.size() != 1 || m_dataFiles[0]->getData() == nullptr)
+		return;
+
+	const MemoryMappedFile* dataFile = m_dataFiles[0];
+	const int64 bytesPerSample = getActiveNumChannels() * sizeof(int16);
+	const int64 fileSize = dataFile->getSize();
+
+	int64 start = jlimit(int64(0), fileSize, sample * bytesPerSample);
+	int64 end = jlimit(int64(0), fileSize, (sample + numSamples) * bytesPerSample);
+
+	const int64 pageSize = 4096;
+	start -= start % pageSize; // the mapping itself is page aligned
+
+	if (end <= start)
+		return;
+
+	const char* data = static_cast<const char*>(dataFile->getData());
+
+#if JUCE_LINUX || JUCE_MAC
+	madvise(const_cast<char*>(data + start), size_t(end - start), MADV_WILLNEED);
+#endif
+
+	// touch every page so the audio thread never waits on a page fault
+	volatile char sink = 0;
+	for (int64 offset = start; offset < end; offset += pageSize)
+		sink += data[offset];
+	(void)sink;
+}
+
+void BinaryFileSource::readTimestamps(int64 startSample, int numSamples, int64* timestamps)
+{
+	const OwnedArray<RecordSegment>& segments = *m_recordSegments[activeRecord.get()];
+	int i = 0;
+
+	while (i < numSamples)
+	{
+		const int64 sample = startSample + i;
+		int s = findSegment(sample);
+		const RecordSegment* segment = segments[s];
+
+		// every segment's timestamp files count samples from its own start; the last one extends past its end
+		const int64 offset = sample - segment->firstSample;
+		int n = numSamples - i;
+		if (s < segments.size() - 1)
+			n = int(jmin(int64(n), segment->numSamples - offset));
+
+		segment->timestamps->readTimestamps(offset, n, timestamps + i);
+
+		// without timestamp files, samples count from the start of the record
+		if (segment->timestamps->getNumSamples() == 0)
+			for (int j = 0; j < n; j++)
+				timestamps[i + j] += segment->firstSample;
+
+		i += n;
+	}
+}
+
+int BinaryFileSource::getNumEventChannels() const
+{
+	return m_eventChannels.size();
+}
+
+RecordedEventChannelInfo BinaryFileSource::getEventChannelInfo(int index) const
+{
+	return m_eventChannels[index];
+}
+
+int BinaryFileSource::getNumSpikeChannels() const
+{
+	return m_spikeElectrodes.size();
+}
+
+RecordedSpikeChannelInfo BinaryFileSource::getSpikeChannelInfo(int index) const
+{
+	const SpikeElectrode& elec = m_spikeElectrodes.getReference(index);
+	RecordedSpikeChannelInfo info = elec.info;
+
+	// point the electrode at the active record's channels, if it was recorded from them
+	const RecordSource record = m_recordSources[activeRecord.get()];
+
+	for (int c = 0; c < info.numChannels; c++)
+	{
+		int channel = -1;
+
+		if (record.channels.size() > 0 && elec.sourceProcessorIds[c] == record.processorId
+			&& elec.sourceSubProcessors[c] == record.subProcessorIdx)
+			channel = record.channels.indexOf(elec.sourceChannels[c]);
+
+		info.sourceChannels.add(channel);
+	}
+
+	return info;
+}
+
+void BinaryFileSource::readEvents(int64 startTimestamp, int64 endTimestamp, Array<RecordedEvent>& events)
+{
+	for (int i = 0; i < m_eventReaders.size(); i++)
+		m_eventReaders[i]->readEvents(startTimestamp, endTimestamp, m_eventReaderChannels[i], events);
+}
+
+void BinaryFileSource::readSpikes(int64 startTimestamp, int64 endTimestamp, Array<RecordedSpike>& spikes)
+{
+	for (int i = 0; i < m_spikeReaders.size(); i++)
+		m_spikeReaders[i]->readSpikes(startTimestamp, endTimestamp, m_firstSpikeChannels[i], spikes);
+}
+
 bool BinaryFileSource::isReady()
 {
 	return true;
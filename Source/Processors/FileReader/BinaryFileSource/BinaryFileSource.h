@@ -25,6 +25,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define BINARYFILESOURCE_H_INCLUDED
 
 #include "../FileSource.h"
+#include "TimestampReader.h"
+#include "EventReader.h"
 
 namespace BinarySource
 {
@@ -40,6 +42,22 @@ namespace BinarySource
 
 		void processChannelData(int16* inBuffer, float* outBuffer, int channel, int64 numSamples) override;
 
+		void processData(const int16* inBuffer, float* const* outBuffers, int64 numSamples) override;
+
+		const int16* getDirectReadPointer(int64 sample) const override;
+
+		void prefetch(int64 sample, int64 numSamples) override;
+
+		void readTimestamps(int64 startSample, int numSamples, int64* timestamps) override;
+
+		int getNumEventChannels() const override;
+		RecordedEventChannelInfo getEventChannelInfo(int index) const override;
+		int getNumSpikeChannels() const override;
+		RecordedSpikeChannelInfo getSpikeChannelInfo(int index) const override;
+
+		void readEvents(int64 startTimestamp, int64 endTimestamp, Array<RecordedEvent>& events) override;
+		void readSpikes(int64 startTimestamp, int64 endTimestamp, Array<RecordedSpike>& spikes) override;
+
 		bool isReady() override;
 
 	private:
@@ -47,12 +65,56 @@ namespace BinarySource
 		void fillRecordInfo() override;
 		void updateActiveRecord() override;
 
-		ScopedPointer<MemoryMappedFile> m_dataFile;
+		void fillEventInfo();
+		void fillSpikeInfo();
+
+		/** Returns the segment of the active record that holds sample */
+		int findSegment(int64 sample) const;
+
+		/** Where the channels of a continuous record originally came from */
+		struct RecordSource
+		{
+			int processorId;
+			int subProcessorIdx;
+			Array<int> channels; // source processor channel of each recorded channel
+		};
+
+		/** A recorded electrode and the source channels of its waveforms */
+		struct SpikeElectrode
+		{
+			RecordedSpikeChannelInfo info;
+			Array<int> sourceProcessorIds;
+			Array<int> sourceSubProcessors;
+			Array<int> sourceChannels;
+		};
+
+		/** The part of a continuous record stored in one segment folder */
+		struct RecordSegment
+		{
+			File dataFile;
+			int64 firstSample;
+			int64 numSamples;
+			ScopedPointer<TimestampReader> timestamps;
+		};
+
+		OwnedArray<MemoryMappedFile> m_dataFiles; // per segment of the active record
 		var m_jsonData;
-		Array<File> m_dataFileArray;
+		Array<File> m_segmentFolders; // just the root folder, unless the recording was split
+		OwnedArray<OwnedArray<RecordSegment>> m_recordSegments; // per record
+		Array<RecordSource> m_recordSources; // per record
+
+		OwnedArray<EventReader> m_eventReaders;
+		Array<int> m_eventReaderChannels; // per event reader, one for every segment of a channel
+		Array<RecordedEventChannelInfo> m_eventChannels;
+
+		OwnedArray<SpikeReader> m_spikeReaders;
+		Array<int> m_firstSpikeChannels; // per spike reader, one for every segment of a group
+		Array<SpikeElectrode> m_spikeElectrodes;
 
 		File m_rootPath;
 		int64 m_samplePos;
+
+		HeapBlock<float> m_bitVolts; // per channel of the active record
 		
 	};
 }
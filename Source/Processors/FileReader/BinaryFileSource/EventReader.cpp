@@ -0,0 +1,200 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "EventReader.h"
+
+#include <algorithm>
+
+using namespace BinarySource;
+
+EventTimestamps::EventTimestamps() : m_sorted(true)
+{}
+
+bool EventTimestamps::open(File file)
+{
+	m_order.free();
+	m_sorted = true;
+
+	if (!m_file.open(file))
+		return false;
+
+	const int64 numEvents = m_file.getNumRecords();
+
+	for (int64 i = 1; i < numEvents && m_sorted; i++)
+		m_sorted = m_file.getValue<int64>(i - 1) <= m_file.getValue<int64>(i);
+
+	if (!m_sorted)
+	{
+		m_order.malloc(size_t(numEvents));
+		for (int64 i = 0; i < numEvents; i++)
+			m_order[i] = i;
+
+		const MappedNpyFile& times = m_file;
+		std::stable_sort(m_order.getData(), m_order.getData() + numEvents,
+			[&times](int64 a, int64 b) { return times.getValue<int64>(a) < times.getValue<int64>(b); });
+	}
+
+	return true;
+}
+
+int64 EventTimestamps::getNumEvents() const
+{
+	return m_file.getNumRecords();
+}
+
+int64 EventTimestamps::getRecordIndex(int64 position) const
+{
+	return m_sorted ? position : m_order[position];
+}
+
+int64 EventTimestamps::getTimestamp(int64 position) const
+{
+	return m_file.getValue<int64>(getRecordIndex(position));
+}
+
+int64 EventTimestamps::findFirst(int64 timestamp) const
+{
+	if (m_sorted)
+		return m_file.upperBound<int64>(timestamp - 1);
+
+	int64 low = 0;
+	int64 high = getNumEvents();
+
+	while (low < high)
+	{
+		int64 mid = low + (high - low) / 2;
+
+		if (getTimestamp(mid) < timestamp)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+bool EventReader::open(File folder)
+{
+	if (!m_timestamps.open(folder.getChildFile("timestamps.npy")))
+		return false;
+
+	if (!m_states.open(folder.getChildFile("channel_states.npy")))
+		return false;
+
+	// only present if the recording saved full TTL words
+	m_words.open(folder.getChildFile("full_words.npy"));
+
+	return true;
+}
+
+void EventReader::readEvents(int64 startTimestamp, int64 endTimestamp, int eventChannel, Array<RecordedEvent>& events) const
+{
+	const int64 numEvents = jmin(m_timestamps.getNumEvents(), m_states.getNumRecords());
+	const int wordSize = jmin(m_words.getRecordSize(), int(sizeof(uint64)));
+
+	for (int64 pos = m_timestamps.findFirst(startTimestamp); pos < m_timestamps.getNumEvents(); pos++)
+	{
+		const int64 timestamp = m_timestamps.getTimestamp(pos);
+		if (timestamp >= endTimestamp)
+			break;
+
+		const int64 index = m_timestamps.getRecordIndex(pos);
+		if (index >= numEvents)
+			continue;
+
+		// stored as +-(channel + 1), the sign being the new state
+		const int16 state = m_states.getValue<int16>(index);
+		if (state == 0)
+			continue;
+
+		RecordedEvent ev;
+		ev.timestamp = timestamp;
+		ev.eventChannel = eventChannel;
+		ev.channel = uint16(std::abs(int(state)) - 1);
+		ev.state = state > 0;
+		ev.hasWord = m_words.isOpen() && index < m_words.getNumRecords();
+		ev.word = 0;
+
+		if (ev.hasWord)
+			memcpy(&ev.word, m_words.getRecord(index), size_t(wordSize));
+
+		events.add(ev);
+	}
+}
+
+bool SpikeReader::open(File folder, int totalSamples)
+{
+	m_numChannels = 0;
+
+	if (totalSamples <= 0)
+		return false;
+
+	if (!m_timestamps.open(folder.getChildFile("spike_times.npy")))
+		return false;
+
+	if (!m_waveforms.open(folder.getChildFile("spike_waveforms.npy")))
+		return false;
+
+	m_numChannels = m_waveforms.getValuesPerRecord() / totalSamples;
+	if (m_numChannels <= 0 || m_numChannels * totalSamples != m_waveforms.getValuesPerRecord())
+		return false;
+
+	m_electrodes.open(folder.getChildFile("spike_electrode_indices.npy"));
+	m_clusters.open(folder.getChildFile("spike_clusters.npy"));
+
+	return true;
+}
+
+int SpikeReader::getNumChannels() const
+{
+	return m_numChannels;
+}
+
+void SpikeReader::readSpikes(int64 startTimestamp, int64 endTimestamp, int firstSpikeChannel, Array<RecordedSpike>& spikes) const
+{
+	const int64 numSpikes = jmin(m_timestamps.getNumEvents(), m_waveforms.getNumRecords());
+
+	for (int64 pos = m_timestamps.findFirst(startTimestamp); pos < m_timestamps.getNumEvents(); pos++)
+	{
+		const int64 timestamp = m_timestamps.getTimestamp(pos);
+		if (timestamp >= endTimestamp)
+			break;
+
+		const int64 index = m_timestamps.getRecordIndex(pos);
+		if (index >= numSpikes)
+			continue;
+
+		// electrode indices are 1-based within the group
+		int electrode = 0;
+		if (index < m_electrodes.getNumRecords())
+			electrode = jmax(0, int(m_electrodes.getValue<uint16>(index)) - 1);
+
+		RecordedSpike spike;
+		spike.timestamp = timestamp;
+		spike.spikeChannel = firstSpikeChannel + electrode;
+		spike.sortedID = index < m_clusters.getNumRecords() ? m_clusters.getValue<uint16>(index) : 0;
+		spike.waveform = static_cast<const int16*>(m_waveforms.getRecord(index));
+
+		spikes.add(spike);
+	}
+}
@@ -0,0 +1,99 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef EVENTREADER_H_INCLUDED
+#define EVENTREADER_H_INCLUDED
+
+#include "../FileSource.h"
+#include "MappedNpyFile.h"
+
+namespace BinarySource
+{
+	/**
+	 Timestamp column of an event or spike file, searchable by time.
+
+	 Files are normally written in time order and are searched in place. Spike
+	 groups interleave electrodes that were detected within the same block, so
+	 when a file is found out of order a sorted index is built once on open.
+	 */
+	class EventTimestamps
+	{
+	public:
+		EventTimestamps();
+
+		bool open(File file);
+
+		int64 getNumEvents() const;
+
+		/** Position, in time order, of the first event at or after the given timestamp */
+		int64 findFirst(int64 timestamp) const;
+
+		int64 getTimestamp(int64 position) const;
+
+		/** Record index in the file of the event at a time-ordered position */
+		int64 getRecordIndex(int64 position) const;
+
+	private:
+		MappedNpyFile m_file;
+		HeapBlock<int64> m_order;
+		bool m_sorted;
+	};
+
+	/** Reads the TTL events of one events/<processor>/TTL_n folder */
+	class EventReader
+	{
+	public:
+		bool open(File folder);
+
+		/** Appends the events in [startTimestamp, endTimestamp), tagged with the given channel index */
+		void readEvents(int64 startTimestamp, int64 endTimestamp, int eventChannel, Array<RecordedEvent>& events) const;
+
+	private:
+		EventTimestamps m_timestamps;
+		MappedNpyFile m_states;
+		MappedNpyFile m_words;
+	};
+
+	/** Reads the spikes of one spikes/<processor>/spike_group_n folder */
+	class SpikeReader
+	{
+	public:
+		bool open(File folder, int totalSamples);
+
+		/** Channels per electrode, taken from the waveform array shape */
+		int getNumChannels() const;
+
+		/** Appends the spikes in [startTimestamp, endTimestamp). Electrode n of the group
+			is reported as spike channel firstSpikeChannel + n. */
+		void readSpikes(int64 startTimestamp, int64 endTimestamp, int firstSpikeChannel, Array<RecordedSpike>& spikes) const;
+
+	private:
+		EventTimestamps m_timestamps;
+		MappedNpyFile m_waveforms;
+		MappedNpyFile m_electrodes;
+		MappedNpyFile m_clusters;
+		int m_numChannels;
+	};
+}
+
+#endif
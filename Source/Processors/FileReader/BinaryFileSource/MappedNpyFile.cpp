@@ -0,0 +1,176 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "MappedNpyFile.h"
+
+using namespace BinarySource;
+
+MappedNpyFile::MappedNpyFile()
+	: m_data(nullptr), m_numRecords(0), m_recordSize(0), m_valuesPerRecord(0)
+{}
+
+bool MappedNpyFile::open(File file)
+{
+	m_file = nullptr;
+	m_data = nullptr;
+	m_numRecords = 0;
+
+	if (!file.existsAsFile())
+		return false;
+
+	ScopedPointer<MemoryMappedFile> mappedFile = new MemoryMappedFile(file, MemoryMappedFile::readOnly);
+	const char* data = static_cast<const char*>(mappedFile->getData());
+	const int64 size = mappedFile->getSize();
+
+	// magic (6) + version (2) + header length (2 for v1, 4 for v2)
+	if (data == nullptr || size < 10 || uint8(data[0]) != 0x93 || memcmp(data + 1, "NUMPY", 5) != 0)
+		return false;
+
+	const int majorVersion = data[6];
+	int64 headerStart, headerLength;
+
+	if (majorVersion == 1)
+	{
+		headerStart = 10;
+		headerLength = ByteOrder::littleEndianShort(data + 8);
+	}
+	else
+	{
+		headerStart = 12;
+		headerLength = ByteOrder::littleEndianInt(data + 8);
+	}
+
+	if (headerStart + headerLength > size)
+		return false;
+
+	if (!parseHeader(String(data + headerStart, size_t(headerLength))) || m_recordSize <= 0)
+		return false;
+
+	m_data = data + headerStart + headerLength;
+	m_numRecords = (size - headerStart - headerLength) / m_recordSize;
+	m_file = mappedFile.release();
+
+	return true;
+}
+
+bool MappedNpyFile::parseHeader(const String& header)
+{
+	m_fieldNames.clear();
+	m_fieldOffsets.clear();
+
+	String descr = header.fromFirstOccurrenceOf("'descr':", false, false).trimStart();
+	String shape = header.fromFirstOccurrenceOf("'shape':", false, false)
+		.fromFirstOccurrenceOf("(", false, false).upToFirstOccurrenceOf(")", false, false);
+
+	int itemSize = 0;
+
+	if (descr.startsWithChar('['))
+	{
+		// structured: [('name', '<i8', (n,)), ...]
+		String fields = descr.substring(1).upToFirstOccurrenceOf("]", false, false);
+
+		while (fields.contains("("))
+		{
+			String field = fields.fromFirstOccurrenceOf("(", false, false);
+			String name = field.fromFirstOccurrenceOf("'", false, false).upToFirstOccurrenceOf("'", false, false);
+			String rest = field.fromFirstOccurrenceOf("'", false, false).fromFirstOccurrenceOf("'", false, false);
+			String type = rest.fromFirstOccurrenceOf("'", false, false).upToFirstOccurrenceOf("'", false, false);
+			rest = rest.fromFirstOccurrenceOf("'", false, false).fromFirstOccurrenceOf("'", false, false);
+
+			// optional sub-array shape
+			int count = 1;
+			String tail = rest.upToFirstOccurrenceOf(")", false, false);
+			if (tail.contains("("))
+			{
+				count = tail.fromFirstOccurrenceOf("(", false, false).getIntValue();
+				rest = rest.fromFirstOccurrenceOf(")", false, false);
+			}
+			fields = rest.fromFirstOccurrenceOf(")", false, false);
+
+			const int typeSize = getTypeSize(type);
+			if (typeSize <= 0)
+				return false;
+
+			m_fieldNames.add(name);
+			m_fieldOffsets.add(itemSize);
+			itemSize += typeSize * jmax(1, count);
+		}
+	}
+	else
+	{
+		itemSize = getTypeSize(descr.fromFirstOccurrenceOf("'", false, false).upToFirstOccurrenceOf("'", false, false));
+	}
+
+	if (itemSize <= 0)
+		return false;
+
+	// the first dimension is the record count, everything after it is part of a record
+	StringArray dims;
+	dims.addTokens(shape, ",", "");
+	dims.trim();
+	dims.removeEmptyStrings();
+
+	m_valuesPerRecord = 1;
+	for (int i = 1; i < dims.size(); i++)
+		m_valuesPerRecord *= dims[i].getIntValue();
+
+	m_recordSize = itemSize * m_valuesPerRecord;
+	return true;
+}
+
+int MappedNpyFile::getTypeSize(const String& typeString)
+{
+	// e.g. '<i8', '|u1', '<f4', '|S12'
+	return typeString.substring(2).getIntValue();
+}
+
+bool MappedNpyFile::isOpen() const
+{
+	return m_data != nullptr;
+}
+
+int64 MappedNpyFile::getNumRecords() const
+{
+	return m_numRecords;
+}
+
+int MappedNpyFile::getRecordSize() const
+{
+	return m_recordSize;
+}
+
+int MappedNpyFile::getValuesPerRecord() const
+{
+	return m_valuesPerRecord;
+}
+
+const void* MappedNpyFile::getRecord(int64 index) const
+{
+	return m_data + index * m_recordSize;
+}
+
+int MappedNpyFile::getFieldOffset(const String& name) const
+{
+	int index = m_fieldNames.indexOf(name);
+	return index < 0 ? -1 : m_fieldOffsets[index];
+}
@@ -0,0 +1,105 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef MAPPEDNPYFILE_H_INCLUDED
+#define MAPPEDNPYFILE_H_INCLUDED
+
+#include "../../../../JuceLibraryCode/JuceHeader.h"
+
+namespace BinarySource
+{
+	/**
+	 Read-only, memory-mapped view of an .npy file as written by the Binary
+	 record engine.
+
+	 Only the header is parsed; records are read straight from the mapping, so
+	 opening is cheap however large the file is. Structured records expose the
+	 byte offset of each named field. The record count is taken from the file
+	 size, so files from an interrupted recording (whose header may lag behind)
+	 are read in full.
+	 */
+	class MappedNpyFile
+	{
+	public:
+		MappedNpyFile();
+
+		bool open(File file);
+		bool isOpen() const;
+
+		int64 getNumRecords() const;
+
+		/** Bytes per record, including every dimension after the first */
+		int getRecordSize() const;
+
+		/** Number of values per record for a plain (non-structured) array */
+		int getValuesPerRecord() const;
+
+		const void* getRecord(int64 index) const;
+
+		/** Byte offset of a named field of a structured record, or -1 */
+		int getFieldOffset(const String& name) const;
+
+		template <typename T>
+		T getValue(int64 index, int offset = 0) const
+		{
+			T value;
+			memcpy(&value, static_cast<const char*>(getRecord(index)) + offset, sizeof(T));
+			return value;
+		}
+
+		/** Index of the first record whose T value at offset is greater than value,
+			assuming the file is sorted on it */
+		template <typename T>
+		int64 upperBound(T value, int offset = 0) const
+		{
+			int64 low = 0;
+			int64 high = m_numRecords;
+
+			while (low < high)
+			{
+				int64 mid = low + (high - low) / 2;
+
+				if (getValue<T>(mid, offset) <= value)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+
+			return low;
+		}
+
+	private:
+		bool parseHeader(const String& header);
+		static int getTypeSize(const String& typeString);
+
+		ScopedPointer<MemoryMappedFile> m_file;
+		const char* m_data;
+		int64 m_numRecords;
+		int m_recordSize;
+		int m_valuesPerRecord;
+		StringArray m_fieldNames;
+		Array<int> m_fieldOffsets;
+	};
+}
+
+#endif
@@ -0,0 +1,217 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "TimestampReader.h"
+
+using namespace BinarySource;
+
+TimestampReader::TimestampReader()
+	: m_compact(false), m_compactSync(false),
+	m_runSample(0), m_runTimestamp(0), m_runLength(0),
+	m_segSample(0), m_segLength(0), m_segStart(0), m_segPeriod(0)
+{}
+
+bool TimestampReader::open(File folder)
+{
+	m_compact = m_timestamps.open(folder.getChildFile("timestamps_index.npy"));
+
+	if (m_compact)
+	{
+		m_runSample = m_timestamps.getFieldOffset("sample_number");
+		m_runTimestamp = m_timestamps.getFieldOffset("timestamp");
+		m_runLength = m_timestamps.getFieldOffset("length");
+
+		if (m_runSample < 0 || m_runTimestamp < 0 || m_runLength < 0)
+			return false;
+	}
+	else if (!m_timestamps.open(folder.getChildFile("timestamps.npy")))
+	{
+		return false;
+	}
+
+	m_compactSync = m_syncTimestamps.open(folder.getChildFile("synchronized_timestamps_index.npy"));
+
+	if (m_compactSync)
+	{
+		m_segSample = m_syncTimestamps.getFieldOffset("sample_number");
+		m_segLength = m_syncTimestamps.getFieldOffset("length");
+		m_segStart = m_syncTimestamps.getFieldOffset("start_time");
+		m_segPeriod = m_syncTimestamps.getFieldOffset("sample_period");
+
+		if (m_segSample < 0 || m_segLength < 0 || m_segStart < 0 || m_segPeriod < 0)
+			m_compactSync = false;
+	}
+	else
+	{
+		m_syncTimestamps.open(folder.getChildFile("synchronized_timestamps.npy"));
+	}
+
+	return true;
+}
+
+int64 TimestampReader::getNumSamples() const
+{
+	if (!m_compact)
+		return m_timestamps.getNumRecords();
+
+	int64 numRuns = m_timestamps.getNumRecords();
+	if (numRuns == 0)
+		return 0;
+
+	return m_timestamps.getValue<int64>(numRuns - 1, m_runSample) + m_timestamps.getValue<int64>(numRuns - 1, m_runLength);
+}
+
+int64 TimestampReader::findRun(int64 sample) const
+{
+	return jmax(int64(0), m_timestamps.upperBound<int64>(sample, m_runSample) - 1);
+}
+
+int64 TimestampReader::findSegment(int64 sample) const
+{
+	return jmax(int64(0), m_syncTimestamps.upperBound<int64>(sample, m_segSample) - 1);
+}
+
+int64 TimestampReader::getTimestamp(int64 sample) const
+{
+	int64 ts;
+	readTimestamps(sample, 1, &ts);
+	return ts;
+}
+
+void TimestampReader::readTimestamps(int64 startSample, int numSamples, int64* timestamps) const
+{
+	const int64 numRecords = m_timestamps.getNumRecords();
+
+	if (numRecords == 0)
+	{
+		for (int i = 0; i < numSamples; i++)
+			timestamps[i] = startSample + i;
+		return;
+	}
+
+	if (!m_compact)
+	{
+		for (int i = 0; i < numSamples; i++)
+			timestamps[i] = m_timestamps.getValue<int64>(jlimit(int64(0), numRecords - 1, startSample + i));
+		return;
+	}
+
+	// walk the runs covering the range; samples past the last run extend it
+	int64 run = findRun(startSample);
+	int i = 0;
+
+	while (i < numSamples)
+	{
+		const int64 runStart = m_timestamps.getValue<int64>(run, m_runSample);
+		const int64 runTimestamp = m_timestamps.getValue<int64>(run, m_runTimestamp);
+		const bool isLastRun = run == numRecords - 1;
+
+		const int64 runEnd = isLastRun ? startSample + numSamples
+			: m_timestamps.getValue<int64>(run + 1, m_runSample);
+
+		for (; i < numSamples && startSample + i < runEnd; i++)
+			timestamps[i] = runTimestamp + (startSample + i - runStart);
+
+		if (!isLastRun)
+			run++;
+	}
+}
+
+int64 TimestampReader::findSample(int64 timestamp) const
+{
+	const int64 numRecords = m_timestamps.getNumRecords();
+
+	if (numRecords == 0)
+		return timestamp;
+
+	if (!m_compact)
+	{
+		// first sample with a timestamp >= the one asked for
+		return m_timestamps.upperBound<int64>(timestamp - 1);
+	}
+
+	int64 run = jmax(int64(0), m_timestamps.upperBound<int64>(timestamp, m_runTimestamp) - 1);
+	const int64 runStart = m_timestamps.getValue<int64>(run, m_runSample);
+	const int64 runTimestamp = m_timestamps.getValue<int64>(run, m_runTimestamp);
+	const int64 runLength = m_timestamps.getValue<int64>(run, m_runLength);
+
+	if (timestamp <= runTimestamp)
+		return runStart;
+
+	if (timestamp < runTimestamp + runLength || run == numRecords - 1)
+		return runStart + (timestamp - runTimestamp);
+
+	// falls in the gap before the next run
+	return runStart + runLength;
+}
+
+bool TimestampReader::hasSynchronizedTimestamps() const
+{
+	return m_syncTimestamps.isOpen() && m_syncTimestamps.getNumRecords() > 0;
+}
+
+double TimestampReader::getSynchronizedTimestamp(int64 sample) const
+{
+	double ts;
+	readSynchronizedTimestamps(sample, 1, &ts);
+	return ts;
+}
+
+void TimestampReader::readSynchronizedTimestamps(int64 startSample, int numSamples, double* timestamps) const
+{
+	const int64 numRecords = m_syncTimestamps.getNumRecords();
+
+	if (!m_syncTimestamps.isOpen() || numRecords == 0)
+	{
+		for (int i = 0; i < numSamples; i++)
+			timestamps[i] = -1.0;
+		return;
+	}
+
+	if (!m_compactSync)
+	{
+		for (int i = 0; i < numSamples; i++)
+			timestamps[i] = m_syncTimestamps.getValue<double>(jlimit(int64(0), numRecords - 1, startSample + i));
+		return;
+	}
+
+	int64 segment = findSegment(startSample);
+	int i = 0;
+
+	while (i < numSamples)
+	{
+		const int64 segmentStart = m_syncTimestamps.getValue<int64>(segment, m_segSample);
+		const double startTime = m_syncTimestamps.getValue<double>(segment, m_segStart);
+		const double period = m_syncTimestamps.getValue<double>(segment, m_segPeriod);
+		const bool isLastSegment = segment == numRecords - 1;
+
+		const int64 segmentEnd = isLastSegment ? startSample + numSamples
+			: m_syncTimestamps.getValue<int64>(segment + 1, m_segSample);
+
+		for (; i < numSamples && startSample + i < segmentEnd; i++)
+			timestamps[i] = startTime + double(startSample + i - segmentStart) * period;
+
+		if (!isLastSegment)
+			segment++;
+	}
+}
@@ -0,0 +1,79 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef TIMESTAMPREADER_H_INCLUDED
+#define TIMESTAMPREADER_H_INCLUDED
+
+#include "MappedNpyFile.h"
+
+namespace BinarySource
+{
+	/**
+	 Reads the sample timestamps of one continuous stream of a Binary recording.
+
+	 Both layouts written by the record engine are handled: the per-sample
+	 timestamps.npy / synchronized_timestamps.npy arrays, and the compact
+	 timestamps_index.npy runs and synchronized_timestamps_index.npy linear
+	 segments, which are expanded on demand. Lookups in the compact form are a
+	 binary search over the runs.
+	 */
+	class TimestampReader
+	{
+	public:
+		TimestampReader();
+
+		/** Opens the timestamp files in a continuous stream folder */
+		bool open(File folder);
+
+		int64 getNumSamples() const;
+
+		int64 getTimestamp(int64 sample) const;
+
+		/** Writes the timestamps of numSamples samples starting at startSample */
+		void readTimestamps(int64 startSample, int numSamples, int64* timestamps) const;
+
+		/** Returns the first sample whose timestamp is at least the given one */
+		int64 findSample(int64 timestamp) const;
+
+		bool hasSynchronizedTimestamps() const;
+
+		double getSynchronizedTimestamp(int64 sample) const;
+
+		void readSynchronizedTimestamps(int64 startSample, int numSamples, double* timestamps) const;
+
+	private:
+		int64 findRun(int64 sample) const;
+		int64 findSegment(int64 sample) const;
+
+		MappedNpyFile m_timestamps;
+		MappedNpyFile m_syncTimestamps;
+		bool m_compact;
+		bool m_compactSync;
+
+		// field offsets in the compact records
+		int m_runSample, m_runTimestamp, m_runLength;
+		int m_segSample, m_segLength, m_segStart, m_segPeriod;
+	};
+}
+
+#endif
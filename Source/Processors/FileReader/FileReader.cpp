@@ -24,6 +24,8 @@
 #include "FileReader.h"
 #include "FileReaderEditor.h"
 #include <stdio.h>
+#include <algorithm>
+#include <cmath>
 #include "../../AccessClass.h"
 #include "../../Audio/AudioComponent.h"
 #include "../PluginManager/PluginManager.h"
@@ -32,17 +34,15 @@
 
 FileReader::FileReader()
     : GenericProcessor ("File Reader")
-    , Thread ("filereader_Async_Reader")
     , timestamp             (0)
+    , systemSamples         (0)
     , currentSampleRate     (0)
     , currentNumChannels    (0)
-    , currentSample         (0)
     , currentNumSamples     (0)
     , startSample           (0)
     , stopSample            (0)
     , counter               (0)
-    , bufferCacheWindow     (0)
-    , m_shouldFillBackBuffer(false)
+    , blockTimestampsSize   (0)
 	, m_bufferSize(1024)
 	, m_sysSampleRate(44100)
 {
@@ -85,8 +85,6 @@ FileReader::FileReader()
 
 FileReader::~FileReader()
 {
-    signalThreadShouldExit();
-    notify();
 }
 
 
@@ -97,11 +95,90 @@ AudioProcessorEditor* FileReader::createEditor()
     return editor;
 }
 
+void FileReader::createDataChannels()
+{
+    GenericProcessor::createDataChannels();
+
+    // channels are created stream by stream, in subprocessor order
+    int channel = 0;
+    for (int sub = 0; sub < streams.size(); ++sub)
+    {
+        FileSource* source = streams[sub]->getSource();
+
+        for (int i = 0; i < streams[sub]->getNumChannels() && channel < dataChannelArray.size(); ++i, ++channel)
+        {
+            RecordedChannelInfo info = source->getChannelInfo (i);
+            dataChannelArray[channel]->setBitVolts (info.bitVolts);
+            dataChannelArray[channel]->setName (info.name);
+        }
+    }
+}
+
 void FileReader::createEventChannels()
 {
-    //editor = new FileReaderEditor (this, true);
+    ttlChannels.clear();
+    ttlWords.clear();
+
+    if (!input) return;
+
+    const int numEventChannels = input->getNumEventChannels();
+    for (int i = 0; i < numEventChannels; i++)
+    {
+        RecordedEventChannelInfo info = input->getEventChannelInfo(i);
+        const int nChans = jmin(info.numChannels, 64); // a TTL word is replayed as a uint64
+
+        if (nChans <= 0)
+        {
+            ttlChannels.add(nullptr);
+            ttlWords.add(0);
+            continue;
+        }
+
+        EventChannel* chan = new EventChannel(EventChannel::TTL, nChans, 0, currentSampleRate, this);
+        chan->setName(info.name.isNotEmpty() ? info.name : getName() + " recorded TTL events");
+        chan->setDescription("TTL events replayed from the file read by \"" + getName() + "\"");
+        chan->setIdentifier("filereader.ttl");
+        eventChannelArray.add(chan);
+        ttlChannels.add(chan);
+        ttlWords.add(0);
+    }
+}
+
+void FileReader::createSpikeChannels()
+{
+    replaySpikeChannels.clear();
+
+    if (!input) return;
+
+    const int numSpikeChannels = input->getNumSpikeChannels();
+    for (int i = 0; i < numSpikeChannels; i++)
+    {
+        RecordedSpikeChannelInfo info = input->getSpikeChannelInfo(i);
+        SpikeChannel::ElectrodeTypes type = SpikeChannel::typeFromNumChannels(info.numChannels);
+
+        if (type == SpikeChannel::INVALID || dataChannelArray.size() == 0)
+        {
+            replaySpikeChannels.add(nullptr);
+            continue;
+        }
+
+        // spikes detected on another stream are attached to the matching channel numbers here
+        Array<const DataChannel*> chans;
+        for (int c = 0; c < info.numChannels; c++)
+        {
+            int channel = info.sourceChannels[c];
+            if (channel < 0 || channel >= dataChannelArray.size())
+                channel = jmin(c, dataChannelArray.size() - 1);
+            chans.add(dataChannelArray[channel]);
+        }
 
-    //return editor;
+        SpikeChannel* spk = new SpikeChannel(type, this, chans);
+        spk->setNumSamples(info.prePeakSamples, info.postPeakSamples);
+        if (info.name.isNotEmpty())
+            spk->setName(info.name);
+        spikeChannelArray.add(spk);
+        replaySpikeChannels.add(spk);
+    }
 }
 
 bool FileReader::isReady()
@@ -111,6 +188,11 @@ bool FileReader::isReady()
         CoreServices::sendStatusMessage ("No file selected in File Reader.");
         return false;
     }
+    else if (streams.size() == 0)
+    {
+        CoreServices::sendStatusMessage ("No playable recording in File Reader.");
+        return false;
+    }
     else
     {
         return input->isReady();
@@ -120,21 +202,32 @@ bool FileReader::isReady()
 
 float FileReader::getDefaultSampleRate() const
 {
-    if (input)
-        return currentSampleRate;
+    return getSampleRate (0);
+}
+
+
+float FileReader::getSampleRate (int subProcessorIdx) const
+{
+    if (FileReaderStream* stream = streams[subProcessorIdx])
+        return stream->getSampleRate();
     else
         return 44100.0;
 }
 
 
+int FileReader::getNumSubProcessors() const
+{
+    return jmax (1, streams.size());
+}
+
+
 int FileReader::getDefaultNumDataOutputs(DataChannel::DataChannelTypes type, int subproc) const
 {
-    if (subproc != 0) return 0;
     if (type != DataChannel::HEADSTAGE_CHANNEL) return 0;
-    if (input)
-        return currentNumChannels;
-    else
-        return 16;
+    if (FileReaderStream* stream = streams[subproc])
+        return stream->getNumChannels();
+    if (subproc != 0 || input) return 0;
+    return 16;
 }
 
 
@@ -155,6 +248,7 @@ void FileReader::setEnabledState (bool t)
 bool FileReader::enable()
 {
 	timestamp = 0;
+	systemSamples = 0;
 
 	AudioDeviceManager& adm = AccessClass::getAudioComponent()->deviceManager;
 	AudioDeviceManager::AudioDeviceSetup ads;
@@ -163,30 +257,28 @@ bool FileReader::enable()
 	m_bufferSize = ads.bufferSize;
 	if (m_bufferSize == 0) m_bufferSize = 1024;
 
-	m_samplesPerBuffer.set(m_bufferSize * (getDefaultSampleRate() / m_sysSampleRate));
-
-	bufferA.malloc(currentNumChannels * m_bufferSize * BUFFER_WINDOW_CACHE_SIZE);
-	bufferB.malloc(currentNumChannels * m_bufferSize * BUFFER_WINDOW_CACHE_SIZE);
-
-        // reset stream to beginning
-        input->seekTo (startSample);
-        currentSample = startSample;
-        readAndFillBufferCache(bufferA); // pre-fill the front buffer with a blocking read
-
-	// set the backbuffer so that on the next call to process() we start with bufferA and buffer
-	// cache window id = 0
-	readBuffer = &bufferB;
-	bufferCacheWindow = 0;
-	m_shouldFillBackBuffer.set(false);
+	for (int i = 0; i < streams.size(); ++i)
+	{
+		// the most samples a stream hands out per block, given rounding
+		const int maxSamplesPerBlock = int (std::ceil (m_bufferSize * (streams[i]->getSampleRate() / m_sysSampleRate))) + 1;
+		streams[i]->startPlayback(maxSamplesPerBlock);
+	}
 
-	startThread(); // start async file reader thread
+	// room for the recorded timestamps of a block, should the buffer size not change
+	blockTimestampsSize = int (std::ceil (m_bufferSize * (getDefaultSampleRate() / m_sysSampleRate))) + 1;
+	blockTimestamps.malloc(blockTimestampsSize);
+	createReplayTemplates();
+	for (int i = 0; i < ttlWords.size(); i++)
+		ttlWords.set(i, 0);
 
 	return isEnabled;
 }
 
 bool FileReader::disable()
 {
-	stopThread(100);
+	for (int i = 0; i < streams.size(); ++i)
+		streams[i]->stopPlayback();
+
 	return true;
 }
 
@@ -216,20 +308,11 @@ bool FileReader::setFile (String fullpath)
     const int index = supportedExtensions[ext] - 1;
     const bool isExtensionSupported = index >= 0;
 
+    streams.clear();
+
     if (isExtensionSupported)
     {
-        const int index = supportedExtensions[ext] -1 ;
-		const int numPluginFileSources = AccessClass::getPluginManager()->getNumFileSources();
-
-		if (index < numPluginFileSources)
-		{
-			Plugin::FileSourceInfo sourceInfo = AccessClass::getPluginManager()->getFileSourceInfo(index);
-			input = sourceInfo.creator();
-		}
-		else
-		{
-			input = createBuiltInFileSource(index - numPluginFileSources);
-		}
+		input = createFileSource(ext);
 		if (!input)
 		{
 			std::cerr << "Error creating file source for extension " << ext << std::endl;
@@ -260,8 +343,10 @@ bool FileReader::setFile (String fullpath)
         return false;
     }
 
+    currentFile = file;
+
     static_cast<FileReaderEditor*> (getEditor())->populateRecordings (input);
-    setActiveRecording (0);
+    setActiveRecording (input->getNumRecords() > 1 ? getAllRecordsIndex() : 0);
     
     return true;
 }
@@ -271,26 +356,63 @@ void FileReader::setActiveRecording (int index)
 {
     if (!input) { return; }
 
-    input->setActiveRecord (index);
+    const int numRecords = input->getNumRecords();
+    const bool playAllRecords = index == getAllRecordsIndex();
+
+    if (!playAllRecords && ! isPositiveAndBelow (index, numRecords))
+        return;
+
+    const int primaryRecord = playAllRecords ? 0 : index;
+    input->setActiveRecord (primaryRecord);
 
     currentNumChannels  = input->getActiveNumChannels();
     currentNumSamples   = input->getActiveNumSamples();
     currentSampleRate   = input->getActiveSampleRate();
 
-    currentSample   = 0;
     startSample     = 0;
     stopSample      = currentNumSamples;
-    bufferCacheWindow = 0;
 
-    for (int i = 0; i < currentNumChannels; ++i)
+    // every stream reads through its own source, so each keeps its own position and mapping
+    streams.clear();
+    const String ext = currentFile.getFileExtension().toLowerCase().substring (1);
+
+    for (int record = 0; record < numRecords; ++record)
     {
-        channelInfo.add (input->getChannelInfo (i));
+        if (!playAllRecords && record != index)
+            continue;
+
+        FileSource* source = createFileSource (ext);
+        if (source == nullptr || ! source->OpenFile (currentFile))
+        {
+            std::cerr << "File Reader: could not open record " << input->getRecordName (record) << std::endl;
+            delete source;
+            continue;
+        }
+
+        streams.add (new FileReaderStream (source, record));
     }
 
+    updatePlaybackRanges();
+
     static_cast<FileReaderEditor*> (getEditor())->setTotalTime (samplesToMilliseconds (currentNumSamples));
-	input->seekTo(startSample);
+}
 
-   
+
+void FileReader::updatePlaybackRanges()
+{
+    for (int i = 0; i < streams.size(); ++i)
+    {
+        FileReaderStream* stream = streams[i];
+        const double ratio = stream->getSampleRate() / currentSampleRate;
+
+        stream->setPlaybackRange (int64 (startSample * ratio), int64 (stopSample * ratio));
+    }
+}
+
+
+int FileReader::getAllRecordsIndex() const
+{
+    return input ? input->getNumRecords() : -1;
 }
 
 
@@ -303,46 +425,41 @@ String FileReader::getFile() const
 }
 
 
-void FileReader::updateSettings()
-{
-     if (!input) return;
-
-     for (int i=0; i < currentNumChannels; i++)
-     {
-         dataChannelArray[i]->setBitVolts(channelInfo[i].bitVolts);
-         dataChannelArray[i]->setName(channelInfo[i].name);
-     }
-}
-
 void FileReader::process (AudioSampleBuffer& buffer)
 {
-    const int samplesNeededPerBuffer = int (float (buffer.getNumSamples()) * (getDefaultSampleRate() / m_sysSampleRate));
-    m_samplesPerBuffer.set(samplesNeededPerBuffer);
-    // FIXME: needs to account for the fact that the ratio might not be an exact
-    //        integer value
-    
-    // if cache window id == 0, we need to read and cache BUFFER_WINDOW_CACHE_SIZE more buffer windows
-    if (bufferCacheWindow == 0)
-    {
-        switchBuffer();
-    }
-    
-    for (int i = 0; i < currentNumChannels; ++i)
+    const int numSystemSamples = buffer.getNumSamples();
+    int firstChannel = 0;
+
+    for (int sub = 0; sub < streams.size(); ++sub)
     {
-        // offset readBuffer index by current cache window count * buffer window size * num channels
-        input->processChannelData (*readBuffer + (samplesNeededPerBuffer * currentNumChannels * bufferCacheWindow),
-                                   buffer.getWritePointer (i, 0),
-                                   i,
-                                   samplesNeededPerBuffer);
+        FileReaderStream* stream = streams[sub];
+
+        // every stream covers the same stretch of time. Counting from the start of
+        // playback carries the rounding over, so streams at different rates stay aligned
+        const int64 samplesDue = int64 (double (systemSamples + numSystemSamples) * (stream->getSampleRate() / m_sysSampleRate));
+        const int samplesNeeded = int (samplesDue - stream->getSamplesPlayed());
+
+        const int64 blockTimestamp = stream->getSamplesPlayed();
+        const int64 blockStart = stream->getPlaybackSample();
+
+        stream->readBlock (buffer, firstChannel, samplesNeeded);
+        setTimestampAndSamples (blockTimestamp, samplesNeeded, sub);
+
+        // recorded events and spikes follow the primary stream
+        if (sub == 0)
+        {
+            timestamp = blockTimestamp;
+
+            if (stopSample > startSample)
+                replayEvents (blockStart, samplesNeeded);
+        }
+
+        firstChannel += stream->getNumChannels();
     }
-    
-    setTimestampAndSamples(timestamp, samplesNeededPerBuffer);
-	timestamp += samplesNeededPerBuffer;
 
-	static_cast<FileReaderEditor*> (getEditor())->setCurrentTime(samplesToMilliseconds(startSample + timestamp % (stopSample - startSample)));
-    
-    bufferCacheWindow += 1;
-    bufferCacheWindow %= BUFFER_WINDOW_CACHE_SIZE;
+    systemSamples += numSystemSamples;
+
+	static_cast<FileReaderEditor*> (getEditor())->setCurrentTime(samplesToMilliseconds(streams[0]->getPlaybackSample()));
 }
 
 
@@ -358,17 +475,17 @@ void FileReader::setParameter (int parameterIndex, float newValue)
         //set startTime
         case 1: 
             startSample = millisecondsToSamples (newValue);
-            currentSample = startSample;
+            updatePlaybackRanges();
 
-            static_cast<FileReaderEditor*> (getEditor())->setCurrentTime (samplesToMilliseconds (currentSample));
+            static_cast<FileReaderEditor*> (getEditor())->setCurrentTime (samplesToMilliseconds (startSample));
             break;
 
         //set stop time
         case 2:
             stopSample = millisecondsToSamples(newValue);
-            currentSample = startSample;
+            updatePlaybackRanges();
 
-            static_cast<FileReaderEditor*> (getEditor())->setCurrentTime (samplesToMilliseconds (currentSample));
+            static_cast<FileReaderEditor*> (getEditor())->setCurrentTime (samplesToMilliseconds (startSample));
             break;
     }
 }
@@ -385,73 +502,173 @@ int64 FileReader::millisecondsToSamples (unsigned int ms) const
     return (int64) (currentSampleRate * float (ms) / 1000.f);
 }
 
-void FileReader::switchBuffer()
+void FileReader::replayEvents(int64 blockStart, int numSamples)
 {
-    if (readBuffer == &bufferA)
-        readBuffer = &bufferB;
-    else
-        readBuffer = &bufferA;
-    
-    m_shouldFillBackBuffer.set(true);
-    notify();
-}
+    if (ttlChannels.size() == 0 && replaySpikeChannels.size() == 0)
+        return;
 
-HeapBlock<int16>* FileReader::getFrontBuffer()
-{
-    return readBuffer;
-}
+    if (numSamples > blockTimestampsSize)
+    {
+        blockTimestampsSize = numSamples;
+        blockTimestamps.malloc(blockTimestampsSize);
+    }
 
-HeapBlock<int16>* FileReader::getBackBuffer()
-{
-    if (readBuffer == &bufferA) return &bufferB;
-    
-    return &bufferA;
-}
+    replayBuffer.clear();
 
-void FileReader::run()
-{
-    while (!threadShouldExit())
+    // playback loops, so a block can end at stopSample and carry on from startSample
+    int offset = 0;
+    int64 sample = blockStart;
+
+    while (offset < numSamples)
     {
-        if (m_shouldFillBackBuffer.compareAndSetBool(false, true))
-        {
-            readAndFillBufferCache(*getBackBuffer());
-        }
-        
-        wait(30);
+        if (sample >= stopSample)
+            sample = startSample;
+
+        const int n = int (jmin (int64 (numSamples - offset), stopSample - sample));
+        replayEventRange(sample, offset, n);
+
+        offset += n;
+        sample += n;
     }
+
+    addEvents(replayBuffer);
 }
 
-void FileReader::readAndFillBufferCache(HeapBlock<int16> &cacheBuffer)
+void FileReader::createReplayTemplates()
 {
-    const int samplesNeededPerBuffer = m_samplesPerBuffer.get();
-    const int samplesNeeded = samplesNeededPerBuffer * BUFFER_WINDOW_CACHE_SIZE;
-    
-    int samplesRead = 0;
-    
-    // should only loop if reached end of file and resuming from start
-    while (samplesRead < samplesNeeded)
+    ttlTemplates.clear();
+    spikeTemplates.clear();
+
+    // A block holds at most one edge per TTL line and sample, and a spike detector
+    // leaves a waveform's length between spikes of one electrode. The scratch space
+    // is sized for that, so it only grows in process() if a file holds more.
+    const int midiHeaderSize = sizeof(int32) + sizeof(uint16);
+    int maxEvents = 0;
+    int maxSpikes = 0;
+    int maxBytes = 0;
+
+    for (int i = 0; i < ttlChannels.size(); i++)
     {
-        int samplesToRead = samplesNeeded - samplesRead;
-        
-        // if reached end of file stream
-        if ( (currentSample + samplesToRead) > stopSample)
+        const EventChannel* chan = ttlChannels[i];
+        if (!chan)
         {
-            samplesToRead = stopSample - currentSample;
-            if (samplesToRead > 0)
-                input->readData (cacheBuffer + samplesRead * currentNumChannels, samplesToRead);
-            
-            // reset stream to beginning
-            input->seekTo (startSample);
-            currentSample = startSample;
+            ttlTemplates.add(nullptr);
+            continue;
         }
-        else // else read the block needed
+
+        MemoryBlock* event = ttlTemplates.add(new MemoryBlock(EVENT_BASE_SIZE + chan->getDataSize(), true));
+        uint64 word = 0;
+        TTLEventPtr ttl = TTLEvent::createTTLEvent(chan, 0, &word, sizeof(uint64), 0);
+        if (ttl)
+            ttl->serialize(event->getData(), event->getSize());
+
+        const int numEvents = chan->getNumChannels() * blockTimestampsSize;
+        maxEvents += numEvents;
+        maxBytes += numEvents * (midiHeaderSize + int(event->getSize()));
+    }
+
+    for (int i = 0; i < replaySpikeChannels.size(); i++)
+    {
+        const SpikeChannel* chan = replaySpikeChannels[i];
+        if (!chan)
         {
-            input->readData (cacheBuffer + samplesRead * currentNumChannels, samplesToRead);
-            
-            currentSample += samplesToRead;
+            spikeTemplates.add(nullptr);
+            continue;
         }
-        
-        samplesRead += samplesToRead;
+
+        const int numChannels = chan->getNumChannels();
+        const int numValues = numChannels * chan->getTotalSamples();
+        MemoryBlock* event = spikeTemplates.add(new MemoryBlock(SPIKE_BASE_SIZE + numChannels * sizeof(float) + chan->getDataSize(), true));
+
+        // recorded thresholds aren't replayed, so they stay at zero
+        SpikeEvent::SpikeBuffer waveform(chan);
+        for (int v = 0; v < numValues; v++)
+            waveform.set(v, 0.0f);
+        Array<float> thresholds;
+        thresholds.insertMultiple(0, 0.0f, numChannels);
+
+        SpikeEventPtr spike = SpikeEvent::createSpikeEvent(chan, 0, thresholds, waveform, 0);
+        if (spike)
+            spike->serialize(event->getData(), event->getSize());
+
+        const int numSpikes = blockTimestampsSize / jmax(1, int(chan->getTotalSamples())) + 1;
+        maxSpikes += numSpikes;
+        maxBytes += numSpikes * (midiHeaderSize + int(event->getSize()));
+    }
+
+    recordedEvents.ensureStorageAllocated(maxEvents);
+    recordedSpikes.ensureStorageAllocated(maxSpikes);
+    replayBuffer.clear();
+    replayBuffer.data.ensureStorageAllocated(maxBytes);
+}
+
+void FileReader::replayEventRange(int64 fromSample, int offset, int numSamples)
+{
+    int64* const ts = blockTimestamps + offset;
+    input->readTimestamps(fromSample, numSamples, ts);
+
+    // recorded timestamps of this stretch; events are searched for in this range
+    const int64 firstTimestamp = ts[0];
+    const int64 endTimestamp = ts[numSamples - 1] + 1;
+
+    recordedEvents.clearQuick();
+    input->readEvents(firstTimestamp, endTimestamp, recordedEvents);
+
+    for (int i = 0; i < recordedEvents.size(); i++)
+    {
+        const RecordedEvent& ev = recordedEvents.getReference(i);
+        const EventChannel* chan = ttlChannels[ev.eventChannel];
+        MemoryBlock* event = ttlTemplates[ev.eventChannel];
+        if (!chan || !event || ev.channel >= chan->getNumChannels())
+            continue;
+
+        // the first sample recorded at or after the event
+        const int sampleNum = offset + int (std::lower_bound (ts, ts + numSamples, ev.timestamp) - ts);
+
+        uint64 word = ttlWords[ev.eventChannel];
+        if (ev.hasWord)
+            word = ev.word;
+        else if (ev.state)
+            word |= (uint64 (1) << ev.channel);
+        else
+            word &= ~(uint64 (1) << ev.channel);
+        ttlWords.set(ev.eventChannel, word);
+
+        // patch the fields TTLEvent::serialize writes for this edge into the channel's event
+        char* data = static_cast<char*>(event->getData());
+        writeUnaligned<int64>(data + 8, timestamp + sampleNum);
+        writeUnaligned<uint16>(data + 16, ev.channel);
+        memcpy(data + EVENT_BASE_SIZE, &word, chan->getDataSize());
+        replayBuffer.addEvent(data, int(event->getSize()), sampleNum);
+    }
+
+    recordedSpikes.clearQuick();
+    input->readSpikes(firstTimestamp, endTimestamp, recordedSpikes);
+
+    for (int i = 0; i < recordedSpikes.size(); i++)
+    {
+        const RecordedSpike& sp = recordedSpikes.getReference(i);
+        const SpikeChannel* chan = replaySpikeChannels[sp.spikeChannel];
+        MemoryBlock* event = spikeTemplates[sp.spikeChannel];
+        if (!chan || !event)
+            continue;
+
+        const int sampleNum = offset + int (std::lower_bound (ts, ts + numSamples, sp.timestamp) - ts);
+
+        // waveforms were stored scaled by the first channel's bitVolts
+        const float bitVolts = chan->getChannelBitVolts(0);
+        const int numValues = chan->getNumChannels() * chan->getTotalSamples();
+
+        // patch the fields SpikeEvent::serialize writes for this spike into the channel's event
+        char* data = static_cast<char*>(event->getData());
+        writeUnaligned<int64>(data + 8, timestamp + sampleNum);
+        writeUnaligned<uint16>(data + 16, sp.sortedID);
+
+        char* waveform = data + SPIKE_BASE_SIZE + chan->getNumChannels() * sizeof(float);
+        for (int v = 0; v < numValues; v++)
+            writeUnaligned<float>(waveform + v * sizeof(float), sp.waveform[v] * bitVolts);
+
+        replayBuffer.addEvent(data, int(event->getSize()), sampleNum);
     }
 }
 
@@ -466,6 +683,25 @@ StringArray FileReader::getSupportedExtensions() const
 	return extensions;
 }
 
+FileSource* FileReader::createFileSource (const String& ext) const
+{
+	const int index = supportedExtensions[ext] - 1;
+	if (index < 0)
+		return nullptr;
+
+	const int numPluginFileSources = AccessClass::getPluginManager()->getNumFileSources();
+
+	if (index < numPluginFileSources)
+	{
+		if (!AccessClass::getPluginManager()->loadPluginLibrary(Plugin::PLUGIN_TYPE_FILE_SOURCE, index))
+			return nullptr;
+		Plugin::FileSourceInfo sourceInfo = AccessClass::getPluginManager()->getFileSourceInfo(index);
+		return sourceInfo.creator();
+	}
+
+	return createBuiltInFileSource(index - numPluginFileSources);
+}
+
 //Built-In
 
 int FileReader::getNumBuiltInFileSources() const
@@ -30,17 +30,18 @@
 
 #include "../GenericProcessor/GenericProcessor.h"
 #include "FileSource.h"
-
-#define BUFFER_WINDOW_CACHE_SIZE 10
+#include "FileReaderStream.h"
 
 
 /**
   Reads data from a file.
 
-  @see GenericProcessor
+  Either one continuous record of the file is played, or all of them at once,
+  each as its own subprocessor at its own sample rate.
+
+  @see GenericProcessor, FileReaderStream
 */
-class FileReader : public GenericProcessor,
-    private Thread
+class FileReader : public GenericProcessor
 {
 public:
     FileReader();
@@ -57,10 +58,11 @@ public:
 
     int getDefaultNumDataOutputs(DataChannel::DataChannelTypes type, int)        const override;
 
+    int getNumSubProcessors()           const override;
+    float getSampleRate (int subProcessorIdx = 0) const override;
     float getDefaultSampleRate()        const override;
     float getBitVolts (const DataChannel* chan)   const override;
 
-    void updateSettings() override;
     void setEnabledState (bool t)  override;
 	bool enable() override;
 	bool disable() override;
@@ -68,63 +70,82 @@ public:
     String getFile() const;
     bool setFile (String fullpath);
 
+    /** Record index that selects every continuous record of the file at once */
+    int getAllRecordsIndex() const;
+
     bool isFileSupported          (const String& filename) const;
     bool isFileExtensionSupported (const String& ext) const;
-    void createEventChannels();
 	StringArray getSupportedExtensions() const;
 
+protected:
+    void createDataChannels() override;
+
+    /** Creates a TTL channel for each event channel stored in the recording */
+    void createEventChannels() override;
+
+    /** Creates a spike channel for each recorded electrode */
+    void createSpikeChannels() override;
+
 private:
     Array<const EventChannel*> moduleEventChannels;
     unsigned int count = 0;
     
     void setActiveRecording (int index);
 
+    /** Sets the playback range of every stream to the time span of the primary one */
+    void updatePlaybackRanges();
+
     unsigned int samplesToMilliseconds (int64 samples)  const;
     int64 millisecondsToSamples (unsigned int ms)       const;
 
-    int64 timestamp;
+    int64 timestamp;        // of the current block of the primary stream
+    int64 systemSamples;    // samples of the audio device clock played since enable()
 
     float currentSampleRate;
     int currentNumChannels;
-    int64 currentSample;
     int64 currentNumSamples;
-    int64 startSample;
+    int64 startSample;      // playback range, in samples of the primary stream
     int64 stopSample;
-    int64 bufferCacheWindow; // the current buffer window to read from readBuffer
-    Array<RecordedChannelInfo> channelInfo;
 
     // for testing purposes only
     int counter;
 
-    ScopedPointer<FileSource> input;
-
-    HeapBlock<int16> * readBuffer;      // Ptr to the current "front" buffer
-    HeapBlock<int16> bufferA;
-    HeapBlock<int16> bufferB;
+    File currentFile;
+    ScopedPointer<FileSource> input;        // metadata and events, active on the primary record
+    OwnedArray<FileReaderStream> streams;   // one per subprocessor, the primary one first
 
     HashMap<String, int> supportedExtensions;
-    
-    Atomic<int> m_shouldFillBackBuffer;
-    Atomic<int> m_samplesPerBuffer;
+
+    // recorded events and spikes, indexed as the FileSource reports them (nullptr if not replayed)
+    Array<const EventChannel*> ttlChannels;
+    Array<const SpikeChannel*> replaySpikeChannels;
+    OwnedArray<MemoryBlock> ttlTemplates;   // each channel's event serialized once by enable(), patched per event
+    OwnedArray<MemoryBlock> spikeTemplates;
+    MidiBuffer replayBuffer;                // events of the current block, merged into the output at its end
+    Array<uint64> ttlWords;                 // last state of each TTL channel, for recordings without full words
+    Array<RecordedEvent> recordedEvents;    // scratch for one block, reused
+    Array<RecordedSpike> recordedSpikes;
+    HeapBlock<int64> blockTimestamps;       // recorded timestamp of each sample of the block
+    int blockTimestampsSize;
 
 	unsigned int m_bufferSize;
 	float m_sysSampleRate;
-    
-    /** Swaps the backbuffer to the front and flags the background reader
-        thread to update the new backbuffer */
-    void switchBuffer();
-    
-    HeapBlock<int16>* getFrontBuffer();
-    HeapBlock<int16>* getBackBuffer();
-    
-    /** Executes the background thread task */
-    void run() override;
-    
-    /** Reads a chunk of the file that fills an entire buffer cache.
-     
-        This method will read into the buffer that passed in by the param 
-     */
-    void readAndFillBufferCache(HeapBlock<int16> &cacheBuffer);
+
+    /** Emits the recorded events and spikes that fall within the current block, at
+        the sample they were recorded on. blockStart is the playback position of
+        the block's first sample. */
+    void replayEvents(int64 blockStart, int numSamples);
+
+    /** Replays the events and spikes of a stretch of the block that doesn't wrap,
+        starting offset samples into it */
+    void replayEventRange(int64 fromSample, int offset, int numSamples);
+
+    /** Serializes an event of every replayed channel and sizes the replay scratch
+        space, so that replaying doesn't allocate */
+    void createReplayTemplates();
+
+    /** Creates a new, unopened source for a file extension */
+    FileSource* createFileSource (const String& extension) const;
 
 	//Methods for built-in file sources
 	int getNumBuiltInFileSources() const;
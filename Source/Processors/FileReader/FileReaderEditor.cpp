@@ -193,7 +193,16 @@ void FileReaderEditor::populateRecordings (FileSource* source)
         recordSelector->addItem (source->getRecordName (i), i + 1);
     }
 
-    recordSelector->setSelectedId (1, dontSendNotification);
+    // plays every record at once, each as its own subprocessor
+    if (numRecords > 1)
+    {
+        recordSelector->addItem ("All streams", numRecords + 1);
+        recordSelector->setSelectedId (numRecords + 1, dontSendNotification);
+    }
+    else
+    {
+        recordSelector->setSelectedId (1, dontSendNotification);
+    }
 }
 
 
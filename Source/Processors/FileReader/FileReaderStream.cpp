@@ -0,0 +1,315 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2018 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "FileReaderStream.h"
+
+
+FileReaderStream::FileReaderStream (FileSource* s, int recordIndex)
+    : Thread                ("filereader_Async_Reader")
+    , source                (s)
+    , numChannels           (0)
+    , startSample           (0)
+    , stopSample            (0)
+    , currentSample         (0)
+    , playbackSample        (0)
+    , samplesPlayed         (0)
+    , useDirectRead         (false)
+    , cacheSize             (0)
+    , cachePosition         (0)
+    , samplesSincePrefetch  (0)
+    , readBuffer            (&bufferA)
+    , m_shouldFillBackBuffer(false)
+{
+    source->setActiveRecord (recordIndex);
+
+    numChannels = source->getActiveNumChannels();
+    stopSample  = source->getActiveNumSamples();
+}
+
+
+FileReaderStream::~FileReaderStream()
+{
+    stopThread (1000);
+}
+
+
+FileSource* FileReaderStream::getSource() const
+{
+    return source;
+}
+
+
+int FileReaderStream::getNumChannels() const
+{
+    return numChannels;
+}
+
+
+float FileReaderStream::getSampleRate() const
+{
+    return source->getActiveSampleRate();
+}
+
+
+int64 FileReaderStream::getNumSamples() const
+{
+    return source->getActiveNumSamples();
+}
+
+
+void FileReaderStream::setPlaybackRange (int64 start, int64 stop)
+{
+    startSample = jlimit (int64 (0), getNumSamples(), start);
+    stopSample  = jlimit (startSample, getNumSamples(), stop);
+
+    currentSample  = startSample;
+    playbackSample = startSample;
+}
+
+
+void FileReaderStream::startPlayback (int maxSamplesPerBlock)
+{
+    stopPlayback();
+
+    cacheSize = jmax (1, maxSamplesPerBlock) * BUFFER_WINDOW_CACHE_SIZE;
+    channelPointers.malloc (numChannels);
+
+    // reset stream to beginning
+    source->seekTo (startSample);
+    currentSample  = startSample;
+    playbackSample = startSample;
+    samplesPlayed  = 0;
+
+    useDirectRead = source->getDirectReadPointer (startSample) != nullptr;
+
+    if (useDirectRead)
+    {
+        bufferA.free();
+        bufferB.free();
+        prefetchAhead (startSample); // blocking, so the first windows are already resident
+        samplesSincePrefetch = 0;
+    }
+    else
+    {
+        bufferA.malloc (numChannels * cacheSize);
+        bufferB.malloc (numChannels * cacheSize);
+
+        readAndFillBufferCache (bufferA); // pre-fill the front buffer with a blocking read
+
+        // the first read swaps bufferA to the front and has bufferB filled behind it
+        readBuffer = &bufferB;
+        cachePosition = cacheSize;
+    }
+
+    m_shouldFillBackBuffer.set (false);
+
+    startThread(); // start async file reader thread
+}
+
+
+void FileReaderStream::stopPlayback()
+{
+    stopThread (100);
+}
+
+
+void FileReaderStream::readBlock (AudioSampleBuffer& buffer, int firstChannel, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    if (useDirectRead)
+        readDirect (buffer, firstChannel, numSamples);
+    else
+        readCached (buffer, firstChannel, numSamples);
+
+    samplesPlayed += numSamples;
+
+    if (stopSample > startSample)
+        playbackSample = startSample + (playbackSample - startSample + numSamples) % (stopSample - startSample);
+}
+
+
+int64 FileReaderStream::getSamplesPlayed() const
+{
+    return samplesPlayed;
+}
+
+
+int64 FileReaderStream::getPlaybackSample() const
+{
+    return playbackSample;
+}
+
+
+void FileReaderStream::switchBuffer()
+{
+    readBuffer = getBackBuffer();
+
+    m_shouldFillBackBuffer.set (true);
+    notify();
+}
+
+
+HeapBlock<int16>* FileReaderStream::getBackBuffer()
+{
+    if (readBuffer == &bufferA) return &bufferB;
+
+    return &bufferA;
+}
+
+
+void FileReaderStream::run()
+{
+    while (! threadShouldExit())
+    {
+        if (m_shouldFillBackBuffer.compareAndSetBool (false, true))
+        {
+            if (useDirectRead)
+                prefetchAhead (m_prefetchSample.get());
+            else
+                readAndFillBufferCache (*getBackBuffer());
+        }
+
+        wait (30);
+    }
+}
+
+
+void FileReaderStream::readCached (AudioSampleBuffer& buffer, int firstChannel, int numSamples)
+{
+    int samplesRead = 0;
+
+    while (samplesRead < numSamples)
+    {
+        // front buffer used up, carry on from the one filled behind it
+        if (cachePosition >= cacheSize)
+        {
+            switchBuffer();
+            cachePosition = 0;
+        }
+
+        const int samplesToRead = jmin (numSamples - samplesRead, cacheSize - cachePosition);
+
+        for (int i = 0; i < numChannels; ++i)
+            channelPointers[i] = buffer.getWritePointer (firstChannel + i, samplesRead);
+
+        source->processData (*readBuffer + cachePosition * numChannels, channelPointers, samplesToRead);
+
+        cachePosition += samplesToRead;
+        samplesRead += samplesToRead;
+    }
+}
+
+
+void FileReaderStream::readDirect (AudioSampleBuffer& buffer, int firstChannel, int numSamples)
+{
+    // every cache window's worth of samples, have the background thread page in the next stretch
+    if (samplesSincePrefetch >= cacheSize)
+    {
+        m_prefetchSample.set (currentSample);
+        m_shouldFillBackBuffer.set (true);
+        notify();
+        samplesSincePrefetch = 0;
+    }
+    samplesSincePrefetch += numSamples;
+
+    int samplesRead = 0;
+
+    while (samplesRead < numSamples)
+    {
+        if (stopSample <= startSample)
+        {
+            for (int i = 0; i < numChannels; ++i)
+                buffer.clear (firstChannel + i, samplesRead, numSamples - samplesRead);
+            return;
+        }
+
+        // reached end of file stream, resume from start
+        if (currentSample >= stopSample)
+            currentSample = startSample;
+
+        const int samplesToRead = int (jmin (int64 (numSamples - samplesRead), stopSample - currentSample));
+
+        for (int i = 0; i < numChannels; ++i)
+            channelPointers[i] = buffer.getWritePointer (firstChannel + i, samplesRead);
+
+        source->processData (source->getDirectReadPointer (currentSample), channelPointers, samplesToRead);
+
+        currentSample += samplesToRead;
+        samplesRead += samplesToRead;
+    }
+}
+
+
+void FileReaderStream::prefetchAhead (int64 fromSample)
+{
+    // cover the windows read until the next request, plus the ones after them
+    int64 samplesToPrefetch = int64 (cacheSize) * 2;
+
+    const int64 samplesToEnd = jmax (int64 (0), stopSample - fromSample);
+    source->prefetch (fromSample, jmin (samplesToPrefetch, samplesToEnd));
+
+    // playback loops, so the start of the range comes next
+    if (samplesToPrefetch > samplesToEnd)
+        source->prefetch (startSample, samplesToPrefetch - samplesToEnd);
+}
+
+
+void FileReaderStream::readAndFillBufferCache (HeapBlock<int16>& cacheBuffer)
+{
+    if (stopSample <= startSample)
+    {
+        zeromem (cacheBuffer, sizeof (int16) * size_t (numChannels) * size_t (cacheSize));
+        return;
+    }
+
+    int samplesRead = 0;
+
+    // should only loop if reached end of file and resuming from start
+    while (samplesRead < cacheSize)
+    {
+        int samplesToRead = cacheSize - samplesRead;
+
+        // if reached end of file stream
+        if ((currentSample + samplesToRead) > stopSample)
+        {
+            samplesToRead = int (stopSample - currentSample);
+            if (samplesToRead > 0)
+                source->readData (cacheBuffer + samplesRead * numChannels, samplesToRead);
+
+            // reset stream to beginning
+            source->seekTo (startSample);
+            currentSample = startSample;
+        }
+        else // else read the block needed
+        {
+            source->readData (cacheBuffer + samplesRead * numChannels, samplesToRead);
+
+            currentSample += samplesToRead;
+        }
+
+        samplesRead += samplesToRead;
+    }
+}
@@ -0,0 +1,128 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2018 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef FILEREADERSTREAM_H_INCLUDED
+#define FILEREADERSTREAM_H_INCLUDED
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "FileSource.h"
+
+#define BUFFER_WINDOW_CACHE_SIZE 10
+
+
+/**
+  Plays back one continuous record of a file.
+
+  Each stream owns its own FileSource, opened on the record it plays, and its
+  own background thread. That thread either keeps a double-buffered cache of
+  the upcoming samples filled or, for sources that expose their samples in
+  memory, pages in the stretch that will be read next.
+
+  @see FileReader
+*/
+class FileReaderStream : private Thread
+{
+public:
+    /** Takes ownership of an opened source and makes recordIndex its active record */
+    FileReaderStream (FileSource* source, int recordIndex);
+    ~FileReaderStream();
+
+    FileSource* getSource() const;
+
+    int getNumChannels()    const;
+    float getSampleRate()   const;
+    int64 getNumSamples()   const;
+
+    /** Sets the stretch of the record that is played in a loop */
+    void setPlaybackRange (int64 startSample, int64 stopSample);
+
+    /** Seeks to the start of the playback range, fills the first stretch of the
+        cache with a blocking read and starts the background thread. The cache is
+        sized for blocks of up to maxSamplesPerBlock samples. */
+    void startPlayback (int maxSamplesPerBlock);
+    void stopPlayback();
+
+    /** Converts the next numSamples samples into getNumChannels() consecutive
+        channels of the buffer, starting at firstChannel */
+    void readBlock (AudioSampleBuffer& buffer, int firstChannel, int numSamples);
+
+    /** Number of samples handed out since playback started */
+    int64 getSamplesPlayed() const;
+
+    /** Position in the record of the next sample readBlock() hands out */
+    int64 getPlaybackSample() const;
+
+private:
+    /** Executes the background thread task */
+    void run() override;
+
+    /** Reads a chunk of the file that fills an entire cache buffer */
+    void readAndFillBufferCache (HeapBlock<int16>& cacheBuffer);
+
+    /** Swaps the backbuffer to the front and flags the background thread to
+        refill the new backbuffer */
+    void switchBuffer();
+
+    HeapBlock<int16>* getBackBuffer();
+
+    void readCached (AudioSampleBuffer& buffer, int firstChannel, int numSamples);
+
+    /** Converts straight from the source's memory, wrapping around at stopSample */
+    void readDirect (AudioSampleBuffer& buffer, int firstChannel, int numSamples);
+
+    /** Asks the source to page in the samples the next cache windows will read */
+    void prefetchAhead (int64 fromSample);
+
+    ScopedPointer<FileSource> source;
+    int numChannels;
+
+    int64 startSample;
+    int64 stopSample;
+    int64 currentSample;        // next sample the background thread (or readDirect) fetches
+    int64 playbackSample;
+    int64 samplesPlayed;
+
+    /** True if the source exposes its samples in memory (e.g. a mapped file), in
+        which case they are converted straight from it and the background thread
+        only prefetches, instead of copying into bufferA/bufferB */
+    bool useDirectRead;
+
+    int cacheSize;              // samples held by each cache buffer
+    int cachePosition;          // samples already handed out from the front buffer
+    int64 samplesSincePrefetch;
+
+    HeapBlock<int16>* readBuffer;   // Ptr to the current "front" buffer
+    HeapBlock<int16> bufferA;
+    HeapBlock<int16> bufferB;
+
+    HeapBlock<float*> channelPointers;  // output write pointers handed to FileSource::processData
+
+    Atomic<int> m_shouldFillBackBuffer;
+    Atomic<int64> m_prefetchSample;     // where the background thread should prefetch from
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FileReaderStream);
+};
+
+
+#endif  // FILEREADERSTREAM_H_INCLUDED
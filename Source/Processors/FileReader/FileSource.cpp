@@ -142,6 +142,67 @@ bool FileSource::OpenFile (File file)
     return fileOpened;
 }
 
+void FileSource::processData (const int16* inBuffer, float* const* outBuffers, int64 numSamples)
+{
+    const int numChannels = getActiveNumChannels();
+
+    for (int i = 0; i < numChannels; ++i)
+        processChannelData (const_cast<int16*> (inBuffer), outBuffers[i], i, numSamples);
+}
+
+
+const int16* FileSource::getDirectReadPointer (int64) const
+{
+    return nullptr;
+}
+
+
+void FileSource::prefetch (int64, int64)
+{
+}
+
+
+void FileSource::readTimestamps (int64 startSample, int numSamples, int64* timestamps)
+{
+    for (int i = 0; i < numSamples; ++i)
+        timestamps[i] = startSample + i;
+}
+
+
+int FileSource::getNumEventChannels() const
+{
+    return 0;
+}
+
+
+RecordedEventChannelInfo FileSource::getEventChannelInfo (int) const
+{
+    return RecordedEventChannelInfo();
+}
+
+
+int FileSource::getNumSpikeChannels() const
+{
+    return 0;
+}
+
+
+RecordedSpikeChannelInfo FileSource::getSpikeChannelInfo (int) const
+{
+    return RecordedSpikeChannelInfo();
+}
+
+
+void FileSource::readEvents (int64, int64, Array<RecordedEvent>&)
+{
+}
+
+
+void FileSource::readSpikes (int64, int64, Array<RecordedSpike>&)
+{
+}
+
+
 bool FileSource::isReady()
 {
     return true;
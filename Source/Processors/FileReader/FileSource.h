@@ -35,6 +35,44 @@ struct RecordedChannelInfo
 };
 
 
+struct RecordedEventChannelInfo
+{
+    String name;
+    String description;
+    int numChannels;
+};
+
+
+struct RecordedSpikeChannelInfo
+{
+    String name;
+    int numChannels;
+    int prePeakSamples;
+    int postPeakSamples;
+    Array<int> sourceChannels;  // channels of the active record the spike came from, -1 if not in it
+};
+
+
+struct RecordedEvent
+{
+    int64 timestamp;
+    int eventChannel;
+    uint16 channel;
+    bool state;
+    bool hasWord;               // false if only the changed line was recorded
+    uint64 word;
+};
+
+
+struct RecordedSpike
+{
+    int64 timestamp;
+    int spikeChannel;
+    uint16 sortedID;
+    const int16* waveform;      // numChannels x (pre + post) samples, valid while the file is open
+};
+
+
 class PLUGIN_API FileSource
 {
 public:
@@ -67,6 +105,43 @@ public:
     virtual void processChannelData (int16* inBuffer, float* outBuffer, int channel, int64 numSamples) = 0;
     virtual void seekTo (int64 sample) = 0;
 
+    /** Converts interleaved samples of all active channels into one float buffer
+        per channel. The default calls processChannelData() once per channel;
+        sources can override it to convert every channel in a single pass. */
+    virtual void processData (const int16* inBuffer, float* const* outBuffers, int64 numSamples);
+
+    /** Returns a pointer to the interleaved samples of the active record starting
+        at the given sample, or nullptr if the data cannot be read without copying.
+        The pointer stays valid until the active record changes. */
+    virtual const int16* getDirectReadPointer (int64 sample) const;
+
+    /** Hints that a range of the active record will be read soon. Called from the
+        FileReader's background thread ahead of getDirectReadPointer(). */
+    virtual void prefetch (int64 sample, int64 numSamples);
+
+    /** Writes the recorded timestamp of numSamples samples of the active record,
+        starting at startSample. The default assumes the recording started at
+        timestamp 0 and had no gaps. */
+    virtual void readTimestamps (int64 startSample, int numSamples, int64* timestamps);
+
+    /** TTL event channels stored alongside the continuous data. Sources that
+        don't record events report none. */
+    virtual int getNumEventChannels() const;
+    virtual RecordedEventChannelInfo getEventChannelInfo (int index) const;
+
+    /** Spike channels (electrodes) stored alongside the continuous data */
+    virtual int getNumSpikeChannels() const;
+    virtual RecordedSpikeChannelInfo getSpikeChannelInfo (int index) const;
+
+    /** Appends every recorded event with startTimestamp <= timestamp < endTimestamp.
+        Timestamps are those returned by readTimestamps(). Called from the audio
+        thread, so implementations should locate the range by searching rather
+        than scanning. */
+    virtual void readEvents (int64 startTimestamp, int64 endTimestamp, Array<RecordedEvent>& events);
+
+    /** Appends every recorded spike with startTimestamp <= timestamp < endTimestamp */
+    virtual void readSpikes (int64 startTimestamp, int64 endTimestamp, Array<RecordedSpike>& spikes);
+
     virtual bool isReady();
 
 protected:
@@ -41,6 +41,7 @@ GenericProcessor::GenericProcessor(const String& name)
 	, editor(nullptr)
 	, parametersAsXml(nullptr)
 	, sendSampleCount(true)
+	, m_outputLayoutChanged(true)
 	, m_processorType(PROCESSOR_TYPE_UTILITY)
 	, m_name(name)
 	, m_isParamsWereLoaded(false)
@@ -401,6 +402,131 @@ void GenericProcessor::update()
 		128);            // blockSize
 
 	editor->update(); // allow the editor to update its settings
+
+	// remember what downstream processors will see, so unchanged outputs can stop propagation
+	MemoryOutputStream layout;
+	writeOutputLayout(layout);
+	m_outputLayoutChanged = (layout.getDataSize() != m_outputLayout.getSize()
+		|| memcmp(layout.getData(), m_outputLayout.getData(), layout.getDataSize()) != 0);
+	if (m_outputLayoutChanged)
+		m_outputLayout = layout.getMemoryBlock();
+}
+
+bool GenericProcessor::hasOutputLayoutChanged() const
+{
+	return m_outputLayoutChanged;
+}
+
+static void writeInfoObjectCommon(OutputStream& stream, const InfoObjectCommon* info)
+{
+	stream.writeShort(info->getSourceNodeID());
+	stream.writeShort(info->getSubProcessorIdx());
+	stream.writeString(info->getSourceType());
+	stream.writeString(info->getSourceName());
+	stream.writeShort(info->getSourceSubprocessorCount());
+	stream.writeString(info->getName());
+	stream.writeString(info->getDescription());
+	stream.writeString(info->getIdentifier());
+	stream.writeFloat(info->getSampleRate());
+	stream.writeShort(info->getSourceIndex());
+	stream.writeShort(info->getSourceTypeIndex());
+}
+
+static void writeMetaDataDescriptor(OutputStream& stream, const MetaDataDescriptor* desc)
+{
+	stream.writeInt(desc->getType());
+	stream.writeInt(desc->getLength());
+	stream.writeString(desc->getName());
+	stream.writeString(desc->getDescription());
+	stream.writeString(desc->getIdentifier());
+}
+
+static void writeMetaData(OutputStream& stream, const MetaDataInfoObject* info)
+{
+	int n = info->getMetaDataCount();
+	stream.writeInt(n);
+	for (int i = 0; i < n; i++)
+	{
+		const MetaDataValue* value = info->getMetaDataValue(i);
+		writeMetaDataDescriptor(stream, info->getMetaDataDescriptor(i));
+		if (value->getDataSize() > 0)
+			stream.write(value->getRawValuePointer(), value->getDataSize());
+	}
+}
+
+static void writeEventMetaData(OutputStream& stream, const MetaDataEventObject* info)
+{
+	int n = info->getEventMetaDataCount();
+	stream.writeInt(n);
+	for (int i = 0; i < n; i++)
+		writeMetaDataDescriptor(stream, info->getEventMetaDataDescriptor(i));
+}
+
+void GenericProcessor::writeOutputLayout(OutputStream& stream) const
+{
+	stream.writeInt64((int64)(pointer_sized_int)settings.originalSource);
+	stream.writeInt(settings.numOutputs);
+
+	stream.writeInt(dataChannelArray.size());
+	for (int i = 0; i < dataChannelArray.size(); i++)
+	{
+		const DataChannel* chan = dataChannelArray[i];
+		writeInfoObjectCommon(stream, chan);
+		writeMetaData(stream, chan);
+		stream.writeString(chan->getHistoricString());
+		stream.writeInt(chan->getChannelType());
+		stream.writeFloat(chan->getBitVolts());
+		stream.writeString(chan->getDataUnits());
+		stream.writeBool(chan->getRecordState());
+	}
+
+	stream.writeInt(eventChannelArray.size());
+	for (int i = 0; i < eventChannelArray.size(); i++)
+	{
+		const EventChannel* chan = eventChannelArray[i];
+		writeInfoObjectCommon(stream, chan);
+		writeMetaData(stream, chan);
+		writeEventMetaData(stream, chan);
+		stream.writeInt(chan->getChannelType());
+		stream.writeInt(chan->getNumChannels());
+		stream.writeInt(chan->getLength());
+		stream.writeBool(chan->getShouldBeRecorded());
+		stream.writeShort(chan->getTimestampOriginProcessor());
+		stream.writeShort(chan->getTimestampOriginSubProcessor());
+	}
+
+	stream.writeInt(spikeChannelArray.size());
+	for (int i = 0; i < spikeChannelArray.size(); i++)
+	{
+		const SpikeChannel* chan = spikeChannelArray[i];
+		writeInfoObjectCommon(stream, chan);
+		writeMetaData(stream, chan);
+		writeEventMetaData(stream, chan);
+		stream.writeInt(chan->getChannelType());
+		stream.writeInt(chan->getPrePeakSamples());
+		stream.writeInt(chan->getPostPeakSamples());
+		Array<SourceChannelInfo> sources = chan->getSourceChannelInfo();
+		for (int c = 0; c < sources.size(); c++)
+		{
+			stream.writeShort(sources[c].processorID);
+			stream.writeShort(sources[c].subProcessorID);
+			stream.writeShort(sources[c].channelIDX);
+			stream.writeFloat(chan->getChannelBitVolts(c));
+		}
+	}
+
+	stream.writeInt(configurationObjectArray.size());
+	for (int i = 0; i < configurationObjectArray.size(); i++)
+	{
+		const ConfigurationObject* config = configurationObjectArray[i];
+		stream.writeShort(config->getSourceNodeID());
+		stream.writeShort(config->getSubProcessorIdx());
+		stream.writeString(config->getName());
+		stream.writeString(config->getDescription());
+		stream.writeString(config->getIdentifier());
+		stream.writeBool(config->getShouldBeRecorded());
+		writeMetaData(stream, config);
+	}
 }
 
 void GenericProcessor::updateChannelIndexes(bool updateNodeID)
@@ -711,12 +837,12 @@ void GenericProcessor::setTimestampAndSamples(juce::uint64 timestamp, uint32 nSa
 int GenericProcessor::processEventBuffer()
 {
 	//
-	// This loops through all events in the buffer, and uses the BUFFER_SIZE
-	// events to determine the number of samples in the current buffer. If
-	// there are multiple such events, the one with the highest number of
-	// samples will be used.
-	// This approach is not ideal, as it will become a problem if we allow
-	// the sample rate to change at different points in the signal chain.
+	// This loops through all events in the buffer, and uses the
+	// TIMESTAMP_AND_SAMPLES events to find the timestamp and number of samples
+	// of every source processor and subprocessor in the current buffer.
+	// Counts are kept per subprocessor, so a processor that changes the sample
+	// rate mid-chain (such as the Decimator) creates its own subprocessor,
+	// owns the channels it resamples, and sends their counts further down.
 	//
 	int numRead = 0;
 
@@ -835,6 +961,41 @@ void GenericProcessor::addSpike(const SpikeChannel* channel, const SpikeEvent* e
 }
 
 
+void GenericProcessor::addEvents(const MidiBuffer& events)
+{
+	if (events.isEmpty())
+		return;
+
+	MidiBuffer& eventBuffer = *m_currentMidiBuffer;
+
+	//Usual case: all the new events come after the ones already there
+	if (eventBuffer.getLastEventTime() <= events.getFirstEventTime())
+	{
+		eventBuffer.data.addArray(events.data);
+		return;
+	}
+
+	//Otherwise merge both, keeping events already there first when sample positions match, as addEvent does
+	m_mergedEvents.clear();
+	m_mergedEvents.data.ensureStorageAllocated(eventBuffer.data.size() + events.data.size());
+
+	const uint8* a = eventBuffer.data.begin();
+	const uint8* const aEnd = eventBuffer.data.end();
+	const uint8* b = events.data.begin();
+	const uint8* const bEnd = events.data.end();
+
+	while (a < aEnd || b < bEnd)
+	{
+		const uint8*& next = (b >= bEnd || (a < aEnd && readUnaligned<int32>(a) <= readUnaligned<int32>(b))) ? a : b;
+		const int size = sizeof(int32) + sizeof(uint16) + readUnaligned<uint16>(next + sizeof(int32));
+		m_mergedEvents.data.addArray(next, size);
+		next += size;
+	}
+
+	eventBuffer.swapWith(m_mergedEvents);
+}
+
+
 void GenericProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& eventBuffer)
 {
 	m_currentMidiBuffer = &eventBuffer;
@@ -423,6 +423,11 @@ public:
     /** Default method for updating settings, called by every processor.*/
     void update();
 
+    /** Returns true if the last call to update() changed anything that downstream
+        processors copy from this one (settings, channels, metadata). The
+        SignalChainManager uses this to stop propagating an update early. */
+    bool hasOutputLayoutChanged() const;
+
 	/** Toggles record ON for all channels */
     void setAllChannelsToRecord();
 
@@ -586,6 +591,10 @@ protected:
 	void addSpike(int channelIndex, const SpikeEvent* event, int sampleNum);
 	void addSpike(const SpikeChannel* channel, const SpikeEvent* event, int sampleNum);
 
+	/** Adds every event of a buffer sorted by sample position, such as one filled by a TTLEventWriter,
+	in a single pass instead of one insertion per event */
+	void addEvents(const MidiBuffer& events);
+
 	/** Method to create the data channels pertaining to this processor, called automatically by update()*/
 	virtual void createDataChannels();
 
@@ -614,6 +623,13 @@ private:
 
 	void createDataChannelsByType(DataChannel::DataChannelTypes type);
 
+	/** Serializes everything a downstream processor inherits in update(). */
+	void writeOutputLayout(OutputStream& stream) const;
+
+	/** Output layout produced by the last call to update(). */
+	MemoryBlock m_outputLayout;
+	bool m_outputLayoutChanged;
+
 	/** Each processor has a unique integer ID that can be used to identify it.*/
 	int nodeId;
 
@@ -641,6 +657,7 @@ private:
 	Array<bool> m_needsToSendTimestampMessages;
 
 	MidiBuffer* m_currentMidiBuffer;
+	MidiBuffer m_mergedEvents;
 
 	typedef std::map<uint16, int> ChannelIndexes;
 	typedef std::unordered_map<uint32, ChannelIndexes> ChannelIndexMap;
@@ -31,6 +31,7 @@
 #include "PluginManager.h"
 #include "../../UI/ProcessorList.h"
 #include "../../UI/ControlPanel.h"
+#include "../../CoreServices.h"
 
 
 static inline void closeHandle(decltype(LoadedLibInfo::handle) handle) {
@@ -108,6 +109,50 @@ PluginManager::~PluginManager()
 }
 
 
+static void findPluginFiles(const File& pluginPath, Array<File>& foundDLLs)
+{
+#ifdef WIN32
+    String pluginExt("*.dll");
+#elif defined(__APPLE__)
+    String pluginExt("*.bundle");
+#else
+    String pluginExt("*.so");
+#endif
+    
+#ifdef __APPLE__
+    pluginPath.findChildFiles(foundDLLs, File::findDirectories, false, pluginExt);
+#else
+	pluginPath.findChildFiles(foundDLLs, File::findFiles, true, pluginExt);
+#endif
+}
+
+/** Returns the key of a plugin library in the plugin cache, or an empty string if it cannot be hashed */
+static String getLibraryHash(const File& file)
+{
+	File library = file;
+
+	// a macOS bundle is a folder; hash the executable inside it
+	if (file.isDirectory())
+	{
+		library = file.getChildFile("Contents/MacOS/" + file.getFileNameWithoutExtension());
+		if (!library.existsAsFile())
+		{
+			Array<File> executables;
+			file.getChildFile("Contents/MacOS").findChildFiles(executables, File::findFiles, false);
+			if (executables.size() != 1)
+				return String();
+			library = executables[0];
+		}
+	}
+
+	// MD5 leaves the hash zeroed when the file cannot be read
+	MD5 md5(library);
+	if (md5 == MD5())
+		return String();
+
+	return md5.toHexString();
+}
+
 void PluginManager::loadAllPlugins()
 {
     Array<File> paths;
@@ -129,58 +174,160 @@ void PluginManager::loadAllPlugins()
 	    paths.add(File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile(".open-ephys/plugins"));	
 #endif
 
+	const double startTime = Time::getMillisecondCounterHiRes();
+
+	pluginCache = XmlDocument::parse(getPluginCacheFile());
+	if (pluginCache != nullptr && pluginCache->hasTagName("PLUGIN_CACHE"))
+	{
+		forEachXmlChildElementWithTagName(*pluginCache, entry, "LIBRARY")
+		{
+			String hash = entry->getStringAttribute("hash");
+			if (hash.isNotEmpty() && hash != MD5().toHexString())
+				cachedLibraries.set(hash, entry);
+		}
+	}
+	updatedPluginCache = new XmlElement("PLUGIN_CACHE");
+
+    Array<File> foundDLLs;
+
     for (auto &pluginPath : paths) {
         if (!pluginPath.isDirectory()) {
             std::cout << "Plugin path not found: " << pluginPath.getFullPathName() 
 					  << "\nCreating new plugins directory..." << std::endl;
 			pluginPath.createDirectory();
         } else {
-            loadPlugins(pluginPath);
+            findPluginFiles(pluginPath, foundDLLs);
         }
     }
+
+	loadPluginFiles(foundDLLs);
+
+	if (!updatedPluginCache->writeToFile(getPluginCacheFile(), String::empty))
+		std::cerr << "Could not write the plugin cache to " << getPluginCacheFile().getFullPathName() << std::endl;
+
+	int numLoaded = 0;
+	for (int i = 0; i < libArray.size(); i++)
+	{
+		if (libArray[i].handle)
+			numLoaded++;
+	}
+
+	std::cout << "Found " << libArray.size() << " plugin libraries in "
+			  << String(Time::getMillisecondCounterHiRes() - startTime, 1) << " ms, "
+			  << numLoaded << " of them loaded" << std::endl;
+
+	cachedLibraries.clear();
+	updatedPluginCache = nullptr;
+	pluginCache = nullptr;
 }
 
 void PluginManager::loadPlugins(const File &pluginPath) {
     Array<File> foundDLLs;
-    
-#ifdef WIN32
-    String pluginExt("*.dll");
-#elif defined(__APPLE__)
-    String pluginExt("*.bundle");
-#else
-    String pluginExt("*.so");
-#endif
-    
-#ifdef __APPLE__
-    pluginPath.findChildFiles(foundDLLs, File::findDirectories, false, pluginExt);
-#else
-	pluginPath.findChildFiles(foundDLLs, File::findFiles, true, pluginExt);
-#endif
+	findPluginFiles(pluginPath, foundDLLs);
+	loadPluginFiles(foundDLLs);
+}
+
+/*
+	 Hashes the plugin files and opens those that have no entry in the
+	 plugin cache, several at a time. Libraries are then added in file
+	 order, so plugin indexes do not depend on which library was opened first.
+ */
+
+class PluginManager::LibraryJob : public ThreadPoolJob
+{
+public:
+	LibraryJob(LibraryDescription& desc_, const HashMap<String, XmlElement*>* cache_)
+		: ThreadPoolJob("Plugin library")
+		, desc(desc_)
+		, cache(cache_)
+	{
+	}
+
+	JobStatus runJob() override
+	{
+		if (cache != nullptr)
+		{
+			desc.hash = getLibraryHash(desc.file);
+			if (desc.hash.isNotEmpty() && cache->contains(desc.hash))
+				return jobHasFinished;
+		}
+		describeLibrary(desc);
+		return jobHasFinished;
+	}
+
+	/** Runs one job per description on a temporary pool and waits for all of them */
+	static void runAll(OwnedArray<LibraryDescription>& descs, const HashMap<String, XmlElement*>* cache)
+	{
+		OwnedArray<LibraryJob> jobs;
+		ThreadPool pool(jlimit(1, 8, SystemStats::getNumCpus()));
+
+		for (int i = 0; i < descs.size(); i++)
+		{
+			jobs.add(new LibraryJob(*descs[i], cache));
+			pool.addJob(jobs.getLast(), false);
+		}
+
+		for (int i = 0; i < jobs.size(); i++)
+			pool.waitForJobToFinish(jobs[i], -1);
+	}
+
+private:
+	LibraryDescription& desc;
+	const HashMap<String, XmlElement*>* cache;
+};
+
+void PluginManager::loadPluginFiles(const Array<File>& files)
+{
+	const bool useCache = updatedPluginCache != nullptr;
+
+	OwnedArray<LibraryDescription> descs;
+	for (int i = 0; i < files.size(); i++)
+		descs.add(new LibraryDescription())->file = files[i];
+
+	LibraryJob::runAll(descs, useCache ? &cachedLibraries : nullptr);
 
-	for (int i = 0; i < foundDLLs.size(); i++)
+	for (int i = 0; i < descs.size(); i++)
 	{
-		std::cout << "Loading Plugin: " << foundDLLs[i].getFileNameWithoutExtension() << "... " << std::flush;
-		int res = loadPlugin(foundDLLs[i].getFullPathName());
+		LibraryDescription& desc = *descs[i];
+		std::cout << "Loading Plugin: " << desc.file.getFileNameWithoutExtension() << "... " << std::flush;
+
+		bool fromCache = false;
+		if (!desc.handle)
+		{
+			if (!useCache || desc.hash.isEmpty() || !cachedLibraries.contains(desc.hash))
+			{
+				std::cout << " DLL Load FAILED" << std::endl;
+				continue;
+			}
+			readCacheEntry(*cachedLibraries[desc.hash], desc);
+			fromCache = true;
+		}
+
+		// a library that could not be hashed is opened on every start instead
+		if (useCache && desc.hash.isNotEmpty())
+			updatedPluginCache->addChildElement(createCacheEntry(desc));
+
+		int res = addLibrary(desc);
 		if (res < 0)
 		{
 			std::cout << " DLL Load FAILED" << std::endl;
 		}
 		else
 		{
-			std::cout << "Loaded with " << res << " plugins" << std::endl;
+			std::cout << (fromCache ? "Found in plugin cache with " : "Loaded with ") << res << " plugins" << std::endl;
 		}
 	}
 }
 
 /*
-	 Takes the user-specified plugin and begins
-	 dynamic loading process. We want to ensure that
-	 no step is exectured without a checkpoint
-	 because dynamic loading calls for rellocation of RAM
-	 and works inside the same POSIX thread as the GUI.
+	 Opens a plugin library and resolves its entry points. A new build loaded
+	 next to an older one of the same library keeps its symbols local and bound
+	 to itself first; otherwise the dynamic linker would resolve its classes to
+	 the ones of the build that is already loaded.
  */
 
-int PluginManager::loadPlugin(const String& pluginLoc) {
+static bool openLibrary(const String& pluginLoc, bool isReload, decltype(LoadedLibInfo::handle)& handle,
+						LibraryInfoFunction& infoFunction, PluginInfoFunction& piFunction) {
 	/*
 	Load in the selected processor. This takes the
 	dynamic object (.so) and copies it into RAM
@@ -190,7 +337,6 @@ int PluginManager::loadPlugin(const String& pluginLoc) {
 	const char* processorLocCString = static_cast<const char*>(pluginLoc.toUTF8());
 
 #ifdef WIN32
-	HINSTANCE handle;
 	handle = LoadLibrary(processorLocCString);
 #elif defined(__APPLE__)
     CFURLRef bundleURL = CFURLCreateFromFileSystemRepresentation(kCFAllocatorDefault,
@@ -198,7 +344,7 @@ int PluginManager::loadPlugin(const String& pluginLoc) {
                                                                  strlen(processorLocCString),
                                                                  true);
     assert(bundleURL);
-    CFBundleRef handle = CFBundleCreate(kCFAllocatorDefault, bundleURL);
+    handle = CFBundleCreate(kCFAllocatorDefault, bundleURL);
     CFRelease(bundleURL);
 #else
 	// Clear errors
@@ -210,17 +356,23 @@ int PluginManager::loadPlugin(const String& pluginLoc) {
 	processor stability and to ensure that it doesn't crash due
 	to memory mishaps.
 	*/
-	void *handle = 0;
-	handle = dlopen(processorLocCString,RTLD_GLOBAL|RTLD_NOW);
+	int flags = RTLD_GLOBAL|RTLD_NOW;
+	if (isReload)
+	{
+		flags = RTLD_LOCAL|RTLD_NOW;
+#ifdef RTLD_DEEPBIND
+		flags |= RTLD_DEEPBIND;
+#endif
+	}
+	handle = dlopen(processorLocCString,flags);
 #endif
 
 	if (!handle) {
 		ERROR_MSG("Failed to load plugin DLL");
 		closeHandle(handle);
-		return -1;
+		return false;
 	}
 
-	LibraryInfoFunction infoFunction = 0;
 #ifdef WIN32
 	infoFunction = (LibraryInfoFunction)GetProcAddress(handle, "getLibInfo");
 #elif defined(__APPLE__)
@@ -234,20 +386,9 @@ int PluginManager::loadPlugin(const String& pluginLoc) {
 	{
 		ERROR_MSG("Failed to load function 'getLibInfo'");
 		closeHandle(handle);
-		return -1;
-	}
-
-	Plugin::LibraryInfo libInfo;
-	infoFunction(&libInfo);
-
-	if (libInfo.apiVersion != PLUGIN_API_VER)
-	{
-		std::cerr << pluginLoc << " invalid version" << std::endl;
-		closeHandle(handle);
-		return -1;
+		return false;
 	}
 
-	PluginInfoFunction piFunction = 0;
 #ifdef WIN32
 	piFunction = (PluginInfoFunction)GetProcAddress(handle, "getPluginInfo");
 #elif defined(__APPLE__)
@@ -261,33 +402,121 @@ int PluginManager::loadPlugin(const String& pluginLoc) {
 	{
         ERROR_MSG("Failed to load function 'getPluginInfo'");
 		closeHandle(handle);
-		return -1;
+		return false;
 	}
 
-	LoadedLibInfo lib;
-	lib.apiVersion = libInfo.apiVersion;
-	lib.name = libInfo.name;
-	lib.libVersion = libInfo.libVersion;
-	lib.numPlugins = libInfo.numPlugins;
-	lib.handle = handle;
+	return true;
+}
 
-	libArray.add(lib);
+/*
+	 Reads what an opened library provides. The plugin names are copied, as
+	 a description may outlive the handle, e.g. when it goes to the plugin cache.
+ */
+
+static const char* getPluginInfoName(const Plugin::PluginInfo& pInfo)
+{
+	switch (pInfo.type)
+	{
+	case Plugin::PLUGIN_TYPE_PROCESSOR:
+		return pInfo.processor.name;
+	case Plugin::PLUGIN_TYPE_RECORD_ENGINE:
+		return pInfo.recordEngine.name;
+	case Plugin::PLUGIN_TYPE_DATA_THREAD:
+		return pInfo.dataThread.name;
+	case Plugin::PLUGIN_TYPE_FILE_SOURCE:
+		return pInfo.fileSource.name;
+	default:
+		return nullptr;
+	}
+}
+
+bool PluginManager::describeLibrary(LibraryDescription& desc)
+{
+	LibraryInfoFunction infoFunction = 0;
+	PluginInfoFunction piFunction = 0;
+
+	if (!openLibrary(desc.file.getFullPathName(), false, desc.handle, infoFunction, piFunction))
+	{
+		desc.handle = 0;
+		return false;
+	}
+
+	Plugin::LibraryInfo libInfo;
+	infoFunction(&libInfo);
+
+	desc.name = String::fromUTF8(libInfo.name);
+	desc.libVersion = libInfo.libVersion;
+	desc.apiVersion = libInfo.apiVersion;
+
+	// the plugin info layout of another API version is unknown
+	if (libInfo.apiVersion != PLUGIN_API_VER)
+		return true;
 
 	Plugin::PluginInfo pInfo;
-	for (int i = 0; i < lib.numPlugins; i++)
+	for (int i = 0; i < libInfo.numPlugins; i++)
 	{
 		if (piFunction(i, &pInfo)) //if somehow there are less plugins than stated, stop adding
 			break;
+		desc.plugins.add(pInfo);
+		desc.pluginNames.add(String::fromUTF8(getPluginInfoName(pInfo)));
+		desc.extensions.add(pInfo.type == Plugin::PLUGIN_TYPE_FILE_SOURCE ? String(pInfo.fileSource.extensions) : String::empty);
+	}
+	return true;
+}
+
+/*
+	 Takes the user-specified plugin and begins
+	 dynamic loading process. We want to ensure that
+	 no step is exectured without a checkpoint
+	 because dynamic loading calls for rellocation of RAM
+	 and works inside the same POSIX thread as the GUI.
+ */
+
+int PluginManager::loadPlugin(const String& pluginLoc) {
+	LibraryDescription desc;
+	desc.file = File(pluginLoc);
+
+	if (!describeLibrary(desc))
+		return -1;
+
+	return addLibrary(desc);
+}
+
+int PluginManager::addLibrary(const LibraryDescription& desc)
+{
+	if (desc.apiVersion != PLUGIN_API_VER)
+	{
+		std::cerr << desc.file.getFullPathName() << " invalid version" << std::endl;
+		closeHandle(desc.handle);
+		return -1;
+	}
+
+	LoadedLibInfo lib;
+	lib.apiVersion = desc.apiVersion;
+	lib.name = keepString(desc.name);
+	lib.libVersion = desc.libVersion;
+	lib.numPlugins = desc.plugins.size();
+	lib.handle = desc.handle;
+	lib.path = desc.file.getFullPathName();
+	lib.hash = desc.hash;
+
+	libArray.add(lib);
+	const int libIndex = libArray.size() - 1;
+
+	for (int i = 0; i < desc.plugins.size(); i++)
+	{
+		const Plugin::PluginInfo& pInfo = desc.plugins.getReference(i);
+		const String& name = desc.pluginNames[i];
 		switch (pInfo.type)
 		{
 		case Plugin::PLUGIN_TYPE_PROCESSOR:
 		{
 			LoadedPluginInfo<Plugin::ProcessorInfo> info;
 			info.creator = pInfo.processor.creator;
-			info.name = pInfo.processor.name;
+			info.name = keepString(name);
 			info.type = pInfo.processor.type;
-			info.libIndex = libArray.size()-1;
-			Plugin::ProcessorInfo pi = getProcessorInfo(String::fromUTF8(info.name));
+			info.libIndex = libIndex;
+			Plugin::ProcessorInfo pi = getProcessorInfo(name);
 			if(pi.name == nullptr)
 				processorPlugins.add(info);
 			break;
@@ -296,9 +525,9 @@ int PluginManager::loadPlugin(const String& pluginLoc) {
 		{
 			LoadedPluginInfo<Plugin::RecordEngineInfo> info;
 			info.creator = pInfo.recordEngine.creator;
-			info.name = pInfo.recordEngine.name;
-			info.libIndex = libArray.size() - 1;
-			Plugin::RecordEngineInfo rei = getRecordEngineInfo(String::fromUTF8(info.name));
+			info.name = keepString(name);
+			info.libIndex = libIndex;
+			Plugin::RecordEngineInfo rei = getRecordEngineInfo(name);
 			if(rei.name == nullptr)
 				recordEnginePlugins.add(info);
 			break;
@@ -307,9 +536,9 @@ int PluginManager::loadPlugin(const String& pluginLoc) {
 		{
 			LoadedPluginInfo<Plugin::DataThreadInfo> info;
 			info.creator = pInfo.dataThread.creator;
-			info.name = pInfo.dataThread.name;
-			info.libIndex = libArray.size() - 1;
-			Plugin::DataThreadInfo dti = getDataThreadInfo(String::fromUTF8(info.name));
+			info.name = keepString(name);
+			info.libIndex = libIndex;
+			Plugin::DataThreadInfo dti = getDataThreadInfo(name);
 			if(dti.name == nullptr)
 				dataThreadPlugins.add(info);
 			break;
@@ -318,17 +547,17 @@ int PluginManager::loadPlugin(const String& pluginLoc) {
 		{
 			LoadedPluginInfo<Plugin::FileSourceInfo> info;
 			info.creator = pInfo.fileSource.creator;
-			info.name = pInfo.fileSource.name;
-			info.extensions = pInfo.fileSource.extensions;
-			info.libIndex = libArray.size();
-			Plugin::FileSourceInfo fsi = getFileSourceInfo(String::fromUTF8(info.name));
+			info.name = keepString(name);
+			info.extensions = keepString(desc.extensions[i]);
+			info.libIndex = libIndex;
+			Plugin::FileSourceInfo fsi = getFileSourceInfo(name);
 			if(fsi.name == nullptr)
 				fileSourcePlugins.add(info);
 			break;
 		}
 		default:
 		{
-			std::cerr << pluginLoc << " invalid plugin type: " << pInfo.type << std::endl;
+			std::cerr << desc.file.getFullPathName() << " invalid plugin type: " << pInfo.type << std::endl;
 			break;
 		}
 		}
@@ -336,6 +565,298 @@ int PluginManager::loadPlugin(const String& pluginLoc) {
 	return lib.numPlugins;
 }
 
+template<class T, class C>
+static void setCreator(Array<LoadedPluginInfo<T>>& pluginArray, int libIndex, const String& name, C creator)
+{
+	for (int i = 0; i < pluginArray.size(); i++)
+	{
+		if (pluginArray[i].libIndex == libIndex && name == String(pluginArray[i].name))
+			pluginArray.getReference(i).creator = creator;
+	}
+}
+
+bool PluginManager::applyLoadedLibrary(int libIndex, LibraryDescription& desc)
+{
+	LoadedLibInfo& lib = libArray.getReference(libIndex);
+
+	if (!desc.handle)
+		return false;
+
+	if (desc.apiVersion != PLUGIN_API_VER || !desc.name.equalsIgnoreCase(lib.name))
+	{
+		std::cerr << lib.path << " no longer matches its plugin cache entry" << std::endl;
+		closeHandle(desc.handle);
+		return false;
+	}
+
+	lib.handle = desc.handle;
+
+	for (int i = 0; i < desc.plugins.size(); i++)
+	{
+		const Plugin::PluginInfo& pInfo = desc.plugins.getReference(i);
+		switch (pInfo.type)
+		{
+		case Plugin::PLUGIN_TYPE_PROCESSOR:
+			setCreator(processorPlugins, libIndex, desc.pluginNames[i], pInfo.processor.creator);
+			break;
+		case Plugin::PLUGIN_TYPE_RECORD_ENGINE:
+			setCreator(recordEnginePlugins, libIndex, desc.pluginNames[i], pInfo.recordEngine.creator);
+			break;
+		case Plugin::PLUGIN_TYPE_DATA_THREAD:
+			setCreator(dataThreadPlugins, libIndex, desc.pluginNames[i], pInfo.dataThread.creator);
+			break;
+		case Plugin::PLUGIN_TYPE_FILE_SOURCE:
+			setCreator(fileSourcePlugins, libIndex, desc.pluginNames[i], pInfo.fileSource.creator);
+			break;
+		default:
+			break;
+		}
+	}
+	return true;
+}
+
+void PluginManager::loadLibraries(const Array<int>& libIndexes)
+{
+	const double startTime = Time::getMillisecondCounterHiRes();
+
+	Array<int> toLoad;
+	OwnedArray<LibraryDescription> descs;
+	for (int i = 0; i < libIndexes.size(); i++)
+	{
+		const int libIndex = libIndexes[i];
+		if (libIndex < 0 || libIndex >= libArray.size() || libArray[libIndex].handle || toLoad.contains(libIndex))
+			continue;
+		toLoad.add(libIndex);
+		descs.add(new LibraryDescription())->file = File(libArray[libIndex].path);
+	}
+
+	if (descs.size() == 0)
+		return;
+	else if (descs.size() == 1)
+		describeLibrary(*descs[0]);
+	else
+		LibraryJob::runAll(descs, nullptr);
+
+	for (int i = 0; i < toLoad.size(); i++)
+	{
+		if (!applyLoadedLibrary(toLoad[i], *descs[i]))
+			std::cerr << "Failed to load plugin library " << libArray[toLoad[i]].path << std::endl;
+	}
+
+	std::cout << "Loaded " << toLoad.size() << " plugin libraries in "
+			  << String(Time::getMillisecondCounterHiRes() - startTime, 1) << " ms" << std::endl;
+}
+
+bool PluginManager::loadPluginLibrary(Plugin::PluginType type, int index)
+{
+	int numPlugins;
+	switch (type)
+	{
+	case Plugin::PLUGIN_TYPE_PROCESSOR:
+		numPlugins = processorPlugins.size();
+		break;
+	case Plugin::PLUGIN_TYPE_RECORD_ENGINE:
+		numPlugins = recordEnginePlugins.size();
+		break;
+	case Plugin::PLUGIN_TYPE_DATA_THREAD:
+		numPlugins = dataThreadPlugins.size();
+		break;
+	case Plugin::PLUGIN_TYPE_FILE_SOURCE:
+		numPlugins = fileSourcePlugins.size();
+		break;
+	default:
+		return false;
+	}
+
+	if (index < 0 || index >= numPlugins)
+		return false;
+
+	Array<int> libIndexes;
+	libIndexes.add(getLibraryIndexFromPlugin(type, index));
+	loadLibraries(libIndexes);
+
+	switch (type)
+	{
+	case Plugin::PLUGIN_TYPE_PROCESSOR:
+		return processorPlugins[index].creator != nullptr;
+	case Plugin::PLUGIN_TYPE_RECORD_ENGINE:
+		return recordEnginePlugins[index].creator != nullptr;
+	case Plugin::PLUGIN_TYPE_DATA_THREAD:
+		return dataThreadPlugins[index].creator != nullptr;
+	default:
+		return fileSourcePlugins[index].creator != nullptr;
+	}
+}
+
+void PluginManager::preloadLibraries(const StringArray& libNames)
+{
+	Array<int> libIndexes;
+	for (int i = 0; i < libNames.size(); i++)
+		libIndexes.addIfNotAlreadyThere(getLibraryIndex(libNames[i]));
+
+	loadLibraries(libIndexes);
+}
+
+int PluginManager::reloadPlugin(const String& pluginLoc)
+{
+	/*
+	Load the new build from a private copy. The dynamic linker would otherwise
+	hand back the handle of the build that is already loaded, and on Windows the
+	original file stays free to be overwritten by the next build.
+	*/
+	File build(pluginLoc);
+	File copy = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile(
+		build.getFileNameWithoutExtension() + "_reload", build.getFileExtension(), false);
+
+	if (!(build.isDirectory() ? build.copyDirectoryTo(copy) : build.copyFileTo(copy)))
+	{
+		std::cerr << pluginLoc << " could not be copied for reloading" << std::endl;
+		return -1;
+	}
+
+	decltype(LoadedLibInfo::handle) handle = 0;
+	LibraryInfoFunction infoFunction = 0;
+	PluginInfoFunction piFunction = 0;
+
+	if (!openLibrary(copy.getFullPathName(), true, handle, infoFunction, piFunction))
+	{
+		copy.deleteRecursively();
+		return -1;
+	}
+
+	Plugin::LibraryInfo libInfo;
+	infoFunction(&libInfo);
+
+	int libIndex = getLibraryIndex(String::fromUTF8(libInfo.name));
+	bool canReload = libInfo.apiVersion == PLUGIN_API_VER && libIndex >= 0;
+
+	for (int i = 0; i < recordEnginePlugins.size(); i++)
+		canReload &= recordEnginePlugins[i].libIndex != libIndex;
+	for (int i = 0; i < fileSourcePlugins.size(); i++)
+		canReload &= fileSourcePlugins[i].libIndex != libIndex;
+
+	Array<Plugin::ProcessorInfo> processors;
+	Array<Plugin::DataThreadInfo> dataThreads;
+	Plugin::PluginInfo pInfo;
+
+	for (int i = 0; i < libInfo.numPlugins && canReload; i++)
+	{
+		if (piFunction(i, &pInfo)) //if somehow there are less plugins than stated, stop adding
+			break;
+		if (pInfo.type == Plugin::PLUGIN_TYPE_PROCESSOR)
+			processors.add(pInfo.processor);
+		else if (pInfo.type == Plugin::PLUGIN_TYPE_DATA_THREAD)
+			dataThreads.add(pInfo.dataThread);
+		else
+			canReload = false;
+	}
+
+	if (!canReload)
+	{
+		std::cerr << pluginLoc << " cannot be reloaded" << std::endl;
+		closeHandle(handle);
+		copy.deleteRecursively();
+		return -1;
+	}
+
+	LoadedLibInfo& lib = libArray.getReference(libIndex);
+	reloadedLibArray.add(lib);
+
+	lib.apiVersion = libInfo.apiVersion;
+	lib.name = libInfo.name;
+	lib.libVersion = libInfo.libVersion;
+	lib.numPlugins = libInfo.numPlugins;
+	lib.handle = handle;
+	lib.path = pluginLoc;
+	lib.shadowCopy = copy;
+
+	reloadPluginEntries(processorPlugins, processors, libIndex);
+	reloadPluginEntries(dataThreadPlugins, dataThreads, libIndex);
+
+	return libIndex;
+}
+
+void PluginManager::releaseReloadedLibraries()
+{
+	for (int i = 0; i < reloadedLibArray.size(); i++)
+	{
+		closeHandle(reloadedLibArray[i].handle);
+		if (reloadedLibArray[i].shadowCopy.exists())
+			reloadedLibArray[i].shadowCopy.deleteRecursively();
+	}
+	reloadedLibArray.clear();
+}
+
+int PluginManager::getLibraryIndex(const String& libName) const
+{
+	for (int i = 0; i < libArray.size(); i++)
+	{
+		if (libName.equalsIgnoreCase(libArray[i].name))
+			return i;
+	}
+	return -1;
+}
+
+PluginManager::LibraryDescription::LibraryDescription()
+	: handle(0)
+	, libVersion(0)
+	, apiVersion(0)
+{
+}
+
+const char* PluginManager::keepString(const String& string)
+{
+	keptStrings.add(string);
+	return keptStrings[keptStrings.size() - 1].toRawUTF8();
+}
+
+File PluginManager::getPluginCacheFile()
+{
+	return CoreServices::getSavedStateDirectory().getChildFile("pluginCache.xml");
+}
+
+void PluginManager::readCacheEntry(const XmlElement& entry, LibraryDescription& desc)
+{
+	desc.name = entry.getStringAttribute("name");
+	desc.libVersion = entry.getIntAttribute("libVersion");
+	desc.apiVersion = entry.getIntAttribute("apiVersion");
+
+	forEachXmlChildElementWithTagName(entry, plugin, "PLUGIN")
+	{
+		Plugin::PluginInfo pInfo;
+		zerostruct(pInfo);
+		pInfo.type = (Plugin::PluginType)plugin->getIntAttribute("type", Plugin::NOT_A_PLUGIN_TYPE);
+		if (pInfo.type == Plugin::PLUGIN_TYPE_PROCESSOR)
+			pInfo.processor.type = (Plugin::ProcessorType)plugin->getIntAttribute("processorType", Plugin::InvalidProcessor);
+
+		desc.plugins.add(pInfo);
+		desc.pluginNames.add(plugin->getStringAttribute("name"));
+		desc.extensions.add(plugin->getStringAttribute("extensions"));
+	}
+}
+
+XmlElement* PluginManager::createCacheEntry(const LibraryDescription& desc)
+{
+	XmlElement* entry = new XmlElement("LIBRARY");
+	entry->setAttribute("hash", desc.hash);
+	entry->setAttribute("path", desc.file.getFullPathName());
+	entry->setAttribute("name", desc.name);
+	entry->setAttribute("libVersion", desc.libVersion);
+	entry->setAttribute("apiVersion", desc.apiVersion);
+
+	for (int i = 0; i < desc.plugins.size(); i++)
+	{
+		XmlElement* plugin = entry->createNewChildElement("PLUGIN");
+		plugin->setAttribute("type", (int)desc.plugins[i].type);
+		plugin->setAttribute("name", desc.pluginNames[i]);
+		if (desc.plugins[i].type == Plugin::PLUGIN_TYPE_PROCESSOR)
+			plugin->setAttribute("processorType", (int)desc.plugins[i].processor.type);
+		else if (desc.plugins[i].type == Plugin::PLUGIN_TYPE_FILE_SOURCE)
+			plugin->setAttribute("extensions", desc.extensions[i]);
+	}
+	return entry;
+}
+
 int PluginManager::getNumProcessors() const
 {
 	return processorPlugins.size();
@@ -482,6 +1003,51 @@ Plugin::FileSourceInfo PluginManager::getEmptyFileSourceInfo()
 	return i;
 }
 
+template<class T>
+void PluginManager::reloadPluginEntries(Array<LoadedPluginInfo<T>>& pluginArray, const Array<T>& newPlugins, int libIndex)
+{
+	Array<bool> matched;
+	matched.insertMultiple(0, false, newPlugins.size());
+
+	// entries keep their position so indexes held elsewhere stay valid; plugins
+	// the new build no longer provides are left as nameless entries without a creator
+	for (int i = 0; i < pluginArray.size(); i++)
+	{
+		if (pluginArray[i].libIndex != libIndex || pluginArray[i].name == nullptr)
+			continue;
+
+		int j = 0;
+		while (j < newPlugins.size() && String(newPlugins[j].name) != String(pluginArray[i].name))
+			j++;
+
+		if (j < newPlugins.size())
+		{
+			static_cast<T&>(pluginArray.getReference(i)) = newPlugins[j];
+			matched.set(j, true);
+		}
+		else
+		{
+			pluginArray.getReference(i).name = nullptr;
+			pluginArray.getReference(i).creator = nullptr;
+		}
+	}
+
+	for (int j = 0; j < newPlugins.size(); j++)
+	{
+		bool exists = matched[j];
+		for (int i = 0; i < pluginArray.size() && !exists; i++)
+			exists = String(pluginArray[i].name) == String(newPlugins[j].name);
+
+		if (!exists)
+		{
+			LoadedPluginInfo<T> info;
+			static_cast<T&>(info) = newPlugins[j];
+			info.libIndex = libIndex;
+			pluginArray.add(info);
+		}
+	}
+}
+
 template<class T>
 bool PluginManager::findPlugin(String name, String libName, const Array<LoadedPluginInfo<T>>& pluginArray, T& pluginInfo) const
 {
@@ -46,6 +46,13 @@ struct LoadedLibInfo : public Plugin::LibraryInfo
 #else
 	void* handle;
 #endif
+	/** Where the library was loaded from. */
+	String path;
+	/** Set when the library was loaded from a private copy by reloadPlugin, so the
+	copy can be deleted once the handle is closed. */
+	File shadowCopy;
+	/** Hash of the library file, the key of its entry in the plugin cache. */
+	String hash;
 };
 
 template<class T>
@@ -62,9 +69,41 @@ class PluginManager {
 public:
 	PluginManager();
 	~PluginManager();
+	/** Finds the plugins in the plugin folders. Libraries already known to the plugin
+	cache are described from it without being loaded; the others are loaded in parallel
+	and added to the cache. A described library is loaded when one of its plugins is
+	first created, see loadPluginLibrary() and preloadLibraries().*/
 	void loadAllPlugins();
     void loadPlugins(const File &pluginPath);
 	int loadPlugin(const String&);
+
+	/** Loads the library providing the given plugin if it was only described from the
+	plugin cache, so the creator of its info can be called. Returns false if the library
+	cannot be loaded or no longer provides the plugin.*/
+	bool loadPluginLibrary(Plugin::PluginType type, int index);
+
+	/** Loads the named libraries that are not loaded yet in parallel, ahead of creating
+	their plugins, e.g. when a configuration is opened.*/
+	void preloadLibraries(const StringArray& libNames);
+
+	/** Loads a new build of an already loaded library and switches the plugins it
+	provides over to it, keeping their indexes. The build is loaded from a private
+	copy so the original file can be rebuilt again and the previous copy, which
+	still backs any existing instances, stays mapped until releaseReloadedLibraries()
+	is called. Libraries providing record engines or file sources are refused, as
+	their instances are not owned by the signal chain. Plugins the new build no
+	longer provides keep their entry, with no name and no creator.
+
+	Returns the index of the reloaded library, or -1 on failure.*/
+	int reloadPlugin(const String& pluginLoc);
+
+	/** Closes the libraries replaced by reloadPlugin. Every processor created from
+	them has to be destroyed first.*/
+	void releaseReloadedLibraries();
+
+	/** Returns the index of the loaded library with the given name, or -1.*/
+	int getLibraryIndex(const String& libName) const;
+
 	//void unloadPlugin(Plugin *);
 	void removeAllPlugins();
 	int getNumProcessors() const;
@@ -84,12 +123,54 @@ public:
 	int getLibraryIndexFromPlugin(Plugin::PluginType type, int index);
 
 private:
+	/** What a library provides, read from the library itself or from its plugin cache entry. */
+	struct LibraryDescription
+	{
+		LibraryDescription();
+
+		File file;
+		String hash;
+		/** 0 when described from the cache */
+		decltype(LoadedLibInfo::handle) handle;
+		String name;
+		int libVersion;
+		int apiVersion;
+		Array<Plugin::PluginInfo> plugins;
+		/** Plugin names and file source extensions, as the pointers in plugins are only valid while the library is loaded */
+		StringArray pluginNames;
+		StringArray extensions;
+	};
+
+	class LibraryJob;
+
+	int addLibrary(const LibraryDescription& desc);
+	bool applyLoadedLibrary(int libIndex, LibraryDescription& desc);
+	void loadLibraries(const Array<int>& libIndexes);
+	void loadPluginFiles(const Array<File>& files);
+	const char* keepString(const String& string);
+
+	static bool describeLibrary(LibraryDescription& desc);
+	static void readCacheEntry(const XmlElement& entry, LibraryDescription& desc);
+	static XmlElement* createCacheEntry(const LibraryDescription& desc);
+	static File getPluginCacheFile();
+
 	Array<LoadedLibInfo> libArray;
+	Array<LoadedLibInfo> reloadedLibArray;
 	Array<LoadedPluginInfo<Plugin::ProcessorInfo>> processorPlugins;
 	Array<LoadedPluginInfo<Plugin::DataThreadInfo>> dataThreadPlugins;
 	Array<LoadedPluginInfo<Plugin::RecordEngineInfo>> recordEnginePlugins;
 	Array<LoadedPluginInfo<Plugin::FileSourceInfo>> fileSourcePlugins;
 
+	/** Names pointed to by the infos of libraries that are not loaded */
+	StringArray keptStrings;
+	/** Cache entries read at startup, keyed by file hash, and the entries to write back */
+	HashMap<String, XmlElement*> cachedLibraries;
+	ScopedPointer<XmlElement> pluginCache;
+	ScopedPointer<XmlElement> updatedPluginCache;
+
+	template<class T>
+	static void reloadPluginEntries(Array<LoadedPluginInfo<T>>& pluginArray, const Array<T>& newPlugins, int libIndex);
+
 	template<class T>
 	bool findPlugin(String name, String libName, const Array<LoadedPluginInfo<T>>& pluginArray, T& pluginInfo) const;
 
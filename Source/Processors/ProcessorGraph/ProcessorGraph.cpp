@@ -102,28 +102,7 @@ void* ProcessorGraph::createNewProcessor(Array<var>& description, int id)//,
 
 	if (processor != 0)
 	{
-		processor->setNodeId(id); // identifier within processor graph
-		std::cout << "  Adding node to graph with ID number " << id << std::endl;
-		std::cout << std::endl;
-		std::cout << std::endl;
-		addNode(processor,id); // have to add it so it can be deleted by the graph
-
-		if (processor->isSource())
-		{
-			// by default, all source nodes record automatically
-			processor->setAllChannelsToRecord();
-			if (processor->isGeneratesTimestamps())
-			{ //If there are no source processors and we add one, set it as default for global timestamps and samplerates
-				m_validTimestampSources.add(processor);
-				if (m_timestampSource == nullptr)
-				{
-					m_timestampSource = processor;
-					m_timestampSourceSubIdx = 0;
-				}
-				if (m_timestampWindow)
-					m_timestampWindow->updateProcessorList();
-			}
-		}
+		addProcessor(processor, id);
 		return processor->createEditor();
 	}
 	else
@@ -133,6 +112,65 @@ void* ProcessorGraph::createNewProcessor(Array<var>& description, int id)//,
 	}
 }
 
+GenericProcessor* ProcessorGraph::replaceProcessor(GenericProcessor* oldProcessor, Array<var>& description)
+{
+	GenericProcessor* processor = 0;
+	try {
+		processor = createProcessorFromDescription(description);
+	}
+	catch (std::exception& e) {
+		NativeMessageBox::showMessageBoxAsync(AlertWindow::WarningIcon, "OpenEphys", e.what());
+	}
+
+	if (processor == 0)
+		return 0;
+
+	int id = oldProcessor->getNodeId();
+	bool wasTimestampSource = (m_timestampSource == oldProcessor);
+	int timestampSourceSubIdx = m_timestampSourceSubIdx;
+
+	removeProcessor(oldProcessor);
+	addProcessor(processor, id);
+
+	if (wasTimestampSource && m_validTimestampSources.contains(processor))
+	{
+		m_timestampSource = processor;
+		m_timestampSourceSubIdx = timestampSourceSubIdx;
+		if (m_timestampWindow)
+			m_timestampWindow->updateProcessorList();
+	}
+
+	processor->createEditor();
+
+	return processor;
+}
+
+void ProcessorGraph::addProcessor(GenericProcessor* processor, int id)
+{
+	processor->setNodeId(id); // identifier within processor graph
+	std::cout << "  Adding node to graph with ID number " << id << std::endl;
+	std::cout << std::endl;
+	std::cout << std::endl;
+	addNode(processor,id); // have to add it so it can be deleted by the graph
+
+	if (processor->isSource())
+	{
+		// by default, all source nodes record automatically
+		processor->setAllChannelsToRecord();
+		if (processor->isGeneratesTimestamps())
+		{ //If there are no source processors and we add one, set it as default for global timestamps and samplerates
+			m_validTimestampSources.add(processor);
+			if (m_timestampSource == nullptr)
+			{
+				m_timestampSource = processor;
+				m_timestampSourceSubIdx = 0;
+			}
+			if (m_timestampWindow)
+				m_timestampWindow->updateProcessorList();
+		}
+	}
+}
+
 void ProcessorGraph::clearSignalChain()
 {
 
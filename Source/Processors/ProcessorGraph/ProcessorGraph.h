@@ -60,6 +60,12 @@ public:
     GenericProcessor* createProcessorFromDescription(Array<var>& description);
 
     void removeProcessor(GenericProcessor* processor);
+
+    /** Creates a processor from description and puts it in the graph under the node ID
+    of oldProcessor, which is deleted along with its editor. If oldProcessor was the
+    global timestamp source, the new processor takes its place. Returns nullptr and
+    leaves oldProcessor untouched if the new processor cannot be created.*/
+    GenericProcessor* replaceProcessor(GenericProcessor* oldProcessor, Array<var>& description);
     Array<GenericProcessor*> getListOfProcessors();
     void clearSignalChain();
 
@@ -116,6 +122,8 @@ private:
 
     void clearConnections();
 
+    void addProcessor(GenericProcessor* processor, int id);
+
     void connectProcessors(GenericProcessor* source, GenericProcessor* dest,
         bool connectContinuous, bool connectEvents);
     void connectProcessorToAudioNode(GenericProcessor* source);
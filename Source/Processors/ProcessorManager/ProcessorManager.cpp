@@ -32,11 +32,12 @@
 #include "../Merger/Merger.h"
 #include "../Splitter/Splitter.h"
 #include "../RecordNode/RecordNode.h"
+#include "../Decimator/Decimator.h"
 
 #include "../PlaceholderProcessor/PlaceholderProcessor.h"
 
 /** Total number of builtin processors **/
-#define BUILTIN_PROCESSORS 4
+#define BUILTIN_PROCESSORS 5
 
 namespace ProcessorManager
 {
@@ -66,6 +67,10 @@ namespace ProcessorManager
 			name = "Record Node";
 			type = FilterProcessor;
 			break;
+		case 4:
+			name = "Decimator";
+			type = FilterProcessor;
+			break;
 		default:
 			name = String::empty;
 			type = -1;
@@ -94,6 +99,9 @@ namespace ProcessorManager
 		case 3:
 			proc = new RecordNode();
 			break;
+		case 4:
+			proc = new Decimator();
+			break;
 		default:
 			return nullptr;
 		}
@@ -130,14 +138,15 @@ namespace ProcessorManager
 			{
 				Plugin::ProcessorInfo info = AccessClass::getPluginManager()->getProcessorInfo(index);
 				name = info.name;
-				type = info.type;
+				// entries of plugins dropped by a library reload have no name
+				type = info.name ? info.type : -1;
 			}
 			break;
 		case DataThreadProcessor:
 		{
 			Plugin::DataThreadInfo info = AccessClass::getPluginManager()->getDataThreadInfo(index);
 			name = info.name;
-			type = SourceProcessor;
+			type = info.name ? SourceProcessor : -1;
 			break;
 		}
 		default:
@@ -156,6 +165,9 @@ namespace ProcessorManager
 			break;
 		case PluginProcessor:
 			{
+				// plugin libraries described from the plugin cache are loaded on first use
+				if (!AccessClass::getPluginManager()->loadPluginLibrary(Plugin::PLUGIN_TYPE_PROCESSOR, index))
+					return nullptr;
 				Plugin::ProcessorInfo info = AccessClass::getPluginManager()->getProcessorInfo(index);
 				GenericProcessor* proc = info.creator();
 				proc->setPluginData(Plugin::PLUGIN_TYPE_PROCESSOR, index);
@@ -164,6 +176,8 @@ namespace ProcessorManager
 			}
 		case DataThreadProcessor:
 		{
+			if (!AccessClass::getPluginManager()->loadPluginLibrary(Plugin::PLUGIN_TYPE_DATA_THREAD, index))
+				return nullptr;
 			Plugin::DataThreadInfo info = AccessClass::getPluginManager()->getDataThreadInfo(index);
 			GenericProcessor* proc = new SourceNode(info.name, info.creator);
 			proc->setPluginData(Plugin::PLUGIN_TYPE_DATA_THREAD, index);
@@ -194,9 +208,10 @@ namespace ProcessorManager
 					if (procName.equalsIgnoreCase(info.name))
 					{
 						int libIndex = pm->getLibraryIndexFromPlugin(Plugin::PLUGIN_TYPE_PROCESSOR, i);
-						if (libName.equalsIgnoreCase(pm->getLibraryName(libIndex)) && libVersion == pm->getLibraryVersion(libIndex))
+						if (libName.equalsIgnoreCase(pm->getLibraryName(libIndex)) && libVersion == pm->getLibraryVersion(libIndex)
+							&& pm->loadPluginLibrary(Plugin::PLUGIN_TYPE_PROCESSOR, i))
 						{
-							proc = info.creator();
+							proc = pm->getProcessorInfo(i).creator();
 							proc->setPluginData(Plugin::PLUGIN_TYPE_PROCESSOR, i);
 							return proc;
 						}
@@ -211,9 +226,10 @@ namespace ProcessorManager
 					if (procName.equalsIgnoreCase(info.name))
 					{
 						int libIndex = pm->getLibraryIndexFromPlugin(Plugin::PLUGIN_TYPE_DATA_THREAD, i);
-						if (libName.equalsIgnoreCase(pm->getLibraryName(libIndex)) && libVersion == pm->getLibraryVersion(libIndex))
+						if (libName.equalsIgnoreCase(pm->getLibraryName(libIndex)) && libVersion == pm->getLibraryVersion(libIndex)
+							&& pm->loadPluginLibrary(Plugin::PLUGIN_TYPE_DATA_THREAD, i))
 						{
-							proc = new SourceNode(info.name, info.creator);
+							proc = new SourceNode(info.name, pm->getDataThreadInfo(i).creator);
 							proc->setPluginData(Plugin::PLUGIN_TYPE_DATA_THREAD, i);
 							return proc;
 						}
@@ -10,6 +10,9 @@ BinaryRecording::BinaryRecording()
 	m_scaledBuffer.malloc(MAX_BUFFER_SIZE);
 	m_intBuffer.malloc(MAX_BUFFER_SIZE);
 	m_tsBuffer.malloc(MAX_BUFFER_SIZE);		
+	m_filePool = new FilePool();
+	m_segmentPool = new FilePool();
+	m_checksums = nullptr;
 }
 
 BinaryRecording::~BinaryRecording() {}
@@ -33,7 +36,14 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
 
 	String basepath = rootFolder.getFullPathName() + rootFolder.separatorString + "experiment" + String(experimentNumber)
         + File::separatorString + "recording" + String(recordingNumber + 1) + File::separatorString;
-    String contPath = basepath + "continuous" + File::separatorString;
+    String contPath = "continuous" + File::separatorString;
+
+    // files prepared when the last recording was closed are only opened below
+    m_recordingFolder = File(basepath);
+    m_filePool->claim(m_recordingFolder);
+    m_openedFiles.clear();
+    m_manifest.clear();
+    m_checksums = m_writeChecksums ? &m_manifest : nullptr;
 
     m_channelIndexes.insertMultiple(0, 0, getNumRecordedChannels());
     m_fileIndexes.insertMultiple(0, 0, getNumRecordedChannels());
@@ -42,7 +52,6 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
     Array<unsigned int> indexedChannelCount;
     Array<var> jsonContinuousfiles;
     Array<var> jsonChannels;
-    StringArray continuousFileNames;
     int lastId = 0;
 
     for (int proc = 0; proc < getNumRecordedProcessors(); proc++)
@@ -90,14 +99,7 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
             if (!found)
             {
                 String datPath = getProcessorString(channelInfo);
-                continuousFileNames.add(contPath + datPath + "continuous.dat");
-
-                //std::cout << "Creating file: " << contPath << datPath << "timestamps.npy" << std::endl;
-                ScopedPointer<NpyFile> tFile = new NpyFile(contPath + datPath + "timestamps.npy", NpyType(BaseType::INT64,1));
-                m_dataTimestampFiles.add(tFile.release());
-
-                ScopedPointer<NpyFile> ftsFile = new NpyFile(contPath + datPath + "synchronized_timestamps.npy", NpyType(BaseType::DOUBLE,1));
-                m_dataFloatTimestampFiles.add(ftsFile.release());
+                m_continuousFolders.add(contPath + datPath);
 
                 m_fileIndexes.set(recordedChan, nInfoArrays);
                 m_channelIndexes.set(recordedChan, 0);
@@ -115,21 +117,19 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
                 jsonFile->setProperty("source_processor_sub_idx", channelInfo->getSubProcessorIdx());
                 jsonFile->setProperty("recorded_processor", channelInfo->getCurrentNodeName());
                 jsonFile->setProperty("recorded_processor_id", channelInfo->getCurrentNodeID());
+                if (m_compactTimestamps)
+                    jsonFile->setProperty("timestamp_format", "index");
                 jsonContinuousfiles.add(var(jsonFile));
             }
         }
         lastId = indexedDataChannels.size();
     }
 
-    int nFiles = continuousFileNames.size();
+    int nFiles = m_continuousFolders.size();
     for (int i = 0; i < nFiles; i++)
     {
         int numChannels = jsonChannels.getReference(i).size();
-        ScopedPointer<SequentialBlockFile> bFile = new SequentialBlockFile(numChannels, samplesPerBlock);
-        if (bFile->openFile(continuousFileNames[i]))
-            m_DataFiles.add(bFile.release());
-        else
-            m_DataFiles.add(nullptr);
+        m_continuousChannels.add(numChannels);
         DynamicObject::Ptr jsonFile = jsonContinuousfiles.getReference(i).getDynamicObject(); 
         jsonFile->setProperty("num_channels", numChannels);
         jsonFile->setProperty("channels", jsonChannels.getReference(i));
@@ -145,7 +145,6 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
     }
 
     int nEvents = getNumRecordedEvents();
-    String eventPath(basepath + "events" + File::separatorString);
     Array<var> jsonEventFiles;
 
     for (int ev = 0; ev < nEvents; ev++)
@@ -153,39 +152,39 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
 
         const EventChannel* chan = getEventChannel(ev);
         String eventName = getProcessorString(chan);
-        NpyType type;
-        String dataFileName;
+        EventFileLayout layout;
 
         switch (chan->getChannelType())
         {
         case EventChannel::TEXT:
             //LOGD("Got TEXT channel");
             eventName += "TEXT_group";
-            type = NpyType(BaseType::CHAR, chan->getLength());
-            dataFileName = "text";
+            layout.mainType = NpyType(BaseType::CHAR, chan->getLength());
+            layout.mainName = "text.npy";
             break;
         case EventChannel::TTL:
             //LOGD("Got TTL channel");
             eventName += "TTL";
-            type = NpyType(BaseType::INT16, 1);
-            dataFileName = "channel_states";
+            layout.mainType = NpyType(BaseType::INT16, 1);
+            layout.mainName = "channel_states.npy";
             break;
         default:
             //LOGD("Got BINARY group");
             eventName += "BINARY_group";
-            type = NpyType(chan->getEquivalentMetaDataType(), chan->getLength());
-            dataFileName = "data_array";
+            layout.mainType = NpyType(chan->getEquivalentMetaDataType(), chan->getLength());
+            layout.mainName = "data_array.npy";
             break;
         }
         eventName += "_" + String(chan->getSourceIndex() + 1) + File::separatorString;
-        ScopedPointer<EventRecording> rec = new EventRecording();
 
-        rec->mainFile = new NpyFile(eventPath + eventName + dataFileName + ".npy", type);
-        rec->timestampFile = new NpyFile(eventPath + eventName + "timestamps.npy", NpyType(BaseType::INT64, 1));
-        rec->channelFile = new NpyFile(eventPath + eventName + "channels.npy", NpyType(BaseType::UINT16, 1));
+        layout.folder = "events" + File::separatorString + eventName;
+        layout.mainDim = 1;
+        layout.timestampName = "timestamps.npy";
+        layout.channelName = "channels.npy";
         if (chan->getChannelType() == EventChannel::TTL && m_saveTTLWords)
         {
-            rec->extraFile = new NpyFile(eventPath + eventName + "full_words.npy", NpyType(BaseType::UINT8, chan->getDataSize()));
+            layout.extraName = "full_words.npy";
+            layout.extraType = NpyType(BaseType::UINT8, chan->getDataSize());
         }
 
         DynamicObject::Ptr jsonChannel = new DynamicObject();
@@ -194,13 +193,13 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
         jsonChannel->setProperty("description", chan->getDescription());
         jsonChannel->setProperty("identifier", chan->getIdentifier());
         jsonChannel->setProperty("sample_rate", chan->getSampleRate());
-        jsonChannel->setProperty("type", jsonTypeValue(type.getType()));
+        jsonChannel->setProperty("type", jsonTypeValue(layout.mainType.getType()));
         jsonChannel->setProperty("num_channels", (int)chan->getNumChannels());
         jsonChannel->setProperty("source_processor", chan->getSourceName());
         createChannelMetaData(chan, jsonChannel);
 
-        rec->metaDataFile = createEventMetadataFile(chan, eventPath + eventName + "metadata.npy", jsonChannel);
-        m_eventFiles.add(rec.release());
+        describeEventMetaData(chan, layout.metaDataTypes, jsonChannel);
+        m_eventLayouts.add(layout);
         jsonEventFiles.add(var(jsonChannel));
     }
 
@@ -210,7 +209,6 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
     Array<uint16> indexedChannels;
     m_spikeFileIndexes.insertMultiple(0, 0, nSpikes);
     m_spikeChannelIndexes.insertMultiple(0, 0, nSpikes);
-    String spikePath(basepath + "spikes" + File::separatorString);
     Array<var> jsonSpikeFiles;
     Array<var> jsonSpikeChannels;
     std::map<uint32, int> groupMap;
@@ -255,23 +253,26 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
 
         if (!found)
         {
-            int fileIndex = m_spikeFiles.size();
+            int fileIndex = m_spikeLayouts.size();
             m_spikeFileIndexes.set(sp, fileIndex);
             indexedSpikes.add(ch);
             m_spikeChannelIndexes.set(sp, 1);
             indexedChannels.add(1);
-            ScopedPointer<EventRecording> rec = new EventRecording();
 
             uint32 procID = GenericProcessor::getProcessorFullId(ch->getSourceNodeID(), ch->getSubProcessorIdx());
             int groupIndex = ++groupMap[procID];
 
             String spikeName = getProcessorString(ch) + "spike_group_" + String(groupIndex) + File::separatorString;
 
-            rec->mainFile = new NpyFile(spikePath + spikeName + "spike_waveforms.npy", NpyType(BaseType::INT16, ch->getTotalSamples()), ch->getNumChannels());
-            rec->timestampFile = new NpyFile(spikePath + spikeName + "spike_times.npy", NpyType(BaseType::INT64, 1));
-            rec->channelFile = new NpyFile(spikePath + spikeName + "spike_electrode_indices.npy", NpyType(BaseType::UINT16, 1));
-            rec->extraFile = new NpyFile(spikePath + spikeName + "spike_clusters.npy", NpyType(BaseType::UINT16, 1));
-            Array<NpyType> tsTypes;
+            EventFileLayout layout;
+            layout.folder = "spikes" + File::separatorString + spikeName;
+            layout.mainName = "spike_waveforms.npy";
+            layout.mainType = NpyType(BaseType::INT16, ch->getTotalSamples());
+            layout.mainDim = ch->getNumChannels();
+            layout.timestampName = "spike_times.npy";
+            layout.channelName = "spike_electrode_indices.npy";
+            layout.extraName = "spike_clusters.npy";
+            layout.extraType = NpyType(BaseType::UINT16, 1);
 
             Array<var> jsonChanArray;
             jsonChanArray.add(var(jsonChannel));
@@ -285,8 +286,8 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
             jsonFile->setProperty("pre_peak_samples", (int)ch->getPrePeakSamples());
             jsonFile->setProperty("post_peak_samples", (int)ch->getPostPeakSamples());
 
-            rec->metaDataFile = createEventMetadataFile(ch, spikePath + spikeName + "metadata.npy", jsonFile);
-            m_spikeFiles.add(rec.release());
+            describeEventMetaData(ch, layout.metaDataTypes, jsonFile);
+            m_spikeLayouts.add(layout);
             jsonSpikeFiles.add(var(jsonFile));
         }
     }
@@ -299,7 +300,21 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
         jsonFile->setProperty("channels", jsonSpikeChannels.getReference(i));
     }
 
-    File syncFile = File(basepath + "sync_messages.txt");
+    m_recordingNum = recordingNumber;
+
+    // every stream gets the same duration per segment, rounded up to whole blocks
+    m_segmentSeconds = getSegmentSeconds(indexedDataChannels);
+    for (int i = 0; i < nFiles; i++)
+    {
+        int64 length = int64(m_segmentSeconds * indexedDataChannels[i]->getSampleRate());
+        length = ((length + samplesPerBlock - 1) / samplesPerBlock) * samplesPerBlock;
+        m_segmentLengths.add(length);
+        m_segmentEnds.add(length > 0 ? length : std::numeric_limits<int64>::max());
+    }
+
+    openSegment(0);
+
+    File syncFile = File(trackFile(basepath + "sync_messages.txt"));
     Result res = syncFile.create();
     if (res.failed())
     {
@@ -310,25 +325,165 @@ void BinaryRecording::openFiles(File rootFolder, int experimentNumber, int recor
         m_syncTextFile = syncFile.createOutputStream();
     }
 
-    m_recordingNum = recordingNumber;
-
     DynamicObject::Ptr jsonSettingsFile = new DynamicObject();
     jsonSettingsFile->setProperty("GUI version", CoreServices::getGUIVersion());
+    if (m_segmentSeconds > 0)
+        jsonSettingsFile->setProperty("segment_index", "segments.json");
     jsonSettingsFile->setProperty("continuous", jsonContinuousfiles);
     jsonSettingsFile->setProperty("events", jsonEventFiles);
     jsonSettingsFile->setProperty("spikes", jsonSpikeFiles);
-    FileOutputStream settingsFileStream(File(basepath + "structure.oebin"));
+    FileOutputStream settingsFileStream(File(trackFile(basepath + "structure.oebin")));
 
     jsonSettingsFile->writeAsJSON(settingsFileStream, 2, false);
 
+    m_filePool->release(m_openedFiles);
+
+}
+
+double BinaryRecording::getSegmentSeconds(const Array<const DataChannel*>& streams) const
+{
+    double seconds = m_segmentMinutes * 60.0;
+
+    if (m_segmentMegabytes > 0)
+    {
+        // the size limit applies to the fastest growing file, which is the data or a timestamp file
+        double maxBytesPerSecond = 0;
+        for (int i = 0; i < streams.size(); i++)
+        {
+            int bytesPerSample = jmax(int(m_continuousChannels[i] * sizeof(int16)), m_compactTimestamps ? 0 : int(sizeof(int64)));
+            maxBytesPerSecond = jmax(maxBytesPerSecond, bytesPerSample * double(streams[i]->getSampleRate()));
+        }
+
+        if (maxBytesPerSecond > 0)
+        {
+            double sizeSeconds = m_segmentMegabytes * 1048576.0 / maxBytesPerSecond;
+            seconds = (seconds > 0) ? jmin(seconds, sizeSeconds) : sizeSeconds;
+        }
+    }
+
+    if (seconds <= 0 || streams.size() == 0)
+        return 0;
+
+    return jmax(seconds, minSegmentSeconds);
+}
+
+String BinaryRecording::getSegmentPath(int segment) const
+{
+    String path = m_recordingFolder.getFullPathName() + File::separatorString;
+
+    if (m_segmentSeconds > 0)
+        path += "segment_" + String(segment) + File::separatorString;
+
+    return path;
+}
+
+/* Without segments there is only segment 0, in the recording folder itself. With them, every
+segment has its own folder with the same continuous, events and spikes layout, and is listed in
+segments.json. Each stream moves to the next segment at exactly its first sample, a multiple of
+samplesPerBlock. Events and spikes move when the first stream does. The files of a segment are
+created in the background while the one before it is written. */
+void BinaryRecording::openSegment(int segment)
+{
+    String path = getSegmentPath(segment);
+
+    if (segment > 0)
+    {
+        m_openedFiles.clear();
+        m_segmentPool->claim(File(path));
+    }
+
+    for (int i = 0; i < m_continuousFolders.size(); i++)
+    {
+        String folder = path + m_continuousFolders[i];
+
+        if (segment == 0)
+        {
+            ScopedPointer<SequentialBlockFile> bFile = new SequentialBlockFile(m_continuousChannels[i], samplesPerBlock, m_checksums);
+            if (bFile->openFile(trackFile(folder + "continuous.dat")))
+                m_DataFiles.add(bFile.release());
+            else
+                m_DataFiles.add(nullptr);
+
+            m_timestampFiles.add(createTimestampFiles(folder));
+            m_nextTimestampFiles.add(nullptr);
+        }
+        else if (m_nextTimestampFiles[i] == nullptr) // a stalled stream keeps the segment it was given
+        {
+            if (m_DataFiles[i] != nullptr)
+                m_DataFiles[i]->openSegment(trackFile(folder + "continuous.dat"), m_segmentEnds[i], m_segmentPool);
+
+            m_nextTimestampFiles.set(i, createTimestampFiles(folder));
+        }
+    }
+
+    // set() adds to the end when opening the first segment
+    Array<EventRecording*> finishedFiles;
+    for (int i = 0; i < m_eventLayouts.size(); i++)
+    {
+        finishedFiles.add(m_eventFiles[i]);
+        m_eventFiles.set(i, createEventFiles(m_eventLayouts.getReference(i), path), false);
+    }
+
+    for (int i = 0; i < m_spikeLayouts.size(); i++)
+    {
+        finishedFiles.add(m_spikeFiles[i]);
+        m_spikeFiles.set(i, createEventFiles(m_spikeLayouts.getReference(i), path), false);
+    }
+
+    m_segment = segment;
+
+    if (m_segmentSeconds > 0)
+    {
+        if (segment > 0)
+            m_segmentPool->release(m_openedFiles);
+
+        // the segment before this one is complete, and the best guess at the next one's sizes
+        m_segmentPool->prepare(File(getSegmentPath(jmax(0, segment - 1))), File(getSegmentPath(segment + 1)));
+
+        // closing and syncing the finished files happens on the pool's thread
+        for (int i = 0; i < finishedFiles.size(); i++)
+            m_segmentPool->retire(finishedFiles[i]);
+
+        writeSegmentIndex();
+    }
+}
+
+void BinaryRecording::writeSegmentIndex()
+{
+    Array<var> jsonSegments;
+
+    for (int s = 0; s <= m_segment; s++)
+    {
+        Array<var> jsonContinuous;
+        for (int i = 0; i < m_continuousFolders.size(); i++)
+        {
+            DynamicObject::Ptr jsonStream = new DynamicObject();
+            jsonStream->setProperty("folder_name", m_continuousFolders[i].fromFirstOccurrenceOf(File::separatorString, false, false)
+                .replace(File::separatorString, "/"));
+            jsonStream->setProperty("first_sample", m_segmentLengths[i] * s);
+            jsonContinuous.add(var(jsonStream));
+        }
+
+        DynamicObject::Ptr jsonSegment = new DynamicObject();
+        jsonSegment->setProperty("folder_name", "segment_" + String(s) + "/");
+        jsonSegment->setProperty("continuous", jsonContinuous);
+        jsonSegments.add(var(jsonSegment));
+    }
+
+    DynamicObject::Ptr jsonIndex = new DynamicObject();
+    jsonIndex->setProperty("segment_seconds", m_segmentSeconds);
+    jsonIndex->setProperty("segments", jsonSegments);
+
+    // written in full every time, so a reader never sees a partial index
+    File indexFile = m_recordingFolder.getChildFile("segments.json");
+    indexFile.replaceWithText(JSON::toString(var(jsonIndex)));
 }
 
-NpyFile* BinaryRecording::createEventMetadataFile(const MetaDataEventObject* channel, String filename, DynamicObject* jsonFile)
+void BinaryRecording::describeEventMetaData(const MetaDataEventObject* channel, Array<NpyType>& types, DynamicObject* jsonFile)
 {
     int nMetaData = channel->getEventMetaDataCount();
-    if (nMetaData < 1) return nullptr;
+    if (nMetaData < 1) return;
 
-    Array<NpyType> types;
     Array<var> jsonMetaData;
     for (int i = 0; i < nMetaData; i++)
     {
@@ -344,7 +499,46 @@ NpyFile* BinaryRecording::createEventMetadataFile(const MetaDataEventObject* cha
     }
     if (jsonFile)
         jsonFile->setProperty("event_metadata", jsonMetaData);
-    return new NpyFile(filename, types);
+}
+
+BinaryRecording::EventRecording* BinaryRecording::createEventFiles(const EventFileLayout& layout, const String& segmentPath)
+{
+    String folder = segmentPath + layout.folder;
+    EventRecording* rec = new EventRecording();
+
+    rec->mainFile = new NpyFile(trackFile(folder + layout.mainName), layout.mainType, layout.mainDim, m_checksums);
+    rec->timestampFile = new NpyFile(trackFile(folder + layout.timestampName), NpyType(BaseType::INT64, 1), 1, m_checksums);
+    rec->channelFile = new NpyFile(trackFile(folder + layout.channelName), NpyType(BaseType::UINT16, 1), 1, m_checksums);
+    if (layout.extraName.isNotEmpty())
+        rec->extraFile = new NpyFile(trackFile(folder + layout.extraName), layout.extraType, 1, m_checksums);
+    if (layout.metaDataTypes.size() > 0)
+        rec->metaDataFile = new NpyFile(trackFile(folder + "metadata.npy"), layout.metaDataTypes, m_checksums);
+
+    return rec;
+}
+
+BinaryRecording::TimestampRecording* BinaryRecording::createTimestampFiles(const String& folder)
+{
+    TimestampRecording* files = new TimestampRecording();
+
+    if (m_compactTimestamps)
+    {
+        files->runFile = new TimestampRunFile(trackFile(folder + "timestamps_index.npy"), m_checksums);
+        files->segmentFile = new TimestampSegmentFile(trackFile(folder + "synchronized_timestamps_index.npy"), m_checksums);
+    }
+    else
+    {
+        files->sampleFile = new NpyFile(trackFile(folder + "timestamps.npy"), NpyType(BaseType::INT64, 1), 1, m_checksums);
+        files->syncFile = new NpyFile(trackFile(folder + "synchronized_timestamps.npy"), NpyType(BaseType::DOUBLE, 1), 1, m_checksums);
+    }
+
+    return files;
+}
+
+String BinaryRecording::trackFile(const String& path)
+{
+    m_openedFiles.add(File(path).getFullPathName());
+    return path;
 }
 
 template <typename TO, typename FROM>
@@ -462,7 +656,43 @@ void BinaryRecording::createChannelMetaData(const MetaDataInfoObject* channel, D
 
 void BinaryRecording::closeFiles()
 {
+	bool segmented = m_segment > 0;
+	int numSegments = m_segment + 1;
+	bool hasSegments = m_segmentSeconds > 0;
+
 	resetChannels();
+	m_segmentPool->clear();
+
+	// every writer has added its checksum by now, including those closed on the pool's thread
+	if (m_checksums != nullptr && m_recordingFolder != File())
+	{
+		m_manifest.addFile(m_recordingFolder.getChildFile("structure.oebin"));
+		m_manifest.addFile(m_recordingFolder.getChildFile("sync_messages.txt"));
+
+		StringArray segmentFolders;
+		if (hasSegments)
+		{
+			m_manifest.addFile(m_recordingFolder.getChildFile("segments.json"));
+			for (int s = 0; s < numSegments; s++)
+				segmentFolders.add("segment_" + String(s) + "/");
+		}
+
+		m_manifest.write(m_recordingFolder, segmentFolders);
+	}
+	m_checksums = nullptr;
+
+	// the next recording in this experiment will most likely need the same files,
+	// unless this one was long enough to be split into segments
+	if (m_recordingFolder != File() && !segmented)
+	{
+		m_filePool->prepare(m_recordingFolder, m_recordingFolder.getSiblingFile("recording" + String(m_recordingNum + 2)));
+	}
+	m_recordingFolder = File();
+}
+
+void BinaryRecording::directoryChanged()
+{
+	m_filePool->clear();
 }
 
 void BinaryRecording::resetChannels()
@@ -470,8 +700,8 @@ void BinaryRecording::resetChannels()
 	m_DataFiles.clear();
 	m_channelIndexes.clear();
 	m_fileIndexes.clear();
-	m_dataTimestampFiles.clear();
-    m_dataFloatTimestampFiles.clear();
+	m_timestampFiles.clear();
+	m_nextTimestampFiles.clear();
 	m_eventFiles.clear();
 	m_spikeChannelIndexes.clear();
 	m_spikeFileIndexes.clear();
@@ -483,6 +713,14 @@ void BinaryRecording::resetChannels()
 	m_tsBuffer.malloc(MAX_BUFFER_SIZE);
 	m_bufferSize = MAX_BUFFER_SIZE;
 	m_startTS.clear();
+
+	m_continuousFolders.clear();
+	m_continuousChannels.clear();
+	m_eventLayouts.clear();
+	m_spikeLayouts.clear();
+	m_segmentLengths.clear();
+	m_segmentEnds.clear();
+	m_segment = 0;
 }
 
 void BinaryRecording::writeEventMetaData(const MetaDataEvent* event, NpyFile* file)
@@ -528,32 +766,19 @@ void BinaryRecording::writeSynchronizedData(int writeChannel, int realChannel, c
 
     /* Get the file index that belongs to the current recording channel */
 	int fileIndex = m_fileIndexes[writeChannel];
+	int64 position = getTimestamp(writeChannel) - m_startTS[writeChannel];
+
+	startSegmentIfNeeded(fileIndex, position + size);
 
     /* Write the data to that file */
 	m_DataFiles[fileIndex]->writeChannel(
-		getTimestamp(writeChannel) - m_startTS[writeChannel],
+		position,
 		m_channelIndexes[writeChannel],
 		m_intBuffer.getData(), size);
 
     /* If is first channel in subprocessor */
 	if (m_channelIndexes[writeChannel] == 0)
-    {
-
-		int64 baseTS = getTimestamp(writeChannel);
-		for (int i = 0; i < size; i++)
-            /* Generate int timestamp */ 
-            m_tsBuffer[i] = baseTS + i;     
-
-        /* Write int timestamps to disc */
-		m_dataTimestampFiles[fileIndex]->writeData(m_tsBuffer, size*sizeof(int64));
-		m_dataTimestampFiles[fileIndex]->increaseRecordCount(size);
-
-        //LOGD("BinaryRecording::writeSynchronizedData: ", *ftsBuffer);
-
-        m_dataFloatTimestampFiles[fileIndex]->writeData(ftsBuffer, size*sizeof(double));
-        m_dataFloatTimestampFiles[fileIndex]->increaseRecordCount(size);
-        
-	}
+		writeTimestamps(fileIndex, position, getTimestamp(writeChannel), ftsBuffer, size);
 }
 
 void BinaryRecording::writeData(int writeChannel, int realChannel, const float* buffer, int size)
@@ -579,28 +804,74 @@ void BinaryRecording::writeData(int writeChannel, int realChannel, const float*
 
     /* Get the file index that belongs to the current recording channel */
 	int fileIndex = m_fileIndexes[writeChannel];
+	int64 position = getTimestamp(writeChannel) - m_startTS[writeChannel];
+
+	startSegmentIfNeeded(fileIndex, position + size);
 
     /* Write the data to that file */
 	m_DataFiles[fileIndex]->writeChannel(
-		getTimestamp(writeChannel) - m_startTS[writeChannel],
+		position,
 		m_channelIndexes[writeChannel],
 		m_intBuffer.getData(), size);
 
     /* If is first channel in subprocessor */
 	if (m_channelIndexes[writeChannel] == 0)
-    {
+		writeTimestamps(fileIndex, position, getTimestamp(writeChannel), nullptr, size);
+
+}
 
-		int64 baseTS = getTimestamp(writeChannel);
-		for (int i = 0; i < size; i++)
-            /* Generate int timestamp */ 
-            m_tsBuffer[i] = baseTS + i;
+void BinaryRecording::startSegmentIfNeeded(int fileIndex, int64 endPosition)
+{
+	// the first stream to get there opens the next segment for all of them. A stream that
+	// fell a whole segment behind the others stays in the files it has
+	if (endPosition > m_segmentEnds[fileIndex] && m_nextTimestampFiles[fileIndex] == nullptr
+		&& m_segmentEnds[fileIndex] == m_segmentLengths[fileIndex] * (m_segment + 1))
+		openSegment(m_segment + 1);
+}
 
-        /* Write int timestamps to disc */
-		m_dataTimestampFiles[fileIndex]->writeData(m_tsBuffer, size*sizeof(int64));
-		m_dataTimestampFiles[fileIndex]->increaseRecordCount(size);
-        
+void BinaryRecording::writeTimestamps(int fileIndex, int64 position, int64 timestamp, const double* syncTimestamps, int size)
+{
+	/* Samples from the stream's next segment on go to that segment's files */
+	int64 segmentEnd = m_segmentEnds[fileIndex];
+	if (position + size > segmentEnd && m_nextTimestampFiles[fileIndex] != nullptr)
+	{
+		int before = int(jmax(int64(0), segmentEnd - position));
+		if (before > 0)
+			writeTimestamps(fileIndex, position, timestamp, syncTimestamps, before);
+
+		m_segmentPool->retire(m_timestampFiles[fileIndex]);
+		m_timestampFiles.set(fileIndex, m_nextTimestampFiles[fileIndex], false);
+		m_nextTimestampFiles.set(fileIndex, nullptr, false);
+		m_segmentEnds.set(fileIndex, segmentEnd + m_segmentLengths[fileIndex]);
+
+		writeTimestamps(fileIndex, position + before, timestamp + before,
+			syncTimestamps != nullptr ? syncTimestamps + before : nullptr, size - before);
+		return;
+	}
+
+	TimestampRecording* files = m_timestampFiles[fileIndex];
+
+	if (m_compactTimestamps)
+	{
+		files->runFile->addTimestamps(timestamp, size);
+		if (syncTimestamps != nullptr)
+			files->segmentFile->addTimestamps(syncTimestamps, size);
+		return;
 	}
 
+	for (int i = 0; i < size; i++)
+		/* Generate int timestamp */
+		m_tsBuffer[i] = timestamp + i;
+
+	/* Write int timestamps to disc */
+	files->sampleFile->writeData(m_tsBuffer, size*sizeof(int64));
+	files->sampleFile->increaseRecordCount(size);
+
+	if (syncTimestamps != nullptr)
+	{
+		files->syncFile->writeData(syncTimestamps, size*sizeof(double));
+		files->syncFile->increaseRecordCount(size);
+	}
 }
 
 void BinaryRecording::writeEvent(int eventIndex, const MidiMessage& event)
@@ -690,10 +961,22 @@ RecordEngineManager* BinaryRecording::getEngineManager()
     EngineParameter* param;
     param = new EngineParameter(EngineParameter::BOOL, 0, "Record TTL full words", true);
     man->addParameter(param);
+    param = new EngineParameter(EngineParameter::BOOL, 1, "Compact timestamp index", false);
+    man->addParameter(param);
+    param = new EngineParameter(EngineParameter::INT, 2, "Segment length (minutes, 0 = off)", 0, 0, 1440);
+    man->addParameter(param);
+    param = new EngineParameter(EngineParameter::INT, 3, "Segment size (MB, 0 = off)", 0, 0, 1048576);
+    man->addParameter(param);
+    param = new EngineParameter(EngineParameter::BOOL, 4, "Write checksum manifest", true);
+    man->addParameter(param);
     return man;
 }
 
 void BinaryRecording::setParameter(EngineParameter& parameter)
 {
 	boolParameter(0, m_saveTTLWords);
+	boolParameter(1, m_compactTimestamps);
+	intParameter(2, m_segmentMinutes);
+	intParameter(3, m_segmentMegabytes);
+	boolParameter(4, m_writeChecksums);
 }
@@ -8,6 +8,8 @@
 #include "../RecordEngine.h"
 #include "SequentialBlockFile.h"
 #include "NpyFile.h"
+#include "TimestampIndexFile.h"
+#include "FilePool.h"
 
 class BinaryRecording : public RecordEngine
 {
@@ -27,6 +29,7 @@ public:
 	void writeSpike(int electrodeIndex, const SpikeEvent* spike) override;
 	void writeTimestampSyncText(uint16 sourceID, uint16 sourceIdx, int64 timestamp, float, String text) override;
 	void setParameter(EngineParameter& parameter) override;
+	void directoryChanged() override;
 
 	static RecordEngineManager* getEngineManager();
 
@@ -42,12 +45,49 @@ private:
         ScopedPointer<NpyFile> extraFile;
     };
 
-    NpyFile* createEventMetadataFile(const MetaDataEventObject* channel, String fileName, DynamicObject* jsonObject);
+    /** Names and types of the files in an event or spike folder, so they can be created again for every segment */
+    struct EventFileLayout
+    {
+        String folder;
+        String mainName;
+        NpyType mainType;
+        unsigned int mainDim;
+        String timestampName;
+        String channelName;
+        String extraName; // no extra file if empty
+        NpyType extraType;
+        Array<NpyType> metaDataTypes; // no metadata file if empty
+    };
+
+    class TimestampRecording
+    {
+    public:
+        ScopedPointer<NpyFile> sampleFile;
+        ScopedPointer<NpyFile> syncFile;
+        ScopedPointer<TimestampRunFile> runFile;         // used instead of the two above
+        ScopedPointer<TimestampSegmentFile> segmentFile; // when m_compactTimestamps is set
+    };
+
+    void describeEventMetaData(const MetaDataEventObject* channel, Array<NpyType>& types, DynamicObject* jsonObject);
 	void createChannelMetaData(const MetaDataInfoObject* channel, DynamicObject* jsonObject);
     void writeEventMetaData(const MetaDataEvent* event, NpyFile* file);
     void increaseEventCounts(EventRecording* rec);
+    String trackFile(const String& path);
+
+    EventRecording* createEventFiles(const EventFileLayout& layout, const String& segmentPath);
+    TimestampRecording* createTimestampFiles(const String& folder);
+    void writeTimestamps(int fileIndex, int64 position, int64 timestamp, const double* syncTimestamps, int size);
+    void startSegmentIfNeeded(int fileIndex, int64 endPosition);
+
+    /** Segments split long recordings into folders of a fixed duration, see openSegment() */
+    double getSegmentSeconds(const Array<const DataChannel*>& streams) const;
+    String getSegmentPath(int segment) const;
+    void openSegment(int segment);
+    void writeSegmentIndex();
 
     bool m_saveTTLWords{ true };
+    bool m_compactTimestamps{ false };
+    bool m_writeChecksums{ true };
 
 	HeapBlock<float> m_scaledBuffer;
 	HeapBlock<int16> m_intBuffer;
@@ -57,6 +97,8 @@ private:
 
 	OwnedArray<SequentialBlockFile> m_DataFiles;
 	OwnedArray<SequentialBlockFile> m_FTSDataFiles;
+	OwnedArray<TimestampRecording> m_timestampFiles;
+	OwnedArray<TimestampRecording> m_nextTimestampFiles; // opened with the next segment, until the stream reaches it
 	Array<unsigned int> m_channelIndexes;
 	Array<unsigned int> m_fileIndexes;
 	OwnedArray<EventRecording> m_eventFiles;
@@ -65,8 +107,6 @@ private:
 	static String jsonTypeValue(BaseType type);
 	static String getProcessorString(const InfoObjectCommon* channelInfo);
 	
-	OwnedArray<NpyFile> m_dataTimestampFiles;
-	OwnedArray<NpyFile> m_dataFloatTimestampFiles;
 	ScopedPointer<FileOutputStream> m_syncTextFile;
 
 	Array<unsigned int> m_spikeFileIndexes;
@@ -75,7 +115,29 @@ private:
 	int m_recordingNum;
 	Array<int64> m_startTS;
 
+	// layout of the files each segment needs
+	StringArray m_continuousFolders;
+	Array<int> m_continuousChannels;
+	Array<EventFileLayout> m_eventLayouts;
+	Array<EventFileLayout> m_spikeLayouts;
+
+	int m_segmentMinutes{ 0 };   // 0 for no segments
+	int m_segmentMegabytes{ 0 }; // largest file of a segment, 0 for no limit
+	double m_segmentSeconds{ 0 };
+	int m_segment{ 0 };
+	Array<int64> m_segmentLengths; // in samples of each stream, a multiple of samplesPerBlock
+	Array<int64> m_segmentEnds;    // first sample of each stream's next segment
+	ScopedPointer<FilePool> m_segmentPool;
+
+	ChecksumManifest m_manifest;
+	ChecksumManifest* m_checksums; // the manifest while checksums are kept, otherwise null
+
+	ScopedPointer<FilePool> m_filePool;
+	File m_recordingFolder;
+	SortedSet<String> m_openedFiles; // files of the current recording, so the pool keeps them
+
 	const int samplesPerBlock{ 4096 };
+	const double minSegmentSeconds{ 10 };
 
 
 };
@@ -0,0 +1,407 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2017 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Checksum.h"
+
+#if JUCE_INTEL
+#include <nmmintrin.h>
+#endif
+
+namespace
+{
+    const uint32 castagnoli = 0x82F63B78; // reflected polynomial
+
+    struct Crc32cTable
+    {
+        Crc32cTable()
+        {
+            for (uint32 i = 0; i < 256; i++)
+            {
+                uint32 crc = i;
+                for (int bit = 0; bit < 8; bit++)
+                    crc = (crc & 1) ? (crc >> 1) ^ castagnoli : crc >> 1;
+                entries[0][i] = crc;
+            }
+
+            for (uint32 i = 0; i < 256; i++)
+                for (int k = 1; k < 8; k++)
+                    entries[k][i] = (entries[k - 1][i] >> 8) ^ entries[0][entries[k - 1][i] & 0xff];
+        }
+
+        uint32 entries[8][256];
+    };
+
+    const Crc32cTable& getTable()
+    {
+        static const Crc32cTable table;
+        return table;
+    }
+
+    // GF(2) matrix helpers for combine(), as in zlib's crc32_combine()
+    uint32 multiply(const uint32* matrix, uint32 vector)
+    {
+        uint32 sum = 0;
+        for (; vector != 0; vector >>= 1, matrix++)
+        {
+            if (vector & 1)
+                sum ^= *matrix;
+        }
+        return sum;
+    }
+
+    void square(uint32* result, const uint32* matrix)
+    {
+        for (int n = 0; n < 32; n++)
+            result[n] = multiply(matrix, matrix[n]);
+    }
+
+    /** Operator that appends numBytes zero bytes to a CRC register, for numBytes a power of two */
+    void getZerosOperator(uint32* result, int64 numBytes)
+    {
+        uint32 odd[32];
+        odd[0] = castagnoli;
+        uint32 row = 1;
+        for (int n = 1; n < 32; n++, row <<= 1)
+            odd[n] = row;
+
+        square(result, odd); // two zero bits
+        square(odd, result); // four zero bits
+
+        for (;;)
+        {
+            square(result, odd);
+            numBytes >>= 1;
+            if (numBytes == 0)
+                return;
+
+            square(odd, result);
+            numBytes >>= 1;
+            if (numBytes == 0)
+                break;
+        }
+
+        for (int n = 0; n < 32; n++)
+            result[n] = odd[n];
+    }
+
+    uint32 updateSoftware(uint32 crc, const uint8* data, size_t numBytes)
+    {
+        const Crc32cTable& t = getTable();
+
+        for (; numBytes >= 8; numBytes -= 8, data += 8)
+        {
+            uint32 low = ByteOrder::littleEndianInt(data) ^ crc;
+            uint32 high = ByteOrder::littleEndianInt(data + 4);
+            crc = t.entries[7][low & 0xff] ^ t.entries[6][(low >> 8) & 0xff]
+                ^ t.entries[5][(low >> 16) & 0xff] ^ t.entries[4][low >> 24]
+                ^ t.entries[3][high & 0xff] ^ t.entries[2][(high >> 8) & 0xff]
+                ^ t.entries[1][(high >> 16) & 0xff] ^ t.entries[0][high >> 24];
+        }
+
+        while (numBytes-- > 0)
+            crc = (crc >> 8) ^ t.entries[0][(crc ^ *data++) & 0xff];
+
+        return crc;
+    }
+
+#if JUCE_INTEL
+    /**
+     The crc32 instruction has a latency of three cycles but can start one every
+     cycle, so long buffers are hashed as three interleaved lanes, and the lanes
+     are joined with these tables, which append a lane's length of zeros.
+     */
+    struct LaneTables
+    {
+        static const size_t longLane = 8192;
+        static const size_t shortLane = 256;
+
+        LaneTables()
+        {
+            fill(longZeros, longLane);
+            fill(shortZeros, shortLane);
+        }
+
+        static void fill(uint32 table[4][256], size_t numBytes)
+        {
+            uint32 op[32];
+            getZerosOperator(op, numBytes);
+            for (uint32 n = 0; n < 256; n++)
+                for (int k = 0; k < 4; k++)
+                    table[k][n] = multiply(op, n << (8 * k));
+        }
+
+        static uint32 shift(const uint32 table[4][256], uint32 crc)
+        {
+            return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff]
+                ^ table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+        }
+
+        uint32 longZeros[4][256];
+        uint32 shortZeros[4][256];
+    };
+
+    const LaneTables& getLaneTables()
+    {
+        static const LaneTables tables;
+        return tables;
+    }
+
+#if JUCE_GCC || JUCE_CLANG
+    __attribute__((target("sse4.2")))
+#endif
+    uint32 updateHardware(uint32 crc, const uint8* data, size_t numBytes)
+    {
+        for (; numBytes > 0 && (pointer_sized_int(data) & 7) != 0; numBytes--)
+            crc = _mm_crc32_u8(crc, *data++);
+
+#if JUCE_64BIT
+        const LaneTables& tables = getLaneTables();
+        const size_t lanes[2] = { LaneTables::longLane, LaneTables::shortLane };
+
+        for (int l = 0; l < 2; l++)
+        {
+            const size_t lane = lanes[l];
+            const uint32 (*zeros)[256] = l == 0 ? tables.longZeros : tables.shortZeros;
+
+            for (; numBytes >= 3 * lane; numBytes -= 3 * lane, data += 3 * lane)
+            {
+                uint64 crc0 = crc, crc1 = 0, crc2 = 0;
+                for (size_t i = 0; i < lane; i += 8)
+                {
+                    crc0 = _mm_crc32_u64(crc0, *reinterpret_cast<const uint64*>(data + i));
+                    crc1 = _mm_crc32_u64(crc1, *reinterpret_cast<const uint64*>(data + lane + i));
+                    crc2 = _mm_crc32_u64(crc2, *reinterpret_cast<const uint64*>(data + 2 * lane + i));
+                }
+                crc = LaneTables::shift(zeros, uint32(crc0)) ^ uint32(crc1);
+                crc = LaneTables::shift(zeros, crc) ^ uint32(crc2);
+            }
+        }
+
+        uint64 crc64 = crc;
+        for (; numBytes >= 8; numBytes -= 8, data += 8)
+            crc64 = _mm_crc32_u64(crc64, *reinterpret_cast<const uint64*>(data));
+        crc = uint32(crc64);
+#endif
+        for (; numBytes >= 4; numBytes -= 4, data += 4)
+            crc = _mm_crc32_u32(crc, *reinterpret_cast<const uint32*>(data));
+
+        while (numBytes-- > 0)
+            crc = _mm_crc32_u8(crc, *data++);
+
+        return crc;
+    }
+
+    const bool useHardware = SystemStats::hasSSE42();
+#endif
+
+    uint32 updateCrc(uint32 crc, const void* data, size_t numBytes)
+    {
+#if JUCE_INTEL
+        if (useHardware)
+            return updateHardware(crc, static_cast<const uint8*>(data), numBytes);
+#endif
+        return updateSoftware(crc, static_cast<const uint8*>(data), numBytes);
+    }
+
+}
+
+Crc32c::Crc32c() : m_crc(0), m_size(0), m_ticks(0)
+{
+}
+
+void Crc32c::update(const void* data, size_t numBytes)
+{
+    const int64 start = Time::getHighResolutionTicks();
+    m_crc = ~updateCrc(~m_crc, data, numBytes);
+    m_size += numBytes;
+    m_ticks += Time::getHighResolutionTicks() - start;
+}
+
+uint32 Crc32c::getValue() const
+{
+    return m_crc;
+}
+
+int64 Crc32c::getSize() const
+{
+    return m_size;
+}
+
+int64 Crc32c::getHashingTicks() const
+{
+    return m_ticks;
+}
+
+uint32 Crc32c::compute(const void* data, size_t numBytes)
+{
+    return ~updateCrc(0xffffffff, data, numBytes);
+}
+
+uint32 Crc32c::combine(uint32 first, uint32 second, int64 secondSize)
+{
+    if (secondSize <= 0)
+        return first;
+
+    uint32 even[32]; // operator for two zero bits
+    uint32 odd[32];  // operator for one zero bit
+
+    odd[0] = castagnoli;
+    uint32 row = 1;
+    for (int n = 1; n < 32; n++, row <<= 1)
+        odd[n] = row;
+
+    square(even, odd); // two zero bits
+    square(odd, even); // four zero bits
+
+    // apply secondSize zero bytes to first, one bit of the length at a time
+    do
+    {
+        square(even, odd);
+        if (secondSize & 1)
+            first = multiply(even, first);
+        secondSize >>= 1;
+        if (secondSize == 0)
+            break;
+
+        square(odd, even);
+        if (secondSize & 1)
+            first = multiply(odd, first);
+        secondSize >>= 1;
+    } while (secondSize != 0);
+
+    return first ^ second;
+}
+
+ChecksumManifest::ChecksumManifest() :
+    m_hashingTicks(0),
+    m_startTicks(Time::getHighResolutionTicks())
+{
+}
+
+void ChecksumManifest::addFile(const String& path, uint32 crc, int64 size, int64 hashingTicks)
+{
+    Entry entry = { File(path).getFullPathName(), crc, size };
+
+    const ScopedLock sl(m_lock);
+    m_entries.add(entry);
+    m_hashingTicks += hashingTicks;
+}
+
+void ChecksumManifest::addFile(const File& file)
+{
+    MemoryBlock data;
+    if (!file.loadFileAsData(data))
+        return;
+
+    const int64 start = Time::getHighResolutionTicks();
+    uint32 crc = Crc32c::compute(data.getData(), data.getSize());
+    addFile(file.getFullPathName(), crc, int64(data.getSize()), Time::getHighResolutionTicks() - start);
+}
+
+bool ChecksumManifest::write(const File& root, const StringArray& segmentFolders)
+{
+    Array<Entry> entries;
+    int64 hashingTicks;
+    {
+        const ScopedLock sl(m_lock);
+        entries.swapWith(m_entries);
+        hashingTicks = m_hashingTicks;
+        m_hashingTicks = 0;
+    }
+    const double recordingSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - m_startTicks);
+    const double hashingSeconds = Time::highResolutionTicksToSeconds(hashingTicks);
+
+    // relative, forward slash paths in a fixed order, so that manifests can be compared
+    StringArray paths;
+    HashMap<String, int> indexes;
+    for (int i = 0; i < entries.size(); i++)
+    {
+        File file(entries[i].path);
+        if (!file.isAChildOf(root))
+            continue;
+
+        String path = file.getRelativePathFrom(root).replace(File::separatorString, "/");
+        indexes.set(path, i);
+        paths.add(path);
+    }
+    paths.sort(false);
+
+    Array<var> jsonFiles;
+    int64 totalSize = 0;
+    for (int i = 0; i < paths.size(); i++)
+    {
+        const Entry& entry = entries.getReference(indexes[paths[i]]);
+        totalSize += entry.size;
+        DynamicObject::Ptr jsonFile = new DynamicObject();
+        jsonFile->setProperty("path", paths[i]);
+        jsonFile->setProperty("size", entry.size);
+        jsonFile->setProperty("crc32c", String::toHexString(int(entry.crc)).paddedLeft('0', 8));
+        jsonFiles.add(var(jsonFile));
+    }
+
+    DynamicObject::Ptr jsonManifest = new DynamicObject();
+    jsonManifest->setProperty("algorithm", "crc32c");
+    jsonManifest->setProperty("files", jsonFiles);
+
+    if (segmentFolders.size() > 0)
+    {
+        Array<var> jsonSegments;
+        for (int s = 0; s < segmentFolders.size(); s++)
+        {
+            String folder = segmentFolders[s];
+            uint32 crc = 0;
+            int64 size = 0;
+
+            for (int i = 0; i < paths.size(); i++)
+            {
+                if (!paths[i].startsWith(folder))
+                    continue;
+
+                const Entry& entry = entries.getReference(indexes[paths[i]]);
+                crc = Crc32c::combine(crc, entry.crc, entry.size);
+                size += entry.size;
+            }
+
+            DynamicObject::Ptr jsonSegment = new DynamicObject();
+            jsonSegment->setProperty("folder_name", folder);
+            jsonSegment->setProperty("size", size);
+            jsonSegment->setProperty("crc32c", String::toHexString(int(crc)).paddedLeft('0', 8));
+            jsonSegments.add(var(jsonSegment));
+        }
+        jsonManifest->setProperty("segments", jsonSegments);
+    }
+
+    std::cout << "Checksummed " << paths.size() << " files (" << String(totalSize / (1024.0 * 1024.0), 1) << " MB) in "
+        << String(hashingSeconds * 1000.0, 1) << " ms over " << String(recordingSeconds, 1) << " s of recording ("
+        << String(recordingSeconds > 0 ? 100.0 * hashingSeconds / recordingSeconds : 0.0, 2) << "%)" << std::endl;
+
+    return root.getChildFile("checksums.json").replaceWithText(JSON::toString(var(jsonManifest)));
+}
+
+void ChecksumManifest::clear()
+{
+    const ScopedLock sl(m_lock);
+    m_entries.clear();
+    m_hashingTicks = 0;
+    m_startTicks = Time::getHighResolutionTicks();
+}
@@ -0,0 +1,106 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2017 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include "../../../../JuceLibraryCode/JuceHeader.h"
+
+/**
+ Running CRC-32C (Castagnoli) of a byte stream.
+
+ Uses the SSE4.2 crc32 instruction where the processor has it, and a
+ slicing-by-8 table elsewhere. The checksums of two consecutive byte ranges
+ can be joined with combine(), so a part written out of order, such as a
+ file header that is updated at close, can be hashed separately.
+ */
+class Crc32c
+{
+public:
+    Crc32c();
+
+    void update(const void* data, size_t numBytes);
+
+    uint32 getValue() const;
+
+    /** Returns the number of bytes hashed so far */
+    int64 getSize() const;
+
+    /** Returns the time spent in update() so far, in high resolution ticks */
+    int64 getHashingTicks() const;
+
+    /** Returns the CRC-32C of data in one go */
+    static uint32 compute(const void* data, size_t numBytes);
+
+    /** Returns the CRC-32C of two ranges back to back, from their checksums and the second's size */
+    static uint32 combine(uint32 first, uint32 second, int64 secondSize);
+
+private:
+    uint32 m_crc;
+    int64 m_size;
+    int64 m_ticks;
+};
+
+/**
+ Collects the checksums of a recording's files as the writers close them, and
+ writes them to checksums.json in the recording folder.
+
+ Writers may close files on other threads (see FilePool), so adding is
+ thread safe. A split recording also gets one checksum per segment folder,
+ the CRC-32C of the folder's files concatenated in path order.
+
+ When the manifest is written, the time spent hashing is logged next to the
+ length of the recording, to keep an eye on what the checksums cost.
+ */
+class ChecksumManifest
+{
+public:
+    ChecksumManifest();
+
+    void addFile(const String& path, uint32 crc, int64 size, int64 hashingTicks = 0);
+
+    /** Reads file whole and adds its checksum. Meant for the small files written outside the writers */
+    void addFile(const File& file);
+
+    /** Writes the manifest of the files under root and forgets them */
+    bool write(const File& root, const StringArray& segmentFolders);
+
+    void clear();
+
+private:
+    struct Entry
+    {
+        String path;
+        uint32 crc;
+        int64 size;
+    };
+
+    CriticalSection m_lock;
+    Array<Entry> m_entries;
+    int64 m_hashingTicks;
+    int64 m_startTicks; // when the manifest was last cleared, normally the start of the recording
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChecksumManifest);
+};
+
+#endif // !CHECKSUM_H
@@ -1,12 +1,14 @@
 #include "../../../../JuceLibraryCode/JuceHeader.h"
+#include "Checksum.h"
 
 template <class StorageType = int16>
 class FileMemoryBlock
 {
 public:
-	FileMemoryBlock(FileOutputStream* file, int blockSize, uint64 offset) :
+	FileMemoryBlock(FileOutputStream* file, int blockSize, uint64 offset, Crc32c* checksum = nullptr) :
 		m_data(blockSize, true),
 		m_file(file),
+		m_checksum(checksum),
 		m_blockSize(blockSize),
 		m_offset(offset),
         m_finalFlushSamples(blockSize)
@@ -15,11 +17,15 @@ public:
 	~FileMemoryBlock() {
 		if (~m_flushed)
 		{
+			//blocks are written in file order, so the checksum runs along with them
+			if (m_checksum != nullptr)
+				m_checksum->update(m_data, m_finalFlushSamples*sizeof(StorageType));
 			m_file->write(m_data, m_finalFlushSamples*sizeof(StorageType));
 		}
 	};
 
 	inline uint64 getOffset() { return m_offset; }
+	inline FileOutputStream* getFile() { return m_file; }
 	inline StorageType* getData() { return m_data.getData(); }
 	void partialFlush(size_t size)
 	{
@@ -29,6 +35,7 @@ public:
 private:
 	HeapBlock<StorageType> m_data;
 	FileOutputStream* const m_file;
+	Crc32c* const m_checksum;
 	const int m_blockSize;
 	const uint64 m_offset;
     size_t m_finalFlushSamples;
@@ -0,0 +1,213 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2017 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "FilePool.h"
+
+#if JUCE_LINUX || JUCE_MAC
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+FilePool::FilePool() : Thread("File Pool"),
+    m_preparing(false)
+{
+}
+
+FilePool::~FilePool()
+{
+    clear();
+}
+
+void FilePool::prepare(const File& finishedFolder, const File& nextFolder)
+{
+    claim(File());
+
+    if (!finishedFolder.isDirectory() || nextFolder.exists())
+        return;
+
+    const ScopedLock sl(m_lock);
+    m_sourceFolder = finishedFolder;
+    m_folder = nextFolder;
+    m_preparing = true;
+    startThread();
+}
+
+bool FilePool::claim(const File& folder)
+{
+    stopThread(-1);
+
+    const ScopedLock sl(m_lock);
+    m_preparing = false;
+    if (m_folder == File())
+        return false;
+
+    if (m_folder == folder)
+        return true;
+
+    deleteFiles(m_files);
+    m_files.clear();
+    m_folder = File();
+    return false;
+}
+
+void FilePool::release(const SortedSet<String>& openedFiles)
+{
+    const ScopedLock sl(m_lock);
+
+    Array<File> unused;
+    for (int i = 0; i < m_files.size(); i++)
+    {
+        if (!openedFiles.contains(m_files[i].getFullPathName()))
+            unused.add(m_files[i]);
+    }
+
+    deleteFiles(unused);
+    m_files.clear();
+    m_folder = File();
+}
+
+void FilePool::clear()
+{
+    claim(File());
+    closeRetired();
+}
+
+void FilePool::retireObject(Retired* object)
+{
+    {
+        const ScopedLock sl(m_lock);
+        m_retired.add(object);
+    }
+
+    // if the thread is just finishing, the object waits for the next start or clear()
+    if (!isThreadRunning())
+        startThread();
+}
+
+void FilePool::closeRetired()
+{
+    for (;;)
+    {
+        ScopedPointer<Retired> object;
+        {
+            const ScopedLock sl(m_lock);
+            object = m_retired.removeAndReturn(0);
+        }
+
+        if (object == nullptr)
+            return;
+    }
+}
+
+void FilePool::deleteFiles(const Array<File>& files)
+{
+    if (files.size() == 0)
+        return;
+
+    for (int i = 0; i < files.size(); i++)
+        files[i].deleteFile();
+
+    // then remove the folders left empty, deepest first. deleteFile() leaves non-empty ones alone
+    Array<File> folders;
+    m_folder.findChildFiles(folders, File::findDirectories, true);
+    for (int i = folders.size() - 1; i >= 0; i--)
+        folders[i].deleteFile();
+    m_folder.deleteFile();
+}
+
+void FilePool::run()
+{
+    // closed first, as they can be the files being copied
+    closeRetired();
+
+    if (m_preparing)
+        prepareFiles();
+
+    closeRetired();
+}
+
+void FilePool::prepareFiles()
+{
+    Array<File> sourceFiles;
+    m_sourceFolder.findChildFiles(sourceFiles, File::findFiles, true);
+
+    Array<int64> sizes;
+    int64 totalBytes = 0;
+    for (int i = 0; i < sourceFiles.size(); i++)
+    {
+        sizes.add(sourceFiles[i].getSize());
+        totalBytes += sizes.getLast();
+    }
+
+    // don't hold on to more than half of the free space for a recording that might not happen
+    bool reserve = totalBytes < m_folder.getParentDirectory().getBytesFreeOnVolume() / 2;
+
+    for (int i = 0; i < sourceFiles.size(); i++)
+    {
+        if (threadShouldExit())
+            return;
+
+        File file = m_folder.getChildFile(sourceFiles[i].getRelativePathFrom(m_sourceFolder));
+        if (file.create().failed())
+            continue;
+
+        {
+            const ScopedLock sl(m_lock);
+            m_files.add(file);
+        }
+
+        if (reserve && sizes[i] > 0)
+            reserveSpace(file, sizes[i]);
+    }
+
+    const ScopedLock sl(m_lock);
+    m_preparing = false;
+}
+
+bool FilePool::reserveSpace(const File& file, int64 numBytes)
+{
+#if JUCE_LINUX || JUCE_MAC
+    int fd = open(file.getFullPathName().toRawUTF8(), O_WRONLY);
+    if (fd < 0)
+        return false;
+
+#if JUCE_LINUX
+    // KEEP_SIZE leaves the file empty, so writers still append from the start
+    bool reserved = fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, numBytes) == 0;
+#else
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, numBytes, 0 };
+    bool reserved = fcntl(fd, F_PREALLOCATE, &store) != -1;
+    if (!reserved)
+    {
+        store.fst_flags = F_ALLOCATEALL;
+        reserved = fcntl(fd, F_PREALLOCATE, &store) != -1;
+    }
+#endif
+
+    close(fd);
+    return reserved;
+#else
+    ignoreUnused(file, numBytes);
+    return false;
+#endif
+}
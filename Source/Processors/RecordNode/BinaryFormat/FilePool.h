@@ -0,0 +1,106 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2017 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef FILEPOOL_H
+#define FILEPOOL_H
+
+#include "../../../../JuceLibraryCode/JuceHeader.h"
+
+/**
+ Creates the files of the next recording before it is started.
+
+ When a recording is closed, the pool creates the same files again, in the
+ background, in the folder the following recording of the same experiment
+ will use. It also reserves as much disk space for each file as the closed
+ recording needed. Opening those files at the next start then skips the
+ directory and file creation, and the reserved space keeps long files
+ contiguous on disk.
+
+ Prepared files the next recording doesn't open are deleted when it starts,
+ and all of them are deleted if it goes to a different folder.
+
+ The same thread closes the files a recording has finished with but keeps
+ going past, such as those of a completed segment, so that syncing them to
+ disk doesn't hold up the writer.
+ */
+class FilePool : public Thread
+{
+public:
+    FilePool();
+    ~FilePool();
+
+    /** Starts creating the files of finishedFolder in nextFolder. Does nothing if nextFolder exists */
+    void prepare(const File& finishedFolder, const File& nextFolder);
+
+    /** Stops preparing. Returns true if the prepared files are in folder, otherwise deletes them */
+    bool claim(const File& folder);
+
+    /** Deletes the claimed files whose full paths aren't in openedFiles */
+    void release(const SortedSet<String>& openedFiles);
+
+    /** Stops preparing, deletes all prepared files and closes the retired ones */
+    void clear();
+
+    /** Takes ownership of object and deletes it on the pool's thread */
+    template <class ObjectType>
+    void retire(ObjectType* object)
+    {
+        if (object != nullptr)
+            retireObject(new RetiredObject<ObjectType>(object));
+    }
+
+    void run() override;
+
+private:
+    struct Retired
+    {
+        virtual ~Retired() {}
+    };
+
+    template <class ObjectType>
+    struct RetiredObject : public Retired
+    {
+        RetiredObject(ObjectType* o) : object(o) {}
+        ScopedPointer<ObjectType> object;
+    };
+
+    void retireObject(Retired* object);
+    void closeRetired();
+    void prepareFiles();
+
+    void deleteFiles(const Array<File>& files);
+
+    /** Reserves space for numBytes without changing the file size, where the platform allows it */
+    static bool reserveSpace(const File& file, int64 numBytes);
+
+    CriticalSection m_lock;
+    File m_sourceFolder;
+    File m_folder;
+    Array<File> m_files;
+    bool m_preparing;
+    OwnedArray<Retired> m_retired;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FilePool);
+};
+
+#endif // !FILEPOOL_H
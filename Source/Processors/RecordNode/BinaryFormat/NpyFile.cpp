@@ -31,7 +31,8 @@ https://github.com/numpy/numpy/blob/master/numpy/lib/format.py
 
 #include "NpyFile.h"
 
-NpyFile::NpyFile(String path, const Array<NpyType>& typeList)
+NpyFile::NpyFile(String path, const Array<NpyType>& typeList, ChecksumManifest* manifest) :
+    m_manifest(manifest)
 {
     m_dim1 = 1;
     m_dim2 = 1;
@@ -51,7 +52,8 @@ NpyFile::NpyFile(String path, const Array<NpyType>& typeList)
     writeHeader(typeList);
 }
 
-NpyFile::NpyFile(String path, NpyType type, unsigned int dim)
+NpyFile::NpyFile(String path, NpyType type, unsigned int dim, ChecksumManifest* manifest) :
+    m_manifest(manifest)
 {
     if (!openFile(path))
         return;
@@ -166,7 +168,16 @@ void NpyFile::writeHeader(const Array<NpyType>& typeList)
     m_file->write(&strHeaderLen, sizeof(uint16));
     m_file->write(strHeader.toUTF8(), strHeaderLen);
     m_headerLen = m_file->getPosition(); // total header length
-    m_file->flush();
+    if (m_manifest != nullptr)
+    {
+        m_header.append(&magicNum, sizeof(uint8));
+        m_header.append(magicStr.toUTF8(), magicStr.getNumBytesAsUTF8());
+        m_header.append(&ver, sizeof(uint16));
+        m_header.append(&strHeaderLen, sizeof(uint16));
+        m_header.append(strHeader.toUTF8(), strHeaderLen);
+    }
+    // no flush here: FileOutputStream::flush() syncs to disk, and doing that for every file
+    // at once delays the start of a recording. The first updateHeader() writes it out.
 }
 
 void NpyFile::updateHeader()
@@ -201,10 +212,28 @@ void NpyFile::updateHeader()
 NpyFile::~NpyFile()
 {
     updateHeader();
+    // gives back any space reserved beyond the data (see FilePool)
+    m_file->truncate();
+
+    if (m_manifest != nullptr)
+    {
+        uint32 crc = Crc32c::combine(getHeaderChecksum(), m_dataChecksum.getValue(), m_dataChecksum.getSize());
+        m_manifest->addFile(m_file->getFile().getFullPathName(), crc, m_headerLen + m_dataChecksum.getSize(), m_dataChecksum.getHashingTicks());
+    }
+}
+
+uint32 NpyFile::getHeaderChecksum()
+{
+    // the header as updateHeader() left it: the final shape written over the initial one
+    String newShape = getShapeString();
+    m_header.copyFrom(newShape.toUTF8(), int(m_shapePos), jmin(newShape.getNumBytesAsUTF8(), m_header.getSize() - m_shapePos));
+    return Crc32c::compute(m_header.getData(), m_header.getSize());
 }
 
 void NpyFile::writeData(const void* data, size_t size)
 {
+    if (m_manifest != nullptr)
+        m_dataChecksum.update(data, size);
     m_file->write(data, size);
 }
 
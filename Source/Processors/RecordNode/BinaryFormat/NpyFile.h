@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define NPYFILE_H
 
 #include "../RecordEngine.h"
+#include "Checksum.h"
 
 
 class NpyType
@@ -46,8 +47,9 @@ private:
 class NpyFile
 {
 public:
-    NpyFile(String path, const Array<NpyType>& typeList);
-    NpyFile(String path, NpyType type, unsigned int dim = 1);
+    /** With a manifest, the file's checksum is added to it when the file is closed */
+    NpyFile(String path, const Array<NpyType>& typeList, ChecksumManifest* manifest = nullptr);
+    NpyFile(String path, NpyType type, unsigned int dim = 1, ChecksumManifest* manifest = nullptr);
     ~NpyFile();
     void writeData(const void* data, size_t size);
     void increaseRecordCount(int count = 1);
@@ -56,7 +58,11 @@ private:
     String getShapeString();
     void writeHeader(const Array<NpyType>& typeList);
     void updateHeader();
+    uint32 getHeaderChecksum();
     ScopedPointer<FileOutputStream> m_file;
+    ChecksumManifest* const m_manifest;
+    Crc32c m_dataChecksum; // the header changes until the file is closed, so it is hashed then
+    MemoryBlock m_header;
     int64 m_headerLen; // total header length
     bool m_okOpen{ false };
     int64 m_recordCount{ 0 };
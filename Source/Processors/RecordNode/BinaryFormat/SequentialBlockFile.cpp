@@ -23,8 +23,20 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "SequentialBlockFile.h"
 
-SequentialBlockFile::SequentialBlockFile(int nChannels, int samplesPerBlock) :
+SequentialBlockFile::OutputFile::~OutputFile()
+{
+	//give back any space reserved beyond the data (see FilePool)
+	stream->truncate();
+
+	if (manifest != nullptr)
+		manifest->addFile(stream->getFile().getFullPathName(), checksum.getValue(), checksum.getSize(), checksum.getHashingTicks());
+}
+
+SequentialBlockFile::SequentialBlockFile(int nChannels, int samplesPerBlock, ChecksumManifest* manifest) :
 m_file(nullptr),
+m_nextFileStart(0),
+m_closer(nullptr),
+m_manifest(manifest),
 m_nChannels(nChannels),
 m_samplesPerBlock(samplesPerBlock),
 m_blockSize(nChannels*samplesPerBlock),
@@ -44,11 +56,48 @@ SequentialBlockFile::~SequentialBlockFile()
 		m_memBlocks.remove(0);
 	}
 
+	if (n == 0)
+		return;
+
 	//manually flush the last one to avoid trailing zeroes
 	m_memBlocks[0]->partialFlush(m_lastBlockFill * m_nChannels);
+	m_memBlocks.clear();
+
+	m_previousFiles.clear();
+	m_file = nullptr;
 }
 
 bool SequentialBlockFile::openFile(String filename)
+{
+	m_file = createFile(filename);
+	if (!m_file)
+	{
+		printf("[RN]SequentialBlockFile::openFile returned false\n");
+		return false;
+	}
+
+	//printf("[RN]SequentialBlockFile::added new FileBlock\n");
+	m_memBlocks.add(createBlock(0));
+	return true;
+}
+
+bool SequentialBlockFile::openSegment(String filename, uint64 firstSample, FilePool* closer)
+{
+	jassert(firstSample % m_samplesPerBlock == 0);
+
+	m_nextFile = createFile(filename);
+	if (!m_nextFile)
+	{
+		printf("[RN]SequentialBlockFile::openSegment returned false\n");
+		return false;
+	}
+
+	m_nextFileStart = firstSample;
+	m_closer = closer;
+	return true;
+}
+
+SequentialBlockFile::OutputFile* SequentialBlockFile::createFile(const String& filename)
 {
 	File file(filename);
 	Result res = file.create();
@@ -60,16 +109,17 @@ bool SequentialBlockFile::openFile(String filename)
 		std::cout << "Re-creating file: " << filename << std::endl;
 	}
 
-	m_file = file.createOutputStream(streamBufferSize);
-	if (!m_file)
-	{
-		printf("[RN]SequentialBlockFile::openFile returned false\n");
-		return false;
-	}
+	FileOutputStream* stream = file.createOutputStream(streamBufferSize);
+	if (stream == nullptr)
+		return nullptr;
 
-	//printf("[RN]SequentialBlockFile::added new FileBlock\n");
-	m_memBlocks.add(new FileBlock(m_file, m_blockSize, 0));
-	return true;
+	return new OutputFile(stream, m_manifest);
+}
+
+FileBlock* SequentialBlockFile::createBlock(uint64 offset)
+{
+	//checksums are only kept for a manifest
+	return new FileBlock(m_file->stream, m_blockSize, offset, m_manifest != nullptr ? &m_file->checksum : nullptr);
 }
 
 bool SequentialBlockFile::writeChannel(uint64 startPos, int channel, int16* data, int nSamples)
@@ -157,6 +207,19 @@ void SequentialBlockFile::allocateBlocks(uint64 startIndex, int numSamples)
 
 	m_memBlocks.removeRange(0, minBlock);
 
+	//once no block is left in a previous segment, its file is complete
+	if (m_previousFiles.size() > 0 && m_memBlocks.size() > 0 && m_memBlocks[0]->getFile() == m_file->stream)
+	{
+		while (m_previousFiles.size() > 0)
+		{
+			OutputFile* finished = m_previousFiles.removeAndReturn(0);
+			if (m_closer != nullptr)
+				m_closer->retire(finished);
+			else
+				delete finished;
+		}
+	}
+
 	//for (int i = 0; i < minBlock; i++)
 	//{
 	//Not the most efficient way, as it has to move back all the elements, but it's a simple array of pointers, so it's quick enough
@@ -172,7 +235,12 @@ void SequentialBlockFile::allocateBlocks(uint64 startIndex, int numSamples)
 	for (int i = 0; i < newBlocks; i++)
 	{
 		lastOffset += m_samplesPerBlock;
-		m_memBlocks.add(new FileBlock(m_file, m_blockSize, lastOffset));
+		if (m_nextFile && lastOffset >= m_nextFileStart)
+		{
+			m_previousFiles.add(m_file.release());
+			m_file = m_nextFile.release();
+		}
+		m_memBlocks.add(createBlock(lastOffset));
 	}
 	if (newBlocks > 0)
 		m_lastBlockFill = 0; //we've added some new blocks, so the last one will be empty
@@ -2,6 +2,7 @@
 #define SEQUENTIALBLOCKFILE_H
 
 #include "FileMemoryBlock.h"
+#include "FilePool.h"
 #include "../Utils.h"
 
 typedef FileMemoryBlock<int16> FileBlock;
@@ -9,14 +10,35 @@ typedef FileMemoryBlock<int16> FileBlock;
 class SequentialBlockFile
 {
 public:
-	SequentialBlockFile(int nChannels, int samplesPerBlock);
+	SequentialBlockFile(int nChannels, int samplesPerBlock, ChecksumManifest* manifest = nullptr);
 	~SequentialBlockFile();
 
 	bool openFile(String filename);
+
+	/** Opens the file the samples from firstSample on go to. It must be a multiple of the
+	block size. The current file is handed to closer once its last block is written */
+	bool openSegment(String filename, uint64 firstSample, FilePool* closer);
+
 	bool writeChannel(uint64 startPos, int channel, int16* data, int nSamples);
 
 private:
-	ScopedPointer<FileOutputStream> m_file;
+	/** An open file and the checksum of the blocks written to it so far */
+	struct OutputFile
+	{
+		OutputFile(FileOutputStream* s, ChecksumManifest* m) : stream(s), manifest(m) {}
+		~OutputFile();
+
+		ScopedPointer<FileOutputStream> stream;
+		Crc32c checksum;
+		ChecksumManifest* const manifest;
+	};
+
+	ScopedPointer<OutputFile> m_file;
+	ScopedPointer<OutputFile> m_nextFile;
+	uint64 m_nextFileStart;
+	OwnedArray<OutputFile> m_previousFiles;
+	FilePool* m_closer;
+	ChecksumManifest* const m_manifest;
 	const int m_nChannels;
 	const int m_samplesPerBlock;
 	const int m_blockSize;
@@ -25,6 +47,8 @@ private:
 	size_t m_lastBlockFill;
 
 	void allocateBlocks(uint64 startIndex, int numSamples);
+	OutputFile* createFile(const String& filename);
+	FileBlock* createBlock(uint64 offset);
 
 	//Compile-time params
 	const int streamBufferSize{ 0 };
@@ -0,0 +1,157 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2017 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "TimestampIndexFile.h"
+
+TimestampRunFile::TimestampRunFile(String path, ChecksumManifest* manifest)
+{
+    Array<NpyType> types;
+    types.add(NpyType("sample_number", BaseType::INT64, 1));
+    types.add(NpyType("timestamp", BaseType::INT64, 1));
+    types.add(NpyType("length", BaseType::INT64, 1));
+    m_file = new NpyFile(path, types, manifest);
+}
+
+TimestampRunFile::~TimestampRunFile()
+{
+    writeRun();
+}
+
+void TimestampRunFile::addTimestamps(int64 firstTimestamp, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    if (m_runLength > 0 && firstTimestamp != m_runTimestamp + m_runLength)
+        writeRun();
+
+    if (m_runLength == 0)
+    {
+        m_runSample = m_numSamples;
+        m_runTimestamp = firstTimestamp;
+    }
+
+    m_runLength += numSamples;
+    m_numSamples += numSamples;
+}
+
+void TimestampRunFile::writeRun()
+{
+    if (m_runLength == 0)
+        return;
+
+    int64 record[3] = { m_runSample, m_runTimestamp, m_runLength };
+    m_file->writeData(record, sizeof(record));
+    m_file->increaseRecordCount();
+
+    m_runLength = 0;
+}
+
+TimestampSegmentFile::TimestampSegmentFile(String path, ChecksumManifest* manifest)
+{
+    Array<NpyType> types;
+    types.add(NpyType("sample_number", BaseType::INT64, 1));
+    types.add(NpyType("length", BaseType::INT64, 1));
+    types.add(NpyType("start_time", BaseType::DOUBLE, 1));
+    types.add(NpyType("sample_period", BaseType::DOUBLE, 1));
+    m_file = new NpyFile(path, types, manifest);
+}
+
+TimestampSegmentFile::~TimestampSegmentFile()
+{
+    writeSegment();
+}
+
+void TimestampSegmentFile::addTimestamps(const double* timestamps, int numSamples)
+{
+    for (int i = 0; i < numSamples; i++)
+    {
+        const double t = timestamps[i];
+
+        if (m_segmentLength >= 2)
+        {
+            // refit the slope over the whole segment so rounding doesn't accumulate; the new
+            // line must still reproduce every earlier sample of the segment within tolerance
+            const double period = (t - m_segmentStart) / double(m_segmentLength);
+
+            if (period >= m_minPeriod && period <= m_maxPeriod)
+            {
+                m_samplePeriod = period;
+                limitPeriod(t, m_segmentLength);
+                m_segmentLength++;
+                m_numSamples++;
+                continue;
+            }
+
+            writeSegment();
+        }
+
+        if (m_segmentLength == 0)
+        {
+            m_segmentSample = m_numSamples;
+            m_segmentStart = t;
+            m_samplePeriod = 0;
+        }
+        else // second sample of the segment fixes its initial slope and the tolerance
+        {
+            m_samplePeriod = t - m_segmentStart;
+            m_tolerance = std::abs(m_samplePeriod) * maxRelativeError;
+            m_minPeriod = m_samplePeriod - m_tolerance;
+            m_maxPeriod = m_samplePeriod + m_tolerance;
+        }
+
+        m_segmentLength++;
+        m_numSamples++;
+    }
+}
+
+void TimestampSegmentFile::limitPeriod(double t, int64 offset)
+{
+    // slopes of the lines from the segment start that keep this sample within tolerance
+    const double lo = (t - m_segmentStart - m_tolerance) / double(offset);
+    const double hi = (t - m_segmentStart + m_tolerance) / double(offset);
+
+    m_minPeriod = jmax(m_minPeriod, lo);
+    m_maxPeriod = jmin(m_maxPeriod, hi);
+}
+
+void TimestampSegmentFile::writeSegment()
+{
+    if (m_segmentLength == 0)
+        return;
+
+    struct
+    {
+        int64 sample;
+        int64 length;
+        double start;
+        double period;
+    } record = { m_segmentSample, m_segmentLength, m_segmentStart, m_samplePeriod };
+
+    static_assert(sizeof(record) == 32, "segment record must match the npy layout");
+
+    m_file->writeData(&record, sizeof(record));
+    m_file->increaseRecordCount();
+
+    m_segmentLength = 0;
+}
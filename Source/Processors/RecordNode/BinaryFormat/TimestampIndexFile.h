@@ -0,0 +1,95 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2017 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef TIMESTAMPINDEXFILE_H
+#define TIMESTAMPINDEXFILE_H
+
+#include "NpyFile.h"
+
+/**
+ Compact replacement for a per-sample timestamps.npy.
+
+ Consecutive samples whose timestamps advance by exactly one are stored as a
+ single run record (sample_number, timestamp, length), so a recording without
+ gaps needs one record instead of one int64 per sample. The open run is
+ written when the file is destroyed.
+ */
+class TimestampRunFile
+{
+public:
+    TimestampRunFile(String path, ChecksumManifest* manifest = nullptr);
+    ~TimestampRunFile();
+
+    /** Appends timestamps firstTimestamp, firstTimestamp + 1, ... for numSamples samples */
+    void addTimestamps(int64 firstTimestamp, int numSamples);
+
+private:
+    void writeRun();
+
+    ScopedPointer<NpyFile> m_file;
+    int64 m_numSamples{ 0 };     // samples seen so far
+    int64 m_runSample{ 0 };      // first sample of the open run
+    int64 m_runTimestamp{ 0 };
+    int64 m_runLength{ 0 };
+};
+
+/**
+ Compact replacement for a per-sample synchronized_timestamps.npy.
+
+ Synchronized times are stored as piecewise-linear segments
+ (sample_number, length, start_time, sample_period). A sample stays in the
+ current segment as long as the line refitted through it still reproduces the
+ time of every sample in the segment to within a small fraction of the
+ segment's initial sample period; otherwise a new segment is started.
+ */
+class TimestampSegmentFile
+{
+public:
+    TimestampSegmentFile(String path, ChecksumManifest* manifest = nullptr);
+    ~TimestampSegmentFile();
+
+    void addTimestamps(const double* timestamps, int numSamples);
+
+private:
+    void writeSegment();
+
+    /** Narrows the range of slopes that keep the sample at offset within tolerance */
+    void limitPeriod(double t, int64 offset);
+
+    ScopedPointer<NpyFile> m_file;
+    int64 m_numSamples{ 0 };
+    int64 m_segmentSample{ 0 };
+    int64 m_segmentLength{ 0 };
+    double m_segmentStart{ 0 };
+    double m_samplePeriod{ 0 };
+
+    // slopes that keep every sample of the segment within m_tolerance of the line
+    double m_minPeriod{ 0 };
+    double m_maxPeriod{ 0 };
+    double m_tolerance{ 0 };
+
+    // largest deviation from the fitted line, as a fraction of the segment's initial sample period
+    const double maxRelativeError{ 1e-3 };
+};
+
+#endif // !TIMESTAMPINDEXFILE_H
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 DataQueue::DataQueue(int blockSize, int nBlocks) :
 	m_buffer(0, blockSize*nBlocks),
 	m_numChans(0),
+	m_numFTSChans(0),
 	m_blockSize(blockSize),
 	m_readInProgress(false),
 	m_numBlocks(nBlocks),
@@ -102,6 +103,25 @@ void DataQueue::resize(int nBlocks)
 	m_FTSBuffer.setSize(m_numFTSChans, size);
 }
 
+void DataQueue::reset()
+{
+	if (m_readInProgress)
+		return;
+
+	for (int i = 0; i < m_numChans; ++i)
+	{
+		m_fifos[i]->reset();
+		m_readSamples.set(i, 0);
+		m_lastReadTimestamps.set(i, 0);
+	}
+
+	for (int i = 0; i < m_numFTSChans; ++i)
+	{
+		m_readFTSSamples.set(i, 0);
+		m_FTSFifos[i]->reset();
+	}
+}
+
 void DataQueue::fillTimestamps(int channel, int index, int size, int64 timestamp)
 {
 	//Search for the next block start.
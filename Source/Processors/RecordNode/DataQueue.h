@@ -45,6 +45,8 @@ public:
 	void setChannels(int nChans);
 	void setFTSChannels(int nChans);
 	void resize(int nBlocks);
+	/** Empties the queue without reallocating it, ready for a new recording */
+	void reset();
 	void getTimestampsForBlock(int idx, Array<int64>& timestamps) const;
 
 	//Only the methods after this comment are considered thread-safe.
@@ -54,6 +54,8 @@ RecordNode::RecordNode()
 
 	isSyncReady = true;
 
+	recordingPrepared = false;
+
 	/* New record nodes default to the record engine currently selected in the Control Panel */
 	setEngine(CoreServices::getSelectedRecordEngineIdx() - 1);
 
@@ -133,6 +135,7 @@ void RecordNode::setEngine(int index)
 {
 	availableEngines = getAvailableRecordEngines();
 	recordEngine = availableEngines[index]->instantiateEngine();
+	recordingPrepared = false;
 }
 
 std::vector<RecordEngineManager*> RecordNode::getAvailableRecordEngines()
@@ -269,7 +272,11 @@ void RecordNode::prepareToPlay(double sampleRate, int estimatedSamplesPerBlock)
 // called by RecordEngine when saving the signal chain
 const String &RecordNode::getLastSettingsXml() const
 {
-	return lastSettingsText;
+	if (lastSettings == nullptr)
+		return String::empty;
+
+	// waits for the settings writer if the file is still being written
+	return lastSettings->getXmlText();
 }
 
 /* Use this function to change parameters while recording...*/
@@ -298,6 +305,11 @@ void RecordNode::updateRecordChannelIndexes()
 void RecordNode::updateChannelStates(int srcIndex, int subProcIdx, std::vector<bool> channelStates)
 {
 	this->dataChannelStates[srcIndex][subProcIdx] = channelStates;
+
+	if (isRecording)
+		recordingPrepared = false;
+	else if (recordingPrepared)
+		prepareRecording();
 }
 
 // called by updateSettings (could be refactored)
@@ -437,6 +449,8 @@ void RecordNode::updateSettings()
 
 	updateSubprocessorMap();
 
+	recordingPrepared = false;
+
 }
 
 // called by GenericProcessor::enableProcessor
@@ -457,16 +471,30 @@ bool RecordNode::enable()
 	recordEngine->startAcquisition();
 
     synchronizer->reset();
+
+	prepareRecording();
+	recordThread->arm();
+
     return true;
 
 }
 
-// called by GenericProcessor::setRecording()
-void RecordNode::startRecording()
+// called by GenericProcessor::disableProcessor
+bool RecordNode::disable()
+{
+
+	recordThread->disarm();
+	return true;
+
+}
+
+// called by enable(), updateChannelStates() and startRecording()
+void RecordNode::prepareRecording()
 {
 
 	channelMap.clear();
 	ftsChannelMap.clear();
+	startRecChannels.clear();
 	int totChans = dataChannelArray.size();
 	OwnedArray<RecordProcessorInfo> procInfo;
 	Array<int> chanProcessorMap;
@@ -514,9 +542,6 @@ void RecordNode::startRecording()
 	}
 
 	int numRecordedChannels = channelMap.size();
-	
-	validBlocks.clear();
-	validBlocks.insertMultiple(0, false, getNumInputs());
 
 	recordEngine->registerRecordNode(this);
 	//recordEngine->resetChannels();
@@ -527,58 +552,67 @@ void RecordNode::startRecording()
 	dataQueue->setChannels(numRecordedChannels);
 	dataQueue->setFTSChannels(recordedProcessorIdx+1);
 
+	recordThread->setQueuePointers(dataQueue, eventQueue, spikeQueue);
+
+	recordingPrepared = true;
+
+}
+
+// called by GenericProcessor::setRecording()
+void RecordNode::startRecording()
+{
+
+	/* Channel maps and queues are normally built while acquiring, see prepareRecording() */
+	if (!recordingPrepared)
+		prepareRecording();
+
+	validBlocks.clear();
+	validBlocks.insertMultiple(0, false, getNumInputs());
+
+	dataQueue->reset();
 	eventQueue->reset();
 	spikeQueue->reset();
-	recordThread->setQueuePointers(dataQueue, eventQueue, spikeQueue);
 	recordThread->setFirstBlockFlag(false);
 
 	hasRecorded = true;
 
-	
-
 	/* Set write properties */
 	setFirstBlock = false;
 
-	//Only start recording thread if at least one continous OR event channel is enabled
-	if (true) //(channelMap.size() || recordEvents)
+	/* Got signal from plugin-GUI to start recording */
+	if (newDirectoryNeeded)
 	{
+		createNewDirectory();
+		recordingNumber = 0;
+		experimentNumber = 1;
+		settingsNeeded = true;
+		recordEngine->directoryChanged();
+	}
+	else
+	{
+		recordingNumber++; // increment recording number within this directory
+	}
 
-		/* Got signal from plugin-GUI to start recording */
-		if (newDirectoryNeeded)
-		{
-			createNewDirectory();
-			recordingNumber = 0;
-			experimentNumber = 1;
-			settingsNeeded = true;
-			recordEngine->directoryChanged();
-		}
-		else
-		{
-			recordingNumber++; // increment recording number within this directory
-		}
-
-		if (!rootFolder.exists())
-		{
-			rootFolder.createDirectory();
-		}
-		
-		if (settingsNeeded)
-		{
-			String settingsFileName = rootFolder.getFullPathName() + File::separator + "settings" + ((experimentNumber > 1) ? "_" + String(experimentNumber) : String::empty) + ".xml";
-			AccessClass::getEditorViewport()->saveState(File(settingsFileName), lastSettingsText);
-			settingsNeeded = false;
-		}
+	/* The record thread creates the directory, and the settings writer its own parent,
+	so nothing here waits on the disk */
+	if (settingsNeeded)
+	{
+		String settingsFileName = rootFolder.getFullPathName() + File::separator + "settings" + ((experimentNumber > 1) ? "_" + String(experimentNumber) : String::empty) + ".xml";
+		lastSettings = AccessClass::getEditorViewport()->saveStateInBackground(File(settingsFileName));
+		settingsNeeded = false;
+	}
 
-		useSynchronizer = static_cast<RecordNodeEditor*> (getEditor())->getSelectedEngineIdx() == 0;
+	useSynchronizer = static_cast<RecordNodeEditor*> (getEditor())->getSelectedEngineIdx() == 0;
 
-		recordThread->setFileComponents(rootFolder, experimentNumber, recordingNumber);
+	recordThread->setFileComponents(rootFolder, experimentNumber, recordingNumber);
 
-		std::cout << "Num event channels: " << eventChannelArray.size() << std::endl;
-		recordThread->startThread();
-		isRecording = true;
+	std::cout << "Num event channels: " << eventChannelArray.size() << std::endl;
+	if (!recordThread->beginRecording())
+	{
+		std::cout << "Record thread is still closing the previous recording, not starting a new one" << std::endl;
+		return;
 	}
-	else
-		isRecording = false;
+	isRecording = true;
 
 }
 
@@ -587,10 +621,11 @@ void RecordNode::stopRecording()
 {
 
 	isRecording = false;
-	if (recordThread->isThreadRunning())
+	if (!recordThread->endRecording(2000))
 	{
-		recordThread->signalThreadShouldExit();
-		recordThread->waitForThreadToExit(2000); //2000
+		//The next recording can only start once these files are closed
+		std::cout << "Record thread is taking a long time to close its files, waiting..." << std::endl;
+		recordThread->endRecording(-1);
 	}
 
 	eventMonitor->displayStatus();
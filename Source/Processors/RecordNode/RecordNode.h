@@ -15,6 +15,7 @@
 #include "DataQueue.h"
 #include "Synchronizer.h"
 #include "Utils.h"
+#include "../../UI/SettingsSnapshot.h"
 
 //#include "taskflow/taskflow.hpp"
 
@@ -78,6 +79,7 @@ public:
 
 	void updateSettings() override;
     bool enable() override;
+    bool disable() override;
 	int getNumSubProcessors() const override;
 
 	void prepareToPlay(double sampleRate, int estimatedSamplesPerBlock);
@@ -115,7 +117,7 @@ public:
     ScopedPointer<Synchronizer> synchronizer;
 
 	int64 samplesWritten;
-	String lastSettingsText;
+	SettingsWriter::Request::Ptr lastSettings;
 
 	int numSubprocessors;
 
@@ -192,11 +194,19 @@ private:
 	int lastDataChannelArraySize;
 
     bool isProcessing;
-	bool isRecording;
+	std::atomic<bool> isRecording;
 	bool hasRecorded;
 	bool settingsNeeded;
     bool shouldRecord;
 
+	/** True when the channel maps, engine mapping and queues match the current channel
+	selection, so startRecording() doesn't need to rebuild them. */
+	bool recordingPrepared;
+
+	/** Builds everything a recording needs that doesn't depend on when it starts. Called
+	while acquiring but not recording, so starting a recording only has to start writing. */
+	void prepareRecording();
+
 	File dataDirectory;
 	File rootFolder;
 
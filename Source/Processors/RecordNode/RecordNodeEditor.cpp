@@ -225,14 +225,14 @@ void RecordNodeEditor::timerCallback()
 {
 
 	/* Disable buttons while recording */
-	if (dataPathButton->isEnabled() && recordNode->recordThread->isThreadRunning())
+	if (dataPathButton->isEnabled() && recordNode->recordThread->isRecording())
 	{
 		dataPathButton->setEnabled(false);
 		engineSelectCombo->setEnabled(false);
 		eventRecord->setEnabled(false);
 		spikeRecord->setEnabled(false);
 	}
-	else if (!dataPathButton->isEnabled() && !recordNode->recordThread->isThreadRunning())
+	else if (!dataPathButton->isEnabled() && !recordNode->recordThread->isRecording())
 	{
 		dataPathButton->setEnabled(true);
 		engineSelectCombo->setEnabled(true);
@@ -245,7 +245,7 @@ void RecordNodeEditor::timerCallback()
 void RecordNodeEditor::comboBoxChanged(ComboBox* box)
 {
 
-	if (!recordNode->recordThread->isThreadRunning())
+	if (!recordNode->recordThread->isRecording())
 	{
 		uint8 selectedEngineIndex = box->getSelectedId();
 		recordNode->setEngine(selectedEngineIndex-1);
@@ -309,11 +309,11 @@ void RecordNodeEditor::buttonEvent(Button *button)
 	{
 		//TODO: Clicking on the master record monitor should do something useful in the future...
 	}
-	else if (button == eventRecord && !recordNode->recordThread->isThreadRunning())
+	else if (button == eventRecord && !recordNode->recordThread->isRecording())
 	{
 		recordNode->setRecordEvents(button->getToggleState());
 	}
-	else if (button == spikeRecord && !recordNode->recordThread->isThreadRunning())
+	else if (button == spikeRecord && !recordNode->recordThread->isRecording())
 	{
 		recordNode->setRecordSpikes(button->getToggleState());
 	}
@@ -524,7 +524,7 @@ void SyncControlButton::componentBeingDeleted(Component &component)
 void SyncControlButton::mouseUp(const MouseEvent &event)
 {
 
-	if (!node->recordThread->isThreadRunning() && event.mods.isLeftButtonDown())
+	if (!node->recordThread->isRecording() && event.mods.isLeftButtonDown())
 	{
 
 		std::vector<bool> channelStates;
@@ -670,7 +670,7 @@ void FifoMonitor::mouseDoubleClick(const MouseEvent &event)
 
 	channelStates = recordNode->dataChannelStates[srcID][subID];
 	
-	bool editable = !recordNode->recordThread->isThreadRunning();
+	bool editable = !recordNode->recordThread->isRecording();
     auto* channelSelector = new RecordChannelSelector(channelStates, editable);
  
     CallOutBox& myBox
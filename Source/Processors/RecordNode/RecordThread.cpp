@@ -31,21 +31,26 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 RecordThread::RecordThread(RecordNode* parentNode, const ScopedPointer<RecordEngine>& engine) :
 Thread("Record Thread"),
-m_engine(engine),
 recordNode(parentNode),
+samplesWritten(0),
+m_engine(engine),
 m_receivedFirstBlock(false),
 m_cleanExit(true),
-samplesWritten(0)
+m_startRequested(false),
+m_stopRequested(false),
+m_sessionActive(false),
+m_sessionFinished(true)
 {
 }
 
 RecordThread::~RecordThread()
 {
+	disarm();
 }
 
 void RecordThread::setFileComponents(File rootFolder, int experimentNumber, int recordingNumber)
 {
-	if (isThreadRunning())
+	if (m_sessionActive)
 	{
 		LOGD(__FUNCTION__, " Tried to set file components while thread was running!");
 		return;
@@ -59,14 +64,14 @@ void RecordThread::setFileComponents(File rootFolder, int experimentNumber, int
 
 void RecordThread::setFTSChannelMap(const Array<int>& channels)
 {
-	if (isThreadRunning())
+	if (m_sessionActive)
 		return;
 	m_ftsChannelArray = channels;
 }
 
 void RecordThread::setChannelMap(const Array<int>& channels)
 {
-	if (isThreadRunning())
+	if (m_sessionActive)
 		return;
 	m_channelArray = channels;
 	m_numChannels = channels.size();
@@ -86,7 +91,76 @@ void RecordThread::setFirstBlockFlag(bool state)
 	this->notify();
 }
 
+void RecordThread::arm()
+{
+	if (!isThreadRunning())
+		startThread();
+}
+
+bool RecordThread::beginRecording()
+{
+	if (m_sessionActive)
+		return false;
+
+	m_stopRequested = false;
+	m_sessionFinished.reset();
+	m_sessionActive = true;
+	m_startRequested = true;
+
+	if (isThreadRunning())
+		notify();
+	else
+		startThread();
+	return true;
+}
+
+bool RecordThread::endRecording(int timeoutMs)
+{
+	if (!m_sessionActive)
+		return true;
+
+	m_stopRequested = true;
+	notify();
+	return m_sessionFinished.wait(timeoutMs);
+}
+
+void RecordThread::disarm()
+{
+	endRecording(2000);
+	signalThreadShouldExit();
+	notify();
+	waitForThreadToExit(2000);
+}
+
+bool RecordThread::isRecording() const
+{
+	return m_sessionActive;
+}
+
+bool RecordThread::shouldKeepRecording()
+{
+	return !m_stopRequested && !threadShouldExit();
+}
+
 void RecordThread::run()
+{
+	//Stay armed between recordings, so starting one only needs a wake-up
+	while (!threadShouldExit())
+	{
+		if (!m_startRequested)
+		{
+			wait(100);
+			continue;
+		}
+
+		m_startRequested = false;
+		recordSession();
+		m_sessionActive = false;
+		m_sessionFinished.signal();
+	}
+}
+
+void RecordThread::recordSession()
 {
 	const AudioSampleBuffer& dataBuffer = m_dataQueue->getAudioBufferReference();
 	const SynchronizedTimestampBuffer& ftsBuffer = m_dataQueue->getFTSBufferReference();
@@ -94,7 +168,7 @@ void RecordThread::run()
 	bool closeEarly = true;
 	//1-Wait until the first block has arrived, so we can align the timestamps
 	bool isWaiting = false;
-	while (!m_receivedFirstBlock && !threadShouldExit())
+	while (!m_receivedFirstBlock && shouldKeepRecording())
 	{
 		if (!isWaiting)
 		{
@@ -104,10 +178,15 @@ void RecordThread::run()
 	}
 
 	//2-Open Files 
-	if (!threadShouldExit())
+	if (shouldKeepRecording())
 	{
 		m_cleanExit = false;
 		closeEarly = false;
+
+		//Created here rather than when recording is requested, so slow filesystems don't delay the start
+		if (!m_rootFolder.exists())
+			m_rootFolder.createDirectory();
+
 		Array<int64> timestamps;
 		m_dataQueue->getTimestampsForBlock(0, timestamps);
 
@@ -123,12 +202,12 @@ void RecordThread::run()
 	//3-Normal loop
 	if (useSynchronizer)
 	{
-		while (!threadShouldExit())
+		while (shouldKeepRecording())
 			writeSynchronizedData(dataBuffer, ftsBuffer, BLOCK_MAX_WRITE_SAMPLES, BLOCK_MAX_WRITE_EVENTS, BLOCK_MAX_WRITE_SPIKES);
 	}
 	else
 	{
-		while (!threadShouldExit())
+		while (shouldKeepRecording())
 			writeData(dataBuffer, BLOCK_MAX_WRITE_SAMPLES, BLOCK_MAX_WRITE_EVENTS, BLOCK_MAX_WRITE_SPIKES);
 	}
 	
@@ -289,7 +368,7 @@ void RecordThread::writeData(const AudioSampleBuffer& dataBuffer, int maxSamples
 
 void RecordThread::forceCloseFiles()
 {
-	if (isThreadRunning() || m_cleanExit)
+	if (m_sessionActive || m_cleanExit)
 		return;
 
 	//EVERY_ENGINE->closeFiles();
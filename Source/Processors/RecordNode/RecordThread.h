@@ -47,6 +47,19 @@ public:
 	void setFTSChannelMap(const Array<int>& channels);
 	void setQueuePointers(DataQueue* data, EventMsgQueue* events, SpikeMsgQueue* spikes);
 
+	/** Starts the thread ahead of recording, so that it only has to be woken up when recording starts. */
+	void arm();
+	/** Starts writing a recording with the current file components and channel maps.
+	Returns false if the files of the previous recording are still being closed. */
+	bool beginRecording();
+	/** Writes the remaining data and closes the files. The thread stays armed for the next recording.
+	Returns false if the files could not be closed within the timeout. */
+	bool endRecording(int timeoutMs);
+	/** Ends any recording and stops the thread. */
+	void disarm();
+	/** True from beginRecording() until the files of that recording are closed. */
+	bool isRecording() const;
+
 	void run() override;
 
 	void setFirstBlockFlag(bool state);
@@ -56,6 +69,9 @@ public:
 	int64 samplesWritten;
 
 private:
+	void recordSession();
+	bool shouldKeepRecording();
+
 	void writeData(const AudioSampleBuffer& buffer, int maxSamples, int maxEvents, int maxSpikes, bool lastBlock = false);
 	void writeSynchronizedData(const AudioSampleBuffer& dataBuffer, const SynchronizedTimestampBuffer& ftsBuffer, int maxSamples, int maxEvents, int maxSpikes, bool lastBlock = false);
 
@@ -71,6 +87,11 @@ private:
 	std::atomic<bool> m_receivedFirstBlock;
 	std::atomic<bool> m_cleanExit;
 
+	std::atomic<bool> m_startRequested;
+	std::atomic<bool> m_stopRequested;
+	std::atomic<bool> m_sessionActive;
+	WaitableEvent m_sessionFinished;
+
 	File m_rootFolder;
 	int m_experimentNumber;
 	int m_recordingNumber;
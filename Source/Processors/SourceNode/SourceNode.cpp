@@ -27,6 +27,20 @@
 #include "../../AccessClass.h"
 #include "../PluginManager/OpenEphysPlugin.h"
 
+/** Number of TTL words checked together for changes before looking at each of them */
+#define TTL_SCAN_GROUP_SIZE 8
+
+static inline uint16 countTrailingZeros(uint64 value)
+{
+#if JUCE_MSVC
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return static_cast<uint16>(index);
+#else
+	return static_cast<uint16>(__builtin_ctzll(value));
+#endif
+}
+
 
 SourceNode::SourceNode (const String& name_, DataThreadCreator dt)
     : GenericProcessor      (name_)
@@ -200,6 +214,7 @@ void SourceNode::setChannelInfo(int channel, String name, float bitVolts)
 void SourceNode::createEventChannels()
 {
 	ttlChannels.clear();
+	ttlWriters.clear();
 	if (dataThread)
 	{
 		//Create base TTL event channels
@@ -216,9 +231,13 @@ void SourceNode::createEventChannels()
 				chan->setIdentifier("sourceevent");
 				eventChannelArray.add(chan);
 				ttlChannels.add(chan);
+				ttlWriters.add(new TTLEventWriter(chan));
 			}
 			else
+			{
 				ttlChannels.add(nullptr);
+				ttlWriters.add(nullptr);
+			}
 		}
 		//Add other events that the source might create
 		Array<EventChannel*> events;
@@ -389,27 +408,44 @@ void SourceNode::process(AudioSampleBuffer& buffer)
 		if (ttlChannels[sub])
 		{
 			int numEventChannels = ttlChannels[sub]->getNumChannels();
+			const uint64 channelMask = (numEventChannels < 64) ? ((uint64(1) << numEventChannels) - 1) : ~uint64(0);
+			const uint64* codes = static_cast<uint64*>(eventCodeBuffers[sub]->getData());
+			const TTLEventWriter* writer = ttlWriters[sub];
+
 			// fill event buffer
+			ttlEventBuffer.clear();
 			uint64 last = eventStates[sub];
-			for (int i = 0; i < nSamples; ++i)
+			int i = 0;
+			while (i < nSamples)
 			{
-				uint64 current = *(static_cast<uint64*>(eventCodeBuffers[sub]->getData()) + i);
-				//If there has been no change to the TTL word, avoid doing anything at all here
-				if (last != current)
+				//Skip runs with no change to the TTL word a group of samples at a time,
+				//XORing each word with the one before it
+				if (i + TTL_SCAN_GROUP_SIZE <= nSamples)
 				{
-					//Create a TTL event for each bit that has changed
-					for (int c = 0; c < numEventChannels; ++c)
+					uint64 flipped = codes[i] ^ last;
+					for (int k = 1; k < TTL_SCAN_GROUP_SIZE; ++k)
+						flipped |= codes[i + k] ^ codes[i + k - 1];
+
+					if ((flipped & channelMask) == 0)
 					{
-						if (((current >> c) & 0x01) != ((last >> c) & 0x01))
-						{
-							TTLEventPtr event = TTLEvent::createTTLEvent(ttlChannels[sub], timestamp + i, &current, sizeof(uint64), c);
-							addEvent(ttlChannels[sub], event, i);
-						}
+						i += TTL_SCAN_GROUP_SIZE;
+						last = codes[i - 1];
+						continue;
 					}
-					last = current;
 				}
+
+				//Create a TTL event for each bit that has changed, lowest channel first
+				uint64 flipped = (codes[i] ^ last) & channelMask;
+				while (flipped != 0)
+				{
+					writer->writeEvent(ttlEventBuffer, i, timestamp + i, countTrailingZeros(flipped), codes + i);
+					flipped &= flipped - 1;
+				}
+				last = codes[i];
+				++i;
 			}
 			eventStates.set(sub, last);
+			addEvents(ttlEventBuffer);
 		}
 	}
 }
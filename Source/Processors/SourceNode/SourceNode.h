@@ -111,6 +111,8 @@ private:
     OwnedArray<MemoryBlock> eventCodeBuffers;
 	Array<uint64> eventStates;
 	Array<EventChannel*> ttlChannels;
+	OwnedArray<TTLEventWriter> ttlWriters;
+	MidiBuffer ttlEventBuffer;
 
     int ttlState;
 	void resizeBuffers();
@@ -545,10 +545,18 @@ void ControlPanel::updateRecordEngineList()
 		recordEngines.add(rem);
 	}
     LOGD("Num plugin engines: ", AccessClass::getPluginManager()->getNumRecordEngines());
+	PluginManager* pm = AccessClass::getPluginManager();
+	StringArray engineLibs;
+	for (int i = 0; i < pm->getNumRecordEngines(); i++)
+		engineLibs.addIfNotAlreadyThere(pm->getLibraryName(pm->getLibraryIndexFromPlugin(Plugin::PLUGIN_TYPE_RECORD_ENGINE, i)));
+	pm->preloadLibraries(engineLibs);
+
 	for (int i = 0; i < AccessClass::getPluginManager()->getNumRecordEngines(); i++)
 	{
 		Plugin::RecordEngineInfo info;
-		info = AccessClass::getPluginManager()->getRecordEngineInfo(i);
+		if (!pm->loadPluginLibrary(Plugin::PLUGIN_TYPE_RECORD_ENGINE, i))
+			continue;
+		info = pm->getRecordEngineInfo(i);
 		recordSelector->addItem(info.name, id++);
         LOGD("Adding engine: ", info.name);
 		recordEngines.add(info.creator());
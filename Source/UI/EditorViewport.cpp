@@ -30,6 +30,8 @@
 #include "../Processors/MessageCenter/MessageCenterEditor.h"
 #include "ProcessorList.h"
 #include "../Processors/ProcessorGraph/ProcessorGraph.h"
+#include "../Processors/PluginManager/PluginManager.h"
+#include "../Processors/Merger/Merger.h"
 
 EditorViewport::EditorViewport()
     : leftmostEditor(0),
@@ -56,6 +58,8 @@ EditorViewport::EditorViewport()
     signalChainManager = new SignalChainManager(this, editorArray,
                                                 signalChainArray);
 
+    settingsWriter = new SettingsWriter();
+
     upButton = new SignalChainScrollButton(UP);
     downButton = new SignalChainScrollButton(DOWN);
     leftButton = new EditorScrollButton(LEFT);
@@ -84,6 +88,7 @@ EditorViewport::EditorViewport()
 EditorViewport::~EditorViewport()
 {
 	signalChainManager = nullptr;
+    settingsWriter = nullptr; // finishes any pending writes
     deleteAllChildren();
 }
 
@@ -1206,6 +1211,43 @@ const String EditorViewport::saveState(File fileToUse, String* xmlText)
 
     currentFile = fileToUse;
 
+    XmlElement* xml = createSettingsXml();
+
+    bool written;
+    if (fileToUse.hasFileExtension(SettingsSnapshot::fileExtension))
+        written = SettingsSnapshot::writeToFile(*xml, currentFile);
+    else
+        written = xml->writeToFile(currentFile, String::empty);
+
+    if (! written)
+        error = "Couldn't write to file ";
+    else
+        error = "Saved configuration as ";
+
+    error += currentFile.getFileName();
+
+	if (xmlText != nullptr)
+	{
+		(*xmlText) = xml->createDocument(String::empty);
+		if ((*xmlText).isEmpty())
+			(*xmlText) = "Couldn't create configuration xml";
+	}
+
+    delete xml;
+
+    return error;
+}
+
+SettingsWriter::Request::Ptr EditorViewport::saveStateInBackground(File fileToUse)
+{
+    currentFile = fileToUse;
+
+    return settingsWriter->write(createSettingsXml(), fileToUse);
+}
+
+XmlElement* EditorViewport::createSettingsXml()
+{
+
     // FileChooser fc("Choose the file to save...",
     //                CoreServices::getDefaultUserSaveDirectory(),
     //                "*",
@@ -1347,23 +1389,7 @@ const String EditorViewport::saveState(File fileToUse, String* xmlText)
     AccessClass::getProcessorList()->saveStateToXml(xml);
     AccessClass::getUIComponent()->saveStateToXml(xml);  // save the UI settings
 
-    if (! xml->writeToFile(currentFile, String::empty))
-        error = "Couldn't write to file ";
-    else
-        error = "Saved configuration as ";
-
-    error += currentFile.getFileName();
-
-	if (xmlText != nullptr)
-	{
-		(*xmlText) = xml->createDocument(String::empty);
-		if ((*xmlText).isEmpty())
-			(*xmlText) = "Couldn't create configuration xml";
-	}
-
-    delete xml;
-
-    return error;
+    return xml;
 }
 
 const String EditorViewport::loadState(File fileToLoad)
@@ -1389,8 +1415,18 @@ const String EditorViewport::loadState(File fileToLoad)
 
     Array<GenericProcessor*> splitPoints;
 
-    XmlDocument doc(currentFile);
-    XmlElement* xml = doc.getDocumentElement();
+    XmlElement* xml;
+
+    if (SettingsSnapshot::isSnapshotFile(currentFile))
+    {
+        SettingsSnapshot snapshot(currentFile);
+        xml = snapshot.createXml();
+    }
+    else
+    {
+        XmlDocument doc(currentFile);
+        xml = doc.getDocumentElement();
+    }
 
     if (xml == 0 || ! xml->hasTagName("SETTINGS"))
     {
@@ -1468,6 +1504,19 @@ const String EditorViewport::loadState(File fileToLoad)
 		return "Failed To Open " + fileToLoad.getFileName();
 	}
     clearSignalChain();
+
+    // load the plugin libraries the chain needs in parallel rather than one by one as processors are created
+    StringArray libNames;
+    forEachXmlChildElementWithTagName(*xml, element, "SIGNALCHAIN")
+    {
+        forEachXmlChildElementWithTagName(*element, processor, "PROCESSOR")
+        {
+            String libName = processor->getStringAttribute("libraryName");
+            if (libName.isNotEmpty())
+                libNames.addIfNotAlreadyThere(libName, true);
+        }
+    }
+    AccessClass::getPluginManager()->preloadLibraries(libNames);
     
     loadingConfig = true; //Indicate config is being loaded into the GUI
     String description;// = " ";
@@ -1642,6 +1691,133 @@ const String EditorViewport::loadState(File fileToLoad)
     
     return error;
 }
+const String EditorViewport::reloadPlugin(File pluginFile)
+{
+
+    if (!canEdit)
+        return "Cannot reload plugins while acquisition is active.";
+
+    PluginManager* pm = AccessClass::getPluginManager();
+    int libIndex = pm->reloadPlugin(pluginFile.getFullPathName());
+
+    if (libIndex < 0)
+        return "Could not reload " + pluginFile.getFileName() + ".";
+
+    String libName = pm->getLibraryName(libIndex);
+    int libVersion = pm->getLibraryVersion(libIndex);
+
+    Array<GenericProcessor*> processors = AccessClass::getProcessorGraph()->getListOfProcessors();
+    Array<GenericProcessor*> replaced;
+
+    for (int i = 0; i < processors.size(); i++)
+    {
+        GenericProcessor* p = processors[i];
+
+        if ((p->getPluginType() != Plugin::PLUGIN_TYPE_PROCESSOR && p->getPluginType() != Plugin::PLUGIN_TYPE_DATA_THREAD)
+            || !p->getLibName().equalsIgnoreCase(libName))
+            continue;
+
+        //See ProcessorGraph::createProcessorFromDescription for description info
+        Array<var> procDesc;
+        procDesc.add(false);
+        procDesc.add(p->getPluginName());
+        procDesc.add((int)p->getPluginType());
+        procDesc.add(p->getIndex());
+        procDesc.add(libName);
+        procDesc.add(libVersion);
+        procDesc.add(p->isSource());
+        procDesc.add(p->isSink());
+
+        replaced.add(replaceNode(p->getEditor(), procDesc));
+    }
+
+    // nothing refers to the previous build anymore
+    pm->releaseReloadedLibraries();
+
+    for (int i = 0; i < replaced.size(); i++)
+        signalChainManager->updateProcessorSettings(replaced[i]);
+
+    if (editorArray.size() > 0)
+        signalChainManager->updateVisibleEditors(editorArray[0], 0, 0, ACTIVATE);
+
+    refreshEditors();
+
+    AccessClass::getProcessorList()->fillItemList();
+    AccessClass::getProcessorList()->repaint();
+
+    repaint();
+
+    return "Reloaded " + libName + ", " + String(replaced.size()) + " processors replaced.";
+}
+
+GenericProcessor* EditorViewport::replaceNode(GenericEditor* editor, Array<var>& description)
+{
+    GenericProcessor* oldProcessor = editor->getProcessor();
+    GenericProcessor* source = oldProcessor->getSourceNode();
+    GenericProcessor* dest = oldProcessor->getDestNode();
+
+    ScopedPointer<XmlElement> state = createNodeXml(oldProcessor, source == nullptr);
+
+    // make the splitter or merger paths next to the old processor the active ones,
+    // so that linking the new processor below takes over exactly its slots
+    if (source != nullptr && source->isSplitter())
+        source->setPathToProcessor(oldProcessor);
+
+    if (dest != nullptr && dest->isMerger())
+        static_cast<Merger*>(dest)->switchToSourceNode(oldProcessor);
+
+    int index = editorArray.indexOf(editor);
+    int tab = editor->tabNumber();
+
+    AccessClass::getGraphViewer()->removeNode(editor);
+
+    ProcessorGraph* graph = AccessClass::getProcessorGraph();
+    GenericProcessor* processor = graph->replaceProcessor(oldProcessor, description);
+
+    if (processor == nullptr)
+    {
+        // the new build failed to create it; keep the slot with a placeholder
+        description.set(3, -1);
+        processor = graph->replaceProcessor(oldProcessor, description);
+    }
+
+    // oldProcessor and editor are gone from here on
+
+    GenericEditor* newEditor = processor->getEditor();
+    newEditor->refreshColors();
+    addChildComponent(newEditor);
+
+    if (index > -1)
+        editorArray.set(index, newEditor);
+
+    if (tab > -1)
+    {
+        newEditor->tabNumber(tab);
+        signalChainArray[tab]->setEditor(newEditor);
+    }
+
+    if (lastEditor == editor)
+        lastEditor = newEditor;
+    if (lastEditorClicked == editor)
+        lastEditorClicked = newEditor;
+    if (editorToUpdate == editor)
+        editorToUpdate = newEditor;
+
+    if (source != nullptr)
+        processor->setSourceNode(source);
+    if (dest != nullptr)
+        processor->setDestNode(dest);
+
+    processor->parametersAsXml = state;
+    setParametersByXML(processor, state);
+    processor->loadFromXml();
+    processor->parametersAsXml = nullptr;
+
+    AccessClass::getGraphViewer()->addNode(newEditor);
+
+    return processor;
+}
+
 /* Set parameters based on XML.*/
 void EditorViewport::setParametersByXML(GenericProcessor* targetProcessor, XmlElement* processorXML)
 {
@@ -34,6 +34,7 @@
 #include "ControlPanel.h"
 #include "UIComponent.h"
 #include "DataViewport.h"
+#include "SettingsSnapshot.h"
 
 class GenericEditor;
 class SignalChainTabButton;
@@ -147,15 +148,31 @@ public:
         return signalChainArray;
     }
 
-    /** Save the current configuration as an XML file. */
+    /** Save the current configuration as an XML file, or as a binary snapshot if the
+        file has the snapshot extension. */
     const String saveState(File filename, String* xmlText = nullptr);
 
 	/** Save the current configuration as an XML file. Reference wrapper*/
 	const String saveState(File filename, String& xmlText);
 
-    /** Load a saved configuration from an XML file. */
+    /** Save the current configuration as an XML file, plus a binary snapshot next to it.
+        Only the settings tree is built on the calling thread; the files are written in the
+        background. The returned request gives access to the XML text once it is written. */
+    SettingsWriter::Request::Ptr saveStateInBackground(File filename);
+
+    /** Load a saved configuration from an XML file or a binary snapshot. */
     const String loadState(File filename);
 
+    /** Loads a new build of a plugin library while acquisition is stopped. Every
+        processor created from the library is replaced in place by an instance from
+        the new build, which gets its node ID, its links in the signal chain and its
+        state as saved by saveToXml. Only the settings downstream of the replaced
+        processors are updated. */
+    const String reloadPlugin(File pluginFile);
+
+    /** Creates the SETTINGS element describing the current configuration. */
+    XmlElement* createSettingsXml();
+
     /** Converts information about a given editor to XML. */
     XmlElement* createNodeXml(GenericProcessor*, bool isStartOfSignalChain);
 
@@ -197,6 +214,8 @@ private:
 
     ScopedPointer<SignalChainManager> signalChainManager;
 
+    ScopedPointer<SettingsWriter> settingsWriter;
+
     Font font;
     Image sourceDropImage;
 
@@ -219,6 +238,9 @@ private:
 
     void resized();
 
+    /** Swaps the processor of editor for one created from description, see reloadPlugin(). */
+    GenericProcessor* replaceNode(GenericEditor* editor, Array<var>& description);
+
     int currentId;
     int maxId;
 
@@ -0,0 +1,437 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SettingsSnapshot.h"
+
+#include <iostream>
+#include <unordered_map>
+
+static const uint32 SNAPSHOT_MAGIC = 0x5353454f; // "OESS"
+static const int SNAPSHOT_VERSION = 1;
+
+const char* const SettingsSnapshot::fileExtension = ".oesnap";
+
+// Names are numbered from 1 in the order they first appear in a section; a name's first
+// use is followed by its text. 0 marks a text element.
+struct NameTable
+{
+    // attribute names are pooled Identifiers, so most names can be found by the address
+    // of their text before falling back to hashing it
+    std::unordered_map<const void*, int> byAddress;
+    HashMap<String, int> byName;
+};
+
+static void writeName(OutputStream& out, NameTable& names, const String& name)
+{
+    const void* address = name.getCharPointer().getAddress();
+    auto it = names.byAddress.find(address);
+    if (it != names.byAddress.end())
+    {
+        out.writeCompressedInt(it->second);
+        return;
+    }
+
+    int id = names.byName[name]; // 0 if not there yet
+    if (id > 0)
+    {
+        out.writeCompressedInt(id);
+    }
+    else
+    {
+        id = names.byName.size() + 1;
+        names.byName.set(name, id);
+        out.writeCompressedInt(id);
+        out.writeString(name);
+    }
+    names.byAddress[address] = id;
+}
+
+/** Decodes a section straight from memory. Faster than going through an InputStream,
+    which reads strings one byte at a time. */
+struct SnapshotReader
+{
+    SnapshotReader(const void* data, size_t size)
+        : pos(static_cast<const uint8*>(data)), end(pos + size), failed(false) {}
+
+    bool isExhausted() const { return failed || pos >= end; }
+
+    // same encoding as OutputStream::writeCompressedInt
+    int readCompressedInt()
+    {
+        if (pos >= end) { failed = true; return 0; }
+        const uint8 sizeByte = *pos++;
+        const int numBytes = sizeByte & 0x7f;
+        if (numBytes > 4 || end - pos < numBytes) { failed = true; return 0; }
+
+        uint32 num = 0;
+        for (int i = 0; i < numBytes; i++)
+            num |= ((uint32)pos[i]) << (i * 8);
+        pos += numBytes;
+
+        return (sizeByte & 0x80) ? -(int)num : (int)num;
+    }
+
+    // same encoding as OutputStream::writeString
+    String readString()
+    {
+        const uint8* nul = static_cast<const uint8*>(memchr(pos, 0, (size_t)(end - pos)));
+        if (nul == nullptr) { failed = true; pos = end; return String::empty; }
+        String text = String::fromUTF8(reinterpret_cast<const char*>(pos), (int)(nul - pos));
+        pos = nul + 1;
+        return text;
+    }
+
+    const uint8* pos;
+    const uint8* const end;
+    bool failed;
+};
+
+// names are kept as Identifiers, which is what XmlElement stores attribute names as, so
+// each one is only looked up in the global string pool once per section
+static Identifier readName(SnapshotReader& in, Array<Identifier>& names, int id)
+{
+    if (id == names.size() + 1)
+    {
+        String name = in.readString();
+        names.add(name.isEmpty() ? Identifier() : Identifier(name));
+        return names.getReference(id - 1);
+    }
+    else if (id > 0 && id <= names.size())
+    {
+        return names.getReference(id - 1);
+    }
+
+    return Identifier();
+}
+
+static void writeElement(OutputStream& out, NameTable& names, const XmlElement& e, bool includeChildren)
+{
+    if (e.isTextElement())
+    {
+        out.writeCompressedInt(0);
+        out.writeString(e.getText());
+        return;
+    }
+
+    writeName(out, names, e.getTagName());
+
+    int numAttributes = e.getNumAttributes();
+    out.writeCompressedInt(numAttributes);
+    for (int i = 0; i < numAttributes; i++)
+    {
+        writeName(out, names, e.getAttributeName(i));
+        out.writeString(e.getAttributeValue(i));
+    }
+
+    if (!includeChildren)
+    {
+        out.writeCompressedInt(0);
+        return;
+    }
+
+    out.writeCompressedInt(e.getNumChildElements());
+    forEachXmlChildElement(e, child)
+        writeElement(out, names, *child, true);
+}
+
+static XmlElement* readElement(SnapshotReader& in, Array<Identifier>& names)
+{
+    if (in.isExhausted())
+        return nullptr;
+
+    int id = in.readCompressedInt();
+    if (id == 0)
+        return XmlElement::createTextElement(in.readString());
+
+    Identifier tag = readName(in, names, id);
+    if (tag.isNull())
+        return nullptr;
+
+    ScopedPointer<XmlElement> e = new XmlElement(tag);
+
+    int numAttributes = in.readCompressedInt();
+    for (int i = 0; i < numAttributes; i++)
+    {
+        Identifier name = readName(in, names, in.readCompressedInt());
+        if (name.isNull() || in.isExhausted())
+            return nullptr;
+        e->setAttribute(name, in.readString());
+    }
+
+    int numChildren = in.readCompressedInt();
+    if (numChildren < 0 || in.failed)
+        return nullptr;
+
+    // addChildElement() walks the whole list of children, so collect them and prepend
+    // in reverse order instead
+    OwnedArray<XmlElement> children;
+    for (int i = 0; i < numChildren; i++)
+    {
+        XmlElement* child = readElement(in, names);
+        if (child == nullptr)
+            return nullptr;
+        children.add(child);
+    }
+
+    for (int i = children.size(); --i >= 0;)
+        e->prependChildElement(children.removeAndReturn(i));
+
+    return e.release();
+}
+
+static void writeSection(OutputStream& out, int depth, const XmlElement& e, bool includeChildren)
+{
+    MemoryOutputStream section;
+    NameTable names;
+    writeElement(section, names, e, includeChildren);
+
+    out.writeCompressedInt(depth);
+    out.writeCompressedInt((int)section.getDataSize());
+    out.write(section.getData(), section.getDataSize());
+}
+
+SettingsSnapshot::SettingsSnapshot(const File& file) : valid(false)
+{
+    if (!file.loadFileAsData(data) || data.getSize() < 8)
+        return;
+
+    const uint8* bytes = static_cast<const uint8*>(data.getData());
+
+    if (ByteOrder::littleEndianInt(bytes) != SNAPSHOT_MAGIC
+        || (int)ByteOrder::littleEndianInt(bytes + 4) != SNAPSHOT_VERSION)
+        return;
+
+    SnapshotReader in(bytes + 8, data.getSize() - 8);
+
+    Array<Identifier> rootNames;
+    rootElement = readElement(in, rootNames);
+    if (rootElement == nullptr)
+        return;
+
+    int numSections = in.readCompressedInt();
+    bool inSignalChain = false;
+
+    for (int i = 0; i < numSections; i++)
+    {
+        Section s;
+        s.depth = in.readCompressedInt();
+        int size = in.readCompressedInt();
+
+        if (in.failed || size <= 0 || size > in.end - in.pos || (s.depth == 1 && !inSignalChain))
+        {
+            std::cout << "Settings snapshot " << file.getFileName() << " is corrupt." << std::endl;
+            return;
+        }
+
+        s.offset = (size_t)(in.pos - bytes);
+        s.size = (size_t)size;
+
+        // the tag is the first name in the section, no need to decode anything else to index it
+        SnapshotReader sectionIn(in.pos, s.size);
+        Array<Identifier> names;
+        s.tag = readName(sectionIn, names, sectionIn.readCompressedInt()).toString();
+
+        if (s.depth == 0)
+            inSignalChain = (s.tag == "SIGNALCHAIN");
+
+        sections.add(s);
+        in.pos += size;
+    }
+
+    valid = true;
+}
+
+SettingsSnapshot::~SettingsSnapshot()
+{
+}
+
+bool SettingsSnapshot::isValid() const
+{
+    return valid;
+}
+
+int SettingsSnapshot::getNumSections() const
+{
+    return sections.size();
+}
+
+String SettingsSnapshot::getSectionTag(int index) const
+{
+    return sections[index].tag;
+}
+
+int SettingsSnapshot::getSectionDepth(int index) const
+{
+    return sections[index].depth;
+}
+
+XmlElement* SettingsSnapshot::createSectionXml(int index) const
+{
+    if (!valid || !isPositiveAndBelow(index, sections.size()))
+        return nullptr;
+
+    const Section& s = sections.getReference(index);
+    SnapshotReader in(addBytesToPointer(data.getData(), s.offset), s.size);
+    Array<Identifier> names;
+
+    return readElement(in, names);
+}
+
+XmlElement* SettingsSnapshot::createXml() const
+{
+    if (!valid)
+        return nullptr;
+
+    ScopedPointer<XmlElement> xml = new XmlElement(*rootElement);
+    XmlElement* signalChain = nullptr;
+
+    for (int i = 0; i < sections.size(); i++)
+    {
+        XmlElement* e = createSectionXml(i);
+        if (e == nullptr)
+            return nullptr;
+
+        if (sections.getReference(i).depth == 1)
+        {
+            signalChain->addChildElement(e);
+        }
+        else
+        {
+            xml->addChildElement(e);
+            signalChain = e->hasTagName("SIGNALCHAIN") ? e : nullptr;
+        }
+    }
+
+    return xml.release();
+}
+
+bool SettingsSnapshot::writeToFile(const XmlElement& settings, const File& file)
+{
+    MemoryOutputStream out;
+    out.writeInt((int)SNAPSHOT_MAGIC);
+    out.writeInt(SNAPSHOT_VERSION);
+
+    NameTable rootNames;
+    writeElement(out, rootNames, settings, false);
+
+    int numSections = 0;
+    forEachXmlChildElement(settings, element)
+    {
+        numSections++;
+        if (element->hasTagName("SIGNALCHAIN"))
+            numSections += element->getNumChildElements();
+    }
+    out.writeCompressedInt(numSections);
+
+    forEachXmlChildElement(settings, element)
+    {
+        if (element->hasTagName("SIGNALCHAIN"))
+        {
+            writeSection(out, 0, *element, false);
+            forEachXmlChildElement(*element, node)
+                writeSection(out, 1, *node, true);
+        }
+        else
+        {
+            writeSection(out, 0, *element, true);
+        }
+    }
+
+    return file.replaceWithData(out.getData(), out.getDataSize());
+}
+
+bool SettingsSnapshot::isSnapshotFile(const File& file)
+{
+    FileInputStream in(file);
+    return in.openedOk() && (uint32)in.readInt() == SNAPSHOT_MAGIC;
+}
+
+// ---- SettingsWriter ----
+
+SettingsWriter::Request::Request(XmlElement* xml_, const File& xmlFile_)
+    : xml(xml_), xmlFile(xmlFile_), success(false), done(true)
+{
+}
+
+const String& SettingsWriter::Request::getXmlText()
+{
+    done.wait();
+    return xmlText;
+}
+
+bool SettingsWriter::Request::wasWritten()
+{
+    done.wait();
+    return success;
+}
+
+SettingsWriter::SettingsWriter() : Thread("Settings Writer")
+{
+    startThread();
+}
+
+SettingsWriter::~SettingsWriter()
+{
+    signalThreadShouldExit();
+    newRequest.signal();
+    waitForThreadToExit(-1);
+}
+
+SettingsWriter::Request::Ptr SettingsWriter::write(XmlElement* settings, const File& xmlFile)
+{
+    Request::Ptr request = new Request(settings, xmlFile);
+    pendingRequests.add(request);
+    newRequest.signal();
+    return request;
+}
+
+void SettingsWriter::run()
+{
+    // queued requests are still written after being asked to exit
+    while (!threadShouldExit() || pendingRequests.size() > 0)
+    {
+        Request::Ptr request = pendingRequests.removeAndReturn(0);
+
+        if (request == nullptr)
+        {
+            newRequest.wait(100);
+            continue;
+        }
+
+        request->xmlText = request->xml->createDocument(String::empty);
+
+        // the record thread may not have created the recording directory yet
+        request->xmlFile.getParentDirectory().createDirectory();
+
+        bool xmlWritten = request->xmlFile.replaceWithText(request->xmlText);
+        bool snapshotWritten = SettingsSnapshot::writeToFile(*request->xml,
+            request->xmlFile.withFileExtension(SettingsSnapshot::fileExtension));
+
+        if (!xmlWritten || !snapshotWritten)
+            std::cout << "Couldn't write settings to " << request->xmlFile.getFullPathName() << std::endl;
+
+        request->success = xmlWritten && snapshotWritten;
+        request->xml = nullptr;
+        request->done.signal();
+    }
+}
@@ -0,0 +1,151 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2018 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __SETTINGSSNAPSHOT_H__
+#define __SETTINGSSNAPSHOT_H__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+
+/**
+
+  Compact binary form of the configuration that EditorViewport::saveState() writes as XML.
+
+  The file is a list of length-prefixed sections: one for each child of the SETTINGS
+  element, and one for each PROCESSOR or SWITCH element inside a SIGNALCHAIN. Opening a
+  snapshot only builds an index of the sections; each one is decoded when it is asked for.
+  Element and attribute names are stored once per section, and everything else is stored
+  as plain strings, so decoding gives back exactly the XML tree that was saved.
+
+  @see EditorViewport, SettingsWriter
+
+*/
+
+class SettingsSnapshot
+{
+public:
+    /** Opens and indexes a snapshot file. Use isValid() to check if it could be read. */
+    explicit SettingsSnapshot(const File& file);
+    ~SettingsSnapshot();
+
+    /** Returns true if the file was a well-formed snapshot. */
+    bool isValid() const;
+
+    /** Returns the number of sections in the snapshot. */
+    int getNumSections() const;
+
+    /** Returns the tag name of a section's element. */
+    String getSectionTag(int index) const;
+
+    /** Returns 0 for children of SETTINGS, 1 for elements of the preceding SIGNALCHAIN. */
+    int getSectionDepth(int index) const;
+
+    /** Decodes a single section. A SIGNALCHAIN section is returned without its elements.
+        The caller owns the returned element. */
+    XmlElement* createSectionXml(int index) const;
+
+    /** Decodes the whole snapshot back into the SETTINGS element. The caller owns it. */
+    XmlElement* createXml() const;
+
+    /** Writes a SETTINGS element as a snapshot file. */
+    static bool writeToFile(const XmlElement& settings, const File& file);
+
+    /** Returns true if the file starts like a snapshot. */
+    static bool isSnapshotFile(const File& file);
+
+    /** File extension used for snapshots written next to an XML settings file. */
+    static const char* const fileExtension;
+
+private:
+    struct Section
+    {
+        int depth;
+        String tag;
+        size_t offset;
+        size_t size;
+    };
+
+    MemoryBlock data;
+    Array<Section> sections;
+    ScopedPointer<XmlElement> rootElement;
+    bool valid;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SettingsSnapshot);
+};
+
+/**
+
+  Turns configurations into files on a background thread.
+
+  The caller builds the SETTINGS element (which needs the signal chain, and so the message
+  thread) and hands it over; the thread then creates the XML text and writes both the XML
+  file and its binary snapshot.
+
+  @see EditorViewport::saveStateInBackground
+
+*/
+
+class SettingsWriter : public Thread
+{
+public:
+    /** One queued configuration. Keep a reference to it to get the XML text once it is written. */
+    class Request : public ReferenceCountedObject
+    {
+    public:
+        typedef ReferenceCountedObjectPtr<Request> Ptr;
+
+        /** Blocks until the request has been written, then returns the XML text. */
+        const String& getXmlText();
+
+        /** Blocks until the request has been written, then returns true if both files were written. */
+        bool wasWritten();
+
+    private:
+        friend class SettingsWriter;
+        Request(XmlElement* xml, const File& xmlFile);
+
+        ScopedPointer<XmlElement> xml;
+        const File xmlFile;
+        String xmlText;
+        bool success;
+        WaitableEvent done;
+    };
+
+    SettingsWriter();
+
+    /** Writes any queued requests before returning. */
+    ~SettingsWriter();
+
+    /** Queues a SETTINGS element, taking ownership of it. It will be written to xmlFile, and as
+        a snapshot to the same path with the snapshot extension. */
+    Request::Ptr write(XmlElement* settings, const File& xmlFile);
+
+    void run() override;
+
+private:
+    ReferenceCountedArray<Request, CriticalSection> pendingRequests;
+    WaitableEvent newRequest;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SettingsWriter);
+};
+
+#endif  // __SETTINGSSNAPSHOT_H__
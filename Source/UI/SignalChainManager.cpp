@@ -24,6 +24,7 @@
 #include "SignalChainManager.h"
 
 #include "EditorViewport.h"
+#include "../Processors/Merger/Merger.h"
 
 #include "../AccessClass.h"
 
@@ -528,8 +529,12 @@ void SignalChainManager::updateVisibleEditors(GenericEditor* activeEditor,
     // Step 7: update all settings
     if (action != ACTIVATE)
     {
-
-		updateProcessorSettings();
+        // an UPDATE only edits the settings of activeEditor's processor, so the
+        // rest of the chain can be updated incrementally
+        if (action == UPDATE && !ev->loadingConfig)
+            updateProcessorSettings(activeEditor->getProcessor());
+        else
+            updateProcessorSettings();
     }
 
 
@@ -537,12 +542,32 @@ void SignalChainManager::updateVisibleEditors(GenericEditor* activeEditor,
 
 }
 
-void SignalChainManager::updateProcessorSettings()
+static bool hasChangedSource(GenericProcessor* p, const Array<GenericProcessor*>& changed)
+{
+    if (p->isMerger())
+    {
+        Merger* merger = static_cast<Merger*>(p);
+        return changed.contains(merger->sourceNodeA) || changed.contains(merger->sourceNodeB);
+    }
+
+    return changed.contains(p->getSourceNode());
+}
+
+void SignalChainManager::updateProcessorSettings(GenericProcessor* changedProcessor)
 {
 	// std::cout << "Updating settings." << std::endl;
 
 	Array<GenericProcessor*> splitters;
 
+	// processors whose output changed during this pass; anything fed by one
+	// of them has to be updated as well
+	Array<GenericProcessor*> changed;
+
+	const double startTime = Time::getMillisecondCounterHiRes();
+	int numProcessors = 0;
+	int numUpdated = 0;
+	int numChannelsUpdated = 0;
+
 	for (int n = 0; n < signalChainArray.size(); n++)
 	{
 		// iterate through signal chains
@@ -557,7 +582,17 @@ void SignalChainManager::updateProcessorSettings()
 		while (p != 0)
 		{
 			// iterate through processors
-			p->update();
+			numProcessors++;
+
+			if (changedProcessor == nullptr || p == changedProcessor || hasChangedSource(p, changed))
+			{
+				p->update();
+				numUpdated++;
+				numChannelsUpdated += p->getNumOutputs();
+
+				if (p->hasOutputLayoutChanged())
+					changed.addIfNotAlreadyThere(p);
+			}
 
 			if (p->isSplitter())
 			{
@@ -575,6 +610,10 @@ void SignalChainManager::updateProcessorSettings()
 			}
 		}
 	}
+
+	std::cout << "Updated " << numUpdated << " of " << numProcessors << " processors ("
+			  << numChannelsUpdated << " output channels) in "
+			  << String(Time::getMillisecondCounterHiRes() - startTime, 1) << " ms" << std::endl;
     
     EditorViewport* ev = AccessClass::getEditorViewport();
     if(!ev->loadingConfig)
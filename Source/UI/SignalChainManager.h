@@ -69,7 +69,10 @@ public:
     /** Clears the signal chain.*/
     void clearSignalChain();
 
-	void updateProcessorSettings();
+    /** Calls update() on the processors in every signal chain. If changedProcessor is
+    given, only that processor and the processors downstream of an output that
+    actually changed are updated; otherwise every processor is.*/
+    void updateProcessorSettings(GenericProcessor* changedProcessor = nullptr);
 
 private:
 
@@ -372,6 +372,7 @@ PopupMenu UIComponent::getMenuForIndex(int menuIndex, const String& menuName)
 		menu.addCommandItem(commandManager, reloadOnStartup);
 		menu.addSeparator();
 		menu.addCommandItem(commandManager, openPluginInstaller);
+		menu.addCommandItem(commandManager, reloadPlugin);
 
 #if !JUCE_MAC
 		menu.addSeparator();
@@ -443,7 +444,8 @@ void UIComponent::getAllCommands(Array <CommandID>& commands)
 		showHelp,
 		resizeWindow,
 		openTimestampSelectionWindow,
-		openPluginInstaller
+		openPluginInstaller,
+		reloadPlugin
 	};
 
 	commands.addArray(ids, numElementsInArray(ids));
@@ -536,6 +538,11 @@ void UIComponent::getCommandInfo(CommandID commandID, ApplicationCommandInfo& re
 			result.addDefaultKeypress('P', ModifierKeys::commandModifier);
 			break;
 
+		case reloadPlugin:
+			result.setInfo("Reload plugin...", "Replace a loaded plugin with a new build of it.", "General", 0);
+			result.setActive(!acquisitionStarted);
+			break;
+
 		case showHelp:
 			result.setInfo("Show help...", "Take me to the GUI wiki.", "General", 0);
 			result.setActive(true);
@@ -682,6 +689,32 @@ bool UIComponent::perform(const InvocationInfo& info)
 				break;
 			}
 
+		case reloadPlugin:
+			{
+#if JUCE_WINDOWS
+				String pluginExt("*.dll");
+#elif JUCE_MAC
+				String pluginExt("*.bundle");
+#else
+				String pluginExt("*.so");
+#endif
+				FileChooser fc("Choose the new plugin build...",
+						File::getSpecialLocation(File::currentApplicationFile).getParentDirectory(),
+						pluginExt,
+						true);
+
+				if (fc.browseForFileToOpen())
+				{
+					sendActionMessage(getEditorViewport()->reloadPlugin(fc.getResult()));
+				}
+				else
+				{
+					sendActionMessage("No plugin selected.");
+				}
+
+				break;
+			}
+
 		default:
 			break;
 
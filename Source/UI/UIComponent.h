@@ -193,7 +193,8 @@ private:
         reloadOnStartup         = 0x2013,
         saveConfigurationAs     = 0x2014,
 		openTimestampSelectionWindow = 0x2015,
-        openPluginInstaller     = 0x2016
+        openPluginInstaller     = 0x2016,
+        reloadPlugin            = 0x2017
     };
 
     File currentConfigFile;